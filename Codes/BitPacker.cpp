@@ -0,0 +1,236 @@
+#include "BitPacker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+constexpr float QuaternionComponentLimit = 0.70710678118f;
+
+QuantizationRange QuaternionComponentRange(int bitsPerComponent) {
+  QuantizationRange range;
+  range.min = -QuaternionComponentLimit;
+  range.max = QuaternionComponentLimit;
+  range.bits = bitsPerComponent;
+  return range;
+}
+
+uint64_t MaxQuantizedValue(int bits) { return (uint64_t(1) << bits) - 1; }
+} // namespace
+
+namespace BitPacking {
+uint32_t QuantizeFloat(float value, const QuantizationRange &range) {
+  // Written so that NaN clamps to the range minimum.
+  float clamped = value >= range.min ? value : range.min;
+  clamped = clamped <= range.max ? clamped : range.max;
+  const double normalized =
+      (static_cast<double>(clamped) - range.min) / (range.max - range.min);
+  return static_cast<uint32_t>(
+      std::llround(normalized * MaxQuantizedValue(range.bits)));
+}
+
+float DequantizeFloat(uint32_t quantized, const QuantizationRange &range) {
+  const double normalized =
+      static_cast<double>(quantized) / MaxQuantizedValue(range.bits);
+  return static_cast<float>(range.min + normalized * (range.max - range.min));
+}
+} // namespace BitPacking
+
+BitPacker::BitPacker(std::vector<char> &buffer) : m_buffer(buffer) {}
+
+BitPacker::~BitPacker() { Flush(); }
+
+void BitPacker::WriteBits(uint32_t value, int bitCount) {
+  if (bitCount <= 0) {
+    return;
+  }
+
+  if (bitCount < 32) {
+    value &= (uint32_t(1) << bitCount) - 1;
+  }
+
+  m_scratch |= static_cast<uint64_t>(value) << m_scratchBits;
+  m_scratchBits += bitCount;
+  m_bitsWritten += static_cast<size_t>(bitCount);
+
+  while (m_scratchBits >= 8) {
+    m_buffer.push_back(static_cast<char>(m_scratch & 0xFF));
+    m_scratch >>= 8;
+    m_scratchBits -= 8;
+  }
+}
+
+void BitPacker::WriteBool(bool value) { WriteBits(value ? 1u : 0u, 1); }
+
+void BitPacker::WriteVarUInt(uint32_t value) {
+  do {
+    uint32_t group = value & 0x7F;
+    value >>= 7;
+    if (value != 0) {
+      group |= 0x80;
+    }
+    WriteBits(group, 8);
+  } while (value != 0);
+}
+
+void BitPacker::WriteVarInt(int32_t value) {
+  WriteVarUInt(BitPacking::ZigZagEncode(value));
+}
+
+void BitPacker::WriteQuantizedFloat(float value,
+                                    const QuantizationRange &range) {
+  WriteBits(BitPacking::QuantizeFloat(value, range), range.bits);
+}
+
+void BitPacker::WriteQuantizedVec3(const Vec3 &value,
+                                   const QuantizationRange &range) {
+  WriteQuantizedFloat(value.x, range);
+  WriteQuantizedFloat(value.y, range);
+  WriteQuantizedFloat(value.z, range);
+}
+
+void BitPacker::WriteQuaternion(const Quaternion &value,
+                                int bitsPerComponent) {
+  float components[4] = {value.x, value.y, value.z, value.w};
+  float lengthSquared = 0.0f;
+  int largest = 0;
+  for (int i = 0; i < 4; ++i) {
+    lengthSquared += components[i] * components[i];
+    if (std::abs(components[i]) > std::abs(components[largest])) {
+      largest = i;
+    }
+  }
+
+  // q and -q are the same rotation, so the dropped component is always made
+  // positive and can be rebuilt from the unit length constraint.
+  const float invLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared)
+                                               : 1.0f;
+  const float sign = components[largest] < 0.0f ? -invLength : invLength;
+
+  const QuantizationRange range = QuaternionComponentRange(bitsPerComponent);
+  WriteBits(static_cast<uint32_t>(largest), 2);
+  for (int i = 0; i < 4; ++i) {
+    if (i != largest) {
+      WriteQuantizedFloat(components[i] * sign, range);
+    }
+  }
+}
+
+void BitPacker::Flush() {
+  if (m_scratchBits > 0) {
+    m_buffer.push_back(static_cast<char>(m_scratch & 0xFF));
+    m_bitsWritten += static_cast<size_t>(8 - m_scratchBits);
+  }
+  m_scratch = 0;
+  m_scratchBits = 0;
+}
+
+BitReader::BitReader(const char *data, size_t size)
+    : m_data(reinterpret_cast<const unsigned char *>(data)), m_size(size) {}
+
+bool BitReader::ReadBits(uint32_t &value, int bitCount) {
+  value = 0;
+  if (m_overflowed || bitCount <= 0 || bitCount > 32 ||
+      m_bitsRead + static_cast<size_t>(bitCount) > m_size * 8) {
+    m_overflowed = m_overflowed || bitCount > 0;
+    return false;
+  }
+
+  for (int written = 0; written < bitCount;) {
+    const size_t byteIndex = m_bitsRead / 8;
+    const int bitOffset = static_cast<int>(m_bitsRead % 8);
+    const int take = (std::min)(8 - bitOffset, bitCount - written);
+    const uint32_t bits =
+        (static_cast<uint32_t>(m_data[byteIndex]) >> bitOffset) &
+        ((1u << take) - 1);
+    value |= bits << written;
+    written += take;
+    m_bitsRead += static_cast<size_t>(take);
+  }
+  return true;
+}
+
+bool BitReader::ReadBool(bool &value) {
+  uint32_t bit = 0;
+  const bool ok = ReadBits(bit, 1);
+  value = bit != 0;
+  return ok;
+}
+
+bool BitReader::ReadVarUInt(uint32_t &value) {
+  value = 0;
+  for (int i = 0; i < BitPacking::MaxVarIntBytes; ++i) {
+    uint32_t group = 0;
+    if (!ReadBits(group, 8)) {
+      return false;
+    }
+
+    value |= (group & 0x7F) << (7 * i);
+    if ((group & 0x80) == 0) {
+      return true;
+    }
+  }
+
+  // More continuation bytes than a 32-bit value can need.
+  m_overflowed = true;
+  return false;
+}
+
+bool BitReader::ReadVarInt(int32_t &value) {
+  uint32_t encoded = 0;
+  const bool ok = ReadVarUInt(encoded);
+  value = BitPacking::ZigZagDecode(encoded);
+  return ok;
+}
+
+bool BitReader::ReadQuantizedFloat(float &value,
+                                   const QuantizationRange &range) {
+  uint32_t quantized = 0;
+  if (!ReadBits(quantized, range.bits)) {
+    return false;
+  }
+
+  value = BitPacking::DequantizeFloat(quantized, range);
+  return true;
+}
+
+bool BitReader::ReadQuantizedVec3(Vec3 &value,
+                                  const QuantizationRange &range) {
+  Vec3 decoded;
+  if (!ReadQuantizedFloat(decoded.x, range) ||
+      !ReadQuantizedFloat(decoded.y, range) ||
+      !ReadQuantizedFloat(decoded.z, range)) {
+    return false;
+  }
+
+  value = decoded;
+  return true;
+}
+
+bool BitReader::ReadQuaternion(Quaternion &value, int bitsPerComponent) {
+  uint32_t largest = 0;
+  if (!ReadBits(largest, 2)) {
+    return false;
+  }
+
+  const QuantizationRange range = QuaternionComponentRange(bitsPerComponent);
+  float components[4] = {};
+  float sumSquares = 0.0f;
+  for (uint32_t i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+
+    if (!ReadQuantizedFloat(components[i], range)) {
+      return false;
+    }
+    sumSquares += components[i] * components[i];
+  }
+
+  components[largest] = std::sqrt((std::max)(0.0f, 1.0f - sumSquares));
+  value.x = components[0];
+  value.y = components[1];
+  value.z = components[2];
+  value.w = components[3];
+  return true;
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Types.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Bounded float range sampled with `bits` bits. Values outside [min, max] are
+// clamped. A range with zero bits means "send the raw float".
+struct QuantizationRange {
+  float min = 0.0f;
+  float max = 0.0f;
+  int bits = 0;
+
+  bool IsEnabled() const { return bits > 0 && bits <= 32 && max > min; }
+};
+
+namespace BitPacking {
+// Bits per component for smallest-three quaternions; 2 + 3 * 10 = 32 bits.
+constexpr int DefaultQuaternionBits = 10;
+constexpr int MaxVarIntBytes = 5;
+
+inline uint32_t ZigZagEncode(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^
+         static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t ZigZagDecode(uint32_t value) {
+  return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+uint32_t QuantizeFloat(float value, const QuantizationRange &range);
+float DequantizeFloat(uint32_t quantized, const QuantizationRange &range);
+} // namespace BitPacking
+
+// Appends a bit stream to a byte buffer. Bits are packed LSB first; the last
+// partial byte is written on Flush() or destruction, so a packer scoped to one
+// property leaves the buffer byte aligned.
+class BitPacker {
+public:
+  explicit BitPacker(std::vector<char> &buffer);
+  ~BitPacker();
+
+  BitPacker(const BitPacker &) = delete;
+  BitPacker &operator=(const BitPacker &) = delete;
+
+  void WriteBits(uint32_t value, int bitCount);
+  void WriteBool(bool value);
+  void WriteVarUInt(uint32_t value);
+  void WriteVarInt(int32_t value);
+  void WriteQuantizedFloat(float value, const QuantizationRange &range);
+  void WriteQuantizedVec3(const Vec3 &value, const QuantizationRange &range);
+  // Smallest-three encoding: the index of the largest component plus the
+  // other three, each in [-1/sqrt(2), 1/sqrt(2)].
+  void WriteQuaternion(const Quaternion &value,
+                       int bitsPerComponent = BitPacking::DefaultQuaternionBits);
+
+  void Flush();
+  size_t GetBitsWritten() const { return m_bitsWritten; }
+
+private:
+  std::vector<char> &m_buffer;
+  uint64_t m_scratch = 0;
+  int m_scratchBits = 0;
+  size_t m_bitsWritten = 0;
+};
+
+// Reads a bit stream written by BitPacker. Reads past the end fail and leave
+// the reader in an overflowed state; every later read fails as well.
+class BitReader {
+public:
+  BitReader(const char *data, size_t size);
+
+  bool ReadBits(uint32_t &value, int bitCount);
+  bool ReadBool(bool &value);
+  bool ReadVarUInt(uint32_t &value);
+  bool ReadVarInt(int32_t &value);
+  bool ReadQuantizedFloat(float &value, const QuantizationRange &range);
+  bool ReadQuantizedVec3(Vec3 &value, const QuantizationRange &range);
+  bool ReadQuaternion(Quaternion &value,
+                      int bitsPerComponent = BitPacking::DefaultQuaternionBits);
+
+  // Whole bytes touched so far, i.e. how far a byte stream must advance.
+  size_t GetBytesConsumed() const { return (m_bitsRead + 7) / 8; }
+  bool HasOverflowed() const { return m_overflowed; }
+
+private:
+  const unsigned char *m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_bitsRead = 0;
+  bool m_overflowed = false;
+};
+} // namespace ToolKit::ToolKitNetworking
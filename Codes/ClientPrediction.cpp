@@ -0,0 +1,171 @@
+#include "ClientPrediction.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ToolKit::ToolKitNetworking {
+uint32_t PredictionBuffer::Record(InputCommand &input,
+                                  const Vec3 &predictedPosition,
+                                  const Quaternion &predictedOrientation) {
+  if (m_count == Capacity) {
+    m_head = (m_head + 1) % Capacity;
+    m_count--;
+  }
+
+  input.sequence = m_nextSequence++;
+  Entry &entry = At(m_count++);
+  entry.input = input;
+  entry.position = predictedPosition;
+  entry.orientation = predictedOrientation;
+  return input.sequence;
+}
+
+ReconcileResult PredictionBuffer::Reconcile(
+    uint32_t ackedSequence, const Vec3 &serverPosition,
+    const Quaternion &serverOrientation, const InputSimulateFn &simulate,
+    Vec3 &outPosition, Quaternion &outOrientation) {
+  if (ackedSequence < m_ackedSequence) {
+    return ReconcileResult::Stale;
+  }
+
+  if (ackedSequence != m_ackedSequence) {
+    // The prediction for the acked input is only known while it is buffered.
+    m_hasAckedState = false;
+    m_ackedSequence = ackedSequence;
+  }
+
+  while (m_count > 0 && At(0).input.sequence <= ackedSequence) {
+    const Entry &entry = At(0);
+    if (entry.input.sequence == ackedSequence) {
+      m_hasAckedState = true;
+      m_ackedPosition = entry.position;
+      m_ackedOrientation = entry.orientation;
+    }
+    m_head = (m_head + 1) % Capacity;
+    m_count--;
+  }
+
+  if (m_hasAckedState && Matches(serverPosition, serverOrientation)) {
+    return ReconcileResult::Confirmed;
+  }
+
+  // The server state is the truth for this ack from now on; later snapshots
+  // repeating it are compared against it instead of the old prediction.
+  m_hasAckedState = true;
+  m_ackedPosition = serverPosition;
+  m_ackedOrientation = serverOrientation;
+
+  Vec3 position = serverPosition;
+  Quaternion orientation = serverOrientation;
+  for (size_t i = 0; i < m_count; ++i) {
+    Entry &entry = At(i);
+    simulate(entry.input, position, orientation);
+    entry.position = position;
+    entry.orientation = orientation;
+  }
+
+  outPosition = position;
+  outOrientation = orientation;
+  return ReconcileResult::Corrected;
+}
+
+bool PredictionBuffer::Matches(const Vec3 &position,
+                               const Quaternion &orientation) const {
+  const Vec3 offset = position - m_ackedPosition;
+  return glm::dot(offset, offset) <= m_positionTolerance * m_positionTolerance &&
+         1.0f - std::abs(glm::dot(orientation, m_ackedOrientation)) <=
+             m_orientationTolerance;
+}
+
+void PredictionBuffer::SetTolerance(float position, float orientation) {
+  m_positionTolerance = (std::max)(position, 0.0f);
+  m_orientationTolerance = (std::max)(orientation, 0.0f);
+}
+
+void PredictionBuffer::Reset() {
+  m_head = 0;
+  m_count = 0;
+  m_nextSequence = 1;
+  m_sentSequence = 0;
+  m_ackedSequence = 0;
+  m_hasAckedState = false;
+}
+
+namespace {
+bool IsFinite(const Vec3 &value) {
+  return std::isfinite(value.x) && std::isfinite(value.y) &&
+         std::isfinite(value.z);
+}
+
+bool IsFinite(const Quaternion &value) {
+  return std::isfinite(value.x) && std::isfinite(value.y) &&
+         std::isfinite(value.z) && std::isfinite(value.w);
+}
+} // namespace
+
+size_t InputCommandQueue::Accept(const InputCommand *commands, size_t count) {
+  size_t accepted = 0;
+  for (size_t i = 0; i < count; ++i) {
+    InputCommand input = commands[i];
+    if (input.sequence <= m_acceptedSequence || m_count >= Capacity) {
+      continue;
+    }
+
+    // Dropped for good: the sequence is consumed so resends are ignored, and
+    // the owner's prediction is corrected by the next ack.
+    const float orientationLength =
+        std::sqrt(glm::dot(input.orientation, input.orientation));
+    if (!IsFinite(input.move) || !IsFinite(input.orientation) ||
+        !std::isfinite(orientationLength) || orientationLength < 1e-3f) {
+      m_acceptedSequence = input.sequence;
+      continue;
+    }
+
+    // NaN fails both comparisons and ends up as zero.
+    input.deltaTime = input.deltaTime > 0.0f
+                          ? (std::min)(input.deltaTime, m_maxDeltaTime)
+                          : 0.0f;
+    const float moveLength = glm::length(input.move);
+    if (moveLength > m_maxMoveLength) {
+      const float scale = (std::max)(m_maxMoveLength, 0.0f) / moveLength;
+      input.move = input.move * scale;
+    }
+    input.orientation = input.orientation * (1.0f / orientationLength);
+
+    m_queue[(m_head + m_count) % Capacity] = input;
+    m_count++;
+    m_acceptedSequence = input.sequence;
+    accepted++;
+  }
+  return accepted;
+}
+
+void InputCommandQueue::AddElapsedTime(float seconds) {
+  if (!(seconds > 0.0f)) {
+    return;
+  }
+
+  const float maxCredit = (std::max)(m_maxTimeCredit, m_maxDeltaTime);
+  m_timeCredit = (std::min)(m_timeCredit + seconds, maxCredit);
+}
+
+bool InputCommandQueue::Pop(InputCommand &outInput) {
+  if (IsEmpty() || m_queue[m_head].deltaTime > m_timeCredit) {
+    return false;
+  }
+
+  outInput = m_queue[m_head];
+  m_head = (m_head + 1) % Capacity;
+  m_count--;
+  m_timeCredit -= outInput.deltaTime;
+  m_processedSequence = outInput.sequence;
+  return true;
+}
+
+void InputCommandQueue::Reset() {
+  m_head = 0;
+  m_count = 0;
+  m_acceptedSequence = 0;
+  m_processedSequence = 0;
+  m_timeCredit = 0.0f;
+}
+} // namespace ToolKit::ToolKitNetworking
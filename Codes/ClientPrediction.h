@@ -0,0 +1,163 @@
+#pragma once
+
+#include <Types.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// One frame of owner input. Sequences are assigned by the owning client,
+// start at 1 and grow by one per command; 0 means "none". What the fields
+// mean is up to the component's SimulateInput(); the default treats `move` as
+// a world-space velocity and `orientation` as the absolute facing.
+struct InputCommand {
+  uint32_t sequence = 0;
+  float deltaTime = 0.0f;
+  Vec3 move = Vec3(0.0f);
+  Quaternion orientation = Quaternion();
+  uint32_t buttons = 0;
+};
+
+// Advances a transform by one input. Must depend only on its arguments so the
+// client's replay reproduces what the server computed.
+using InputSimulateFn =
+    std::function<void(const InputCommand &, Vec3 &, Quaternion &)>;
+
+enum class ReconcileResult {
+  Stale,     // Older ack than one already applied; nothing changed.
+  Confirmed, // The server agrees with the prediction.
+  Corrected  // Replayed the unacked inputs from the server state.
+};
+
+// Client side of prediction: every input the server has not acked yet, with
+// the transform predicted right after it. When a snapshot acks a sequence,
+// the server transform is compared against the prediction for that input and,
+// if they disagree, the remaining inputs are replayed on top of it.
+class PredictionBuffer {
+public:
+  static constexpr size_t Capacity = 128;
+
+  // Assigns the next sequence to `input` and stores it with the transform
+  // predicted after simulating it. When the buffer is full the oldest input
+  // is dropped; the server is too far behind to ack it in time anyway.
+  uint32_t Record(InputCommand &input, const Vec3 &predictedPosition,
+                  const Quaternion &predictedOrientation);
+
+  // Applies a server ack. `serverPosition`/`serverOrientation` is the
+  // authoritative transform after `ackedSequence` (0 when the server has not
+  // processed any input yet). On a correction `outPosition`/`outOrientation`
+  // receives the replayed transform; otherwise they are left untouched.
+  ReconcileResult Reconcile(uint32_t ackedSequence, const Vec3 &serverPosition,
+                            const Quaternion &serverOrientation,
+                            const InputSimulateFn &simulate, Vec3 &outPosition,
+                            Quaternion &outOrientation);
+
+  // Unacked inputs, oldest first.
+  size_t GetPendingCount() const { return m_count; }
+  const InputCommand &GetPendingInput(size_t index) const {
+    return At(index).input;
+  }
+
+  uint32_t GetNewestSequence() const { return m_nextSequence - 1; }
+  uint32_t GetLastAckedSequence() const { return m_ackedSequence; }
+
+  // Whether inputs were recorded since the last MarkSent().
+  bool HasUnsentInput() const { return m_sentSequence < GetNewestSequence(); }
+  void MarkSent() { m_sentSequence = GetNewestSequence(); }
+
+  // Server/prediction disagreement tolerated without a replay, in world
+  // units and in 1 - |dot| between the orientations.
+  void SetTolerance(float position, float orientation);
+
+  void Reset();
+
+private:
+  struct Entry {
+    InputCommand input;
+    Vec3 position = Vec3(0.0f);
+    Quaternion orientation = Quaternion();
+  };
+
+  Entry &At(size_t index) { return m_entries[(m_head + index) % Capacity]; }
+  const Entry &At(size_t index) const {
+    return m_entries[(m_head + index) % Capacity];
+  }
+  bool Matches(const Vec3 &position, const Quaternion &orientation) const;
+
+private:
+  std::vector<Entry> m_entries = std::vector<Entry>(Capacity);
+  size_t m_head = 0;
+  size_t m_count = 0;
+  uint32_t m_nextSequence = 1;
+  uint32_t m_sentSequence = 0;
+  // Prediction for the newest acked input, kept to compare later snapshots
+  // that repeat the same ack.
+  uint32_t m_ackedSequence = 0;
+  bool m_hasAckedState = false;
+  Vec3 m_ackedPosition = Vec3(0.0f);
+  Quaternion m_ackedOrientation = Quaternion();
+  float m_positionTolerance = 0.01f;
+  float m_orientationTolerance = 0.001f;
+};
+
+// Server side: inputs received from a component's owner, waiting for the next
+// simulation step. Inputs are resent until acked, so repeats and anything at
+// or below the newest accepted sequence are dropped. Nothing a client sends is
+// trusted: values are validated on arrival and the simulated input time is
+// bounded by the server time that actually elapsed.
+class InputCommandQueue {
+public:
+  static constexpr size_t Capacity = 64;
+
+  // Queues the commands newer than anything accepted so far, in sequence
+  // order. `deltaTime` is clamped to [0, max delta time] and `move` to the
+  // max move length, so a client cannot move faster by claiming long frames
+  // or large moves; `orientation` is normalized. Commands with non-finite
+  // values or a degenerate orientation are dropped. Returns the number
+  // queued.
+  size_t Accept(const InputCommand *commands, size_t count);
+
+  // Credits server time the owner may simulate; call once per tick with the
+  // tick length. The credit is capped at the max time credit, so a client
+  // cannot bank idle time and spend it in a burst.
+  void AddElapsedTime(float seconds);
+
+  // Next input to simulate; marks it processed and spends its delta time.
+  // Returns false while the credit does not cover the next input, which then
+  // waits for a later tick.
+  bool Pop(InputCommand &outInput);
+
+  bool IsEmpty() const { return m_count == 0; }
+  // Inputs waiting to be simulated; never above Capacity.
+  size_t GetSize() const { return m_count; }
+  uint32_t GetLastProcessedSequence() const { return m_processedSequence; }
+  float GetTimeCredit() const { return m_timeCredit; }
+
+  void SetMaxDeltaTime(float seconds) { m_maxDeltaTime = seconds; }
+  float GetMaxDeltaTime() const { return m_maxDeltaTime; }
+  // Longest `move` accepted; with the default SimulateInput() that is the
+  // top speed in world units per second.
+  void SetMaxMoveLength(float length) { m_maxMoveLength = length; }
+  float GetMaxMoveLength() const { return m_maxMoveLength; }
+  // Never below the max delta time, or a full-length input would never fit.
+  void SetMaxTimeCredit(float seconds) { m_maxTimeCredit = seconds; }
+  float GetMaxTimeCredit() const { return m_maxTimeCredit; }
+
+  void Reset();
+
+private:
+  // Ring of waiting inputs, oldest at m_head. A client whose clock runs
+  // fast always has inputs waiting, so the storage must not grow with them.
+  std::array<InputCommand, Capacity> m_queue;
+  size_t m_head = 0;
+  size_t m_count = 0;
+  uint32_t m_acceptedSequence = 0;
+  uint32_t m_processedSequence = 0;
+  float m_maxDeltaTime = 0.1f;
+  float m_maxMoveLength = 20.0f;
+  float m_maxTimeCredit = 0.25f;
+  float m_timeCredit = 0.0f;
+};
+} // namespace ToolKit::ToolKitNetworking
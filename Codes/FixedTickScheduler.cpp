@@ -0,0 +1,88 @@
+#include "FixedTickScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+// Absorbs rounding when the snapshot period is a whole number of ticks, e.g.
+// three 1/60 s ticks per 1/20 s snapshot.
+constexpr double PeriodEpsilon = 1e-9;
+} // namespace
+
+void FixedTickScheduler::Configure(const Settings &settings) {
+  m_settings = settings;
+  m_settings.tickRate = (std::max)(0.0f, m_settings.tickRate);
+  m_settings.snapshotRate = (std::max)(0.0f, m_settings.snapshotRate);
+  m_settings.maxCatchUpTicks = (std::max)(1u, m_settings.maxCatchUpTicks);
+}
+
+FixedTickScheduler::Steps FixedTickScheduler::Advance(double deltaTime) {
+  Steps steps;
+  deltaTime = (std::max)(0.0, deltaTime);
+
+  const double interval = GetTickInterval();
+  if (interval <= 0.0) {
+    steps.ticks = 1;
+    steps.sendSnapshot = IsSnapshotDue(deltaTime);
+    return steps;
+  }
+
+  m_accumulator += deltaTime;
+  const double due = std::floor(m_accumulator / interval + PeriodEpsilon);
+  m_accumulator = (std::max)(0.0, m_accumulator - due * interval);
+  if (due > m_settings.maxCatchUpTicks) {
+    m_droppedTicks += static_cast<uint64_t>(due) - m_settings.maxCatchUpTicks;
+    steps.ticks = m_settings.maxCatchUpTicks;
+  } else {
+    steps.ticks = static_cast<uint32_t>(due);
+  }
+
+  for (uint32_t i = 0; i < steps.ticks; ++i) {
+    steps.sendSnapshot = IsSnapshotDue(interval) || steps.sendSnapshot;
+  }
+  return steps;
+}
+
+double FixedTickScheduler::GetTickInterval() const {
+  return m_settings.tickRate > 0.0f ? 1.0 / m_settings.tickRate : 0.0;
+}
+
+double FixedTickScheduler::GetAlpha() const {
+  const double interval = GetTickInterval();
+  return interval > 0.0 ? m_accumulator / interval : 0.0;
+}
+
+void FixedTickScheduler::Reset() {
+  m_accumulator = 0.0;
+  m_snapshotAccumulator = 0.0;
+  m_sentFirstSnapshot = false;
+  m_droppedTicks = 0;
+}
+
+bool FixedTickScheduler::IsSnapshotDue(double tickSeconds) {
+  if (m_settings.snapshotRate <= 0.0f ||
+      (m_settings.tickRate > 0.0f &&
+       m_settings.snapshotRate >= m_settings.tickRate)) {
+    return true;
+  }
+
+  // The first tick sends at once, so new peers do not wait a full period.
+  if (!m_sentFirstSnapshot) {
+    m_sentFirstSnapshot = true;
+    m_snapshotAccumulator = 0.0;
+    return true;
+  }
+
+  const double period = 1.0 / m_settings.snapshotRate;
+  m_snapshotAccumulator += tickSeconds;
+  if (m_snapshotAccumulator + PeriodEpsilon < period) {
+    return false;
+  }
+
+  // A stall sends one snapshot, not a burst.
+  m_snapshotAccumulator =
+      (std::min)(m_snapshotAccumulator - period, period - PeriodEpsilon);
+  m_snapshotAccumulator = (std::max)(0.0, m_snapshotAccumulator);
+  return true;
+}
+} // namespace ToolKit::ToolKitNetworking
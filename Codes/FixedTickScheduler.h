@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ToolKit::ToolKitNetworking {
+// Server tick pacing. Frame times accumulate and are spent in fixed ticks, so
+// the tick rate no longer follows the render frame rate; snapshots go out at
+// their own, usually lower, rate. A long frame runs at most MaxCatchUpTicks
+// ticks and drops the rest of its time instead of spiralling.
+class FixedTickScheduler {
+public:
+  struct Settings {
+    // Simulation ticks per second; 0 runs one tick per update.
+    float tickRate = 60.0f;
+    // Snapshots per second; 0, or a rate at or above the tick rate, sends
+    // one after every tick.
+    float snapshotRate = 20.0f;
+    uint32_t maxCatchUpTicks = 5;
+  };
+
+  struct Steps {
+    // Ticks to simulate in this update.
+    uint32_t ticks = 0;
+    // Send a snapshot after the last of them. Catch-up ticks share one.
+    bool sendSnapshot = false;
+  };
+
+  // Keeps the accumulated time; a rate change applies from the next update.
+  void Configure(const Settings &settings);
+  const Settings &GetSettings() const { return m_settings; }
+
+  Steps Advance(double deltaTime);
+
+  // Seconds per tick, 0 when ticks follow updates.
+  double GetTickInterval() const;
+  // Unspent time as a fraction of a tick, for rendering between ticks.
+  double GetAlpha() const;
+  uint64_t GetDroppedTicks() const { return m_droppedTicks; }
+
+  void Reset();
+
+private:
+  bool IsSnapshotDue(double tickSeconds);
+
+private:
+  Settings m_settings;
+  double m_accumulator = 0.0;
+  double m_snapshotAccumulator = 0.0;
+  bool m_sentFirstSnapshot = false;
+  uint64_t m_droppedTicks = 0;
+};
+} // namespace ToolKit::ToolKitNetworking
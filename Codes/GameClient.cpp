@@ -2,11 +2,13 @@
 #include "NetworkPackets.h"
 #include <iostream>
 
-ToolKit::ToolKitNetworking::GameClient::GameClient() {
-  m_netHandle = enet_host_create(nullptr, 1, 1, 0, 0);
+ToolKit::ToolKitNetworking::GameClient::GameClient(bool threadedIo) {
+  m_netHandle = enet_host_create(nullptr, 1, DeliveryChannelCount, 0, 0);
   m_timerSinceLastPacket = 0.f;
   m_PeerId = -1;
   m_isConnected = false;
+  m_netPeer = nullptr;
+  m_threadedIo = threadedIo;
 }
 
 ToolKit::ToolKitNetworking::GameClient::~GameClient() {}
@@ -20,8 +22,14 @@ bool ToolKit::ToolKitNetworking::GameClient::Connect(const std::string &host,
     return false;
   }
 
-  m_netPeer = enet_host_connect(m_netHandle, &address, 2, 0);
+  m_ioThread.reset();
+  m_netPeer =
+      enet_host_connect(m_netHandle, &address, DeliveryChannelCount, 0);
 
+  if (m_netPeer != nullptr && m_threadedIo) {
+    m_ioThread = std::make_unique<TransportIoThread>();
+    m_ioThread->Start(m_netHandle);
+  }
   return m_netPeer != nullptr;
 }
 
@@ -30,43 +38,34 @@ bool ToolKit::ToolKitNetworking::GameClient::UpdateClient() {
     return false;
 
   m_timerSinceLastPacket++;
-
-  ENetEvent event;
-  while (enet_host_service(m_netHandle, &event, 0) > 0) {
-    if (event.type == ENET_EVENT_TYPE_CONNECT) {
-      m_isConnected = true;
-      TK_LOG("Client transport connected to server.");
-
-      for (const auto &callback : m_onClientConnectedToServer) {
-        callback();
+  // Anything queued outside the replication tick goes out before new packets
+  // are handled.
+  FlushOutgoing();
+
+  if (m_ioThread) {
+    m_ioThread->Drain([this](TransportDatagram &event) {
+      if (event.kind == TransportEventKind::Connect) {
+        OnConnected();
+      } else if (event.kind == TransportEventKind::Disconnect) {
+        OnDisconnected();
+      } else {
+        OnDatagram(event.bytes.data(), event.bytes.size());
       }
-
-      SendClientInitPacket();
-    } else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
-      TK_LOG("Client transport disconnected from server.");
-      m_isConnected = false;
-      m_netPeer = nullptr;
-      m_PeerId = -1;
-    } else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
-      GamePacket *packet = (GamePacket *)event.packet->data;
-      TK_LOG(("Client transport received packet type=" +
-              std::to_string(packet->type))
-                 .c_str());
-
-      if (packet->type == NetworkMessage::ClientInit) {
-        ClientInitPacket *initPacket = (ClientInitPacket *)packet;
-        m_PeerId = initPacket->assignedPeerID;
-        TK_LOG(("Client: Received ClientInit. Assigned PeerID: " +
-                std::to_string(m_PeerId))
-                   .c_str());
-      } else if (!ProcessPacket(packet)) {
-        TK_LOG("Client: Failed to process packet (No handler?)");
+    });
+  } else {
+    ENetEvent event;
+    while (enet_host_service(m_netHandle, &event, 0) > 0) {
+      if (event.type == ENET_EVENT_TYPE_CONNECT) {
+        OnConnected();
+      } else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
+        OnDisconnected();
+      } else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+        OnDatagram(event.packet->data, event.packet->dataLength);
       }
-      m_timerSinceLastPacket = 0.0f;
+      enet_packet_destroy(event.packet);
     }
-
-    enet_packet_destroy(event.packet);
   }
+
   if (m_timerSinceLastPacket >
       100.0f) { // Increased timeout to prevent premature dc during debugging
     return false;
@@ -87,27 +86,116 @@ void ToolKit::ToolKitNetworking::GameClient::SetPeerID(TransportPeerId peerID) {
   m_PeerId = peerID;
 }
 
-void ToolKit::ToolKitNetworking::GameClient::SendPacket(GamePacket &payload,
-                                                        bool reliable) {
-  if (!m_netPeer)
-    return;
-  int totalPacketSize = payload.GetTotalSize();
-  enet_uint32 flags = reliable ? ENET_PACKET_FLAG_RELIABLE : 0;
-  ENetPacket *dataPacket = enet_packet_create(&payload, totalPacketSize, flags);
-  enet_peer_send(m_netPeer, 0, dataPacket);
+void ToolKit::ToolKitNetworking::GameClient::SendPacket(
+    GamePacket &payload, DeliveryChannel channel) {
+  QueueOrSend(payload, channel);
 }
 
 void ToolKit::ToolKitNetworking::GameClient::SendReliablePacket(
     GamePacket &payload) const {
+  QueueOrSend(payload, DeliveryChannel::Lifecycle);
+}
+
+void ToolKit::ToolKitNetworking::GameClient::FlushOutgoing() {
+  FlushQueued();
+}
+
+void ToolKit::ToolKitNetworking::GameClient::FlushQueued() const {
+  if (!m_netPeer) {
+    m_outgoing.Clear();
+    return;
+  }
+
+  m_outgoing.Flush([this](const void *data, size_t size,
+                          DeliveryChannel channel) {
+    SendNow(data, size, channel);
+  });
+}
+
+void ToolKit::ToolKitNetworking::GameClient::SendNow(
+    const void *data, size_t size, DeliveryChannel channel) const {
+  if (m_ioThread) {
+    m_ioThread->Send(m_netPeer->incomingPeerID, data, size, channel);
+    return;
+  }
+
+  ENetPacket *dataPacket = CreatePooledPacket(data, size, channel);
+  if (dataPacket != nullptr &&
+      enet_peer_send(m_netPeer, GetENetChannel(channel), dataPacket) != 0) {
+    enet_packet_destroy(dataPacket);
+  }
+}
+
+void ToolKit::ToolKitNetworking::GameClient::QueueOrSend(
+    GamePacket &payload, DeliveryChannel channel) const {
   if (!m_netPeer)
     return;
-  int totalPacketSize = payload.GetTotalSize();
-  ENetPacket *dataPacket =
-      enet_packet_create(&payload, totalPacketSize, ENET_PACKET_FLAG_RELIABLE);
-  enet_peer_send(m_netPeer, 0, dataPacket);
+  if (m_outgoing.Queue(payload, channel)) {
+    return;
+  }
+
+  // Too large to bundle; queued messages go first to keep their order.
+  FlushQueued();
+  SendNow(&payload, payload.GetTotalSize(), channel);
+}
+
+void ToolKit::ToolKitNetworking::GameClient::OnConnected() {
+  m_isConnected = true;
+  TK_LOG("Client transport connected to server.");
+
+  for (const auto &callback : m_onClientConnectedToServer) {
+    callback();
+  }
+
+  SendClientInitPacket();
+}
+
+void ToolKit::ToolKitNetworking::GameClient::OnDisconnected() {
+  TK_LOG("Client transport disconnected from server.");
+  m_isConnected = false;
+  m_netPeer = nullptr;
+  m_PeerId = -1;
+}
+
+void ToolKit::ToolKitNetworking::GameClient::OnDatagram(void *data,
+                                                        size_t length) {
+  if (!IsWellFormedPacket(data, length)) {
+    TK_LOG("Client dropped malformed packet.");
+    return;
+  }
+
+  GamePacket *packet = (GamePacket *)data;
+  if (packet->type != NetworkMessage::Bundle) {
+    HandleReceivedPacket(packet);
+  } else if (!PacketBundle::ForEach(data, length, [this](GamePacket *message) {
+               HandleReceivedPacket(message);
+             })) {
+    TK_LOG("Client dropped the rest of a malformed bundle.");
+  }
+  m_timerSinceLastPacket = 0.0f;
+}
+
+void ToolKit::ToolKitNetworking::GameClient::HandleReceivedPacket(
+    GamePacket *packet) {
+  TK_LOG(("Client transport received packet type=" +
+          std::to_string(packet->type))
+             .c_str());
+
+  if (packet->type == NetworkMessage::ClientInit) {
+    ClientInitPacket *initPacket = (ClientInitPacket *)packet;
+    m_PeerId = initPacket->assignedPeerID;
+    TK_LOG(("Client: Received ClientInit. Assigned PeerID: " +
+            std::to_string(m_PeerId))
+               .c_str());
+  } else if (!ProcessPacket(packet)) {
+    TK_LOG("Client: Failed to process packet (No handler?)");
+  }
 }
 
 void ToolKit::ToolKitNetworking::GameClient::Disconnect() {
+  m_outgoing.Clear();
+  // ENet is not thread safe; take the host back before touching the peer.
+  m_ioThread.reset();
   if (m_netPeer) {
     enet_peer_disconnect_now(m_netPeer, 0);
     m_netPeer = nullptr;
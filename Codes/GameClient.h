@@ -1,6 +1,9 @@
 #pragma once
 #include "ITransportPeer.h"
 #include "NetworkBase.h"
+#include "PacketBatcher.h"
+#include "TransportIoThread.h"
+#include <memory>
 #include <vector>
 #include <functional>
 #include <string>
@@ -8,7 +11,9 @@
 namespace ToolKit::ToolKitNetworking {
 	class GameClient : public NetworkBase, public ITransportPeer {
 	public:
-		GameClient();
+		// With `threadedIo`, ENet is serviced on a TransportIoThread once
+		// connecting and UpdateClient() only handles what it received.
+		explicit GameClient(bool threadedIo = false);
 		~GameClient();
 
 		bool Connect(const std::string& host, int portNum) override;
@@ -19,8 +24,9 @@ namespace ToolKit::ToolKitNetworking {
 		void SetPeerID(TransportPeerId peerID) override;
 
 
-		void SendPacket(GamePacket& payload, bool reliable = false) override;
+		void SendPacket(GamePacket& payload, DeliveryChannel channel = DeliveryChannel::Snapshot) override;
 		void SendReliablePacket(GamePacket& payload) const;
+		void FlushOutgoing() override;
 		void Disconnect() override;
 		void AddOnClientConnected(const std::function<void()>& callback);
 
@@ -39,6 +45,19 @@ namespace ToolKit::ToolKitNetworking {
 
 		_ENetPeer* m_netPeer;
 
+		// Outgoing bundle to the server, flushed once per tick.
+		mutable PacketBatcher m_outgoing;
+
+		bool m_threadedIo;
+		std::unique_ptr<TransportIoThread> m_ioThread;
+
+		void QueueOrSend(GamePacket& payload, DeliveryChannel channel) const;
+		void FlushQueued() const;
+		void SendNow(const void* data, size_t size, DeliveryChannel channel) const;
+		void OnConnected();
+		void OnDisconnected();
+		void OnDatagram(void* data, size_t length);
+		void HandleReceivedPacket(GamePacket* packet);
 
 		void SendClientInitPacket();
 	};
@@ -6,12 +6,13 @@
 using namespace ToolKit::ToolKitNetworking;
 
 GameServer::GameServer(const std::string &bindAddress, int onPort,
-                       int maxClients) {
+                       int maxClients, bool threadedIo) {
   m_bindAddress = bindAddress;
   port = onPort;
   clientMax = maxClients;
   m_netHandle = nullptr;
   m_serverTick = 0;
+  m_threadedIo = threadedIo;
 
   Initialise();
 }
@@ -30,7 +31,8 @@ bool GameServer::Initialise() {
   }
   address.port = port;
 
-  m_netHandle = enet_host_create(&address, clientMax, 1, 0, 0);
+  m_netHandle =
+      enet_host_create(&address, clientMax, DeliveryChannelCount, 0, 0);
 
   if (!m_netHandle) {
     std::string functionName = __FUNCTION__;
@@ -40,20 +42,32 @@ bool GameServer::Initialise() {
     return false;
   }
 
+  m_peerTable.assign(m_netHandle->peerCount, nullptr);
+  m_outgoing.assign(m_netHandle->peerCount, PacketBatcher());
+
   char ipString[16];
   enet_address_get_host_ip(&m_netHandle->address, ipString, sizeof(ipString));
   m_ipAddress = std::string(ipString);
 
+  if (m_threadedIo) {
+    m_ioThread = std::make_unique<TransportIoThread>();
+    m_ioThread->Start(m_netHandle);
+  }
+
   return true;
 }
 
 void GameServer::Shutdown() {
   SendGlobalPacket(NetworkMessage::Shutdown);
   if (m_netHandle) {
+    FlushOutgoing();
+    // Stopping sends what the I/O thread still has queued.
+    m_ioThread.reset();
     enet_host_destroy(m_netHandle);
     m_netHandle = nullptr;
   }
   m_connectedPeers.clear();
+  m_peerTable.clear();
 }
 
 void GameServer::AddPeer(int peerNumber) {
@@ -80,42 +94,164 @@ void GameServer::RemovePeer(int peerNumber) {
 }
 
 bool GameServer::SendGlobalReliablePacket(GamePacket &packet) const {
-  return SendGlobalPacket(packet, true);
+  return SendGlobalPacket(packet, DeliveryChannel::Lifecycle);
 }
 
-bool GameServer::SendGlobalPacket(GamePacket &packet, bool reliable) const {
+bool GameServer::SendGlobalPacket(GamePacket &packet,
+                                  DeliveryChannel channel) const {
   if (!m_netHandle)
     return false;
-  enet_uint32 flags = reliable ? ENET_PACKET_FLAG_RELIABLE : 0;
-  ENetPacket *dataPacket =
-      enet_packet_create(&packet, packet.GetTotalSize(), flags);
-  enet_host_broadcast(m_netHandle, 0, dataPacket);
+
+  const bool bundle = m_outgoing[0].CanBundle(packet);
+  for (size_t i = 0; i < m_peerTable.size(); ++i) {
+    ENetPeer *p = m_peerTable[i];
+    if (p == nullptr) {
+      continue;
+    }
+
+    if (bundle) {
+      m_outgoing[i].Queue(packet, channel);
+    } else {
+      FlushPeer(p);
+    }
+  }
+
+  if (!bundle) {
+    if (m_ioThread) {
+      m_ioThread->Send(-1, &packet, packet.GetTotalSize(), channel);
+    } else {
+      ENetPacket *dataPacket =
+          CreatePooledPacket(&packet, packet.GetTotalSize(), channel);
+      if (dataPacket != nullptr) {
+        enet_host_broadcast(m_netHandle, GetENetChannel(channel), dataPacket);
+      }
+    }
+  }
   return true;
 }
 
 bool GameServer::SendGlobalPacket(int messageID) const {
   GamePacket packet;
   packet.type = (short)messageID;
-  return SendGlobalPacket(packet, false);
+  return SendGlobalPacket(packet, DeliveryChannel::Snapshot);
 }
 
 bool GameServer::SendPacketToPeer(TransportPeerId peerID, GamePacket &packet,
-                                  bool reliable) const {
+                                  DeliveryChannel channel) const {
   if (!m_netHandle)
     return false;
 
-  for (size_t i = 0; i < m_netHandle->peerCount; ++i) {
-    ENetPeer *p = &m_netHandle->peers[i];
-    if (p->state == ENET_PEER_STATE_CONNECTED &&
-        (int)p->incomingPeerID + 1 == peerID) {
-      enet_uint32 flags = reliable ? ENET_PACKET_FLAG_RELIABLE : 0;
-      ENetPacket *dataPacket =
-          enet_packet_create(&packet, packet.GetTotalSize(), flags);
-      enet_peer_send(p, 0, dataPacket);
-      return true;
+  ENetPeer *p = FindConnectedPeer(peerID);
+  if (p == nullptr) {
+    return false;
+  }
+
+  PacketBatcher &outgoing = m_outgoing[p->incomingPeerID];
+  if (!outgoing.Queue(packet, channel)) {
+    FlushPeer(p);
+    SendNow(p, &packet, packet.GetTotalSize(), channel);
+  }
+  return true;
+}
+
+bool GameServer::SendPacketToPeers(const std::vector<TransportPeerId> &peerIDs,
+                                   GamePacket &packet,
+                                   DeliveryChannel channel) const {
+  if (!m_netHandle || peerIDs.empty())
+    return false;
+
+  if (m_outgoing[0].CanBundle(packet)) {
+    bool queuedAny = false;
+    for (TransportPeerId peerID : peerIDs) {
+      ENetPeer *p = FindConnectedPeer(peerID);
+      if (p != nullptr) {
+        queuedAny |= m_outgoing[p->incomingPeerID].Queue(packet, channel);
+      }
+    }
+    return queuedAny;
+  }
+
+  if (m_ioThread) {
+    bool sentToAny = false;
+    for (TransportPeerId peerID : peerIDs) {
+      ENetPeer *p = FindConnectedPeer(peerID);
+      if (p != nullptr) {
+        FlushPeer(p);
+        SendNow(p, &packet, packet.GetTotalSize(), channel);
+        sentToAny = true;
+      }
+    }
+    return sentToAny;
+  }
+
+  // ENet packets are reference counted, so a single pooled copy of the
+  // payload is queued on every target peer.
+  ENetPacket *dataPacket =
+      CreatePooledPacket(&packet, packet.GetTotalSize(), channel);
+  if (dataPacket == nullptr) {
+    return false;
+  }
+
+  bool sentToAny = false;
+  for (TransportPeerId peerID : peerIDs) {
+    ENetPeer *p = FindConnectedPeer(peerID);
+    if (p == nullptr) {
+      continue;
+    }
+
+    FlushPeer(p);
+    if (enet_peer_send(p, GetENetChannel(channel), dataPacket) == 0) {
+      sentToAny = true;
     }
   }
-  return false;
+
+  if (dataPacket->referenceCount == 0) {
+    enet_packet_destroy(dataPacket);
+  }
+  return sentToAny;
+}
+
+void GameServer::FlushOutgoing() {
+  if (!m_netHandle) {
+    return;
+  }
+
+  for (ENetPeer *p : m_peerTable) {
+    if (p != nullptr) {
+      FlushPeer(p);
+    }
+  }
+}
+
+void GameServer::FlushPeer(ENetPeer *peer) const {
+  PacketBatcher &outgoing = m_outgoing[peer->incomingPeerID];
+  if (outgoing.HasPending()) {
+    outgoing.Flush([&](const void *data, size_t size, DeliveryChannel channel) {
+      SendNow(peer, data, size, channel);
+    });
+  }
+}
+
+void GameServer::SendNow(ENetPeer *peer, const void *data, size_t size,
+                         DeliveryChannel channel) const {
+  if (m_ioThread) {
+    m_ioThread->Send(peer->incomingPeerID, data, size, channel);
+    return;
+  }
+
+  ENetPacket *dataPacket = CreatePooledPacket(data, size, channel);
+  if (dataPacket != nullptr &&
+      enet_peer_send(peer, GetENetChannel(channel), dataPacket) != 0) {
+    enet_packet_destroy(dataPacket);
+  }
+}
+
+ENetPeer *GameServer::FindConnectedPeer(TransportPeerId peerID) const {
+  // Peer IDs are ENet slot indices plus one.
+  if (peerID < 1 || static_cast<size_t>(peerID) > m_peerTable.size()) {
+    return nullptr;
+  }
+  return m_peerTable[static_cast<size_t>(peerID) - 1];
 }
 
 bool GameServer::GetPeer(int peerIndex, int &peerId) const {
@@ -133,28 +269,74 @@ void GameServer::UpdateServer() {
     return;
   }
 
-  m_serverTick++;
+  // Anything queued outside the replication tick goes out before new input
+  // is handled.
+  FlushOutgoing();
+
+  if (m_ioThread) {
+    m_ioThread->Drain([this](TransportDatagram &event) {
+      if (event.kind == TransportEventKind::Connect) {
+        OnPeerConnected(event.peerSlot);
+      } else if (event.kind == TransportEventKind::Disconnect) {
+        OnPeerDisconnected(event.peerSlot);
+      } else {
+        OnDatagram(event.peerSlot, event.bytes.data(), event.bytes.size());
+      }
+    });
+    return;
+  }
 
   ENetEvent event;
   while (enet_host_service(m_netHandle, &event, 0) > 0) {
     int type = event.type;
-    ENetPeer *p = event.peer;
-    int peer = p->incomingPeerID;
+    int peer = event.peer->incomingPeerID;
 
     if (type == ENetEventType::ENET_EVENT_TYPE_CONNECT) {
-      TK_LOG("Server: New client has connected");
+      OnPeerConnected(peer);
     } else if (type == ENetEventType::ENET_EVENT_TYPE_DISCONNECT) {
-      TK_LOG("Server: Client has disconnected");
-      RemovePeer(peer + 1);
-      GamePacket packet;
-      packet.type = NetworkMessage::PeerDisconnected;
-      ProcessPacket(&packet, peer + 1);
+      OnPeerDisconnected(peer);
     } else if (type == ENetEventType::ENET_EVENT_TYPE_RECEIVE) {
-      GamePacket *packet = reinterpret_cast<GamePacket *>(event.packet->data);
-      ProcessPacket(packet, peer + 1);
+      OnDatagram(peer, event.packet->data, event.packet->dataLength);
     }
     enet_packet_destroy(event.packet);
   }
 }
 
+void GameServer::OnPeerConnected(int peerSlot) {
+  TK_LOG("Server: New client has connected");
+  // The host's peer array never moves, so the game thread may keep pointers
+  // into it while the I/O thread services the host.
+  m_peerTable[peerSlot] = &m_netHandle->peers[peerSlot];
+}
+
+void GameServer::OnPeerDisconnected(int peerSlot) {
+  TK_LOG("Server: Client has disconnected");
+  RemovePeer(peerSlot + 1);
+  m_peerTable[peerSlot] = nullptr;
+  m_outgoing[peerSlot].Clear();
+  GamePacket packet;
+  packet.type = NetworkMessage::PeerDisconnected;
+  ProcessPacket(&packet, peerSlot + 1);
+}
+
+void GameServer::OnDatagram(int peerSlot, void *data, size_t length) {
+  const int peer = peerSlot + 1;
+  if (!IsWellFormedPacket(data, length)) {
+    TK_LOG(("Server dropped malformed packet from peer=" + std::to_string(peer))
+               .c_str());
+    return;
+  }
+
+  GamePacket *packet = reinterpret_cast<GamePacket *>(data);
+  if (packet->type != NetworkMessage::Bundle) {
+    ProcessPacket(packet, peer);
+  } else if (!PacketBundle::ForEach(data, length, [&](GamePacket *message) {
+               ProcessPacket(message, peer);
+             })) {
+    TK_LOG(("Server dropped the rest of a malformed bundle from peer=" +
+            std::to_string(peer))
+               .c_str());
+  }
+}
+
 void GameServer::SetMaxClients(int maxClients) { clientMax = maxClients; }
@@ -1,13 +1,18 @@
 #pragma once
 #include "ITransportHost.h"
 #include "NetworkBase.h"
+#include "PacketBatcher.h"
+#include "TransportIoThread.h"
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace ToolKit::ToolKitNetworking {
 	class GameServer : public NetworkBase, public ITransportHost {
 	public:
-		GameServer(const std::string& bindAddress, int onPort, int maxClients);
+		// With `threadedIo`, ENet is serviced on a TransportIoThread and
+		// UpdateServer() only handles what it received.
+		GameServer(const std::string& bindAddress, int onPort, int maxClients, bool threadedIo = false);
 		~GameServer();
 
 		bool Initialise();
@@ -18,10 +23,12 @@ namespace ToolKit::ToolKitNetworking {
 		virtual void RemovePeer(int peerNumber);
 
 		bool SendGlobalReliablePacket(GamePacket& packet) const override;
-		bool SendGlobalPacket(GamePacket& packet, bool reliable = false) const override;
+		bool SendGlobalPacket(GamePacket& packet, DeliveryChannel channel = DeliveryChannel::Snapshot) const override;
 		bool SendGlobalPacket(int messageID) const override;
 		
-		bool SendPacketToPeer(TransportPeerId peerID, GamePacket& packet, bool reliable = false) const override;
+		bool SendPacketToPeer(TransportPeerId peerID, GamePacket& packet, DeliveryChannel channel = DeliveryChannel::Snapshot) const override;
+		bool SendPacketToPeers(const std::vector<TransportPeerId>& peerIDs, GamePacket& packet, DeliveryChannel channel = DeliveryChannel::Snapshot) const override;
+		void FlushOutgoing() override;
 
 		bool GetPeer(int peerIndex, int& peerId) const;
 		int GetConnectedPeerCount() const override { return (int)m_connectedPeers.size(); }
@@ -30,6 +37,7 @@ namespace ToolKit::ToolKitNetworking {
 		std::string GetIpAddress() const override;
 
 		virtual void UpdateServer() override;
+		void AdvanceServerTick() override { m_serverTick++; }
 		void SetMaxClients(int maxClients);
 		void RegisterPacketHandler(int msgID, PacketReceiver* receiver) override { NetworkBase::RegisterPacketHandler(msgID, receiver); }
 		void ClearPacketHandlers() override { NetworkBase::ClearPacketHandlers(); }
@@ -37,6 +45,12 @@ namespace ToolKit::ToolKitNetworking {
 		int GetServerTick() const override { return m_serverTick; }
 
 	protected:
+		_ENetPeer* FindConnectedPeer(TransportPeerId peerID) const;
+		void FlushPeer(_ENetPeer* peer) const;
+		void SendNow(_ENetPeer* peer, const void* data, size_t size, DeliveryChannel channel) const;
+		void OnPeerConnected(int peerSlot);
+		void OnPeerDisconnected(int peerSlot);
+		void OnDatagram(int peerSlot, void* data, size_t length);
 
 		std::string m_bindAddress;
 		int	port;
@@ -46,6 +60,15 @@ namespace ToolKit::ToolKitNetworking {
 
 		std::vector<TransportPeerId> m_connectedPeers;
 
+		// Per ENet peer slot (peer ID - 1). Slots are filled on connect and
+		// cleared on disconnect, so targeted sends never scan the host's peers.
+		std::vector<_ENetPeer*> m_peerTable;
+		// Outgoing bundles per slot, flushed once per tick.
+		mutable std::vector<PacketBatcher> m_outgoing;
+
+		bool m_threadedIo = false;
+		std::unique_ptr<TransportIoThread> m_ioThread;
+
 		std::string m_ipAddress;
 
 	};
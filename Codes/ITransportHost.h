@@ -13,17 +13,30 @@ public:
   virtual bool IsInitialised() const = 0;
   virtual void Shutdown() = 0;
   virtual bool SendGlobalReliablePacket(GamePacket &packet) const = 0;
-  virtual bool SendGlobalPacket(GamePacket &packet,
-                                bool reliable = false) const = 0;
+  virtual bool SendGlobalPacket(
+      GamePacket &packet,
+      DeliveryChannel channel = DeliveryChannel::Snapshot) const = 0;
   virtual bool SendGlobalPacket(int messageID) const = 0;
-  virtual bool SendPacketToPeer(TransportPeerId peerID, GamePacket &packet,
-                                bool reliable = false) const = 0;
+  virtual bool SendPacketToPeer(
+      TransportPeerId peerID, GamePacket &packet,
+      DeliveryChannel channel = DeliveryChannel::Snapshot) const = 0;
+  // Sends one shared payload to every listed peer without re-encoding it.
+  virtual bool SendPacketToPeers(
+      const std::vector<TransportPeerId> &peerIDs, GamePacket &packet,
+      DeliveryChannel channel = DeliveryChannel::Snapshot) const = 0;
+  // Small packets are bundled per peer until this is called, normally at the
+  // end of every tick.
+  virtual void FlushOutgoing() = 0;
   virtual void AddPeer(TransportPeerId peerID) = 0;
   virtual void RemovePeer(TransportPeerId peerID) = 0;
   virtual int GetConnectedPeerCount() const = 0;
   virtual const std::vector<TransportPeerId> &GetConnectedPeers() const = 0;
   virtual std::string GetIpAddress() const = 0;
+  // Receives and handles what arrived since the last call; runs once per
+  // update, however many ticks the update simulates.
   virtual void UpdateServer() = 0;
+  // Called once per simulated server tick.
+  virtual void AdvanceServerTick() = 0;
   virtual int GetServerTick() const = 0;
 
   virtual void RegisterPacketHandler(int msgID, PacketReceiver *receiver) = 0;
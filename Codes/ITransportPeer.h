@@ -14,7 +14,12 @@ public:
   virtual bool GetIsConnected() const = 0;
   virtual TransportPeerId GetPeerID() const = 0;
   virtual void SetPeerID(TransportPeerId peerID) = 0;
-  virtual void SendPacket(GamePacket &payload, bool reliable = false) = 0;
+  virtual void
+  SendPacket(GamePacket &payload,
+             DeliveryChannel channel = DeliveryChannel::Snapshot) = 0;
+  // Small packets are bundled until this is called, normally at the end of
+  // every tick.
+  virtual void FlushOutgoing() = 0;
   virtual void Disconnect() = 0;
   virtual std::string GetIPAddress() = 0;
 
@@ -0,0 +1,100 @@
+#include "InterestGrid.h"
+
+namespace ToolKit::ToolKitNetworking {
+InterestGrid::InterestGrid(float cellSize) { SetCellSize(cellSize); }
+
+void InterestGrid::SetCellSize(float cellSize) {
+  if (!(cellSize > 0.0f)) {
+    cellSize = DefaultCellSize;
+  }
+
+  m_cellSize = cellSize;
+  m_inverseCellSize = 1.0f / cellSize;
+
+  m_cells.clear();
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    m_entries[i].cell =
+        CellKey(CellCoord(m_entries[i].position.x),
+                CellCoord(m_entries[i].position.z));
+    AddToCell(i);
+  }
+}
+
+void InterestGrid::Update(int networkID, const Vec3 &position,
+                          int entityIndex) {
+  const int64_t cell = CellKey(CellCoord(position.x), CellCoord(position.z));
+
+  auto it = m_entryByID.find(networkID);
+  if (it == m_entryByID.end()) {
+    Entry entry;
+    entry.networkID = networkID;
+    entry.entityIndex = entityIndex;
+    entry.position = position;
+    entry.cell = cell;
+    m_entryByID.emplace(networkID, m_entries.size());
+    m_entries.push_back(entry);
+    AddToCell(m_entries.size() - 1);
+    return;
+  }
+
+  Entry &entry = m_entries[it->second];
+  entry.position = position;
+  entry.entityIndex = entityIndex;
+  if (entry.cell != cell) {
+    RemoveFromCell(it->second);
+    entry.cell = cell;
+    AddToCell(it->second);
+  }
+}
+
+void InterestGrid::Remove(int networkID) {
+  auto it = m_entryByID.find(networkID);
+  if (it == m_entryByID.end()) {
+    return;
+  }
+
+  const size_t index = it->second;
+  const size_t last = m_entries.size() - 1;
+  RemoveFromCell(index);
+  m_entryByID.erase(it);
+
+  if (index != last) {
+    // Swap the last entry into the hole and repoint its cell slot.
+    m_entries[index] = m_entries[last];
+    const Entry &moved = m_entries[index];
+    m_cells[moved.cell][moved.slot] = index;
+    m_entryByID[moved.networkID] = index;
+  }
+  m_entries.pop_back();
+}
+
+void InterestGrid::Clear() {
+  m_entries.clear();
+  m_entryByID.clear();
+  m_cells.clear();
+}
+
+void InterestGrid::AddToCell(size_t entryIndex) {
+  Entry &entry = m_entries[entryIndex];
+  std::vector<size_t> &bucket = m_cells[entry.cell];
+  entry.slot = bucket.size();
+  bucket.push_back(entryIndex);
+}
+
+void InterestGrid::RemoveFromCell(size_t entryIndex) {
+  const Entry &entry = m_entries[entryIndex];
+  auto cell = m_cells.find(entry.cell);
+  if (cell == m_cells.end()) {
+    return;
+  }
+
+  std::vector<size_t> &bucket = cell->second;
+  const size_t movedEntry = bucket.back();
+  bucket[entry.slot] = movedEntry;
+  m_entries[movedEntry].slot = entry.slot;
+  bucket.pop_back();
+  if (bucket.empty()) {
+    m_cells.erase(cell);
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
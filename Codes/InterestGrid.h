@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Uniform grid over entity positions on the XZ plane. Entities are bucketed
+// by cell; moving within a cell only updates the stored position, so calling
+// Update() for every entity every tick stays cheap.
+class InterestGrid {
+public:
+  static constexpr float DefaultCellSize = 32.0f;
+
+  explicit InterestGrid(float cellSize = DefaultCellSize);
+
+  // Rebuckets every tracked entity.
+  void SetCellSize(float cellSize);
+  float GetCellSize() const { return m_cellSize; }
+
+  // Inserts the entity or moves it. `entityIndex` is an opaque value handed
+  // back by queries; the replication manager stores the entity's slot in the
+  // current tick's entity list.
+  void Update(int networkID, const Vec3 &position, int entityIndex);
+  void Remove(int networkID);
+  void Clear();
+
+  // Calls fn(networkID, entityIndex, distanceSquared) for every entity within
+  // `radius` of `center`.
+  template <typename Fn>
+  void ForEachInRadius(const Vec3 &center, float radius, Fn &&fn) const;
+
+  size_t Size() const { return m_entries.size(); }
+
+private:
+  struct Entry {
+    int networkID = -1;
+    int entityIndex = -1;
+    Vec3 position;
+    int64_t cell = 0;
+    size_t slot = 0;
+  };
+
+  int CellCoord(float value) const {
+    // Out-of-range and NaN coordinates would make the cast undefined; they
+    // land in the outermost cells (NaN in cell 0) instead.
+    const double cell =
+        std::floor(static_cast<double>(value) * m_inverseCellSize);
+    if (std::isnan(cell)) {
+      return 0;
+    }
+    return static_cast<int>(
+        (std::max)(-2147483648.0, (std::min)(cell, 2147483647.0)));
+  }
+
+  static int64_t CellKey(int x, int z) {
+    return (static_cast<int64_t>(x) << 32) ^
+           static_cast<int64_t>(static_cast<uint32_t>(z));
+  }
+
+  void AddToCell(size_t entryIndex);
+  void RemoveFromCell(size_t entryIndex);
+
+private:
+  float m_cellSize = DefaultCellSize;
+  float m_inverseCellSize = 1.0f / DefaultCellSize;
+  std::vector<Entry> m_entries;
+  std::unordered_map<int, size_t> m_entryByID;
+  std::unordered_map<int64_t, std::vector<size_t>> m_cells;
+};
+
+template <typename Fn>
+void InterestGrid::ForEachInRadius(const Vec3 &center, float radius,
+                                   Fn &&fn) const {
+  if (radius < 0.0f || m_entries.empty()) {
+    return;
+  }
+
+  const float radiusSquared = radius * radius;
+  const int minX = CellCoord(center.x - radius);
+  const int maxX = CellCoord(center.x + radius);
+  const int minZ = CellCoord(center.z - radius);
+  const int maxZ = CellCoord(center.z + radius);
+
+  for (int x = minX; x <= maxX; ++x) {
+    for (int z = minZ; z <= maxZ; ++z) {
+      auto cell = m_cells.find(CellKey(x, z));
+      if (cell == m_cells.end()) {
+        continue;
+      }
+
+      for (size_t entryIndex : cell->second) {
+        const Entry &entry = m_entries[entryIndex];
+        const Vec3 offset = entry.position - center;
+        const float distanceSquared =
+            offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+        if (distanceSquared <= radiusSquared) {
+          fn(entry.networkID, entry.entityIndex, distanceSquared);
+        }
+      }
+    }
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,172 @@
+#include "InterestManager.h"
+#include <algorithm>
+#include <iterator>
+
+namespace ToolKit::ToolKitNetworking {
+void InterestManager::SetRadius(float radius) {
+  if (radius == m_radius) {
+    return;
+  }
+
+  m_radius = radius;
+  if (IsEnabled()) {
+    // Cells as wide as the query radius keep a query to a 3x3 block.
+    m_grid.SetCellSize(radius * ExitRadiusScale);
+  } else {
+    Reset();
+  }
+}
+
+void InterestManager::Update(const std::vector<InterestEntity> &entities,
+                             const std::vector<TransportPeerId> &peers) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  m_globalIndices.clear();
+  for (auto &owned : m_ownedIndices) {
+    owned.second.clear();
+  }
+
+  for (size_t i = 0; i < entities.size(); ++i) {
+    const InterestEntity &entity = entities[i];
+    if (entity.hasPosition) {
+      m_grid.Update(entity.networkID, entity.position, static_cast<int>(i));
+    } else {
+      m_grid.Remove(entity.networkID);
+      m_globalIndices.push_back(static_cast<int>(i));
+    }
+
+    if (entity.ownerID > 0) {
+      m_ownedIndices[entity.ownerID].push_back(static_cast<int>(i));
+    }
+  }
+
+  for (TransportPeerId peerID : peers) {
+    UpdatePeer(peerID, m_peers[peerID], entities);
+  }
+}
+
+void InterestManager::UpdatePeer(TransportPeerId peerID, PeerState &peer,
+                                 const std::vector<InterestEntity> &entities) {
+  peer.relevantByIndex.assign(entities.size(), 0);
+  peer.previous.swap(peer.relevant);
+  peer.relevant.clear();
+  peer.entered.clear();
+  peer.left.clear();
+
+  auto mark = [&](int entityIndex) {
+    uint8_t &flag = peer.relevantByIndex[entityIndex];
+    if (flag == 0) {
+      flag = 1;
+      peer.relevant.push_back(entities[entityIndex].networkID);
+    }
+  };
+
+  const std::vector<int> *owned = nullptr;
+  auto ownedIt = m_ownedIndices.find(peerID);
+  if (ownedIt != m_ownedIndices.end()) {
+    owned = &ownedIt->second;
+  }
+
+  int viewerIndex = -1;
+  if (owned != nullptr) {
+    for (int index : *owned) {
+      if (entities[index].hasPosition) {
+        viewerIndex = index;
+        break;
+      }
+    }
+  }
+
+  if (viewerIndex < 0) {
+    for (size_t i = 0; i < entities.size(); ++i) {
+      mark(static_cast<int>(i));
+    }
+  } else {
+    for (int index : m_globalIndices) {
+      mark(index);
+    }
+    for (int index : *owned) {
+      mark(index);
+    }
+
+    const float enterRadiusSquared = m_radius * m_radius;
+    m_grid.ForEachInRadius(
+        entities[viewerIndex].position, m_radius * ExitRadiusScale,
+        [&](int networkID, int entityIndex, float distanceSquared) {
+          if (distanceSquared <= enterRadiusSquared ||
+              std::binary_search(peer.previous.begin(), peer.previous.end(),
+                                 networkID)) {
+            mark(entityIndex);
+          }
+        });
+  }
+
+  std::sort(peer.relevant.begin(), peer.relevant.end());
+  std::set_difference(peer.relevant.begin(), peer.relevant.end(),
+                      peer.previous.begin(), peer.previous.end(),
+                      std::back_inserter(peer.entered));
+  std::set_difference(peer.previous.begin(), peer.previous.end(),
+                      peer.relevant.begin(), peer.relevant.end(),
+                      std::back_inserter(peer.left));
+}
+
+bool InterestManager::IsRelevant(TransportPeerId peerID,
+                                 int entityIndex) const {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  auto peer = m_peers.find(peerID);
+  return peer != m_peers.end() && entityIndex >= 0 &&
+         static_cast<size_t>(entityIndex) <
+             peer->second.relevantByIndex.size() &&
+         peer->second.relevantByIndex[entityIndex] != 0;
+}
+
+bool InterestManager::IsRelevantByID(TransportPeerId peerID,
+                                     int networkID) const {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  auto peer = m_peers.find(peerID);
+  return peer != m_peers.end() &&
+         std::binary_search(peer->second.relevant.begin(),
+                            peer->second.relevant.end(), networkID);
+}
+
+const std::vector<int> &
+InterestManager::GetEntered(TransportPeerId peerID) const {
+  auto peer = m_peers.find(peerID);
+  return peer != m_peers.end() ? peer->second.entered : m_empty;
+}
+
+const std::vector<int> &InterestManager::GetLeft(TransportPeerId peerID) const {
+  auto peer = m_peers.find(peerID);
+  return peer != m_peers.end() ? peer->second.left : m_empty;
+}
+
+void InterestManager::RemovePeer(TransportPeerId peerID) {
+  m_peers.erase(peerID);
+}
+
+void InterestManager::RemoveEntity(int networkID) {
+  m_grid.Remove(networkID);
+  for (auto &entry : m_peers) {
+    std::vector<int> &relevant = entry.second.relevant;
+    auto it = std::lower_bound(relevant.begin(), relevant.end(), networkID);
+    if (it != relevant.end() && *it == networkID) {
+      relevant.erase(it);
+    }
+  }
+}
+
+void InterestManager::Reset() {
+  m_grid.Clear();
+  m_peers.clear();
+  m_globalIndices.clear();
+  m_ownedIndices.clear();
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "InterestGrid.h"
+#include "TransportTypes.h"
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Interest inputs for one replicated entity.
+struct InterestEntity {
+  int networkID = -1;
+  TransportPeerId ownerID = -1;
+  // Entities without a transform are relevant to everyone.
+  bool hasPosition = false;
+  Vec3 position;
+};
+
+// Decides which entities each peer hears about. A peer's view is centred on
+// the first entity it owns; everything within the relevancy radius, every
+// entity the peer owns and every entity without a transform is relevant.
+// Peers that own nothing yet see the whole world.
+class InterestManager {
+public:
+  // An entity must move this much farther than the radius before it stops
+  // being relevant, so entities on the border don't spawn and despawn every
+  // tick.
+  static constexpr float ExitRadiusScale = 1.25f;
+
+  // A radius of zero or less disables interest management: every entity is
+  // relevant to every peer.
+  void SetRadius(float radius);
+  float GetRadius() const { return m_radius; }
+  bool IsEnabled() const { return m_radius > 0.0f; }
+
+  // Moves entities in the grid and recomputes every peer's relevant set.
+  void Update(const std::vector<InterestEntity> &entities,
+              const std::vector<TransportPeerId> &peers);
+
+  // `entityIndex` indexes the entity list of the last Update().
+  bool IsRelevant(TransportPeerId peerID, int entityIndex) const;
+  bool IsRelevantByID(TransportPeerId peerID, int networkID) const;
+
+  // Network IDs that became relevant or stopped being relevant to the peer
+  // during the last Update().
+  const std::vector<int> &GetEntered(TransportPeerId peerID) const;
+  const std::vector<int> &GetLeft(TransportPeerId peerID) const;
+
+  void RemovePeer(TransportPeerId peerID);
+  void RemoveEntity(int networkID);
+  void Reset();
+
+private:
+  struct PeerState {
+    std::vector<uint8_t> relevantByIndex;
+    // Sorted network IDs relevant after this and the previous Update().
+    std::vector<int> relevant;
+    std::vector<int> previous;
+    std::vector<int> entered;
+    std::vector<int> left;
+  };
+
+  void UpdatePeer(TransportPeerId peerID, PeerState &peer,
+                  const std::vector<InterestEntity> &entities);
+
+private:
+  float m_radius = 0.0f;
+  InterestGrid m_grid;
+  std::map<TransportPeerId, PeerState> m_peers;
+  // Rebuilt every Update(): entities without a transform, and the entities
+  // each peer owns in list order. The first owned entity with a transform is
+  // the peer's viewer.
+  std::vector<int> m_globalIndices;
+  std::unordered_map<TransportPeerId, std::vector<int>> m_ownedIndices;
+  std::vector<int> m_empty;
+};
+} // namespace ToolKit::ToolKitNetworking
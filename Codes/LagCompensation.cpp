@@ -0,0 +1,279 @@
+#include "LagCompensation.h"
+#include "InterestManager.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ToolKit::ToolKitNetworking {
+void LagCompensationFrame::Clear() {
+  networkIDs.clear();
+  positions.clear();
+  orientations.clear();
+  boundsMin.clear();
+  boundsMax.clear();
+  boundsRadius.clear();
+}
+
+void LagCompensationFrame::Reserve(size_t count) {
+  networkIDs.reserve(count);
+  positions.reserve(count);
+  orientations.reserve(count);
+  boundsMin.reserve(count);
+  boundsMax.reserve(count);
+  boundsRadius.reserve(count);
+}
+
+void LagCompensationFrame::Add(int networkID, const Vec3 &position,
+                               const Quaternion &orientation,
+                               const Vec3 &localMin, const Vec3 &localMax) {
+  networkIDs.push_back(networkID);
+  positions.push_back(position);
+  orientations.push_back(orientation);
+  boundsMin.push_back(localMin);
+  boundsMax.push_back(localMax);
+
+  Vec3 farthest;
+  for (int axis = 0; axis < 3; ++axis) {
+    farthest[axis] =
+        (std::max)(std::abs(localMin[axis]), std::abs(localMax[axis]));
+  }
+  boundsRadius.push_back(std::sqrt(glm::dot(farthest, farthest)));
+}
+
+void LagCompensationFrame::Add(const LagCompensationFrame &from, size_t index,
+                               const Vec3 &position,
+                               const Quaternion &orientation) {
+  networkIDs.push_back(from.networkIDs[index]);
+  positions.push_back(position);
+  orientations.push_back(orientation);
+  boundsMin.push_back(from.boundsMin[index]);
+  boundsMax.push_back(from.boundsMax[index]);
+  boundsRadius.push_back(from.boundsRadius[index]);
+}
+
+LagCompensationHistory::LagCompensationHistory(size_t capacity) {
+  SetCapacity(capacity);
+}
+
+void LagCompensationHistory::SetCapacity(size_t capacity) {
+  m_frames.clear();
+  m_frames.resize(capacity == 0 ? 1 : capacity);
+  m_newestTick = -1;
+  m_recordingTick = -1;
+}
+
+LagCompensationFrame &LagCompensationHistory::BeginFrame(int tick,
+                                                         double time) {
+  m_recordingTick = (std::max)(tick, 0);
+  Slot &slot = SlotFor(m_recordingTick);
+  slot.tick = m_recordingTick;
+  slot.time = time;
+  slot.frame.Clear();
+  return slot.frame;
+}
+
+void LagCompensationHistory::EndFrame() {
+  if (m_recordingTick < 0) {
+    return;
+  }
+
+  LagCompensationFrame &frame = SlotFor(m_recordingTick).frame;
+  if (!std::is_sorted(frame.networkIDs.begin(), frame.networkIDs.end())) {
+    m_order.resize(frame.Size());
+    std::iota(m_order.begin(), m_order.end(), 0u);
+    std::sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) {
+      return frame.networkIDs[a] < frame.networkIDs[b];
+    });
+
+    m_sorted.Clear();
+    m_sorted.Reserve(frame.Size());
+    for (uint32_t index : m_order) {
+      m_sorted.Add(frame, index, frame.positions[index],
+                   frame.orientations[index]);
+    }
+
+    // Swapping hands the old buffers to the scratch frame, so neither side
+    // reallocates once both have grown to the world size.
+    std::swap(frame, m_sorted);
+  }
+
+  m_newestTick = (std::max)(m_newestTick, m_recordingTick);
+  m_recordingTick = -1;
+}
+
+const LagCompensationHistory::Slot *
+LagCompensationHistory::FindSlot(int tick) const {
+  if (tick < 0 || tick > m_newestTick ||
+      tick <= m_newestTick - static_cast<int>(m_frames.size())) {
+    return nullptr;
+  }
+
+  const Slot &slot = m_frames[static_cast<size_t>(tick) % m_frames.size()];
+  return slot.tick == tick ? &slot : nullptr;
+}
+
+bool LagCompensationHistory::HasTick(int tick) const {
+  return FindSlot(tick) != nullptr;
+}
+
+int LagCompensationHistory::GetOldestTick() const {
+  if (m_newestTick < 0) {
+    return -1;
+  }
+
+  const int first =
+      (std::max)(0, m_newestTick - static_cast<int>(m_frames.size()) + 1);
+  for (int tick = first; tick <= m_newestTick; ++tick) {
+    if (FindSlot(tick) != nullptr) {
+      return tick;
+    }
+  }
+  return -1;
+}
+
+double
+LagCompensationHistory::ResolveViewTick(int ackedTick,
+                                        double interpolationDelay) const {
+  const Slot *later = FindSlot(ackedTick);
+  if (later == nullptr) {
+    return -1.0;
+  }
+
+  const double viewTime = later->time - interpolationDelay;
+  while (const Slot *earlier = FindSlot(later->tick - 1)) {
+    if (earlier->time <= viewTime) {
+      const double span = later->time - earlier->time;
+      const double fraction =
+          span > 0.0 ? (viewTime - earlier->time) / span : 0.0;
+      return earlier->tick + fraction;
+    }
+    later = earlier;
+  }
+
+  // Older than the window: the oldest recorded tick is the best we have.
+  return later->tick;
+}
+
+bool LagCompensationHistory::Rewind(double tick, TransportPeerId viewer,
+                                    const InterestManager *interest,
+                                    LagCompensationFrame &out) const {
+  out.Clear();
+  const int oldestTick = GetOldestTick();
+  if (oldestTick < 0) {
+    return false;
+  }
+
+  tick = (std::min)((std::max)(tick, static_cast<double>(oldestTick)),
+                    static_cast<double>(m_newestTick));
+
+  // Latest recorded tick at or before the target, then the next one after.
+  const Slot *from = nullptr;
+  for (int t = static_cast<int>(std::floor(tick)); from == nullptr; --t) {
+    from = FindSlot(t);
+  }
+
+  const Slot *to = nullptr;
+  if (tick > from->tick) {
+    for (int t = from->tick + 1; to == nullptr && t <= m_newestTick; ++t) {
+      to = FindSlot(t);
+    }
+  }
+
+  const float fraction =
+      to != nullptr
+          ? static_cast<float>((tick - from->tick) / (to->tick - from->tick))
+          : 0.0f;
+
+  const LagCompensationFrame &a = from->frame;
+  out.Reserve(a.Size());
+  size_t j = 0;
+  for (size_t i = 0; i < a.Size(); ++i) {
+    const int networkID = a.networkIDs[i];
+    if (interest != nullptr && !interest->IsRelevantByID(viewer, networkID)) {
+      continue;
+    }
+
+    Vec3 position = a.positions[i];
+    Quaternion orientation = a.orientations[i];
+    if (to != nullptr) {
+      // Both frames are sorted, so matching entities is a single merge pass.
+      const LagCompensationFrame &b = to->frame;
+      while (j < b.Size() && b.networkIDs[j] < networkID) {
+        j++;
+      }
+      if (j < b.Size() && b.networkIDs[j] == networkID) {
+        position = glm::mix(position, b.positions[j], fraction);
+        orientation = glm::normalize(
+            glm::slerp(orientation, b.orientations[j], fraction));
+      }
+    }
+
+    out.Add(a, i, position, orientation);
+  }
+  return true;
+}
+
+void LagCompensationHistory::Reset() { SetCapacity(m_frames.size()); }
+
+namespace LagCompensation {
+bool Raycast(const LagCompensationFrame &frame, const Vec3 &origin,
+             const Vec3 &direction, float maxDistance, int ignoreNetworkID,
+             LagCompensationHit &outHit) {
+  bool hit = false;
+  float nearest = maxDistance;
+  for (size_t i = 0; i < frame.Size(); ++i) {
+    if (frame.networkIDs[i] == ignoreNetworkID) {
+      continue;
+    }
+
+    // Reject with the enclosing sphere before rotating the ray.
+    const Vec3 toCenter = frame.positions[i] - origin;
+    const float radius = frame.boundsRadius[i];
+    const float along = glm::dot(toCenter, direction);
+    const float offAxisSquared = glm::dot(toCenter, toCenter) - along * along;
+    // Evaluated without short-circuiting: half the entities are behind the
+    // shooter, which makes an early-out branch unpredictable.
+    if ((along + radius < 0.0f) | (along - radius > nearest) |
+        (offAxisSquared > radius * radius)) {
+      continue;
+    }
+
+    // Test against the box in the entity's local space.
+    const Quaternion inverse = glm::conjugate(frame.orientations[i]);
+    const Vec3 localOrigin = inverse * (origin - frame.positions[i]);
+    const Vec3 localDirection = inverse * direction;
+    const Vec3 &boxMin = frame.boundsMin[i];
+    const Vec3 &boxMax = frame.boundsMax[i];
+
+    float enter = 0.0f;
+    float exit = nearest;
+    bool miss = false;
+    for (int axis = 0; axis < 3 && !miss; ++axis) {
+      const float o = localOrigin[axis];
+      const float d = localDirection[axis];
+      if (std::abs(d) < 1e-8f) {
+        miss = o < boxMin[axis] || o > boxMax[axis];
+        continue;
+      }
+
+      float t1 = (boxMin[axis] - o) / d;
+      float t2 = (boxMax[axis] - o) / d;
+      if (t1 > t2) {
+        std::swap(t1, t2);
+      }
+      enter = (std::max)(enter, t1);
+      exit = (std::min)(exit, t2);
+      miss = enter > exit;
+    }
+
+    if (!miss) {
+      hit = true;
+      nearest = enter;
+      outHit.networkID = frame.networkIDs[i];
+      outHit.distance = enter;
+    }
+  }
+  return hit;
+}
+} // namespace LagCompensation
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "TransportTypes.h"
+#include <Types.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+class InterestManager;
+
+// Hittable entities of one server tick, one array per field and sorted by
+// network ID. Bounds are a local-space box around the entity's position;
+// `boundsRadius` encloses the box in any orientation for cheap rejection.
+struct LagCompensationFrame {
+  std::vector<int> networkIDs;
+  std::vector<Vec3> positions;
+  std::vector<Quaternion> orientations;
+  std::vector<Vec3> boundsMin;
+  std::vector<Vec3> boundsMax;
+  std::vector<float> boundsRadius;
+
+  size_t Size() const { return networkIDs.size(); }
+  void Clear();
+  void Reserve(size_t count);
+  void Add(int networkID, const Vec3 &position, const Quaternion &orientation,
+           const Vec3 &localMin, const Vec3 &localMax);
+  void Add(const LagCompensationFrame &from, size_t index, const Vec3 &position,
+           const Quaternion &orientation);
+};
+
+struct LagCompensationHit {
+  int networkID = -1;
+  float distance = 0.0f;
+};
+
+// Server-side ring of the hittable world for the last few ticks. A shot is
+// validated against the world as the shooter saw it: rewind into a reusable
+// frame once, then run any number of queries against it. Rewinding touches
+// each recorded entity once and does not allocate once the buffers have
+// grown to the world size.
+class LagCompensationHistory {
+public:
+  static constexpr size_t DefaultCapacity = 64;
+
+  explicit LagCompensationHistory(size_t capacity = DefaultCapacity);
+
+  // Resizes the window. Existing history is dropped.
+  void SetCapacity(size_t capacity);
+  size_t GetCapacity() const { return m_frames.size(); }
+
+  // Records `tick` at server time `time` (seconds). Entities may be added in
+  // any order; EndFrame() sorts them.
+  LagCompensationFrame &BeginFrame(int tick, double time);
+  void EndFrame();
+
+  bool HasTick(int tick) const;
+  int GetNewestTick() const { return m_newestTick; }
+  int GetOldestTick() const;
+
+  // Fractional tick the peer was looking at: the server time of its acked
+  // tick minus its interpolation delay, mapped back onto recorded ticks.
+  // Returns -1 when the acked tick is not in the window.
+  double ResolveViewTick(int ackedTick, double interpolationDelay) const;
+
+  // Fills `out` with the world at `tick`, blending transforms between the two
+  // recorded ticks around it and clamping to the window. Entities spawned
+  // after the earlier tick are left out. With `interest`, only entities
+  // relevant to `viewer` are kept. Returns false when nothing is recorded.
+  bool Rewind(double tick, TransportPeerId viewer,
+              const InterestManager *interest,
+              LagCompensationFrame &out) const;
+
+  void Reset();
+
+private:
+  struct Slot {
+    int tick = -1;
+    double time = 0.0;
+    LagCompensationFrame frame;
+  };
+
+  const Slot *FindSlot(int tick) const;
+  Slot &SlotFor(int tick) {
+    return m_frames[static_cast<size_t>(tick) % m_frames.size()];
+  }
+
+private:
+  std::vector<Slot> m_frames;
+  int m_newestTick = -1;
+  int m_recordingTick = -1;
+  // Scratch for sorting a recorded frame by network ID.
+  std::vector<uint32_t> m_order;
+  LagCompensationFrame m_sorted;
+};
+
+namespace LagCompensation {
+// Nearest entity box hit by the ray within `maxDistance`. `direction` must be
+// normalized. Entities matching `ignoreNetworkID` (usually the shooter) are
+// skipped.
+bool Raycast(const LagCompensationFrame &frame, const Vec3 &origin,
+             const Vec3 &direction, float maxDistance, int ignoreNetworkID,
+             LagCompensationHit &outHit);
+} // namespace LagCompensation
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <Types.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Longest string or container a payload may announce. Checked against the
+// bytes actually left before anything is allocated.
+constexpr uint32_t NetMaxContainerLength = 1u << 16;
+
+template <typename T> constexpr bool NetAlwaysFalse = false;
+
+// How a type travels in RPC arguments and NetworkVariables. Specializations
+// provide:
+//   static constexpr size_t FixedSize;  // encoded bytes, 0 when it varies
+//   static constexpr size_t MinSize;    // fewest bytes any value takes
+//   template <typename W> static void Write(W &out, const T &value);
+//   template <typename R> static bool Read(R &in, T &value);
+//   static size_t EncodedSize(const T &value);
+// W needs Write(const void *, size_t); R needs ReadBytes(void *, size_t) and
+// CanReadSize(size_t), as PacketStream and PacketReader have. Read() returns
+// false for truncated or out-of-range input; `value` may then be partially
+// overwritten.
+template <typename T, typename Enable = void> struct NetSerializer {
+  static_assert(NetAlwaysFalse<T>,
+                "No NetSerializer for this type. Specialize NetSerializer, or "
+                "use TK_NET_SERIALIZE_AS_BYTES for plain structs without "
+                "pointers.");
+};
+
+// Copies the object representation. Only for trivially copyable types
+// without pointers; the byte order is the host's, as everywhere else on the
+// wire.
+template <typename T> struct NetRawSerializer {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Raw serialization needs a trivially copyable type.");
+  static constexpr size_t FixedSize = sizeof(T);
+  static constexpr size_t MinSize = sizeof(T);
+
+  template <typename W> static void Write(W &out, const T &value) {
+    out.Write(&value, sizeof(T));
+  }
+
+  template <typename R> static bool Read(R &in, T &value) {
+    return in.ReadBytes(&value, sizeof(T));
+  }
+
+  static constexpr size_t EncodedSize(const T &) { return sizeof(T); }
+};
+
+template <typename T>
+constexpr bool NetIsRawScalar =
+    (std::is_arithmetic_v<T> || std::is_enum_v<T>)&&!std::is_same_v<T, bool>;
+
+template <typename T>
+struct NetSerializer<T, std::enable_if_t<NetIsRawScalar<T>>>
+    : NetRawSerializer<T> {};
+
+template <> struct NetSerializer<Vec3> : NetRawSerializer<Vec3> {};
+template <> struct NetSerializer<Quaternion> : NetRawSerializer<Quaternion> {};
+
+// One byte; anything but 0 or 1 is rejected, since a bool holding another
+// value is undefined behavior.
+template <> struct NetSerializer<bool> {
+  static constexpr size_t FixedSize = 1;
+  static constexpr size_t MinSize = 1;
+
+  template <typename W> static void Write(W &out, const bool &value) {
+    const uint8_t byte = value ? 1 : 0;
+    out.Write(&byte, 1);
+  }
+
+  template <typename R> static bool Read(R &in, bool &value) {
+    uint8_t byte = 0;
+    if (!in.ReadBytes(&byte, 1) || byte > 1) {
+      return false;
+    }
+    value = byte == 1;
+    return true;
+  }
+
+  static constexpr size_t EncodedSize(const bool &) { return 1; }
+};
+
+namespace NetVarIntCodec {
+constexpr size_t MaxBytes = 10;
+
+constexpr size_t EncodedSize(uint64_t value) {
+  size_t bytes = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    bytes++;
+  }
+  return bytes;
+}
+
+// LEB128: seven bits per byte, low bits first.
+template <typename W> void Write(W &out, uint64_t value) {
+  uint8_t bytes[MaxBytes];
+  size_t count = 0;
+  do {
+    uint8_t byte = static_cast<uint8_t>(value & 0x7f);
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80;
+    }
+    bytes[count++] = byte;
+  } while (value != 0);
+  out.Write(bytes, count);
+}
+
+template <typename R> bool Read(R &in, uint64_t &value) {
+  value = 0;
+  for (size_t i = 0; i < MaxBytes; ++i) {
+    uint8_t byte = 0;
+    if (!in.ReadBytes(&byte, 1)) {
+      return false;
+    }
+    // The tenth byte only has room for the top bit of a 64-bit value.
+    if (i == MaxBytes - 1 && byte > 1) {
+      return false;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads a string or container length and checks that the payload can hold
+// that many elements of at least `minElementSize` bytes each.
+template <typename R>
+bool ReadLength(R &in, size_t minElementSize, size_t &length) {
+  uint64_t value = 0;
+  if (!Read(in, value) || value > NetMaxContainerLength) {
+    return false;
+  }
+  length = static_cast<size_t>(value);
+  return in.CanReadSize(length * minElementSize);
+}
+} // namespace NetVarIntCodec
+
+// Integer sent as a varint, zig-zag encoded when signed, so small magnitudes
+// take one byte instead of sizeof(T).
+template <typename T> struct NetVarInt {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                "NetVarInt needs an integer type.");
+  T value = 0;
+
+  NetVarInt() = default;
+  NetVarInt(T v) : value(v) {}
+  operator T() const { return value; }
+};
+
+template <typename T> struct NetSerializer<NetVarInt<T>> {
+  static constexpr size_t FixedSize = 0;
+  static constexpr size_t MinSize = 1;
+
+  static uint64_t Encode(T value) {
+    if constexpr (std::is_signed_v<T>) {
+      const int64_t wide = value;
+      return (static_cast<uint64_t>(wide) << 1) ^
+             static_cast<uint64_t>(wide >> 63);
+    } else {
+      return value;
+    }
+  }
+
+  template <typename W> static void Write(W &out, const NetVarInt<T> &value) {
+    NetVarIntCodec::Write(out, Encode(value.value));
+  }
+
+  template <typename R> static bool Read(R &in, NetVarInt<T> &value) {
+    uint64_t encoded = 0;
+    if (!NetVarIntCodec::Read(in, encoded)) {
+      return false;
+    }
+
+    if constexpr (std::is_signed_v<T>) {
+      const int64_t wide = static_cast<int64_t>(encoded >> 1) ^
+                           -static_cast<int64_t>(encoded & 1);
+      if (wide < std::numeric_limits<T>::min() ||
+          wide > std::numeric_limits<T>::max()) {
+        return false;
+      }
+      value.value = static_cast<T>(wide);
+    } else {
+      if (encoded > std::numeric_limits<T>::max()) {
+        return false;
+      }
+      value.value = static_cast<T>(encoded);
+    }
+    return true;
+  }
+
+  static size_t EncodedSize(const NetVarInt<T> &value) {
+    return NetVarIntCodec::EncodedSize(Encode(value.value));
+  }
+};
+
+// Varint byte count followed by the bytes.
+template <> struct NetSerializer<std::string> {
+  static constexpr size_t FixedSize = 0;
+  static constexpr size_t MinSize = 1;
+
+  template <typename W> static void Write(W &out, const std::string &value) {
+    NetVarIntCodec::Write(out, value.size());
+    out.Write(value.data(), value.size());
+  }
+
+  template <typename R> static bool Read(R &in, std::string &value) {
+    size_t length = 0;
+    if (!NetVarIntCodec::ReadLength(in, 1, length)) {
+      return false;
+    }
+    value.resize(length);
+    return in.ReadBytes(value.data(), length);
+  }
+
+  static size_t EncodedSize(const std::string &value) {
+    return NetVarIntCodec::EncodedSize(value.size()) + value.size();
+  }
+};
+
+// Varint element count followed by the elements.
+template <typename T, typename Alloc>
+struct NetSerializer<std::vector<T, Alloc>> {
+  using Element = NetSerializer<T>;
+  static constexpr size_t FixedSize = 0;
+  static constexpr size_t MinSize = 1;
+
+  template <typename W>
+  static void Write(W &out, const std::vector<T, Alloc> &value) {
+    NetVarIntCodec::Write(out, value.size());
+    for (const T &element : value) {
+      Element::Write(out, element);
+    }
+  }
+
+  template <typename R> static bool Read(R &in, std::vector<T, Alloc> &value) {
+    size_t length = 0;
+    if (!NetVarIntCodec::ReadLength(in, Element::MinSize, length)) {
+      return false;
+    }
+
+    value.resize(length);
+    for (size_t i = 0; i < length; ++i) {
+      T element{};
+      if (!Element::Read(in, element)) {
+        return false;
+      }
+      value[i] = std::move(element);
+    }
+    return true;
+  }
+
+  static size_t EncodedSize(const std::vector<T, Alloc> &value) {
+    size_t size = NetVarIntCodec::EncodedSize(value.size());
+    if constexpr (Element::FixedSize != 0) {
+      size += value.size() * Element::FixedSize;
+    } else {
+      for (const T &element : value) {
+        size += Element::EncodedSize(element);
+      }
+    }
+    return size;
+  }
+};
+
+// Exactly N elements, no length prefix.
+template <typename T, size_t N> struct NetSerializer<std::array<T, N>> {
+  using Element = NetSerializer<T>;
+  static constexpr size_t FixedSize = N * Element::FixedSize;
+  static constexpr size_t MinSize = N * Element::MinSize;
+
+  template <typename W>
+  static void Write(W &out, const std::array<T, N> &value) {
+    for (const T &element : value) {
+      Element::Write(out, element);
+    }
+  }
+
+  template <typename R> static bool Read(R &in, std::array<T, N> &value) {
+    for (T &element : value) {
+      if (!Element::Read(in, element)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static size_t EncodedSize(const std::array<T, N> &value) {
+    if constexpr (FixedSize != 0 || N == 0) {
+      return FixedSize;
+    } else {
+      size_t size = 0;
+      for (const T &element : value) {
+        size += Element::EncodedSize(element);
+      }
+      return size;
+    }
+  }
+};
+
+// True when every type in the pack encodes to a fixed byte count.
+template <typename... Ts>
+constexpr bool NetIsFixedSize = ((NetSerializer<Ts>::FixedSize != 0) && ...);
+
+template <typename... Ts>
+constexpr size_t NetFixedSizeOf = (NetSerializer<Ts>::FixedSize + ... + 0);
+
+// Encoded size of the values, a constant when the types allow it.
+template <typename... Ts> size_t NetEncodedSize(const Ts &...values) {
+  if constexpr (NetIsFixedSize<Ts...>) {
+    return NetFixedSizeOf<Ts...>;
+  } else {
+    return (NetSerializer<Ts>::EncodedSize(values) + ... + 0);
+  }
+}
+
+template <typename W, typename... Ts>
+void NetWriteAll(W &out, const Ts &...values) {
+  (NetSerializer<Ts>::Write(out, values), ...);
+}
+
+// Stops at the first value that fails to decode.
+template <typename R, typename... Ts> bool NetReadAll(R &in, Ts &...values) {
+  return (NetSerializer<Ts>::Read(in, values) && ...);
+}
+} // namespace ToolKit::ToolKitNetworking
+
+// Sends a plain struct as its bytes. Use at global scope, after the type is
+// complete.
+#define TK_NET_SERIALIZE_AS_BYTES(Type)                                        \
+  namespace ToolKit::ToolKitNetworking {                                       \
+  template <>                                                                  \
+  struct NetSerializer<Type> : NetRawSerializer<Type> {};                      \
+  }
@@ -2,10 +2,26 @@
 #include <iostream>
 
 #include "NetworkPackets.h"
+#include "PacketBufferPool.h"
+#include <cstring>
 
 namespace ToolKit::ToolKitNetworking {
+	// ENet allocates a header for every packet and a command for every send,
+	// ack and receive. Taking that memory from the buffer pool keeps steady
+	// traffic off the heap.
+	static void* ENET_CALLBACK AllocateENetMemory(size_t size) {
+		return PacketBufferPool::Get().AllocateBlock(size);
+	}
+
+	static void ENET_CALLBACK FreeENetMemory(void* memory) {
+		PacketBufferPool::Get().FreeBlock(memory);
+	}
+
 	void NetworkBase::Initialise() {
-		enet_initialize();
+		ENetCallbacks callbacks = {};
+		callbacks.malloc = AllocateENetMemory;
+		callbacks.free = FreeENetMemory;
+		enet_initialize_with_callbacks(ENET_VERSION, &callbacks);
 	}
 
 	void NetworkBase::Destroy() {
@@ -51,6 +67,47 @@ namespace ToolKit::ToolKitNetworking {
 		return false;
 	}
 
+	enet_uint8 NetworkBase::GetENetChannel(DeliveryChannel channel) {
+		return static_cast<enet_uint8>(channel);
+	}
+
+	enet_uint32 NetworkBase::GetENetFlags(DeliveryChannel channel) {
+		switch (channel) {
+		case DeliveryChannel::Lifecycle:
+		case DeliveryChannel::ReliableRpc:
+			return ENET_PACKET_FLAG_RELIABLE;
+		case DeliveryChannel::UnreliableRpc:
+			return ENET_PACKET_FLAG_UNSEQUENCED;
+		default:
+			return 0;
+		}
+	}
+
+	static void ReleasePooledPacketData(ENetPacket* packet) {
+		PacketBufferPool::Get().ReleaseDetached(static_cast<std::vector<char>*>(packet->userData));
+		packet->userData = nullptr;
+	}
+
+	ENetPacket* NetworkBase::CreatePooledPacket(const void* data, size_t size, DeliveryChannel channel) {
+		std::vector<char>* buffer = PacketBufferPool::Get().AcquireDetached(size);
+		buffer->resize(size);
+		if (size > 0) {
+			std::memcpy(buffer->data(), data, size);
+		}
+
+		// NO_ALLOCATE makes ENet send straight from the pooled buffer instead of
+		// copying it into memory of its own.
+		ENetPacket* packet = enet_packet_create(buffer->data(), size, GetENetFlags(channel) | ENET_PACKET_FLAG_NO_ALLOCATE);
+		if (packet == nullptr) {
+			PacketBufferPool::Get().ReleaseDetached(buffer);
+			return nullptr;
+		}
+
+		packet->userData = buffer;
+		packet->freeCallback = ReleasePooledPacketData;
+		return packet;
+	}
+
 	bool NetworkBase::GetPacketHandlers(int msgID, PacketHandlerIterator& first, PacketHandlerIterator& last) const {
 		auto range = packetHandlers.equal_range(msgID);
 
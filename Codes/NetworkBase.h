@@ -4,6 +4,7 @@ struct _ENetHost;
 struct _ENetPeer;
 struct _ENetEvent;
 
+#include "TransportTypes.h"
 #include <enet/enet.h>
 #include <map>
 
@@ -22,6 +23,15 @@ namespace ToolKit::ToolKitNetworking {
 
         static int GetDefaultPort();
 
+        // ENet channel ID and packet flags for a delivery channel. Hosts are
+        // created with DeliveryChannelCount channels.
+        static enet_uint8 GetENetChannel(DeliveryChannel channel);
+        static enet_uint32 GetENetFlags(DeliveryChannel channel);
+
+        // ENet packet holding a copy of the payload in a PacketBufferPool
+        // buffer, which goes back to the pool when ENet destroys the packet.
+        static ENetPacket* CreatePooledPacket(const void* data, size_t size, DeliveryChannel channel);
+
         virtual void RegisterPacketHandler(int msgID, PacketReceiver* receiver);
 
         virtual void ClearPacketHandlers();
@@ -5,11 +5,6 @@
 #include <Node.h>
 #include <algorithm>
 
-namespace {
-	constexpr const float MIN_STATE_SYNC_POS_THRESHOLD = 0.001f;
-	constexpr const float MIN_STATE_SYNC_ROT_THRESHOLD = 0.001f;
-}
-
 namespace ToolKit::ToolKitNetworking {
 	TKDefineClass(NetworkComponent, Component);
 
@@ -45,132 +40,216 @@ namespace ToolKit::ToolKitNetworking {
 
 	bool NetworkComponent::IsLocalPlayer() const { return IsOwner(); }
 
-	void NetworkComponent::Serialize(PacketStream& stream, int baseTick) {
-		stream.WriteInt(networkID);
+	void NetworkComponent::CaptureReplication(ReplicationFrame& frame, bool hasTransform) {
+		// Variables of entities without a transform are not sent, so their
+		// changes stay pending until the entity has one.
+		if (hasTransform) {
+			CaptureVariableChanges(frame.tick);
+		}
+
+		frame.AddEntity(networkID, m_ownerPeerID, m_replicationPriority, m_updateInterval,
+			m_inputQueue.GetLastProcessedSequence(), m_positionQuantization, m_orientationBits);
+		if (m_variableOffsets.size() == m_networkVariables.size()) {
+			frame.SetVariables(m_variableChanges.GetChangedTicks().data(), m_variableOffsets.data(),
+				m_networkVariables.size(), m_variableBytes.buffer.data(), m_variableBytes.GetSize());
+		}
+	}
+
+	bool NetworkComponent::Deserialize(PacketReader& stream, int serverTick, int baseTick) {
+		NetworkState baseState;
+		const bool hasBase = baseTick != -1;
+		if (hasBase && !GetNetworkState(baseTick, baseState)) {
+			// The baseline was never stored or already left the history window.
+			// Decoding against any other state would apply wrong values.
+			return false;
+		}
+
+		PropertyDeserializer deserializer(stream);
 
-		int sizeOffset = (int)stream.GetSize();
-		int placeholderSize = 0;
-		stream.WriteInt(placeholderSize);
+		// A truncated transform would be applied half decoded; nothing is applied
+		// unless every property before the variables could be read.
+		Vec3 finalPos;
+		Quaternion finalRot;
+		uint32_t inputAck = 0;
+		if (!deserializer.ReadQuantized(NetworkProperty::Position, finalPos,
+				hasBase ? baseState.GetPosition() : Vec3(0, 0, 0), m_positionQuantization) ||
+			!deserializer.ReadCompressed(NetworkProperty::Orientation, finalRot,
+				hasBase ? baseState.GetOrientation() : Quaternion(), m_orientationBits) ||
+			!deserializer.Read(NetworkProperty::InputAck, inputAck, 0u)) {
+			return false;
+		}
 
 		auto entity = m_entity.lock();
 		if (entity && entity->m_node) {
-			Vec3 currentPos = entity->m_node->GetTranslation();
-			Quaternion currentRot = entity->m_node->GetOrientation();
-
-			NetworkState baseState;
-			bool hasBase = (baseTick != -1) && GetNetworkState(baseTick, baseState);
-
-			PropertySerializer serializer(stream);
-
-			bool posChanged =
-				!hasBase || glm::distance(currentPos, baseState.GetPosition()) > MIN_STATE_SYNC_POS_THRESHOLD;
-			bool rotChanged =
-				!hasBase ||
-				std::abs(1.0f -
-					std::abs(glm::dot(currentRot, baseState.GetOrientation()))) >
-				MIN_STATE_SYNC_ROT_THRESHOLD;
-
-			serializer.Write(NetworkProperty::Position, currentPos, posChanged);
-			serializer.Write(NetworkProperty::Orientation, currentRot, rotChanged);
-
-			bool anyVarDirty = false;
-			for (auto* var : m_networkVariables) {
-				if (var->IsDirty()) {
-					anyVarDirty = true;
-					break;
+			if (IsLocalPlayer()) {
+				Vec3 position;
+				Quaternion orientation;
+				const InputSimulateFn simulate = [this](const InputCommand& input, Vec3& p, Quaternion& q) {
+					SimulateInput(input, p, q);
+				};
+				if (m_prediction.Reconcile(inputAck, finalPos, finalRot, simulate, position, orientation) ==
+					ReconcileResult::Corrected) {
+					entity->m_node->SetTranslation(position);
+					entity->m_node->SetOrientation(orientation);
 				}
+			} else if (!IsServer() && NetworkManager::Instance->GetEnableInterpolationVal()) {
+				m_interpolationBuffer.Push(serverTick, finalPos, finalRot);
+			} else {
+				entity->m_node->SetTranslation(finalPos);
+				entity->m_node->SetOrientation(finalRot);
 			}
 
-			if (anyVarDirty || !hasBase) {
-				serializer.MarkAsChanged(NetworkProperty::NetworkVariables);
-				stream.WriteInt((int)m_networkVariables.size());
-				for (auto* var : m_networkVariables) {
-					var->Serialize(stream);
-					if (IsServer())
-						var->ResetDirty();
-				}
-			}
+			// The baseline is what the server sent, even where the owner predicts
+			// ahead of it; later deltas are encoded against it.
+			lastFullState.SetPosition(finalPos);
+			lastFullState.SetOrientation(finalRot);
+			lastFullState.SetNetworkStateID(serverTick);
+			stateHistory.Store(lastFullState.GetNetworkStateID(), lastFullState);
+		}
 
-			NetworkState state;
-			state.SetPosition(currentPos);
-			state.SetOrientation(currentRot);
-			state.SetNetworkStateID(NetworkManager::Instance->GetServerTick());
-			SetLatestNetworkState(state);
+		if (!deserializer.Has(NetworkProperty::NetworkVariables)) {
+			return true;
 		}
 
-		int currentSize = (int)stream.GetSize();
-		int dataSize = currentSize - sizeOffset - sizeof(int);
-		std::memcpy(stream.buffer.data() + sizeOffset, &dataSize, sizeof(int));
+		size_t varCount = 0;
+		if (!VariableMask::Read(stream, m_networkVariables.size(), varCount, m_variableMask)) {
+			return false;
+		}
+		for (size_t i = 0; i < varCount; i++) {
+			// Later variables cannot be located past a malformed one.
+			if (VariableMask::IsSet(m_variableMask, i) &&
+				!m_networkVariables[i]->Deserialize(stream)) {
+				return false;
+			}
+		}
+		return true;
 	}
 
-	void NetworkComponent::Deserialize(PacketStream& stream, int baseTick) {
-		NetworkState baseState;
-		bool hasBase = (baseTick != -1) && GetNetworkState(baseTick, baseState);
+	void NetworkComponent::PredictInput(const InputCommand& input) {
+		auto entity = m_entity.lock();
+		if (!entity || !entity->m_node || (!IsServer() && !IsLocalPlayer())) {
+			return;
+		}
 
-		PropertyDeserializer deserializer(stream);
+		Vec3 position = entity->m_node->GetTranslation();
+		Quaternion orientation = entity->m_node->GetOrientation();
+		InputCommand command = input;
+		SimulateInput(command, position, orientation);
+		entity->m_node->SetTranslation(position);
+		entity->m_node->SetOrientation(orientation);
 
-		Vec3 finalPos;
-		deserializer.Read(NetworkProperty::Position, finalPos,
-			hasBase ? baseState.GetPosition() : Vec3(0, 0, 0));
+		if (!IsServer()) {
+			m_prediction.Record(command, position, orientation);
+		}
+	}
 
-		Quaternion finalRot;
-		deserializer.Read(NetworkProperty::Orientation, finalRot,
-			hasBase ? baseState.GetOrientation() : Quaternion());
+	void NetworkComponent::SimulateInput(const InputCommand& input, Vec3& position,
+		Quaternion& orientation) {
+		position += input.move * input.deltaTime;
+		orientation = input.orientation;
+	}
+
+	size_t NetworkComponent::QueueInputs(const InputCommand* commands, size_t count) {
+		return m_inputQueue.Accept(commands, count);
+	}
 
+	void NetworkComponent::ProcessInputs(float elapsedSeconds) {
+		m_inputQueue.AddElapsedTime(elapsedSeconds);
 		auto entity = m_entity.lock();
-		if (entity && entity->m_node && !IsLocalPlayer()) {
-			entity->m_node->SetTranslation(finalPos);
-			entity->m_node->SetOrientation(finalRot);
+		if (m_inputQueue.IsEmpty() || !entity || !entity->m_node) {
+			return;
+		}
 
-			lastFullState.SetPosition(finalPos);
-			lastFullState.SetOrientation(finalRot);
-			lastFullState.SetNetworkStateID(NetworkManager::Instance->GetServerTick());
-			stateHistory.push_back(lastFullState);
-		}
-		else if (entity && entity->m_node && IsLocalPlayer()) {
-			Vec3 localPos = entity->m_node->GetTranslation();
-			Quaternion localRot = entity->m_node->GetOrientation();
-			lastFullState.SetPosition(localPos);
-			lastFullState.SetOrientation(localRot);
-			lastFullState.SetNetworkStateID(NetworkManager::Instance->GetServerTick());
-			stateHistory.push_back(lastFullState);
-		}
-
-		if (deserializer.Has(NetworkProperty::NetworkVariables)) {
-			int varCount = 0;
-			stream.ReadInt(varCount);
-			for (int i = 0; i < varCount && i < (int)m_networkVariables.size(); i++) {
-				m_networkVariables[i]->Deserialize(stream);
-			}
+		Vec3 position = entity->m_node->GetTranslation();
+		Quaternion orientation = entity->m_node->GetOrientation();
+		InputCommand input;
+		while (m_inputQueue.Pop(input)) {
+			SimulateInput(input, position, orientation);
 		}
+		entity->m_node->SetTranslation(position);
+		entity->m_node->SetOrientation(orientation);
 	}
 
 	void NetworkComponent::RegisterNetworkVariable(NetworkVariableBase* var) {
 		m_networkVariables.push_back(var);
+		m_variableChanges.Resize(m_networkVariables.size());
+	}
+
+	void NetworkComponent::CaptureVariableChanges(int tick) {
+		if (tick == m_variableCaptureTick) {
+			return;
+		}
+
+		m_variableCaptureTick = tick;
+		bool changed = m_variableOffsets.size() != m_networkVariables.size();
+		for (size_t i = 0; i < m_networkVariables.size(); i++) {
+			if (m_networkVariables[i]->IsDirty()) {
+				m_variableChanges.MarkChanged(i, tick);
+				m_networkVariables[i]->ResetDirty();
+				changed = true;
+			}
+		}
+
+		if (changed) {
+			m_variableBytes.Clear();
+			m_variableOffsets.resize(m_networkVariables.size());
+			for (size_t i = 0; i < m_networkVariables.size(); i++) {
+				m_variableOffsets[i] = static_cast<uint32_t>(m_variableBytes.GetSize());
+				m_networkVariables[i]->Serialize(m_variableBytes);
+			}
+		}
 	}
 
 	void NetworkComponent::RegisterRPC(const std::string& name, RPCFunction func) {
 		m_rpcHandlers[CalculateHash(name)] = func;
 	}
 
-	void NetworkComponent::HandleRPC(uint32_t hash, PacketStream& stream) {
-		if (m_rpcHandlers.count(hash)) {
-			m_rpcHandlers[hash](stream);
+	bool NetworkComponent::HandleRPC(uint32_t hash, PacketStream& stream) {
+		if (!m_rpcHandlers.empty()) {
+			auto handler = m_rpcHandlers.find(hash);
+			if (handler != m_rpcHandlers.end()) {
+				handler->second(stream);
+				return true;
+			}
+		}
+
+		NetworkRPCRegistry& registry = NetworkRPCRegistry::Instance();
+		if (m_rpcTable == nullptr || m_rpcTableGeneration != registry.GetGeneration()) {
+			m_rpcTable = &registry.GetTable(Class());
+			m_rpcTableGeneration = registry.GetGeneration();
+		}
+
+		const RPCDispatchTable::Entry* entry = m_rpcTable->Find(hash);
+		return entry != nullptr && entry->dispatch(this, stream);
+	}
+
+	void NetworkComponent::ApplyInterpolation(double renderTick, double maxExtrapolationTicks) {
+		auto entity = m_entity.lock();
+		if (!entity || !entity->m_node || IsLocalPlayer()) {
 			return;
 		}
 
-		auto dispatcher = NetworkRPCRegistry::Instance().GetDispatcher(Class(), hash);
-		if (dispatcher) {
-			dispatcher(this, stream);
+		Vec3 position;
+		Quaternion orientation;
+		if (m_interpolationBuffer.Sample(renderTick, maxExtrapolationTicks, position,
+			orientation) != InterpolationResult::Empty) {
+			entity->m_node->SetTranslation(position);
+			entity->m_node->SetOrientation(orientation);
 		}
 	}
 
 	void NetworkComponent::UpdateStateHistory(int minID) {
-		auto it = std::remove_if(stateHistory.begin(), stateHistory.end(),
-			[minID](const NetworkState& state) {
-				return state.GetNetworkStateID() < minID;
-			});
-		stateHistory.erase(it, stateHistory.end());
+		stateHistory.DiscardBefore(minID);
+	}
+
+	void NetworkComponent::SetStateHistoryDepth(int depth) {
+		if (depth > 0 && depth != GetStateHistoryDepth()) {
+			stateHistory.SetCapacity(static_cast<size_t>(depth));
+		}
+	}
+
+	int NetworkComponent::GetStateHistoryDepth() const {
+		return static_cast<int>(stateHistory.GetCapacity());
 	}
 
 	NetworkState& NetworkComponent::GetLatestNetworkState() {
@@ -180,38 +259,44 @@ namespace ToolKit::ToolKitNetworking {
 	void NetworkComponent::SetLatestNetworkState(
 		ToolKitNetworking::NetworkState& lastState) {
 		lastFullState = lastState;
-		stateHistory.push_back(lastFullState);
+		stateHistory.Store(lastFullState.GetNetworkStateID(), lastFullState);
 	}
 
 	ComponentPtr NetworkComponent::Copy(EntityPtr entityPtr) {
 		NetworkComponentPtr nc = MakeNewPtr<NetworkComponent>();
 		nc->m_localData = m_localData;
 		nc->m_entity = entityPtr;
+		nc->m_positionQuantization = m_positionQuantization;
+		nc->m_orientationBits = m_orientationBits;
+		nc->m_replicationPriority = m_replicationPriority;
+		nc->m_updateInterval = m_updateInterval;
+		nc->m_hitBoundsMin = m_hitBoundsMin;
+		nc->m_hitBoundsMax = m_hitBoundsMax;
 		return nc;
 	}
 
 	bool NetworkComponent::GetNetworkState(int stateID,
 		ToolKitNetworking::NetworkState& state) {
-		for (auto& entry : stateHistory) {
-			if (entry.GetNetworkStateID() == stateID) {
-				state = entry;
-				return true;
-			}
-		}
-		return false;
+		return stateHistory.Lookup(stateID, state) == TickHistoryLookup::Found;
 	}
 
 	uint32_t NetworkComponent::CalculateHash(const std::string& name) {
-		uint32_t hash = 5381;
-		for (char c : name)
-			hash = ((hash << 5) + hash) + c;
-		return hash;
+		return RPCNameHash(name);
+	}
+
+	void NetworkComponent::LogOversizedRPC(uint32_t functionHash,
+		size_t packetSize) const {
+		TK_LOG(("RPC not sent: hash=" + std::to_string(functionHash) + " netID=" +
+			std::to_string(networkID) + " needs " + std::to_string(packetSize) +
+			" bytes, over the " + std::to_string(MaxRPCPacketBytes) + " byte limit.")
+			.c_str());
 	}
 
 	void NetworkComponent::SendRPCPacketInternal(PacketStream& stream,
-		RPCReceiver target) {
+		RPCReceiver target, const RPCSendPolicy& policy) {
 		if (NetworkManager::Instance) {
-			NetworkManager::Instance->SendRPCPacket(stream, target, m_ownerPeerID);
+			NetworkManager::Instance->SendRPCPacket(stream, target, m_ownerPeerID,
+				policy);
 		}
 	}
 } // namespace ToolKit::ToolKitNetworking
@@ -1,7 +1,14 @@
 #pragma once
+#include "ClientPrediction.h"
 #include "NetworkMacros.h"
 #include "NetworkPackets.h"
 #include "NetworkVariable.h"
+#include "NetworkVariableDelta.h"
+#include "RPCPacket.h"
+#include "RPCThrottle.h"
+#include "ReplicationFrame.h"
+#include "SnapshotInterpolation.h"
+#include "TickHistoryRing.h"
 #include <Component.h>
 #include <functional>
 #include <map>
@@ -18,21 +25,6 @@ namespace ToolKit {
 		typedef std::shared_ptr<class NetworkComponent> NetworkComponentPtr;
 		typedef std::vector<NetworkComponentPtr> NetworkComponentPtrArray;
 
-		enum class RPCReceiver { Server, Owner, Others, All };
-
-		struct RPCPacket : public GamePacket {
-			int networkID;
-			uint32_t functionHash;
-			// Data follows in the stream
-
-			RPCPacket() {
-				type = NetworkMessage::RPC;
-				size = sizeof(RPCPacket) - sizeof(GamePacket);
-				networkID = -1;
-				functionHash = 0;
-			}
-		};
-
 		typedef std::function<void(PacketStream&)> RPCFunction;
 
 		static VariantCategory NetworkComponentCategory{ "Network Component", 90 };
@@ -60,8 +52,63 @@ namespace ToolKit {
 			bool IsLocalPlayer() const;
 
 			// SerializationT
-			virtual void Serialize(PacketStream& stream, int baseTick);
-			virtual void Deserialize(PacketStream& stream, int baseTick);
+			// Server: appends this component's replicated state to `frame` at the end
+			// of the tick. The transform is captured by ReplicationManager; snapshot
+			// records are written from the frame alone (see WriteEntityRecord()).
+			void CaptureReplication(ReplicationFrame& frame, bool hasTransform);
+			// `stream` views the received packet; it is only valid during the call.
+			// `serverTick` is the tick the record was encoded on; the decoded state is
+			// stored as that tick's baseline.
+			// Returns false when the record cannot be fully applied: a delta against a
+			// tick no longer in the state history or a truncated transform leave the
+			// component untouched; a malformed variable stops at that variable.
+			virtual bool Deserialize(PacketReader& stream, int serverTick, int baseTick);
+
+			// Optional bit-packed transform encodings. Off by default; every peer
+			// must use the same settings for a given component type.
+			void SetPositionQuantization(const QuantizationRange& range) { m_positionQuantization = range; }
+			const QuantizationRange& GetPositionQuantization() const { return m_positionQuantization; }
+			void SetOrientationBits(int bitsPerComponent) { m_orientationBits = bitsPerComponent; }
+			int GetOrientationBits() const { return m_orientationBits; }
+
+			// Snapshot scheduling. Priority accumulates every tick the component is
+			// due and unsent; the interval is the minimum number of ticks between
+			// two updates to the same peer.
+			void SetReplicationPriority(float priority) { m_replicationPriority = priority; }
+			float GetReplicationPriority() const { return m_replicationPriority; }
+			void SetUpdateInterval(int ticks) { m_updateInterval = ticks; }
+			int GetUpdateInterval() const { return m_updateInterval; }
+
+			// Local-space box used by server-side lag compensation. Components without
+			// one are not recorded in the rewind history.
+			void SetHitBounds(const Vec3& localMin, const Vec3& localMax) { m_hitBoundsMin = localMin; m_hitBoundsMax = localMax; }
+			const Vec3& GetHitBoundsMin() const { return m_hitBoundsMin; }
+			const Vec3& GetHitBoundsMax() const { return m_hitBoundsMax; }
+			bool HasHitBounds() const {
+				return m_hitBoundsMax.x > m_hitBoundsMin.x && m_hitBoundsMax.y > m_hitBoundsMin.y &&
+					m_hitBoundsMax.z > m_hitBoundsMin.z;
+			}
+
+			// Owner input. On the owning client the input is simulated at once,
+			// applied to the node and kept until a snapshot acks it; the server
+			// replays the same input and corrects the owner if they disagree. On
+			// the server (host or server-driven) it is applied directly.
+			void PredictInput(const InputCommand& input);
+
+			// Advances a transform by one input, on the owner and on the server.
+			// Override for game movement; it must depend only on its arguments.
+			virtual void SimulateInput(const InputCommand& input, Vec3& position, Quaternion& orientation);
+
+			// Server: inputs received from the owner, simulated by ProcessInputs().
+			// Each tick simulates at most `elapsedSeconds` of input, plus what the
+			// queue's time credit carries over; the rest waits for later ticks.
+			size_t QueueInputs(const InputCommand* commands, size_t count);
+			void ProcessInputs(float elapsedSeconds);
+
+			PredictionBuffer& GetPredictionBuffer() { return m_prediction; }
+			// Server-side input limits (delta time, move length, time credit).
+			InputCommandQueue& GetInputQueue() { return m_inputQueue; }
+			const InputCommandQueue& GetInputQueue() const { return m_inputQueue; }
 
 			// Network Variables
 			void RegisterNetworkVariable(NetworkVariableBase* var);
@@ -71,9 +118,19 @@ namespace ToolKit {
 
 			template <typename... Args>
 			void SendRPC(const std::string& name, RPCReceiver target, Args... args);
+			// `functionHash` is RPCNameHash() of the RPC name; the TK_RPC_*_IMPL
+			// macros pass it as a compile-time constant.
+			template <typename... Args>
+			void SendRPC(uint32_t functionHash, RPCReceiver target, Args... args);
+			// Sends with a delivery channel, rate limit and coalescing; see
+			// RPCSendPolicy. SendRPC() is reliable and unthrottled.
+			template <typename... Args>
+			void SendRPCWithPolicy(uint32_t functionHash, RPCReceiver target,
+				const RPCSendPolicy& policy, Args... args);
 
-			// Internal RPC handling
-			void HandleRPC(uint32_t hash, PacketStream& stream);
+			// Internal RPC handling. False when no handler takes the hash or its
+			// arguments are malformed.
+			bool HandleRPC(uint32_t hash, PacketStream& stream);
 
 			// ToolKit Overrides
 			void ParameterConstructor() override;
@@ -83,6 +140,15 @@ namespace ToolKit {
 			EntityPtr GetEntity() const { return m_entity.lock(); }
 			void UpdateStateHistory(int minID);
 
+			// Number of ticks kept for delta baselines. Resizing drops history.
+			void SetStateHistoryDepth(int depth);
+			int GetStateHistoryDepth() const;
+
+			// Remote transforms received while interpolation is on are buffered
+			// and only reach the node here, sampled at `renderTick`.
+			void ApplyInterpolation(double renderTick, double maxExtrapolationTicks);
+			const InterpolationBuffer& GetInterpolationBuffer() const { return m_interpolationBuffer; }
+
 			NetworkState& GetLatestNetworkState();
 			void SetLatestNetworkState(ToolKitNetworking::NetworkState& lastState);
 
@@ -94,20 +160,46 @@ namespace ToolKit {
 
 		protected:
 			bool GetNetworkState(int stateID, ToolKitNetworking::NetworkState& state);
+			// Moves dirty flags into the per-variable change ticks once per tick, so
+			// every peer encoded on that tick sees the same changes. Later changes
+			// are stamped with the next tick. Re-encodes m_variableBytes when a
+			// variable changed.
+			void CaptureVariableChanges(int tick);
 			uint32_t CalculateHash(const std::string& name);
-			void SendRPCPacketInternal(PacketStream& stream, RPCReceiver target);
+			void SendRPCPacketInternal(PacketStream& stream, RPCReceiver target,
+				const RPCSendPolicy& policy);
+			void LogOversizedRPC(uint32_t functionHash, size_t packetSize) const;
 
 		protected:
 			std::string m_spawnClassName;
 			int networkID = -1;
 			int m_ownerPeerID = -1; // -1 for Server/No owner
 			bool m_isDynamicallySpawned = false;
+			QuantizationRange m_positionQuantization;
+			int m_orientationBits = 0;
+			float m_replicationPriority = 1.0f;
+			int m_updateInterval = 1;
+			Vec3 m_hitBoundsMin = Vec3(0.0f);
+			Vec3 m_hitBoundsMax = Vec3(0.0f);
 
 			std::vector<NetworkVariableBase*> m_networkVariables;
+			VariableChangeTracker m_variableChanges;
+			std::vector<uint8_t> m_variableMask;
+			int m_variableCaptureTick = -1;
+			// Encoded values of all network variables, copied into each frame.
+			PacketStream m_variableBytes;
+			std::vector<uint32_t> m_variableOffsets;
 			std::map<uint32_t, RPCFunction> m_rpcHandlers;
+			// Registry table of this component's class, refreshed when the
+			// registry generation changes.
+			const RPCDispatchTable* m_rpcTable = nullptr;
+			uint32_t m_rpcTableGeneration = 0;
 
 			ToolKitNetworking::NetworkState lastFullState;
-			std::vector<ToolKitNetworking::NetworkState> stateHistory;
+			TickHistoryRing<ToolKitNetworking::NetworkState> stateHistory;
+			InterpolationBuffer m_interpolationBuffer;
+			PredictionBuffer m_prediction;
+			InputCommandQueue m_inputQueue;
 		};
 	} // namespace ToolKitNetworking
 } // namespace ToolKit
@@ -116,19 +208,29 @@ namespace ToolKit::ToolKitNetworking {
 	template <typename... Args>
 	void NetworkComponent::SendRPC(const std::string& name, RPCReceiver target,
 		Args... args) {
-		PacketStream rpcStream;
-		RPCPacket header;
-		header.networkID = this->networkID;
-		header.functionHash = CalculateHash(name);
-
-		rpcStream.Write(header);
-
-		// Pack arguments
-		([&](const auto& arg) { rpcStream.Write(arg); }(args), ...);
+		SendRPC(CalculateHash(name), target, args...);
+	}
 
-		RPCPacket* packedHeader = (RPCPacket*)rpcStream.GetData();
-		packedHeader->size = (short)(rpcStream.GetSize() - sizeof(GamePacket));
+	template <typename... Args>
+	void NetworkComponent::SendRPC(uint32_t functionHash, RPCReceiver target,
+		Args... args) {
+		SendRPCWithPolicy(functionHash, target, RPCSendPolicy::Reliable(), args...);
+	}
 
-		SendRPCPacketInternal(rpcStream, target);
+	template <typename... Args>
+	void NetworkComponent::SendRPCWithPolicy(uint32_t functionHash,
+		RPCReceiver target, const RPCSendPolicy& policy, Args... args) {
+		const size_t packetSize = RPCPacketSize(args...);
+		if (packetSize > MaxRPCPacketBytes) {
+			LogOversizedRPC(functionHash, packetSize);
+			return;
+		}
+
+		PacketStream rpcStream(packetSize);
+		if (!PackRPC(rpcStream, this->networkID, functionHash, args...)) {
+			LogOversizedRPC(functionHash, packetSize);
+			return;
+		}
+		SendRPCPacketInternal(rpcStream, target, policy);
 	}
 } // namespace ToolKit::ToolKitNetworking
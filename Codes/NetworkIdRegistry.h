@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Identifies one registration of a network ID. The generation changes every
+// time the ID is re-registered, so a handle captured before a despawn never
+// resolves to the object that later reuses the same ID.
+struct NetworkIdHandle {
+  int networkID = -1;
+  uint32_t generation = 0;
+
+  bool IsValid() const { return networkID >= 0 && generation != 0; }
+};
+
+// Network ID -> object registry with O(1) insert, lookup and removal.
+//
+// IDs are mapped through an open-addressed table (linear probing, backward
+// shift deletion) into a dense item array. The dense array is what callers
+// iterate; removal swaps the last item into the freed position, so iteration
+// order is not registration order. IDs come off the wire, so the table is keyed
+// by value instead of being indexed by it: a hostile ID cannot force a large
+// allocation.
+template <typename T> class NetworkIdRegistry {
+public:
+  // Returns false when the ID is negative, the item is null or the ID is
+  // already registered.
+  bool Insert(int networkID, T *item) {
+    if (networkID < 0 || item == nullptr) {
+      return false;
+    }
+
+    if ((m_items.size() + 1) * 2 > m_buckets.size()) {
+      Rehash(m_buckets.empty() ? MinBucketCount : m_buckets.size() * 2);
+    }
+
+    size_t bucket = FindBucket(networkID);
+    if (m_buckets[bucket].networkID == networkID) {
+      return false;
+    }
+
+    m_buckets[bucket].networkID = networkID;
+    m_buckets[bucket].denseIndex = static_cast<uint32_t>(m_items.size());
+    m_items.push_back(item);
+    m_itemIDs.push_back(networkID);
+    m_itemGenerations.push_back(m_nextGeneration++);
+    if (m_nextGeneration == 0) {
+      m_nextGeneration = 1;
+    }
+    return true;
+  }
+
+  // Removes the ID only while it still maps to `item`.
+  bool Remove(int networkID, const T *item) {
+    if (networkID < 0 || m_items.empty()) {
+      return false;
+    }
+
+    size_t bucket = FindBucket(networkID);
+    if (m_buckets[bucket].networkID != networkID) {
+      return false;
+    }
+
+    uint32_t denseIndex = m_buckets[bucket].denseIndex;
+    if (m_items[denseIndex] != item) {
+      return false;
+    }
+
+    EraseBucket(bucket);
+
+    uint32_t lastIndex = static_cast<uint32_t>(m_items.size() - 1);
+    if (denseIndex != lastIndex) {
+      m_items[denseIndex] = m_items[lastIndex];
+      m_itemIDs[denseIndex] = m_itemIDs[lastIndex];
+      m_itemGenerations[denseIndex] = m_itemGenerations[lastIndex];
+      m_buckets[FindBucket(m_itemIDs[denseIndex])].denseIndex = denseIndex;
+    }
+
+    m_items.pop_back();
+    m_itemIDs.pop_back();
+    m_itemGenerations.pop_back();
+    return true;
+  }
+
+  T *Find(int networkID) const {
+    const int denseIndex = FindDenseIndex(networkID);
+    return denseIndex < 0 ? nullptr : m_items[denseIndex];
+  }
+
+  NetworkIdHandle GetHandle(int networkID) const {
+    NetworkIdHandle handle;
+    const int denseIndex = FindDenseIndex(networkID);
+    if (denseIndex >= 0) {
+      handle.networkID = networkID;
+      handle.generation = m_itemGenerations[denseIndex];
+    }
+    return handle;
+  }
+
+  // Returns null if the ID was removed or re-registered since the handle was
+  // taken.
+  T *Resolve(const NetworkIdHandle &handle) const {
+    const int denseIndex = FindDenseIndex(handle.networkID);
+    if (denseIndex < 0 || m_itemGenerations[denseIndex] != handle.generation) {
+      return nullptr;
+    }
+    return m_items[denseIndex];
+  }
+
+  void Reserve(size_t count) {
+    size_t bucketCount = MinBucketCount;
+    while (bucketCount < count * 2) {
+      bucketCount *= 2;
+    }
+
+    if (bucketCount > m_buckets.size()) {
+      Rehash(bucketCount);
+    }
+    m_items.reserve(count);
+    m_itemIDs.reserve(count);
+    m_itemGenerations.reserve(count);
+  }
+
+  void Clear() {
+    m_buckets.clear();
+    m_items.clear();
+    m_itemIDs.clear();
+    m_itemGenerations.clear();
+  }
+
+  const std::vector<T *> &Items() const { return m_items; }
+  size_t Size() const { return m_items.size(); }
+  bool Empty() const { return m_items.empty(); }
+
+private:
+  static constexpr int EmptyBucket = -1;
+  static constexpr size_t MinBucketCount = 16;
+
+  struct Bucket {
+    int networkID = EmptyBucket;
+    uint32_t denseIndex = 0;
+  };
+
+  size_t HomeBucket(int networkID) const {
+    // Fibonacci hashing spreads sequential IDs across the table.
+    const uint64_t hash =
+        static_cast<uint64_t>(static_cast<uint32_t>(networkID)) *
+        0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash >> 32) & (m_buckets.size() - 1);
+  }
+
+  // Returns the bucket holding `networkID`, or the empty bucket that ends its
+  // probe sequence.
+  size_t FindBucket(int networkID) const {
+    const size_t mask = m_buckets.size() - 1;
+    size_t bucket = HomeBucket(networkID);
+    while (m_buckets[bucket].networkID != EmptyBucket &&
+           m_buckets[bucket].networkID != networkID) {
+      bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+  }
+
+  int FindDenseIndex(int networkID) const {
+    if (networkID < 0 || m_items.empty()) {
+      return -1;
+    }
+
+    const Bucket &bucket = m_buckets[FindBucket(networkID)];
+    return bucket.networkID == networkID ? static_cast<int>(bucket.denseIndex)
+                                         : -1;
+  }
+
+  void EraseBucket(size_t bucket) {
+    const size_t mask = m_buckets.size() - 1;
+    size_t hole = bucket;
+    size_t next = (hole + 1) & mask;
+    while (m_buckets[next].networkID != EmptyBucket) {
+      const size_t home = HomeBucket(m_buckets[next].networkID);
+      // Shift the entry back unless its home lies cyclically in (hole, next].
+      const bool homeBetween = hole <= next ? (home > hole && home <= next)
+                                            : (home > hole || home <= next);
+      if (!homeBetween) {
+        m_buckets[hole] = m_buckets[next];
+        hole = next;
+      }
+      next = (next + 1) & mask;
+    }
+    m_buckets[hole] = Bucket();
+  }
+
+  void Rehash(size_t bucketCount) {
+    m_buckets.assign(bucketCount, Bucket());
+    for (size_t i = 0; i < m_itemIDs.size(); ++i) {
+      size_t bucket = FindBucket(m_itemIDs[i]);
+      m_buckets[bucket].networkID = m_itemIDs[i];
+      m_buckets[bucket].denseIndex = static_cast<uint32_t>(i);
+    }
+  }
+
+private:
+  std::vector<Bucket> m_buckets;
+  std::vector<T *> m_items;
+  std::vector<int> m_itemIDs;
+  std::vector<uint32_t> m_itemGenerations;
+  uint32_t m_nextGeneration = 1;
+};
+} // namespace ToolKit::ToolKitNetworking
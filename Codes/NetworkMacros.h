@@ -1,5 +1,6 @@
 #pragma once
 #include <tuple>
+#include "NetSerializer.h"
 #include "NetworkRPCRegistry.h"
 
 #ifdef TK_NET_STATIC
@@ -18,37 +19,35 @@
 
 namespace ToolKit::ToolKitNetworking
 {
-	template<typename... Args>
-	struct RPCArgUnpacker
+	template<typename T, typename... Args, void (T::*Func)(Args...)>
+	struct RPCThunk<Func>
 	{
-		static std::tuple<Args...> Unpack(PacketStream& stream)
+		// Every argument is decoded before the call, and the payload must end
+		// with the last one.
+		static bool Dispatch(NetworkComponent* comp, PacketStream& stream)
 		{
-			std::tuple<Args...> args;
-			std::apply([&stream](auto&... arg) {
-				(stream.Read(arg), ...);
+			std::tuple<std::decay_t<Args>...> args;
+			const bool decoded = std::apply([&stream](auto&... arg) {
+				return NetReadAll(stream, arg...);
 			}, args);
-			return args;
+			if (!decoded || stream.CanReadSize(1))
+			{
+				return false;
+			}
+
+			std::apply([comp](auto&... unpackedArgs) {
+				(static_cast<T*>(comp)->*Func)(unpackedArgs...);
+			}, args);
+			return true;
 		}
 	};
 
-	template<typename T, typename... Args>
-	void RPCDispatcherHelper(NetworkComponent* comp, void (T::*func)(Args...), PacketStream& stream)
-	{
-		auto args = RPCArgUnpacker<std::decay_t<Args>...>::Unpack(stream);
-		std::apply([comp, func](auto&&... unpackedArgs) {
-			(static_cast<T*>(comp)->*func)(unpackedArgs...);
-		}, args);
-	}
-
-	// Helper to register RPCs
-	template<typename T, typename... Args>
+	// Registers a dispatcher during static initialization.
 	struct RPCRegisterer
 	{
-		RPCRegisterer(ToolKit::ClassMeta* cls, const std::string& name, void (T::*func)(Args...))
+		RPCRegisterer(ToolKit::ClassMeta* cls, std::string_view name, uint32_t hash, RPCDispatcherFn dispatcher)
 		{
-			NetworkRPCRegistry::Instance().Register(cls, name, [func](NetworkComponent* comp, PacketStream& stream) {
-				RPCDispatcherHelper(comp, func, stream);
-			});
+			NetworkRPCRegistry::Instance().Register(cls, name, hash, dispatcher);
 		}
 	};
 }
@@ -67,78 +66,76 @@ namespace ToolKit::ToolKitNetworking
 	void Name##_Implementation(__VA_ARGS__)
 
 // Macros for Implementation
-#define TK_RPC_SERVER_IMPL(Class, Name, Signature, Args) \
-	void Class::Name Signature { \
-		if (IsServer()) { Name##_Implementation Args; } \
-		else { SendRPC(#Name, RPCReceiver::Server, Args); } \
-	} \
-	static ToolKit::ToolKitNetworking::RPCRegisterer<Class, void Class::*Signature> _rpc_reg_##Class##_##Name(Class::StaticClass(), #Name, &Class::Name##_Implementation); \
-	void Class::Name##_Implementation Signature
-
-// Note: The above macro for Registry deduction is tricky. 
-// Signature is like (float force). Args is like (force).
-// We need to pass the function pointer.
-// Corrected Registration line:
-#define TK_RPC_SERVER_IMPL_FIXED(Class, Name, Signature, Params) \
-	void Class::Name Signature { \
-		if (IsServer()) { Name##_Implementation Params; } \
-		else { SendRPC(#Name, RPCReceiver::Server, Params); } \
-	} \
-	void Class::Name##_Implementation Signature
-
-// Actually I can simplify. The user can just call a registration macro in the constructor if they want, 
-// OR we use the static helper. The static helper needs to know the type of the function.
-
-// Let's use a more robust version that doesn't require the user to repeat too much.
 // Header:
 // TK_RPC_SERVER(RequestJump, float force);
 // Implementation:
 // TK_RPC_SERVER_IMPL(Player, RequestJump, (float force), (force)) { ... }
-
-#undef TK_RPC_SERVER_IMPL
-#define TK_RPC_SERVER_IMPL(Class, Name, Signature, Params) \
+// RPC names are hashed at compile time; dispatch goes through the flat
+// per-class table in NetworkRPCRegistry. The lambdas spread Params into
+// SendRPC's argument list.
+#define TK_RPC_REGISTER(Class, Name) \
+	static ToolKit::ToolKitNetworking::RPCRegisterer _rpc_reg_##Class##_##Name( \
+		Class::StaticClass(), #Name, ToolKit::ToolKitNetworking::RPCNameHash(#Name), \
+		&ToolKit::ToolKitNetworking::RPCThunk<&Class::Name##_Implementation>::Dispatch)
+
+// The _POLICY variants take an RPCSendPolicy for the remote call, e.g.
+// TK_RPC_MULTICAST_IMPL_POLICY(Player, SyncAim,
+//   RPCSendPolicy::Unreliable(20.0f, true), (Vec3 aim), (aim)) { ... }
+// sends at most 20 times a second, unreliably, with only the latest aim of
+// each update.
+#define TK_RPC_SERVER_IMPL_POLICY(Class, Name, Policy, Signature, Params) \
 	void Class::Name Signature { \
+		constexpr uint32_t rpcHash = ToolKit::ToolKitNetworking::RPCNameHash(#Name); \
 		if (IsServer()) { Name##_Implementation Params; } \
-		else { SendRPC(#Name, RPCReceiver::Server, Params); } \
+		else { [this, rpcHash](auto... rpcArgs) { SendRPCWithPolicy(rpcHash, RPCReceiver::Server, Policy, rpcArgs...); } Params; } \
 	} \
-	inline static ToolKit::ToolKitNetworking::RPCRegisterer<Class> _rpc_reg_##Class##_##Name##_instance = \
-		ToolKit::ToolKitNetworking::RPCRegisterer<Class>(Class::StaticClass(), #Name, &Class::Name##_Implementation); \
+	TK_RPC_REGISTER(Class, Name); \
 	void Class::Name##_Implementation Signature
 
-// Error in above: RPCRegisterer needs to deduce types.
-// I'll use a factory function.
-namespace ToolKit::ToolKitNetworking {
-	template<typename T, typename... Args>
-	RPCRegisterer<T, Args...> MakeRPCRegisterer(ToolKit::ClassMeta* cls, const std::string& name, void (T::*func)(Args...)) {
-		return RPCRegisterer<T, Args...>(cls, name, func);
-	}
-}
-
-#undef TK_RPC_SERVER_IMPL
-#define TK_RPC_SERVER_IMPL(Class, Name, Signature, Params) \
-	void Class::Name Signature { \
-		if (IsServer()) { Name##_Implementation Params; } \
-		else { SendRPC(#Name, RPCReceiver::Server, Params); } \
-	} \
-	static auto _rpc_reg_##Class##_##Name = ToolKit::ToolKitNetworking::MakeRPCRegisterer(Class::StaticClass(), #Name, &Class::Name##_Implementation); \
-	void Class::Name##_Implementation Signature
-
-#define TK_RPC_CLIENT_IMPL(Class, Name, Signature, Params) \
+#define TK_RPC_CLIENT_IMPL_POLICY(Class, Name, Policy, Signature, Params) \
 	void Class::Name Signature { \
-		if (IsServer()) { SendRPC(#Name, RPCReceiver::Owner, Params); } \
+		constexpr uint32_t rpcHash = ToolKit::ToolKitNetworking::RPCNameHash(#Name); \
+		if (IsServer()) { [this, rpcHash](auto... rpcArgs) { SendRPCWithPolicy(rpcHash, RPCReceiver::Owner, Policy, rpcArgs...); } Params; } \
 		else { Name##_Implementation Params; } \
 	} \
-	static auto _rpc_reg_##Class##_##Name = ToolKit::ToolKitNetworking::MakeRPCRegisterer(Class::StaticClass(), #Name, &Class::Name##_Implementation); \
+	TK_RPC_REGISTER(Class, Name); \
 	void Class::Name##_Implementation Signature
 
-#define TK_RPC_MULTICAST_IMPL(Class, Name, Signature, Params) \
+#define TK_RPC_MULTICAST_IMPL_POLICY(Class, Name, Policy, Signature, Params) \
 	void Class::Name Signature { \
+		constexpr uint32_t rpcHash = ToolKit::ToolKitNetworking::RPCNameHash(#Name); \
 		if (IsServer()) { \
 			Name##_Implementation Params; \
-			SendRPC(#Name, RPCReceiver::Others, Params); \
+			[this, rpcHash](auto... rpcArgs) { SendRPCWithPolicy(rpcHash, RPCReceiver::Others, Policy, rpcArgs...); } Params; \
 		} else { \
-			SendRPC(#Name, RPCReceiver::Server, Params); \
+			[this, rpcHash](auto... rpcArgs) { SendRPCWithPolicy(rpcHash, RPCReceiver::Server, Policy, rpcArgs...); } Params; \
 		} \
 	} \
-	static auto _rpc_reg_##Class##_##Name = ToolKit::ToolKitNetworking::MakeRPCRegisterer(Class::StaticClass(), #Name, &Class::Name##_Implementation); \
+	TK_RPC_REGISTER(Class, Name); \
 	void Class::Name##_Implementation Signature
+
+#define TK_RPC_SERVER_IMPL(Class, Name, Signature, Params) \
+	TK_RPC_SERVER_IMPL_POLICY(Class, Name, \
+		ToolKit::ToolKitNetworking::RPCSendPolicy::Reliable(), Signature, Params)
+
+#define TK_RPC_CLIENT_IMPL(Class, Name, Signature, Params) \
+	TK_RPC_CLIENT_IMPL_POLICY(Class, Name, \
+		ToolKit::ToolKitNetworking::RPCSendPolicy::Reliable(), Signature, Params)
+
+#define TK_RPC_MULTICAST_IMPL(Class, Name, Signature, Params) \
+	TK_RPC_MULTICAST_IMPL_POLICY(Class, Name, \
+		ToolKit::ToolKitNetworking::RPCSendPolicy::Reliable(), Signature, Params)
+
+// Unreliable, unthrottled variants for cosmetic events where a lost call does
+// not matter.
+#define TK_RPC_SERVER_UNRELIABLE_IMPL(Class, Name, Signature, Params) \
+	TK_RPC_SERVER_IMPL_POLICY(Class, Name, \
+		ToolKit::ToolKitNetworking::RPCSendPolicy::Unreliable(), Signature, Params)
+
+#define TK_RPC_CLIENT_UNRELIABLE_IMPL(Class, Name, Signature, Params) \
+	TK_RPC_CLIENT_IMPL_POLICY(Class, Name, \
+		ToolKit::ToolKitNetworking::RPCSendPolicy::Unreliable(), Signature, Params)
+
+#define TK_RPC_MULTICAST_UNRELIABLE_IMPL(Class, Name, Signature, Params) \
+	TK_RPC_MULTICAST_IMPL_POLICY(Class, Name, \
+		ToolKit::ToolKitNetworking::RPCSendPolicy::Unreliable(), Signature, Params)
@@ -66,6 +66,26 @@ ToolKit::ToolKitNetworking::NetworkManager::NetworkManager() {
   m_server = nullptr;
   m_client = nullptr;
   m_useDeltaCompression = true;
+  m_stateHistoryDepth = 64;
+  // Entity record bytes per peer per snapshot; 0 sends everything.
+  m_snapshotByteBudget = 0;
+  // Worker threads encoding snapshots beside the game thread; 0 encodes on
+  // the game thread only.
+  m_snapshotEncodeThreads = 0;
+  // Encodes a tick's snapshots on a background thread while the next tick
+  // simulates; they are sent one update later.
+  m_asyncSnapshotEncoding = false;
+  // Simulation ticks per second, independent of the frame rate; 0 runs one
+  // tick per Update().
+  m_serverTickRate = 60.0f;
+  // Snapshots per second; 0 sends one after every tick.
+  m_snapshotSendRate = 20.0f;
+  // Ticks one Update() may run to catch up; time beyond them is dropped.
+  m_maxCatchUpTicks = 5;
+  // World units around a peer's player; 0 replicates everything to everyone.
+  m_relevancyRadius = 0.0f;
+  // Services ENet on a dedicated I/O thread instead of inside Update().
+  m_threadedTransport = false;
   m_sessionDirectoryBrokerTimeoutMs = 5000;
   m_allowInsecureSessionDirectoryBrokerForLocalDev = false;
   m_connectHost = "127.0.0.1";
@@ -202,7 +222,7 @@ bool ToolKit::ToolKitNetworking::NetworkManager::StartAsClient(
     m_client = nullptr;
   }
 
-  m_client = MakeNewPtr<GameClient>();
+  m_client = MakeNewPtr<GameClient>(GetThreadedTransportVal());
   if (ITransportPeer *client = m_client.get()) {
     bool isConnected = client->Connect(host, portNum);
     if (isConnected) {
@@ -243,7 +263,8 @@ bool ToolKit::ToolKitNetworking::NetworkManager::StartAsServer(uint16_t port) {
   const uint maxClients = hostRequest.maxClients == 0 ? m_maxClients : hostRequest.maxClients;
 
   m_server = MakeNewPtr<GameServer>(bindAddress, port,
-                                    static_cast<int>((std::max)(1u, maxClients)));
+                                    static_cast<int>((std::max)(1u, maxClients)),
+                                    GetThreadedTransportVal());
   if (!m_server || !m_server->IsInitialised()) {
     TK_LOG("Failed to start server transport.");
     m_server = nullptr;
@@ -269,7 +290,7 @@ bool ToolKit::ToolKitNetworking::NetworkManager::StartAsServer(uint16_t port) {
   m_server->RegisterPacketHandler(
       ToolKitNetworking::NetworkMessage::SnapshotAck, this);
   m_server->RegisterPacketHandler(ToolKitNetworking::NetworkMessage::RPC, this);
-  m_server->RegisterPacketHandler(NetworkMessage::ClientUpdate, this);
+  m_server->RegisterPacketHandler(NetworkMessage::InputCommands, this);
 
   const std::string serverLogStr =
       "Started as server on port " + std::to_string(port);
@@ -309,10 +330,10 @@ void ToolKit::ToolKitNetworking::NetworkManager::DespawnNetworkObject(
   }
 }
 
-void ToolKit::ToolKitNetworking::NetworkManager::SendClientUpdate(
+void ToolKit::ToolKitNetworking::NetworkManager::SendInputCommands(
     NetworkComponent *component) {
   if (m_replicationManager) {
-    m_replicationManager->SendClientUpdate(component);
+    m_replicationManager->SendInputCommands(component);
   }
 }
 
@@ -361,6 +382,16 @@ int ToolKit::ToolKitNetworking::NetworkManager::GetLocalPeerID() const {
   return -1;
 }
 
+ToolKit::ToolKitNetworking::NetworkSettings
+ToolKit::ToolKitNetworking::NetworkManager::GetNetworkSettings() const {
+  NetworkSettings settings;
+  settings.enableInterpolation = GetEnableInterpolationVal();
+  settings.enableExtrapolation = GetEnableExtrapolationVal();
+  settings.enableLagCompensation = GetEnableLagCompensationVal();
+  settings.bufferTime = (std::max)(0.0f, GetBufferTimeVal());
+  return settings;
+}
+
 bool ToolKit::ToolKitNetworking::NetworkManager::IsDedicatedServer() const {
   return GetRoleVal().GetEnum<NetworkRole>() == NetworkRole::DedicatedServer;
 }
@@ -403,6 +434,25 @@ ToolKit::ToolKitNetworking::NetworkManager::GetNetworkComponents() const {
   return m_replicationManager->GetNetworkComponents();
 }
 
+const ToolKit::ToolKitNetworking::LagCompensationFrame *
+ToolKit::ToolKitNetworking::NetworkManager::RewindForPeer(
+    TransportPeerId peerID) {
+  return m_replicationManager ? m_replicationManager->RewindForPeer(peerID)
+                              : nullptr;
+}
+
+bool ToolKit::ToolKitNetworking::NetworkManager::BeginLagCompensation(
+    TransportPeerId peerID) {
+  return m_replicationManager &&
+         m_replicationManager->BeginLagCompensation(peerID);
+}
+
+void ToolKit::ToolKitNetworking::NetworkManager::EndLagCompensation() {
+  if (m_replicationManager) {
+    m_replicationManager->EndLagCompensation();
+  }
+}
+
 ToolKit::ToolKitNetworking::HostingMode
 ToolKit::ToolKitNetworking::NetworkManager::GetConfiguredHostingMode() const {
   return SessionCore::LegacyRoleToHostingMode(
@@ -587,9 +637,10 @@ ToolKit::ToolKitNetworking::NetworkManager::GetLastJoinRequest() const {
 }
 
 void ToolKit::ToolKitNetworking::NetworkManager::SendRPCPacket(
-    PacketStream &rpcStream, RPCReceiver target, int ownerID) {
+    PacketStream &rpcStream, RPCReceiver target, int ownerID,
+    const RPCSendPolicy &policy) {
   if (m_replicationManager) {
-    m_replicationManager->SendRPCPacket(rpcStream, target, ownerID);
+    m_replicationManager->SendRPCPacket(rpcStream, target, ownerID, policy);
   }
 }
 
@@ -622,6 +673,26 @@ void ToolKit::ToolKitNetworking::NetworkManager::ParameterConstructor() {
               NetworkManagerCategory.Priority, true, true);
   UseDeltaCompression_Define(m_useDeltaCompression, NetworkManagerCategory.Name,
                              NetworkManagerCategory.Priority, true, true);
+  StateHistoryDepth_Define(m_stateHistoryDepth, NetworkManagerCategory.Name,
+                           NetworkManagerCategory.Priority, true, true);
+  SnapshotByteBudget_Define(m_snapshotByteBudget, NetworkManagerCategory.Name,
+                            NetworkManagerCategory.Priority, true, true);
+  SnapshotEncodeThreads_Define(m_snapshotEncodeThreads,
+                               NetworkManagerCategory.Name,
+                               NetworkManagerCategory.Priority, true, true);
+  AsyncSnapshotEncoding_Define(m_asyncSnapshotEncoding,
+                               NetworkManagerCategory.Name,
+                               NetworkManagerCategory.Priority, true, true);
+  ServerTickRate_Define(m_serverTickRate, NetworkManagerCategory.Name,
+                        NetworkManagerCategory.Priority, true, true);
+  SnapshotSendRate_Define(m_snapshotSendRate, NetworkManagerCategory.Name,
+                          NetworkManagerCategory.Priority, true, true);
+  MaxCatchUpTicks_Define(m_maxCatchUpTicks, NetworkManagerCategory.Name,
+                         NetworkManagerCategory.Priority, true, true);
+  RelevancyRadius_Define(m_relevancyRadius, NetworkManagerCategory.Name,
+                         NetworkManagerCategory.Priority, true, true);
+  ThreadedTransport_Define(m_threadedTransport, NetworkManagerCategory.Name,
+                           NetworkManagerCategory.Priority, true, true);
   SessionJoinMethod_Define(m_sessionJoinMethod, NetworkManagerCategory.Name,
                            NetworkManagerCategory.Priority, true, true);
   ConnectHost_Define(m_connectHost, NetworkManagerCategory.Name,
@@ -693,6 +764,72 @@ void ToolKit::ToolKitNetworking::NetworkManager::ParameterConstructor() {
     return true;
   };
 
+  ParamStateHistoryDepth().m_validator = [](ToolKit::Value &val,
+                                            String &msg) -> bool {
+    if (uint *depth = std::get_if<uint>(&val)) {
+      if (*depth < 2 || *depth > 1024) {
+        msg = "State history depth must be between 2 and 1024 ticks.";
+        return false;
+      }
+    }
+    return true;
+  };
+
+  ParamSnapshotEncodeThreads().m_validator = [](ToolKit::Value &val,
+                                                String &msg) -> bool {
+    if (uint *threads = std::get_if<uint>(&val)) {
+      if (*threads > 64) {
+        msg = "Snapshot encode threads must be between 0 and 64.";
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const auto validateRate = [](ToolKit::Value &val, String &msg) -> bool {
+    if (float *rate = std::get_if<float>(&val)) {
+      if (*rate < 0.0f || *rate > 1000.0f) {
+        msg = "Rate must be between 0 and 1000 Hz; 0 follows Update().";
+        return false;
+      }
+    }
+    return true;
+  };
+
+  ParamServerTickRate().m_validator = validateRate;
+  ParamSnapshotSendRate().m_validator = validateRate;
+  ParamMaxCatchUpTicks().m_validator = [](ToolKit::Value &val,
+                                          String &msg) -> bool {
+    if (uint *ticks = std::get_if<uint>(&val)) {
+      if (*ticks == 0 || *ticks > 60) {
+        msg = "Max catch-up ticks must be between 1 and 60.";
+        return false;
+      }
+    }
+    return true;
+  };
+
+  ParamRelevancyRadius().m_validator = [](ToolKit::Value &val,
+                                          String &msg) -> bool {
+    if (float *radius = std::get_if<float>(&val)) {
+      if (*radius < 0.0f) {
+        msg = "Relevancy radius cannot be negative; use 0 to disable it.";
+        return false;
+      }
+    }
+    return true;
+  };
+
+  ParamBufferTime().m_validator = [](ToolKit::Value &val, String &msg) -> bool {
+    if (float *bufferTime = std::get_if<float>(&val)) {
+      if (*bufferTime < 0.0f || *bufferTime > 1.0f) {
+        msg = "Buffer time must be between 0 and 1 second.";
+        return false;
+      }
+    }
+    return true;
+  };
+
   ParamMaxClients().m_validator = [](ToolKit::Value &val, String &msg) -> bool {
     if (uint *maxClients = std::get_if<uint>(&val)) {
       if (*maxClients == 0) {
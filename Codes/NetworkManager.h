@@ -33,6 +33,8 @@ struct NetworkSettings {
   bool enableExtrapolation = false;
   bool enableLagCompensation = false;
   float bufferTime = 0.1f; // 100ms
+  // How long a remote entity keeps moving after its newest snapshot.
+  float maxExtrapolationTime = 0.25f;
 };
 
 typedef std::shared_ptr<class NetworkManager> NetworkManagerPtr;
@@ -73,7 +75,7 @@ public:
                                        const Quaternion &rot);
   void DespawnNetworkObject(NetworkComponent *component);
 
-  void SendClientUpdate(NetworkComponent *component);
+  void SendInputCommands(NetworkComponent *component);
 
   void ReceivePacket(int type, GamePacket *payload, int source) override;
   void Update(float deltaTime);
@@ -85,6 +87,9 @@ public:
   bool IsServer() const;
   int GetLocalPeerID() const;
 
+  // Client-side smoothing settings built from the parameters.
+  NetworkSettings GetNetworkSettings() const;
+
   bool IsDedicatedServer() const;
   bool IsHost() const;
   bool IsClient() const;
@@ -109,7 +114,16 @@ public:
   void SetReplicationClockNowProviderForTests(
       std::function<uint64_t()> clockNowProvider);
 
-  void SendRPCPacket(PacketStream &rpcStream, RPCReceiver target, int ownerID);
+  void SendRPCPacket(PacketStream &rpcStream, RPCReceiver target, int ownerID,
+                     const RPCSendPolicy &policy = RPCSendPolicy());
+
+  // Server-side lag compensation, active when EnableLagCompensation is set.
+  // Validate a peer's shot against RewindForPeer() with
+  // LagCompensation::Raycast, or bracket engine queries with
+  // Begin/EndLagCompensation to move live entities into the past.
+  const LagCompensationFrame *RewindForPeer(TransportPeerId peerID);
+  bool BeginLagCompensation(TransportPeerId peerID);
+  void EndLagCompensation();
 
   ComponentPtr Copy(EntityPtr entityPtr) override;
 
@@ -120,6 +134,15 @@ public:
 
   TKDeclareParam(MultiChoiceVariant, Role)
   TKDeclareParam(bool, UseDeltaCompression)
+  TKDeclareParam(uint, StateHistoryDepth)
+  TKDeclareParam(uint, SnapshotByteBudget)
+  TKDeclareParam(uint, SnapshotEncodeThreads)
+  TKDeclareParam(bool, AsyncSnapshotEncoding)
+  TKDeclareParam(float, ServerTickRate)
+  TKDeclareParam(float, SnapshotSendRate)
+  TKDeclareParam(uint, MaxCatchUpTicks)
+  TKDeclareParam(float, RelevancyRadius)
+  TKDeclareParam(bool, ThreadedTransport)
   TKDeclareParam(MultiChoiceVariant, SessionJoinMethod)
   TKDeclareParam(String, ConnectHost)
   TKDeclareParam(uint, ConnectPort)
@@ -154,6 +177,15 @@ protected:
 protected:
   MultiChoiceVariant m_role;
   bool m_useDeltaCompression;
+  uint m_stateHistoryDepth;
+  uint m_snapshotByteBudget;
+  uint m_snapshotEncodeThreads;
+  bool m_asyncSnapshotEncoding;
+  float m_serverTickRate;
+  float m_snapshotSendRate;
+  uint m_maxCatchUpTicks;
+  float m_relevancyRadius;
+  bool m_threadedTransport;
   MultiChoiceVariant m_sessionJoinMethod;
   String m_connectHost;
   uint m_connectPort;
@@ -1,6 +1,10 @@
 #pragma once
+#include "BitPacker.h"
+#include "ClientPrediction.h"
 #include "NetworkState.h"
+#include "PacketBufferPool.h"
 #include <cstring>
+#include <utility>
 #include <vector>
 
 
@@ -15,14 +19,15 @@ enum NetworkMessage {
   RPC,
   Spawn,
   Despawn,
-  ClientUpdate,
+  InputCommands,
   ClientInit,
   HandshakeHello,
   HandshakeChallenge,
   HandshakeResponse,
   HandshakeAccept,
   HandshakeReject,
-  PeerDisconnected
+  PeerDisconnected,
+  Bundle
 };
 
 enum class NetworkProperty : unsigned char {
@@ -31,6 +36,7 @@ enum class NetworkProperty : unsigned char {
   Orientation = 1 << 1,
   Scale = 1 << 2,
   NetworkVariables = 1 << 3,
+  InputAck = 1 << 4,
   All = 0xFF
 };
 
@@ -147,10 +153,18 @@ struct HandshakeRejectPacket : public GamePacket {
   }
 };
 
+// One fragment of a tick's snapshot. A tick is split into fragments of whole
+// entity records; each fragment covers entities
+// [firstEntityIndex, firstEntityIndex + entityCount) and can be applied on its
+// own. Each entity record names the tick it is delta encoded against;
+// `baseTick` is the newest tick the receiving peer had acked.
 struct WorldSnapshotPacket : public GamePacket {
   int serverTick;
-  int baseTick; // -1 for full state
+  int baseTick; // -1 when the peer has no usable ack
   int entityCount;
+  int firstEntityIndex;
+  short fragmentIndex;
+  short fragmentCount;
 
   WorldSnapshotPacket() {
     type = NetworkMessage::Snapshot;
@@ -158,6 +172,9 @@ struct WorldSnapshotPacket : public GamePacket {
     serverTick = 0;
     baseTick = -1;
     entityCount = 0;
+    firstEntityIndex = 0;
+    fragmentIndex = 0;
+    fragmentCount = 1;
   }
 };
 
@@ -190,27 +207,165 @@ struct DespawnPacket : public GamePacket {
   }
 };
 
-struct ClientUpdatePacket : public GamePacket {
+// Owner input for one component: the newest unacked commands, oldest first.
+// Commands are resent until acked, so a lost packet is covered by the next
+// one. Only `commandCount` entries are sent.
+struct InputCommandPacket : public GamePacket {
+  static constexpr int MaxCommands = 16;
+
   int networkID;
-  float px, py, pz;
-  float rx, ry, rz, rw;
+  int commandCount;
+  InputCommand commands[MaxCommands];
 
-  ClientUpdatePacket() {
-    type = NetworkMessage::ClientUpdate;
-    size = sizeof(ClientUpdatePacket) - sizeof(GamePacket);
+  InputCommandPacket() {
+    type = NetworkMessage::InputCommands;
     networkID = -1;
-    px = py = pz = 0.0f;
-    rx = ry = rz = 0.0f;
-    rw = 1.0f;
+    SetCommandCount(0);
+  }
+
+  void SetCommandCount(int count) {
+    commandCount = count;
+    size = static_cast<short>(GetPayloadSize(count));
+  }
+
+  // True when the declared size covers `commandCount` commands.
+  bool IsValid() const {
+    return commandCount >= 0 && commandCount <= MaxCommands &&
+           size >= GetPayloadSize(commandCount);
+  }
+
+private:
+  static int GetPayloadSize(int count) {
+    return static_cast<int>(sizeof(InputCommandPacket) - sizeof(GamePacket) -
+                            (MaxCommands - count) * sizeof(InputCommand));
+  }
+};
+
+// Non-owning, bounds-checked reader over received bytes, e.g. the ENet packet
+// buffer. Sub-views share the underlying memory, so decoding a snapshot needs
+// no copies or allocations. The viewed memory must outlive the reader.
+class PacketReader {
+public:
+  PacketReader() = default;
+  PacketReader(const void *data, size_t size)
+      : m_data(static_cast<const char *>(data)), m_size(data ? size : 0) {}
+
+  template <typename T> bool Read(T &value) {
+    if (!CanReadSize(sizeof(T))) {
+      return false;
+    }
+    std::memcpy(&value, m_data + m_offset, sizeof(T));
+    m_offset += sizeof(T);
+    return true;
+  }
+
+  bool ReadInt(int &value) { return Read(value); }
+  bool ReadShort(short &value) { return Read(value); }
+  bool ReadFloat(float &value) { return Read(value); }
+  bool ReadBool(bool &value) { return Read(value); }
+
+  bool ReadBytes(void *out, size_t size) {
+    if (!CanReadSize(size)) {
+      return false;
+    }
+    if (size > 0) {
+      std::memcpy(out, m_data + m_offset, size);
+    }
+    m_offset += size;
+    return true;
   }
+
+  // Hands out the next `size` bytes as their own reader and moves past them.
+  bool ReadView(size_t size, PacketReader &outView) {
+    if (!CanReadSize(size)) {
+      return false;
+    }
+    outView = PacketReader(m_data + m_offset, size);
+    m_offset += size;
+    return true;
+  }
+
+  bool CanReadSize(size_t size) const { return size <= m_size - m_offset; }
+
+  bool SkipChecked(int size) {
+    if (size < 0 || !CanReadSize(static_cast<size_t>(size))) {
+      return false;
+    }
+    m_offset += static_cast<size_t>(size);
+    return true;
+  }
+
+  const char *GetData() const { return m_data; }
+  const char *GetCurrent() const { return m_data + m_offset; }
+  size_t GetSize() const { return m_size; }
+  size_t GetReadOffset() const { return m_offset; }
+  size_t GetRemaining() const { return m_size - m_offset; }
+
+private:
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_offset = 0;
 };
 
+// True when `length` received bytes hold a complete GamePacket whose declared
+// size does not run past the buffer.
+inline bool IsWellFormedPacket(const void *data, size_t length) {
+  if (data == nullptr || length < sizeof(GamePacket)) {
+    return false;
+  }
+
+  const GamePacket *packet = static_cast<const GamePacket *>(data);
+  return packet->size >= 0 &&
+         static_cast<size_t>(packet->GetTotalSize()) <= length;
+}
+
+// The buffer is drawn from PacketBufferPool and handed back on destruction,
+// so short-lived streams such as RPC payloads do not hit the heap once the
+// pool is warm.
 class PacketStream {
 public:
+  static constexpr size_t DefaultCapacity = 1024;
+
   std::vector<char> buffer;
   int readOffset = 0;
 
-  PacketStream() { buffer.reserve(1024); }
+  PacketStream() : buffer(PacketBufferPool::Get().Acquire(DefaultCapacity)) {}
+
+  // Sized up front, e.g. from NetEncodedSize(), so writing never reallocates.
+  explicit PacketStream(size_t capacity)
+      : buffer(PacketBufferPool::Get().Acquire(capacity)) {}
+
+  PacketStream(const PacketStream &other)
+      : buffer(PacketBufferPool::Get().Acquire(other.buffer.size())),
+        readOffset(other.readOffset) {
+    buffer.assign(other.buffer.begin(), other.buffer.end());
+  }
+
+  PacketStream(PacketStream &&other) noexcept
+      : buffer(std::move(other.buffer)), readOffset(other.readOffset) {
+    other.readOffset = 0;
+  }
+
+  PacketStream &operator=(const PacketStream &other) {
+    if (this != &other) {
+      buffer.assign(other.buffer.begin(), other.buffer.end());
+      readOffset = other.readOffset;
+    }
+    return *this;
+  }
+
+  PacketStream &operator=(PacketStream &&other) noexcept {
+    if (this != &other) {
+      PacketBufferPool::Get().Release(std::move(buffer));
+      buffer = std::move(other.buffer);
+      other.buffer.clear();
+      readOffset = other.readOffset;
+      other.readOffset = 0;
+    }
+    return *this;
+  }
+
+  ~PacketStream() { PacketBufferPool::Get().Release(std::move(buffer)); }
 
   void Write(const void *data, size_t size) {
     size_t currentSize = buffer.size();
@@ -238,6 +393,17 @@ public:
   bool ReadFloat(float &value) { return Read(value); }
   bool ReadBool(bool &value) { return Read(value); }
 
+  bool ReadBytes(void *out, size_t size) {
+    if (!CanReadSize(size)) {
+      return false;
+    }
+    if (size > 0) {
+      std::memcpy(out, buffer.data() + readOffset, size);
+    }
+    readOffset += static_cast<int>(size);
+    return true;
+  }
+
   void Clear() {
     buffer.clear();
     readOffset = 0;
@@ -260,6 +426,10 @@ public:
   }
 
   void Skip(size_t size) { readOffset += (int)size; }
+
+  PacketReader GetReader() const {
+    return PacketReader(buffer.data(), buffer.size());
+  }
 };
 
 class PropertySerializer {
@@ -282,6 +452,36 @@ public:
     }
   }
 
+  // Bit-packed variants. A disabled range or zero bits falls back to the raw
+  // encoding, so reader and writer only have to agree on the settings.
+  void WriteQuantized(NetworkProperty prop, const Vec3 &value,
+                      const QuantizationRange &range, bool changed) {
+    if (!range.IsEnabled()) {
+      Write(prop, value, changed);
+      return;
+    }
+
+    if (changed) {
+      m_mask |= static_cast<unsigned char>(prop);
+      BitPacker packer(m_stream.buffer);
+      packer.WriteQuantizedVec3(value, range);
+    }
+  }
+
+  void WriteCompressed(NetworkProperty prop, const Quaternion &value,
+                       int bitsPerComponent, bool changed) {
+    if (bitsPerComponent <= 0) {
+      Write(prop, value, changed);
+      return;
+    }
+
+    if (changed) {
+      m_mask |= static_cast<unsigned char>(prop);
+      BitPacker packer(m_stream.buffer);
+      packer.WriteQuaternion(value, bitsPerComponent);
+    }
+  }
+
   void MarkAsChanged(NetworkProperty prop) {
     m_mask |= static_cast<unsigned char>(prop);
   }
@@ -292,25 +492,81 @@ private:
   unsigned char m_mask = 0;
 };
 
+// Each read keeps `defaultValue` for properties the mask leaves out. A read
+// returns false, also keeping the default, when the payload ends inside the
+// property; the stream is not advanced past it, so stop reading there.
 class PropertyDeserializer {
 public:
-  PropertyDeserializer(PacketStream &stream) : m_stream(stream) {
+  PropertyDeserializer(PacketReader &stream) : m_stream(stream) {
     m_stream.Read(m_mask);
   }
 
   template <typename T>
-  void Read(NetworkProperty prop, T &value, const T &defaultValue) {
-    if (HasProperty(m_mask, prop)) {
-      m_stream.Read(value);
-    } else {
-      value = defaultValue;
+  bool Read(NetworkProperty prop, T &value, const T &defaultValue) {
+    value = defaultValue;
+    if (!HasProperty(m_mask, prop)) {
+      return true;
+    }
+
+    T decoded;
+    if (!m_stream.Read(decoded)) {
+      return false;
     }
+    value = decoded;
+    return true;
+  }
+
+  bool ReadQuantized(NetworkProperty prop, Vec3 &value, const Vec3 &defaultValue,
+                     const QuantizationRange &range) {
+    if (!range.IsEnabled()) {
+      return Read(prop, value, defaultValue);
+    }
+
+    value = defaultValue;
+    if (!HasProperty(m_mask, prop)) {
+      return true;
+    }
+
+    BitReader reader = RemainingBits();
+    if (!reader.ReadQuantizedVec3(value, range)) {
+      return false;
+    }
+    Advance(reader);
+    return true;
+  }
+
+  bool ReadCompressed(NetworkProperty prop, Quaternion &value,
+                      const Quaternion &defaultValue, int bitsPerComponent) {
+    if (bitsPerComponent <= 0) {
+      return Read(prop, value, defaultValue);
+    }
+
+    value = defaultValue;
+    if (!HasProperty(m_mask, prop)) {
+      return true;
+    }
+
+    BitReader reader = RemainingBits();
+    if (!reader.ReadQuaternion(value, bitsPerComponent)) {
+      return false;
+    }
+    Advance(reader);
+    return true;
   }
 
   bool Has(NetworkProperty prop) const { return HasProperty(m_mask, prop); }
 
 private:
-  PacketStream &m_stream;
+  BitReader RemainingBits() const {
+    return BitReader(m_stream.GetCurrent(), m_stream.GetRemaining());
+  }
+
+  void Advance(const BitReader &reader) {
+    m_stream.SkipChecked(static_cast<int>(reader.GetBytesConsumed()));
+  }
+
+private:
+  PacketReader &m_stream;
   unsigned char m_mask = 0;
 };
 } // namespace ToolKit::ToolKitNetworking
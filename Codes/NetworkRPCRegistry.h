@@ -1,19 +1,20 @@
 #pragma once
-#include <map>
-#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include "NetworkPackets.h"
-
-namespace ToolKit
-{
-	struct ClassMeta;
-}
+#include "RPCDispatchTable.h"
+#include <Component.h>
 
 namespace ToolKit::ToolKitNetworking
 {
 	class NetworkComponent;
 
-	typedef std::function<void(NetworkComponent*, PacketStream&)> RPCDispatcherFn;
+	// Calls the member function `Func` with arguments unpacked from the stream.
+	// Specialized in NetworkMacros.h; its Dispatch is a plain RPCDispatcherFn.
+	template<auto Func>
+	struct RPCThunk;
 
 	class NetworkRPCRegistry
 	{
@@ -24,33 +25,86 @@ namespace ToolKit::ToolKitNetworking
 			return instance;
 		}
 
-		void Register(ToolKit::ClassMeta* cls, const std::string& name, RPCDispatcherFn dispatcher)
+		// Called from static initializers by the TK_RPC_*_IMPL macros. A name
+		// whose hash is already taken by another RPC of the class is rejected and
+		// reported once the class table is first used.
+		RPCRegisterResult Register(ToolKit::ClassMeta* cls, std::string_view name, uint32_t hash, RPCDispatcherFn dispatcher)
 		{
-			m_registry[cls][CalculateHash(name)] = dispatcher;
+			DeclaredRPCs& declared = m_declared[cls];
+			const RPCRegisterResult result = declared.table.Add(hash, name, dispatcher);
+			if (result == RPCRegisterResult::Collision)
+			{
+				declared.rejectedNames.emplace_back(name);
+			}
+
+			m_resolved.clear();
+			m_generation++;
+			return result;
 		}
 
-		RPCDispatcherFn GetDispatcher(ToolKit::ClassMeta* cls, uint32_t hash)
+		// The class's RPCs merged with those of every super class, derived ones
+		// first. Built on first use; the pointer stays valid until the next
+		// Register() call, which bumps GetGeneration().
+		const RPCDispatchTable& GetTable(ToolKit::ClassMeta* cls)
 		{
-			if (m_registry.count(cls) && m_registry[cls].count(hash))
+			auto resolved = m_resolved.find(cls);
+			if (resolved != m_resolved.end())
 			{
-				return m_registry[cls][hash];
+				return resolved->second;
 			}
-			
-			// Try base classes
-			// ToolKit ClassMeta has Super pointer
-			// We might need to iterate up the chain
-			return nullptr;
+
+			RPCDispatchTable& table = m_resolved[cls];
+			std::vector<RPCDispatchTable::Entry> collisions;
+			for (ToolKit::ClassMeta* meta = cls; meta != nullptr; meta = meta->Super)
+			{
+				auto declared = m_declared.find(meta);
+				if (declared == m_declared.end())
+				{
+					continue;
+				}
+
+				// Logged here rather than in Register(), which runs during static
+				// initialization before the logger exists.
+				for (const std::string& rejected : declared->second.rejectedNames)
+				{
+					TK_LOG(("RPC " + String(meta->Name) + "::" + rejected +
+						" was not registered: its hash collides with another RPC of the class.").c_str());
+				}
+
+				collisions.clear();
+				table.Inherit(declared->second.table, &collisions);
+				for (const RPCDispatchTable::Entry& collision : collisions)
+				{
+					TK_LOG(("RPC " + String(meta->Name) + "::" + String(collision.name) +
+						" is unreachable from " + String(cls->Name) +
+						": its hash collides with an RPC of a derived class.").c_str());
+				}
+			}
+
+			return table;
 		}
+		uint32_t GetGeneration() const { return m_generation; }
 
-		uint32_t CalculateHash(const std::string& name)
+		RPCDispatcherFn GetDispatcher(ToolKit::ClassMeta* cls, uint32_t hash)
 		{
-			uint32_t hash = 5381;
-			for (char c : name)
-				hash = ((hash << 5) + hash) + c;
-			return hash;
+			const RPCDispatchTable::Entry* entry = GetTable(cls).Find(hash);
+			return entry ? entry->dispatch : nullptr;
+		}
+
+		static constexpr uint32_t CalculateHash(std::string_view name)
+		{
+			return RPCNameHash(name);
 		}
 
 	private:
-		std::map<ToolKit::ClassMeta*, std::map<uint32_t, RPCDispatcherFn>> m_registry;
+		struct DeclaredRPCs
+		{
+			RPCDispatchTable table;
+			std::vector<std::string> rejectedNames;
+		};
+
+		std::unordered_map<ToolKit::ClassMeta*, DeclaredRPCs> m_declared;
+		std::unordered_map<ToolKit::ClassMeta*, RPCDispatchTable> m_resolved;
+		uint32_t m_generation = 0;
 	};
 }
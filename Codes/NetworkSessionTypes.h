@@ -63,7 +63,7 @@ enum class ResolvedRouteKind {
 };
 
 namespace SessionProtocol {
-constexpr uint Version = 1;
+constexpr uint Version = 7;
 constexpr uint BuildCompatibilityRevision = 1;
 constexpr uint DefaultConnectionTimeoutMs = 10000;
 constexpr uint DefaultHandshakeTimeoutMs = 5000;
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include "NetSerializer.h"
 #include "NetworkPackets.h"
 
 namespace ToolKit::ToolKitNetworking
@@ -10,12 +11,14 @@ namespace ToolKit::ToolKitNetworking
 	public:
 		virtual ~NetworkVariableBase() = default;
 		virtual void Serialize(PacketStream& stream) = 0;
-		virtual void Deserialize(PacketStream& stream) = 0;
+		// False when the payload is truncated or malformed; the value is kept.
+		virtual bool Deserialize(PacketReader& stream) = 0;
 		virtual bool IsDirty() const = 0;
 		virtual void ResetDirty() = 0;
 		virtual const std::string& GetName() const = 0;
 	};
 
+	// T is encoded with NetSerializer<T>.
 	template<typename T>
 	class NetworkVariable : public NetworkVariableBase
 	{
@@ -44,12 +47,18 @@ namespace ToolKit::ToolKitNetworking
 
 		void Serialize(PacketStream& stream) override
 		{
-			stream.Write(m_value);
+			NetSerializer<T>::Write(stream, m_value);
 		}
 
-		void Deserialize(PacketStream& stream) override
+		bool Deserialize(PacketReader& stream) override
 		{
-			stream.Read(m_value);
+			T value = T();
+			if (!NetSerializer<T>::Read(stream, value))
+			{
+				return false;
+			}
+			m_value = std::move(value);
+			return true;
 		}
 
 		bool IsDirty() const override { return m_dirty; }
@@ -0,0 +1,83 @@
+#include "NetworkVariableDelta.h"
+#include "BitPacker.h"
+#include <algorithm>
+
+namespace ToolKit::ToolKitNetworking {
+void VariableChangeTracker::Resize(size_t variableCount) {
+  m_changedTicks.resize(variableCount, -1);
+}
+
+void VariableChangeTracker::MarkChanged(size_t variableIndex, int tick) {
+  if (variableIndex < m_changedTicks.size()) {
+    m_changedTicks[variableIndex] = tick;
+  }
+}
+
+int VariableChangeTracker::GetChangedTick(size_t variableIndex) const {
+  return variableIndex < m_changedTicks.size() ? m_changedTicks[variableIndex]
+                                               : -1;
+}
+
+size_t VariableChangeTracker::BuildMask(int baseTick,
+                                        std::vector<uint8_t> &outMask) const {
+  return BuildVariableMask(m_changedTicks.data(), m_changedTicks.size(),
+                           baseTick, outMask);
+}
+
+void VariableChangeTracker::Reset() {
+  std::fill(m_changedTicks.begin(), m_changedTicks.end(), -1);
+}
+
+size_t BuildVariableMask(const int *changedTicks, size_t variableCount,
+                         int baseTick, std::vector<uint8_t> &outMask) {
+  outMask.assign((variableCount + 7) / 8, 0);
+
+  size_t selected = 0;
+  for (size_t i = 0; i < variableCount; ++i) {
+    if (baseTick == -1 || changedTicks[i] > baseTick) {
+      outMask[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+      selected++;
+    }
+  }
+  return selected;
+}
+
+namespace VariableMask {
+void Write(PacketStream &stream, size_t variableCount,
+           const std::vector<uint8_t> &mask) {
+  BitPacker packer(stream.buffer);
+  packer.WriteVarUInt(static_cast<uint32_t>(variableCount));
+  for (size_t i = 0; i < variableCount; ++i) {
+    packer.WriteBool(IsSet(mask, i));
+  }
+}
+
+bool Read(PacketReader &stream, size_t maxVariables, size_t &outVariableCount,
+          std::vector<uint8_t> &outMask) {
+  outVariableCount = 0;
+  outMask.clear();
+
+  BitReader reader(stream.GetCurrent(), stream.GetRemaining());
+  uint32_t count = 0;
+  if (!reader.ReadVarUInt(count) || count > maxVariables) {
+    return false;
+  }
+
+  // The count is byte aligned, so the mask bits start on a fresh byte.
+  outMask.assign((count + 7) / 8, 0);
+  for (uint32_t i = 0; i < count; ++i) {
+    bool set = false;
+    if (!reader.ReadBool(set)) {
+      outMask.clear();
+      return false;
+    }
+    if (set) {
+      outMask[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+    }
+  }
+
+  outVariableCount = count;
+  return stream.SkipChecked(static_cast<int>(reader.GetBytesConsumed()));
+}
+} // namespace VariableMask
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "NetworkPackets.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Remembers the tick each network variable of a component last changed on.
+// A delta against a baseline carries exactly the variables changed after
+// that baseline, so every peer gets what it is missing no matter how many
+// other peers were encoded before it on the same tick.
+class VariableChangeTracker {
+public:
+  // New variables count as never changed; a full state still sends them.
+  void Resize(size_t variableCount);
+  size_t GetVariableCount() const { return m_changedTicks.size(); }
+
+  void MarkChanged(size_t variableIndex, int tick);
+  int GetChangedTick(size_t variableIndex) const;
+
+  // Fills one bit per variable, LSB first, for variables changed after
+  // `baseTick`; a base tick of -1 selects every variable. Returns the number
+  // of selected variables.
+  size_t BuildMask(int baseTick, std::vector<uint8_t> &outMask) const;
+
+  const std::vector<int> &GetChangedTicks() const { return m_changedTicks; }
+
+  void Reset();
+
+private:
+  std::vector<int> m_changedTicks;
+};
+
+// BuildMask() over change ticks stored elsewhere, e.g. a ReplicationFrame.
+size_t BuildVariableMask(const int *changedTicks, size_t variableCount,
+                         int baseTick, std::vector<uint8_t> &outMask);
+
+namespace VariableMask {
+inline bool IsSet(const std::vector<uint8_t> &mask, size_t index) {
+  return index / 8 < mask.size() && (mask[index / 8] >> (index % 8)) & 1;
+}
+
+// Wire form: variable count as a varint followed by one bit per variable,
+// padded to a whole byte.
+void Write(PacketStream &stream, size_t variableCount,
+           const std::vector<uint8_t> &mask);
+// Fails on truncated input or when the count exceeds `maxVariables`.
+bool Read(PacketReader &stream, size_t maxVariables, size_t &outVariableCount,
+          std::vector<uint8_t> &outMask);
+} // namespace VariableMask
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,74 @@
+#include "PacketBatcher.h"
+#include <cstring>
+
+namespace ToolKit::ToolKitNetworking {
+static_assert(sizeof(PacketBundleHeader) % PacketBatcher::MessageAlignment == 0,
+              "Bundled messages must start aligned.");
+
+PacketBatcher::PacketBatcher(size_t maxBundleBytes)
+    : m_maxBundleBytes(maxBundleBytes) {}
+
+bool PacketBatcher::CanBundle(const GamePacket &packet) const {
+  return sizeof(PacketBundleHeader) +
+             static_cast<size_t>(packet.GetTotalSize()) <=
+         m_maxBundleBytes;
+}
+
+bool PacketBatcher::Queue(const GamePacket &packet,
+                          DeliveryChannel deliveryChannel) {
+  const size_t index = static_cast<size_t>(deliveryChannel);
+  if (!CanBundle(packet) || index >= DeliveryChannelCount) {
+    return false;
+  }
+
+  const size_t size = static_cast<size_t>(packet.GetTotalSize());
+  Channel &channel = m_channels[index];
+  Bundle *bundle =
+      channel.used > 0 ? &channel.bundles[channel.used - 1] : nullptr;
+  if (bundle == nullptr ||
+      PacketBundle::AlignMessageOffset(bundle->bytes.size()) + size >
+          m_maxBundleBytes) {
+    bundle = &OpenBundle(channel);
+  }
+
+  const size_t offset = PacketBundle::AlignMessageOffset(bundle->bytes.size());
+  bundle->bytes.resize(offset + size);
+  std::memcpy(bundle->bytes.data() + offset, &packet, size);
+  bundle->messageCount++;
+  m_queuedMessages++;
+  return true;
+}
+
+bool PacketBatcher::HasPending() const {
+  for (const Channel &channel : m_channels) {
+    if (channel.used > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+PacketBatcher::Bundle &PacketBatcher::OpenBundle(Channel &channel) {
+  if (channel.used == channel.bundles.size()) {
+    channel.bundles.emplace_back();
+    channel.bundles.back().bytes.reserve(m_maxBundleBytes);
+  }
+
+  Bundle &bundle = channel.bundles[channel.used++];
+  PacketBundleHeader header;
+  bundle.bytes.resize(sizeof(header));
+  std::memcpy(bundle.bytes.data(), &header, sizeof(header));
+  bundle.messageCount = 0;
+  return bundle;
+}
+
+void PacketBatcher::Clear() {
+  for (Channel &channel : m_channels) {
+    for (size_t i = 0; i < channel.used; ++i) {
+      channel.bundles[i].bytes.clear();
+      channel.bundles[i].messageCount = 0;
+    }
+    channel.used = 0;
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "NetworkPackets.h"
+#include "TransportTypes.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Datagram carrying several GamePackets back to back. Each message starts on
+// a MessageAlignment boundary, so receivers can keep casting payloads to
+// packet structs.
+struct PacketBundleHeader : public GamePacket {
+  int messageCount;
+
+  PacketBundleHeader() {
+    type = NetworkMessage::Bundle;
+    size = sizeof(PacketBundleHeader) - sizeof(GamePacket);
+    messageCount = 0;
+  }
+};
+
+// Outgoing messages to one destination, coalesced into MTU-bounded bundles
+// until the transport flushes them, normally once per tick. Each delivery
+// channel has its own bundles and keeps its queueing order. A bundle holding
+// a single message goes out as the bare message.
+class PacketBatcher {
+public:
+  // Bundle datagram size, header included; the same MTU margin as snapshot
+  // fragments.
+  static constexpr size_t DefaultMaxBundleBytes = 1200;
+  static constexpr size_t MessageAlignment = 8;
+
+  explicit PacketBatcher(size_t maxBundleBytes = DefaultMaxBundleBytes);
+
+  // Packets too large to share a bundle have to be sent on their own. Flush
+  // this destination first so they do not overtake queued messages.
+  bool CanBundle(const GamePacket &packet) const;
+
+  // Copies `packet` into the open bundle of `channel`, starting a new one
+  // when it does not fit. Returns false for packets CanBundle() rejects.
+  bool Queue(const GamePacket &packet, DeliveryChannel channel);
+
+  bool HasPending() const;
+
+  // Hands every bundle to `send(const void *data, size_t size,
+  // DeliveryChannel channel)`, channel by channel, then empties the queues.
+  // Buffers are kept for the next tick.
+  template <typename SendFn> void Flush(SendFn &&send);
+
+  // Drops everything queued, e.g. when the destination disconnected.
+  void Clear();
+
+  uint64_t GetQueuedMessageCount() const { return m_queuedMessages; }
+  uint64_t GetSentDatagramCount() const { return m_sentDatagrams; }
+
+private:
+  struct Bundle {
+    std::vector<char> bytes;
+    int messageCount = 0;
+  };
+
+  struct Channel {
+    std::vector<Bundle> bundles;
+    size_t used = 0;
+  };
+
+  Bundle &OpenBundle(Channel &channel);
+
+private:
+  size_t m_maxBundleBytes;
+  Channel m_channels[DeliveryChannelCount];
+  uint64_t m_queuedMessages = 0;
+  uint64_t m_sentDatagrams = 0;
+};
+
+template <typename SendFn> void PacketBatcher::Flush(SendFn &&send) {
+  for (size_t c = 0; c < DeliveryChannelCount; ++c) {
+    const DeliveryChannel deliveryChannel = static_cast<DeliveryChannel>(c);
+    Channel &channel = m_channels[c];
+    for (size_t i = 0; i < channel.used; ++i) {
+      Bundle &bundle = channel.bundles[i];
+      if (bundle.messageCount == 1) {
+        send(bundle.bytes.data() + sizeof(PacketBundleHeader),
+             bundle.bytes.size() - sizeof(PacketBundleHeader), deliveryChannel);
+      } else {
+        PacketBundleHeader *header =
+            reinterpret_cast<PacketBundleHeader *>(bundle.bytes.data());
+        header->size =
+            static_cast<short>(bundle.bytes.size() - sizeof(GamePacket));
+        header->messageCount = bundle.messageCount;
+        send(bundle.bytes.data(), bundle.bytes.size(), deliveryChannel);
+      }
+      m_sentDatagrams++;
+    }
+  }
+  Clear();
+}
+
+namespace PacketBundle {
+inline size_t AlignMessageOffset(size_t offset) {
+  return (offset + PacketBatcher::MessageAlignment - 1) &
+         ~(PacketBatcher::MessageAlignment - 1);
+}
+
+// Calls `handler(GamePacket *)` for each message of a received bundle, in
+// order. `data` must hold a well formed bundle packet. Stops at the first
+// message that is malformed, runs past the bundle or is itself a bundle and
+// returns false.
+template <typename Fn> bool ForEach(void *data, size_t length, Fn &&handler) {
+  if (length < sizeof(PacketBundleHeader)) {
+    return false;
+  }
+
+  const PacketBundleHeader *header =
+      static_cast<const PacketBundleHeader *>(data);
+  const size_t bundleSize =
+      (std::min)(length, static_cast<size_t>(header->GetTotalSize()));
+  char *bytes = static_cast<char *>(data);
+  size_t offset = sizeof(PacketBundleHeader);
+  for (int i = 0; i < header->messageCount; ++i) {
+    offset = AlignMessageOffset(offset);
+    if (offset >= bundleSize ||
+        !IsWellFormedPacket(bytes + offset, bundleSize - offset)) {
+      return false;
+    }
+
+    GamePacket *message = reinterpret_cast<GamePacket *>(bytes + offset);
+    if (message->type == NetworkMessage::Bundle) {
+      return false;
+    }
+
+    handler(message);
+    offset += static_cast<size_t>(message->GetTotalSize());
+  }
+  return true;
+}
+} // namespace PacketBundle
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,163 @@
+#include "PacketBufferPool.h"
+#include <cstring>
+#include <utility>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+// A block starts with its buffer's address, padded to keep the alignment.
+constexpr size_t BlockHeaderBytes = alignof(std::max_align_t);
+} // namespace
+
+PacketBufferPool::PacketBufferPool() {
+  // Releasing must not allocate, so the free lists never grow past this.
+  for (std::vector<std::vector<char>> &freeList : m_free) {
+    freeList.reserve(MaxFreePerClass);
+  }
+  m_detachedShells.reserve(MaxFreePerClass);
+}
+
+PacketBufferPool &PacketBufferPool::Get() {
+  static PacketBufferPool pool;
+  return pool;
+}
+
+int PacketBufferPool::ClassForRequest(size_t minCapacity) {
+  int index = 0;
+  size_t classBytes = MinClassBytes;
+  while (classBytes < minCapacity) {
+    if (++index == static_cast<int>(ClassCount)) {
+      return -1;
+    }
+    classBytes <<= 1;
+  }
+  return index;
+}
+
+int PacketBufferPool::ClassForCapacity(size_t capacity) {
+  if (capacity < MinClassBytes) {
+    return -1;
+  }
+
+  int index = 0;
+  size_t classBytes = MinClassBytes;
+  while (index + 1 < static_cast<int>(ClassCount) && classBytes * 2 <= capacity) {
+    classBytes <<= 1;
+    index++;
+  }
+  return index;
+}
+
+std::vector<char> PacketBufferPool::Acquire(size_t minCapacity) {
+  std::vector<char> buffer;
+  const int index = ClassForRequest(minCapacity);
+  if (index < 0) {
+    buffer.reserve(minCapacity);
+    return buffer;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::vector<char>> &freeList = m_free[index];
+    if (!freeList.empty()) {
+      buffer = std::move(freeList.back());
+      freeList.pop_back();
+      return buffer;
+    }
+    m_created++;
+  }
+
+  buffer.reserve(MinClassBytes << index);
+  return buffer;
+}
+
+void PacketBufferPool::Release(std::vector<char> &&buffer) {
+  const int index = ClassForCapacity(buffer.capacity());
+  if (index < 0) {
+    return;
+  }
+
+  buffer.clear();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<std::vector<char>> &freeList = m_free[index];
+  if (freeList.size() < MaxFreePerClass) {
+    freeList.push_back(std::move(buffer));
+  }
+}
+
+std::vector<char> *PacketBufferPool::AcquireDetached(size_t minCapacity) {
+  std::vector<char> *shell = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_detachedShells.empty()) {
+      shell = m_detachedShells.back();
+      m_detachedShells.pop_back();
+    }
+  }
+
+  if (shell == nullptr) {
+    shell = new std::vector<char>();
+  }
+  *shell = Acquire(minCapacity);
+  return shell;
+}
+
+void PacketBufferPool::ReleaseDetached(std::vector<char> *buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+
+  Release(std::move(*buffer));
+  buffer->clear();
+  buffer->shrink_to_fit();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_detachedShells.size() < MaxFreePerClass) {
+    m_detachedShells.push_back(buffer);
+  } else {
+    delete buffer;
+  }
+}
+
+void *PacketBufferPool::AllocateBlock(size_t size) {
+  std::vector<char> *buffer = AcquireDetached(BlockHeaderBytes + size);
+  buffer->resize(BlockHeaderBytes + size);
+  std::memcpy(buffer->data(), &buffer, sizeof(buffer));
+  return buffer->data() + BlockHeaderBytes;
+}
+
+void PacketBufferPool::FreeBlock(void *block) {
+  if (block == nullptr) {
+    return;
+  }
+
+  std::vector<char> *buffer = nullptr;
+  std::memcpy(&buffer, static_cast<char *>(block) - BlockHeaderBytes,
+              sizeof(buffer));
+  ReleaseDetached(buffer);
+}
+
+uint64_t PacketBufferPool::GetCreatedCount() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_created;
+}
+
+size_t PacketBufferPool::GetFreeCount() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t count = 0;
+  for (const std::vector<std::vector<char>> &freeList : m_free) {
+    count += freeList.size();
+  }
+  return count;
+}
+
+void PacketBufferPool::Trim() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (std::vector<std::vector<char>> &freeList : m_free) {
+    freeList.clear();
+  }
+  for (std::vector<char> *shell : m_detachedShells) {
+    delete shell;
+  }
+  m_detachedShells.clear();
+}
+} // namespace ToolKit::ToolKitNetworking
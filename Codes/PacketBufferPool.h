@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Recycled byte buffers in power-of-two size classes. A released buffer keeps
+// its memory and goes back to the class its capacity covers, so once traffic
+// has warmed the pool up, taking a buffer does not touch the heap. Safe to use
+// from several threads; the transport I/O thread releases buffers the game
+// thread acquired.
+class PacketBufferPool {
+public:
+  static constexpr size_t MinClassBytes = 256;
+  static constexpr size_t ClassCount = 9; // 256 bytes to 64 KiB.
+  static constexpr size_t MaxClassBytes = MinClassBytes << (ClassCount - 1);
+  // Free buffers kept per class; releases beyond that are freed.
+  static constexpr size_t MaxFreePerClass = 256;
+
+  PacketBufferPool();
+  PacketBufferPool(const PacketBufferPool &) = delete;
+  PacketBufferPool &operator=(const PacketBufferPool &) = delete;
+
+  // Process-wide pool used by PacketStream and the ENet send path.
+  static PacketBufferPool &Get();
+
+  // An empty buffer with at least `minCapacity` bytes of capacity. Requests
+  // above MaxClassBytes get a plain, unpooled buffer.
+  std::vector<char> Acquire(size_t minCapacity);
+  // Takes the buffer's memory back. Buffers smaller than MinClassBytes are
+  // simply freed.
+  void Release(std::vector<char> &&buffer);
+
+  // Like Acquire(), for memory handed to another owner by address, e.g. an
+  // ENet packet. The returned object stays valid until ReleaseDetached().
+  std::vector<char> *AcquireDetached(size_t minCapacity);
+  void ReleaseDetached(std::vector<char> *buffer);
+
+  // Raw memory of `size` bytes in a detached buffer, aligned like operator
+  // new, for allocators that only get the pointer back, e.g. enet_malloc.
+  void *AllocateBlock(size_t size);
+  void FreeBlock(void *block);
+
+  // Buffers created because no free one was available.
+  uint64_t GetCreatedCount() const;
+  size_t GetFreeCount() const;
+
+  // Frees every pooled buffer.
+  void Trim();
+
+private:
+  static int ClassForRequest(size_t minCapacity);
+  static int ClassForCapacity(size_t capacity);
+
+private:
+  mutable std::mutex m_mutex;
+  std::vector<std::vector<char>> m_free[ClassCount];
+  std::vector<std::vector<char> *> m_detachedShells;
+  uint64_t m_created = 0;
+};
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+class NetworkComponent;
+class PacketStream;
+
+// Unpacks the RPC arguments from `stream` and calls the implementation.
+// Returns false without calling it when the arguments do not decode.
+using RPCDispatcherFn = bool (*)(NetworkComponent *component,
+                                 PacketStream &stream);
+
+// djb2 of the RPC name, sent as RPCPacket::functionHash. Usable in constant
+// expressions so the RPC macros hash their names at compile time.
+constexpr uint32_t RPCNameHash(std::string_view name) {
+  uint32_t hash = 5381;
+  for (char c : name) {
+    hash = ((hash << 5) + hash) + static_cast<uint32_t>(c);
+  }
+  return hash;
+}
+
+enum class RPCRegisterResult {
+  Added,
+  // The same name was registered again; the new dispatcher replaced it.
+  Replaced,
+  // A different name already uses the hash; the table is unchanged.
+  Collision
+};
+
+// RPC dispatchers of one class, sorted by hash so a lookup is a binary search
+// over a contiguous array. Header-only: game modules register RPCs through
+// the macros without linking the plugin's core library.
+class RPCDispatchTable {
+public:
+  struct Entry {
+    uint32_t hash = 0;
+    // Not owned; the RPC macros register string literals.
+    std::string_view name;
+    RPCDispatcherFn dispatch = nullptr;
+  };
+
+  RPCRegisterResult Add(uint32_t hash, std::string_view name,
+                        RPCDispatcherFn dispatch);
+
+  // Adds the entries of `base` this table does not override by name. Base
+  // entries whose hash is taken by a different name here are skipped and
+  // appended to `outCollisions` when given. Returns the collision count.
+  size_t Inherit(const RPCDispatchTable &base,
+                 std::vector<Entry> *outCollisions = nullptr);
+
+  const Entry *Find(uint32_t hash) const;
+
+  const std::vector<Entry> &GetEntries() const { return m_entries; }
+  size_t Size() const { return m_entries.size(); }
+  bool IsEmpty() const { return m_entries.empty(); }
+
+private:
+  std::vector<Entry>::iterator LowerBound(uint32_t hash);
+
+private:
+  std::vector<Entry> m_entries;
+};
+
+inline std::vector<RPCDispatchTable::Entry>::iterator
+RPCDispatchTable::LowerBound(uint32_t hash) {
+  return std::lower_bound(
+      m_entries.begin(), m_entries.end(), hash,
+      [](const Entry &entry, uint32_t value) { return entry.hash < value; });
+}
+
+inline RPCRegisterResult RPCDispatchTable::Add(uint32_t hash,
+                                               std::string_view name,
+                                               RPCDispatcherFn dispatch) {
+  auto it = LowerBound(hash);
+  if (it != m_entries.end() && it->hash == hash) {
+    if (it->name != name) {
+      return RPCRegisterResult::Collision;
+    }
+    it->dispatch = dispatch;
+    return RPCRegisterResult::Replaced;
+  }
+
+  Entry entry;
+  entry.hash = hash;
+  entry.name = name;
+  entry.dispatch = dispatch;
+  m_entries.insert(it, entry);
+  return RPCRegisterResult::Added;
+}
+
+inline size_t RPCDispatchTable::Inherit(const RPCDispatchTable &base,
+                                        std::vector<Entry> *outCollisions) {
+  size_t collisions = 0;
+  for (const Entry &entry : base.m_entries) {
+    auto it = LowerBound(entry.hash);
+    if (it == m_entries.end() || it->hash != entry.hash) {
+      m_entries.insert(it, entry);
+    } else if (it->name != entry.name) {
+      collisions++;
+      if (outCollisions != nullptr) {
+        outCollisions->push_back(entry);
+      }
+    }
+  }
+  return collisions;
+}
+
+inline const RPCDispatchTable::Entry *
+RPCDispatchTable::Find(uint32_t hash) const {
+  auto it = std::lower_bound(
+      m_entries.begin(), m_entries.end(), hash,
+      [](const Entry &entry, uint32_t value) { return entry.hash < value; });
+  if (it == m_entries.end() || it->hash != hash) {
+    return nullptr;
+  }
+  return &*it;
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "NetSerializer.h"
+#include "NetworkPackets.h"
+#include <climits>
+#include <cstdint>
+
+namespace ToolKit::ToolKitNetworking {
+enum class RPCReceiver { Server, Owner, Others, All };
+
+struct RPCPacket : public GamePacket {
+  int networkID;
+  uint32_t functionHash;
+  // Data follows in the stream
+
+  RPCPacket() {
+    type = NetworkMessage::RPC;
+    size = sizeof(RPCPacket) - sizeof(GamePacket);
+    networkID = -1;
+    functionHash = 0;
+  }
+};
+
+// GamePacket::size is a short, so no RPC can be larger than this.
+constexpr size_t MaxRPCPacketBytes = SHRT_MAX + sizeof(GamePacket);
+
+// Bytes PackRPC() writes for these arguments.
+template <typename... Args> size_t RPCPacketSize(const Args &...args) {
+  return sizeof(RPCPacket) + NetEncodedSize(args...);
+}
+
+// Replaces the contents of `stream` with an RPC call: the header followed by
+// the encoded arguments. A stream sized with RPCPacketSize() never grows.
+// Returns false and leaves `stream` empty when the call exceeds
+// MaxRPCPacketBytes.
+template <typename... Args>
+bool PackRPC(PacketStream &stream, int networkID, uint32_t functionHash,
+             const Args &...args) {
+  stream.Clear();
+  if (RPCPacketSize(args...) > MaxRPCPacketBytes) {
+    return false;
+  }
+
+  RPCPacket header;
+  header.networkID = networkID;
+  header.functionHash = functionHash;
+  stream.Write(header);
+  NetWriteAll(stream, args...);
+  if (stream.GetSize() > MaxRPCPacketBytes) {
+    stream.Clear();
+    return false;
+  }
+
+  RPCPacket *packed = static_cast<RPCPacket *>(stream.GetData());
+  packed->size = static_cast<short>(stream.GetSize() - sizeof(GamePacket));
+  return true;
+}
+} // namespace ToolKit::ToolKitNetworking
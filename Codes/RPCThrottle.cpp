@@ -0,0 +1,112 @@
+#include "RPCThrottle.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace ToolKit::ToolKitNetworking {
+size_t RPCThrottleKeyHash::operator()(const RPCThrottleKey &key) const {
+  size_t hash = std::hash<int>()(key.networkID);
+  hash ^= std::hash<uint32_t>()(key.functionHash) + 0x9e3779b9 + (hash << 6) +
+          (hash >> 2);
+  hash ^= std::hash<uint32_t>()(key.receiver) + 0x9e3779b9 + (hash << 6) +
+          (hash >> 2);
+  return hash;
+}
+
+bool RPCThrottle::IsAllowed(const Stream &stream, double now) const {
+  if (stream.maxRate <= 0.0f || !stream.hasSent) {
+    return true;
+  }
+  // Updates rarely land exactly on the interval; a small tolerance keeps a
+  // 30 Hz limit at 30 Hz under a 60 Hz update.
+  const double interval = 1.0 / stream.maxRate;
+  return now - stream.lastSentTime >= interval - 1e-4;
+}
+
+size_t RPCThrottle::FindOrAddStream(const RPCThrottleKey &key) {
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    return it->second;
+  }
+
+  size_t index = 0;
+  if (!m_freeStreams.empty()) {
+    index = m_freeStreams.back();
+    m_freeStreams.pop_back();
+  } else {
+    index = m_streams.size();
+    m_streams.emplace_back();
+  }
+
+  Stream &stream = m_streams[index];
+  stream.rpc.key = key;
+  stream.hasSent = false;
+  stream.queued = false;
+  m_index.emplace(key, index);
+  return index;
+}
+
+RPCThrottleResult RPCThrottle::Submit(const RPCThrottleKey &key,
+                                      const RPCSendPolicy &policy,
+                                      int ownerID, const void *payload,
+                                      size_t size, double now) {
+  if (!policy.IsThrottled()) {
+    return RPCThrottleResult::Send;
+  }
+
+  const size_t index = FindOrAddStream(key);
+  Stream &stream = m_streams[index];
+  stream.maxRate = policy.maxRate;
+
+  if (!policy.coalesce) {
+    if (!IsAllowed(stream, now)) {
+      m_dropped++;
+      return RPCThrottleResult::Dropped;
+    }
+    stream.hasSent = true;
+    stream.lastSentTime = now;
+    return RPCThrottleResult::Send;
+  }
+
+  if (stream.queued) {
+    m_coalesced++;
+  } else {
+    stream.queued = true;
+    m_queued.push_back(index);
+  }
+
+  stream.rpc.ownerID = ownerID;
+  stream.rpc.channel = policy.channel;
+  const char *bytes = static_cast<const char *>(payload);
+  stream.rpc.payload.assign(bytes, bytes + size);
+  return RPCThrottleResult::Queued;
+}
+
+void RPCThrottle::ForgetComponent(int networkID) {
+  for (auto it = m_index.begin(); it != m_index.end();) {
+    if (it->first.networkID != networkID) {
+      ++it;
+      continue;
+    }
+
+    Stream &stream = m_streams[it->second];
+    if (stream.queued) {
+      stream.queued = false;
+      m_queued.erase(std::remove(m_queued.begin(), m_queued.end(), it->second),
+                     m_queued.end());
+    }
+    m_freeStreams.push_back(it->second);
+    it = m_index.erase(it);
+  }
+}
+
+void RPCThrottle::Reset() {
+  m_index.clear();
+  m_streams.clear();
+  m_freeStreams.clear();
+  m_queued.clear();
+  m_flushing.clear();
+  m_dropped = 0;
+  m_coalesced = 0;
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "TransportTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// How an RPC is delivered. The default is reliable and unthrottled.
+struct RPCSendPolicy {
+  DeliveryChannel channel = DeliveryChannel::ReliableRpc;
+  // Sends per second for one RPC of one component and receiver; 0 means no
+  // limit.
+  float maxRate = 0.0f;
+  // Calls made before the next update replace each other, so only the
+  // latest arguments go out.
+  bool coalesce = false;
+
+  static constexpr RPCSendPolicy Reliable(float maxRate = 0.0f,
+                                          bool coalesce = false) {
+    return RPCSendPolicy{DeliveryChannel::ReliableRpc, maxRate, coalesce};
+  }
+
+  static constexpr RPCSendPolicy Unreliable(float maxRate = 0.0f,
+                                            bool coalesce = false) {
+    return RPCSendPolicy{DeliveryChannel::UnreliableRpc, maxRate, coalesce};
+  }
+
+  bool IsThrottled() const { return maxRate > 0.0f || coalesce; }
+};
+
+// One RPC stream being throttled: the component, the RPC and the receiver.
+struct RPCThrottleKey {
+  int networkID = -1;
+  uint32_t functionHash = 0;
+  uint8_t receiver = 0;
+
+  bool operator==(const RPCThrottleKey &other) const {
+    return networkID == other.networkID &&
+           functionHash == other.functionHash && receiver == other.receiver;
+  }
+};
+
+struct RPCThrottleKeyHash {
+  size_t operator()(const RPCThrottleKey &key) const;
+};
+
+enum class RPCThrottleResult {
+  // Send the RPC now.
+  Send,
+  // Held until Flush(); later calls may replace it.
+  Queued,
+  // Over the rate limit.
+  Dropped
+};
+
+// Applies RPCSendPolicy rate limits and coalescing before RPCs reach the
+// transport, so redundant calls never occupy the send queues. Payload
+// buffers are reused once every throttled stream has been seen.
+class RPCThrottle {
+public:
+  struct QueuedRpc {
+    RPCThrottleKey key;
+    int ownerID = -1;
+    DeliveryChannel channel = DeliveryChannel::ReliableRpc;
+    // The whole RPC packet.
+    std::vector<char> payload;
+  };
+
+  // `now` is in seconds. Unthrottled policies are always sent.
+  RPCThrottleResult Submit(const RPCThrottleKey &key,
+                           const RPCSendPolicy &policy, int ownerID,
+                           const void *payload, size_t size, double now);
+
+  // Hands each queued RPC whose rate limit allows it to
+  // `send(const QueuedRpc &)`, in the order the streams were first queued.
+  // RPCs still over their limit stay queued. `send` may submit new RPCs;
+  // they wait for the next flush.
+  template <typename SendFn> void Flush(double now, SendFn &&send);
+
+  // Drops the streams of a despawned component.
+  void ForgetComponent(int networkID);
+  void Reset();
+
+  bool HasQueued() const { return !m_queued.empty(); }
+  uint64_t GetDroppedCount() const { return m_dropped; }
+  uint64_t GetCoalescedCount() const { return m_coalesced; }
+
+private:
+  struct Stream {
+    QueuedRpc rpc;
+    float maxRate = 0.0f;
+    double lastSentTime = 0.0;
+    bool hasSent = false;
+    bool queued = false;
+  };
+
+  size_t FindOrAddStream(const RPCThrottleKey &key);
+
+  bool IsAllowed(const Stream &stream, double now) const;
+
+private:
+  std::unordered_map<RPCThrottleKey, size_t, RPCThrottleKeyHash> m_index;
+  std::vector<Stream> m_streams;
+  std::vector<size_t> m_freeStreams;
+  std::vector<size_t> m_queued;
+  std::vector<size_t> m_flushing;
+  QueuedRpc m_sending;
+  uint64_t m_dropped = 0;
+  uint64_t m_coalesced = 0;
+};
+
+template <typename SendFn> void RPCThrottle::Flush(double now, SendFn &&send) {
+  m_flushing.swap(m_queued);
+  m_queued.clear();
+  for (size_t index : m_flushing) {
+    Stream &stream = m_streams[index];
+    if (!stream.queued) {
+      continue; // Forgotten by an earlier send.
+    }
+    if (!IsAllowed(stream, now)) {
+      m_queued.push_back(index);
+      continue;
+    }
+
+    stream.queued = false;
+    stream.hasSent = true;
+    stream.lastSentTime = now;
+    // Sent from m_sending: `send` may queue the same stream again or grow
+    // m_streams. The buffers trade places and keep their capacity.
+    m_sending.key = stream.rpc.key;
+    m_sending.ownerID = stream.rpc.ownerID;
+    m_sending.channel = stream.rpc.channel;
+    m_sending.payload.swap(stream.rpc.payload);
+    send(static_cast<const QueuedRpc &>(m_sending));
+  }
+  m_flushing.clear();
+}
+} // namespace ToolKit::ToolKitNetworking
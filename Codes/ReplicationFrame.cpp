@@ -0,0 +1,119 @@
+#include "ReplicationFrame.h"
+#include "NetworkVariableDelta.h"
+#include <cstring>
+
+namespace ToolKit::ToolKitNetworking {
+ReplicationFrame::ReplicationFrame() {
+  variableBegin.push_back(0);
+  variableOffsets.push_back(0);
+}
+
+void ReplicationFrame::Begin(int frameTick, size_t expectedCount) {
+  tick = frameTick;
+  networkIDs.clear();
+  ownerIDs.clear();
+  priorities.clear();
+  updateIntervals.clear();
+  inputAcks.clear();
+  positionQuantization.clear();
+  orientationBits.clear();
+  variableBegin.assign(1, 0);
+  variableChangedTicks.clear();
+  variableOffsets.assign(1, 0);
+  variableBytes.clear();
+  spawned.clear();
+  despawned.clear();
+
+  networkIDs.reserve(expectedCount);
+  ownerIDs.reserve(expectedCount);
+  priorities.reserve(expectedCount);
+  updateIntervals.reserve(expectedCount);
+  inputAcks.reserve(expectedCount);
+  positionQuantization.reserve(expectedCount);
+  orientationBits.reserve(expectedCount);
+  variableBegin.reserve(expectedCount + 1);
+
+  transforms.tick = frameTick;
+  transforms.Resize(expectedCount);
+}
+
+void ReplicationFrame::AddEntity(int networkID, int ownerID, float priority,
+                                 int updateInterval, uint32_t inputAck,
+                                 const QuantizationRange &quantization,
+                                 int bits) {
+  networkIDs.push_back(networkID);
+  ownerIDs.push_back(ownerID);
+  priorities.push_back(priority);
+  updateIntervals.push_back(updateInterval);
+  inputAcks.push_back(inputAck);
+  positionQuantization.push_back(quantization);
+  orientationBits.push_back(bits);
+  variableBegin.push_back(variableBegin.back());
+}
+
+void ReplicationFrame::SetVariables(const int *changedTicks,
+                                    const uint32_t *offsets, size_t count,
+                                    const char *bytes, size_t byteCount) {
+  const uint32_t base = static_cast<uint32_t>(variableBytes.size());
+  variableChangedTicks.insert(variableChangedTicks.end(), changedTicks,
+                              changedTicks + count);
+  // The last entry is the end offset of the previous slot, which is where
+  // this slot's bytes start.
+  variableOffsets.pop_back();
+  for (size_t i = 0; i < count; ++i) {
+    variableOffsets.push_back(base + offsets[i]);
+  }
+  variableOffsets.push_back(base + static_cast<uint32_t>(byteCount));
+  variableBytes.insert(variableBytes.end(), bytes, bytes + byteCount);
+  variableBegin.back() += static_cast<uint32_t>(count);
+}
+
+void WriteEntityRecord(const ReplicationFrame &frame, size_t slot,
+                       int baseTick, const SnapshotTransform &transform,
+                       PacketStream &stream,
+                       std::vector<uint8_t> &maskScratch) {
+  stream.WriteInt(frame.networkIDs[slot]);
+  stream.WriteInt(baseTick);
+
+  const size_t sizeOffset = stream.GetSize();
+  stream.WriteInt(0);
+
+  if (transform.present) {
+    PropertySerializer serializer(stream);
+
+    serializer.WriteQuantized(NetworkProperty::Position, transform.position,
+                              frame.positionQuantization[slot],
+                              transform.positionChanged);
+    serializer.WriteCompressed(NetworkProperty::Orientation,
+                               transform.orientation,
+                               frame.orientationBits[slot],
+                               transform.orientationChanged);
+
+    // Not delta encoded: the owner reconciles on every snapshot, including
+    // those where the transform matches the baseline.
+    const uint32_t inputAck = frame.inputAcks[slot];
+    serializer.Write(NetworkProperty::InputAck, inputAck, inputAck != 0);
+
+    const size_t first = frame.variableBegin[slot];
+    const size_t count = frame.GetVariableCount(slot);
+    const size_t changedVariables = BuildVariableMask(
+        frame.variableChangedTicks.data() + first, count,
+        transform.hasBaseline ? baseTick : -1, maskScratch);
+    if (changedVariables > 0) {
+      serializer.MarkAsChanged(NetworkProperty::NetworkVariables);
+      VariableMask::Write(stream, count, maskScratch);
+      for (size_t i = 0; i < count; ++i) {
+        if (VariableMask::IsSet(maskScratch, i)) {
+          const uint32_t begin = frame.variableOffsets[first + i];
+          const uint32_t end = frame.variableOffsets[first + i + 1];
+          stream.Write(frame.variableBytes.data() + begin, end - begin);
+        }
+      }
+    }
+  }
+
+  const int dataSize =
+      static_cast<int>(stream.GetSize() - sizeOffset - sizeof(int));
+  std::memcpy(stream.buffer.data() + sizeOffset, &dataSize, sizeof(int));
+}
+} // namespace ToolKit::ToolKitNetworking
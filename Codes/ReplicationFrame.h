@@ -0,0 +1,68 @@
+#pragma once
+
+#include "BitPacker.h"
+#include "NetworkPackets.h"
+#include "TransformCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Replication state of one server tick, copied out of the components at the
+// end of the tick. Snapshot scheduling and encoding read only this frame and
+// the TransformCache, never a live entity, so tick N can be encoded while
+// tick N + 1 simulates. Every array is indexed by replication slot and keeps
+// its capacity between ticks, so a capture is a series of appends.
+struct ReplicationFrame {
+  int tick = -1;
+  std::vector<int> networkIDs;
+  std::vector<int> ownerIDs;
+  std::vector<float> priorities;
+  std::vector<int> updateIntervals;
+  // Last owner input the server simulated; acked in every record.
+  std::vector<uint32_t> inputAcks;
+  std::vector<QuantizationRange> positionQuantization;
+  std::vector<int> orientationBits;
+  // Slot `s` owns variables [variableBegin[s], variableBegin[s + 1]).
+  std::vector<uint32_t> variableBegin;
+  // Per variable: the tick it last changed on, and where its encoded value
+  // starts in variableBytes. variableOffsets has one extra end offset.
+  std::vector<int> variableChangedTicks;
+  std::vector<uint32_t> variableOffsets;
+  std::vector<char> variableBytes;
+  // World transforms of the slots; committed to the TransformCache once the
+  // previous frame is no longer being encoded.
+  TransformFrame transforms;
+  // Network IDs registered and unregistered since the previous frame.
+  std::vector<int> spawned;
+  std::vector<int> despawned;
+
+  ReplicationFrame();
+
+  size_t Size() const { return networkIDs.size(); }
+  // Empties the frame for `tick`, keeping capacity.
+  void Begin(int tick, size_t expectedCount);
+
+  // Appends the next slot. Its transform is set separately in `transforms`.
+  void AddEntity(int networkID, int ownerID, float priority,
+                 int updateInterval, uint32_t inputAck,
+                 const QuantizationRange &quantization, int orientationBits);
+  // Sets the network variables of the slot added last: `count` change ticks,
+  // and `bytes` holding the encoded values back to back, variable `i`
+  // starting at `offsets[i]`.
+  void SetVariables(const int *changedTicks, const uint32_t *offsets,
+                    size_t count, const char *bytes, size_t byteCount);
+
+  size_t GetVariableCount(size_t slot) const {
+    return variableBegin[slot + 1] - variableBegin[slot];
+  }
+};
+
+// Writes the entity record of `slot` against `baseTick`: network ID, base
+// tick, payload size, then the changed properties. `maskScratch` is reused
+// between calls.
+void WriteEntityRecord(const ReplicationFrame &frame, size_t slot,
+                       int baseTick, const SnapshotTransform &transform,
+                       PacketStream &stream,
+                       std::vector<uint8_t> &maskScratch);
+} // namespace ToolKit::ToolKitNetworking
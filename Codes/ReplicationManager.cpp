@@ -50,8 +50,17 @@ void ReplicationManager::RegisterComponent(NetworkComponent *networkComponent) {
     m_nextNetworkID = networkComponent->GetNetworkID() + 1;
   }
 
-  if (std::find(m_networkComponents.begin(), m_networkComponents.end(),
-                networkComponent) != m_networkComponents.end()) {
+  NetworkComponent *registered =
+      m_networkComponents.Find(networkComponent->GetNetworkID());
+  if (registered == networkComponent) {
+    return;
+  }
+
+  if (registered != nullptr) {
+    TK_LOG(("NetworkComponent registration rejected: ID " +
+            std::to_string(networkComponent->GetNetworkID()) +
+            " is already in use.")
+               .c_str());
     return;
   }
 
@@ -59,7 +68,23 @@ void ReplicationManager::RegisterComponent(NetworkComponent *networkComponent) {
     networkComponent->SetOwnerID(0);
   }
 
-  m_networkComponents.push_back(networkComponent);
+  networkComponent->SetStateHistoryDepth(
+      static_cast<int>(m_owner.GetStateHistoryDepthVal()));
+
+  m_networkComponents.Insert(networkComponent->GetNetworkID(),
+                             networkComponent);
+  m_pendingSpawned.push_back(networkComponent->GetNetworkID());
+  if (!m_owner.IsServer()) {
+    const int networkID = networkComponent->GetNetworkID();
+    m_retiredSnapshotEntities.erase(
+        std::remove_if(m_retiredSnapshotEntities.begin(),
+                       m_retiredSnapshotEntities.end(),
+                       [networkID](const RetiredSnapshotEntity &entity) {
+                         return entity.networkID == networkID;
+                       }),
+        m_retiredSnapshotEntities.end());
+    ReplayPendingSnapshotRecords(networkComponent);
+  }
 
   std::string logMsg =
       "NetworkComponent Registered: ID " +
@@ -70,23 +95,57 @@ void ReplicationManager::RegisterComponent(NetworkComponent *networkComponent) {
 }
 
 void ReplicationManager::UnregisterComponent(NetworkComponent *networkComponent) {
-  auto it = std::remove(m_networkComponents.begin(), m_networkComponents.end(),
-                        networkComponent);
-  if (it != m_networkComponents.end()) {
-    m_networkComponents.erase(it, m_networkComponents.end());
+  if (m_networkComponents.Remove(networkComponent->GetNetworkID(),
+                                 networkComponent)) {
+    // Scheduling and interest state goes when the despawn reaches a frame.
+    m_pendingDespawned.push_back(networkComponent->GetNetworkID());
+    m_rpcThrottle.ForgetComponent(networkComponent->GetNetworkID());
+
+    // Never restore into a destroyed entity.
+    for (size_t i = 0; i < m_rewoundComponents.size(); ++i) {
+      if (m_rewoundComponents[i] == networkComponent) {
+        m_rewoundComponents.erase(m_rewoundComponents.begin() + i);
+        m_savedPositions.erase(m_savedPositions.begin() + i);
+        m_savedOrientations.erase(m_savedOrientations.begin() + i);
+        break;
+      }
+    }
   }
 }
 
 void ReplicationManager::ClearRegisteredComponents() {
-  std::vector<NetworkComponent *> toDestroy;
-  std::swap(toDestroy, m_networkComponents);
+  m_encodeThread.Wait();
+  m_snapshotsPending = false;
+  std::vector<NetworkComponent *> toDestroy = m_networkComponents.Items();
+  m_networkComponents.Clear();
   m_nextNetworkID = 1;
-  m_peerLastAckedTick.clear();
+  m_replicationScheduler.Reset();
+  m_interestManager.Reset();
   m_peerHandshakeStates.clear();
   m_currentServerTick = 0;
-  m_clientUpdateTimer = 0.0f;
-  m_sendStream.Clear();
   m_receiveStream.Clear();
+  m_snapshotEncoder.Reset();
+  for (ReplicationFrame &frame : m_replicationFrames) {
+    frame.Begin(-1, 0);
+  }
+  m_pendingSpawned.clear();
+  m_pendingDespawned.clear();
+  m_transformCache.Reset();
+  m_scheduledEntities.clear();
+  m_scheduledSnapshots.clear();
+  m_interestEntities.clear();
+  m_snapshotFragments.clear();
+  m_snapshotFragmentTracker.Reset();
+  m_snapshotClock.Reset();
+  m_lagCompensation.Reset();
+  m_rewoundFrame.Clear();
+  m_rewoundPeer = -1;
+  m_rewoundAtTick = -1;
+  m_rewoundComponents.clear();
+  m_serverTime = 0.0;
+  m_tickScheduler.Reset();
+  m_rpcThrottle.Reset();
+  m_rpcClock = 0.0;
   ResetAuthenticationState();
 
   std::vector<NetworkComponent *> preservedComponents;
@@ -128,12 +187,14 @@ void ReplicationManager::ClearRegisteredComponents() {
     }
   }
 
-  m_networkComponents = std::move(preservedComponents);
+  for (auto *nc : preservedComponents) {
+    m_networkComponents.Insert(nc->GetNetworkID(), nc);
+  }
 }
 
 const std::vector<NetworkComponent *> &
 ReplicationManager::GetNetworkComponents() const {
-  return m_networkComponents;
+  return m_networkComponents.Items();
 }
 
 NetworkComponent *ReplicationManager::InstantiateNetworkObject(
@@ -205,6 +266,9 @@ void ReplicationManager::ResetAuthenticationState() {
   m_localSessionAuthenticated = false;
   m_localAuthFailed = false;
   m_pendingPreAuthSpawns.clear();
+  m_pendingRpcs.clear();
+  m_pendingSnapshotRecords.clear();
+  m_retiredSnapshotEntities.clear();
   m_localClientNonce = 0;
   m_localServerNonce = 0;
   m_pendingJoinRequest = SessionJoinRequest{};
@@ -236,7 +300,8 @@ void ReplicationManager::RejectPeer(int peerID, DisconnectReason reason,
   HandshakeRejectPacket reject;
   reject.reason = static_cast<int>(reason);
   CopyStringToPacketField(reject.detail, detail);
-  m_owner.m_server->SendPacketToPeer(peerID, reject, true);
+  m_owner.m_server->SendPacketToPeer(peerID, reject,
+                                     DeliveryChannel::Lifecycle);
 }
 
 void ReplicationManager::RejectLocalSession(DisconnectReason reason,
@@ -291,11 +356,18 @@ NetworkComponent *ReplicationManager::SpawnNetworkObject(
     packet.rw = rot.w;
     strncpy(packet.className, prefabName.c_str(), 127);
 
-    TK_LOG(("Replication server broadcasting spawn netID=" +
-            std::to_string(packet.networkID) + " owner=" +
-            std::to_string(packet.ownerID) + " class=" + prefabName)
-               .c_str());
-    m_owner.m_server->SendGlobalPacket(packet, true);
+    if (m_interestManager.IsEnabled()) {
+      // Peers get the spawn once the object becomes relevant to them.
+      TK_LOG(("Replication server deferred spawn to interest update netID=" +
+              std::to_string(packet.networkID) + " class=" + prefabName)
+                 .c_str());
+    } else {
+      TK_LOG(("Replication server broadcasting spawn netID=" +
+              std::to_string(packet.networkID) + " owner=" +
+              std::to_string(packet.ownerID) + " class=" + prefabName)
+                 .c_str());
+      m_owner.m_server->SendGlobalPacket(packet, DeliveryChannel::Lifecycle);
+    }
   }
 
   return netComp;
@@ -311,7 +383,14 @@ void ReplicationManager::DespawnNetworkObject(NetworkComponent *component) {
   if (m_owner.IsServer() && m_owner.m_server) {
     DespawnPacket packet;
     packet.networkID = netID;
-    m_owner.m_server->SendGlobalPacket(packet, true);
+    if (m_interestManager.IsEnabled()) {
+      CollectInterestedPeers(netID, m_interestPeers);
+      m_owner.m_server->SendPacketToPeers(m_interestPeers, packet,
+                                          DeliveryChannel::Lifecycle);
+      m_interestManager.RemoveEntity(netID);
+    } else {
+      m_owner.m_server->SendGlobalPacket(packet, DeliveryChannel::Lifecycle);
+    }
   }
 
   if (auto entity = component->GetEntity()) {
@@ -322,7 +401,7 @@ void ReplicationManager::DespawnNetworkObject(NetworkComponent *component) {
   }
 }
 
-void ReplicationManager::SendClientUpdate(NetworkComponent *component) {
+void ReplicationManager::SendInputCommands(NetworkComponent *component) {
   if (!component || !m_owner.m_client) {
     return;
   }
@@ -331,32 +410,29 @@ void ReplicationManager::SendClientUpdate(NetworkComponent *component) {
     return;
   }
 
-  if (auto entity = component->GetEntity()) {
-    Vec3 pos = entity->m_node->GetTranslation();
-    Quaternion rot = entity->m_node->GetOrientation();
-
-    ClientUpdatePacket packet;
-    packet.networkID = component->GetNetworkID();
-    packet.px = pos.x;
-    packet.py = pos.y;
-    packet.pz = pos.z;
-    packet.rx = rot.x;
-    packet.ry = rot.y;
-    packet.rz = rot.z;
-    packet.rw = rot.w;
+  // The newest unacked inputs; older ones the server has either processed or
+  // will skip over.
+  PredictionBuffer &prediction = component->GetPredictionBuffer();
+  const size_t pending = prediction.GetPendingCount();
+  if (pending == 0) {
+    return;
+  }
 
-    m_owner.m_client->SendPacket(packet, false);
+  const size_t count = (std::min)(
+      pending, static_cast<size_t>(InputCommandPacket::MaxCommands));
+  InputCommandPacket packet;
+  packet.networkID = component->GetNetworkID();
+  for (size_t i = 0; i < count; ++i) {
+    packet.commands[i] = prediction.GetPendingInput(pending - count + i);
   }
+  packet.SetCommandCount(static_cast<int>(count));
+
+  m_owner.m_client->SendPacket(packet, DeliveryChannel::Snapshot);
+  prediction.MarkSent();
 }
 
 NetworkComponent *ReplicationManager::FindComponentByNetworkID(int networkID) const {
-  for (auto *networkComponent : m_networkComponents) {
-    if (networkComponent->GetNetworkID() == networkID) {
-      return networkComponent;
-    }
-  }
-
-  return nullptr;
+  return m_networkComponents.Find(networkID);
 }
 
 bool ReplicationManager::BeginSessionHandshake(const SessionJoinRequest &request) {
@@ -384,7 +460,7 @@ bool ReplicationManager::BeginSessionHandshake(const SessionJoinRequest &request
           request.sessionId + " target=" + request.targetEndpoint.host + ":" +
           std::to_string(request.targetEndpoint.port))
              .c_str());
-  m_owner.m_client->SendPacket(hello, true);
+  m_owner.m_client->SendPacket(hello, DeliveryChannel::Lifecycle);
   return true;
 }
 
@@ -488,7 +564,8 @@ void ReplicationManager::HandleHandshakeHello(HandshakeHelloPacket *packet,
   TK_LOG(("Replication server sending HandshakeChallenge to peer=" +
           std::to_string(source))
              .c_str());
-  m_owner.m_server->SendPacketToPeer(source, challenge, true);
+  m_owner.m_server->SendPacketToPeer(source, challenge,
+                                     DeliveryChannel::Lifecycle);
 }
 
 void ReplicationManager::HandleHandshakeChallenge(HandshakeChallengePacket *packet) {
@@ -509,7 +586,7 @@ void ReplicationManager::HandleHandshakeChallenge(HandshakeChallengePacket *pack
   response.clientNonce = m_localClientNonce;
   response.serverNonce = m_localServerNonce;
   TK_LOG("Replication client received HandshakeChallenge; sending HandshakeResponse.");
-  m_owner.m_client->SendPacket(response, true);
+  m_owner.m_client->SendPacket(response, DeliveryChannel::Lifecycle);
 }
 
 void ReplicationManager::HandleHandshakeResponse(HandshakeResponsePacket *packet,
@@ -558,7 +635,8 @@ void ReplicationManager::HandleHandshakeResponse(HandshakeResponsePacket *packet
   CopyStringToPacketField(accept.sessionId, m_owner.GetActiveSession().sessionId);
   CopyStringToPacketField(accept.buildCompatibilityId,
                           m_owner.GetActiveSession().buildCompatibilityId);
-  m_owner.m_server->SendPacketToPeer(source, accept, true);
+  m_owner.m_server->SendPacketToPeer(source, accept,
+                                     DeliveryChannel::Lifecycle);
   TK_LOG(("Replication server sent HandshakeAccept to peer=" +
           std::to_string(source))
              .c_str());
@@ -654,9 +732,11 @@ void ReplicationManager::HandleSpawnPacket(const SpawnPacket &packet) {
               std::to_string(packet.networkID) + " owner=" +
               std::to_string(packet.ownerID) + " class=" + className)
                  .c_str());
+      ReplayPendingRpcs(packet.networkID);
     } else {
       TK_LOG(("NetworkManager: Client failed to spawn object: " + className)
                  .c_str());
+      RetireSnapshotEntity(packet.networkID, GetServerTick());
     }
   } else {
     TK_LOG(("Replication client ignored duplicate Spawn netID=" +
@@ -679,7 +759,8 @@ void ReplicationManager::ReceivePacket(int type, GamePacket *payload, int source
 
   if (type == NetworkMessage::PeerDisconnected) {
     m_peerHandshakeStates.erase(source);
-    m_peerLastAckedTick.erase(source);
+    m_replicationScheduler.RemovePeer(source);
+    m_interestManager.RemovePeer(source);
     return;
   }
 
@@ -759,114 +840,132 @@ void ReplicationManager::ReceivePacket(int type, GamePacket *payload, int source
   }
 
   if (type == NetworkMessage::Snapshot) {
-    m_receiveStream.Clear();
-
-    int totalSize = payload->GetTotalSize();
-    m_receiveStream.Write((void *)payload, totalSize);
-
-    m_receiveStream.readOffset = sizeof(WorldSnapshotPacket);
-    WorldSnapshotPacket *packet = (WorldSnapshotPacket *)payload;
+    // Decode straight from the transport buffer; component payloads are
+    // handed out as sub-views of it.
+    PacketReader reader(payload, static_cast<size_t>(payload->GetTotalSize()));
+    WorldSnapshotPacket packet;
+    if (!reader.Read(packet)) {
+      TK_LOG("Snapshot packet is shorter than its header.");
+      return;
+    }
 
-    int entityCount = packet->entityCount;
-    int baseTick = packet->baseTick;
+    int entityCount = packet.entityCount;
 
     if (!m_owner.IsServer()) {
-      SetServerTick(packet->serverTick);
+      SetServerTick(packet.serverTick);
+      m_snapshotClock.OnSnapshot(packet.serverTick);
+
+      // Past the history depth the server no longer encodes against a tick,
+      // so records that old are no baseline anyone depends on.
+      const int oldestTick =
+          packet.serverTick -
+          static_cast<int>(m_owner.GetStateHistoryDepthVal());
+      m_pendingSnapshotRecords.erase(
+          std::remove_if(m_pendingSnapshotRecords.begin(),
+                         m_pendingSnapshotRecords.end(),
+                         [oldestTick](const PendingSnapshotRecord &record) {
+                           return record.serverTick < oldestTick;
+                         }),
+          m_pendingSnapshotRecords.end());
+      m_retiredSnapshotEntities.erase(
+          std::remove_if(m_retiredSnapshotEntities.begin(),
+                         m_retiredSnapshotEntities.end(),
+                         [oldestTick](const RetiredSnapshotEntity &entity) {
+                           return entity.lastTick < oldestTick;
+                         }),
+          m_retiredSnapshotEntities.end());
     }
 
+    // A tick with a record that was not applied must not be acked, or the
+    // server would encode later deltas against state the client never had.
+    bool applied = true;
     for (int i = 0; i < entityCount; i++) {
       int networkID = -1;
-      if (!m_receiveStream.Read(networkID)) {
-        break;
-      }
-
+      int baseTick = -1;
       int packetSize = 0;
-      if (!m_receiveStream.Read(packetSize)) {
+      if (!reader.Read(networkID) || !reader.Read(baseTick) ||
+          !reader.Read(packetSize)) {
+        applied = false;
         break;
       }
 
-      if (!m_receiveStream.CanReadSize(static_cast<size_t>(
-              packetSize < 0 ? 0 : packetSize)) ||
-          packetSize < 0) {
+      PacketReader componentView;
+      if (packetSize < 0 ||
+          !reader.ReadView(static_cast<size_t>(packetSize), componentView)) {
         TK_LOG("Snapshot packet contains invalid component payload size.");
+        applied = false;
         break;
       }
 
       NetworkComponent *targetComponent = FindComponentByNetworkID(networkID);
-      if (targetComponent) {
-        bool isLocallyOwned =
-            !m_owner.IsServer() &&
-            (targetComponent->GetOwnerID() == m_owner.GetLocalPeerID());
-
-        if (!isLocallyOwned) {
-          PacketStream componentStream;
-          componentStream.Write(m_receiveStream.buffer.data() +
-                                    m_receiveStream.readOffset,
-                                static_cast<size_t>(packetSize));
-          targetComponent->Deserialize(componentStream, baseTick);
-        } else {
-          TK_LOG(("Snapshot skipped for locally-owned component: " +
-                  std::to_string(networkID))
-                     .c_str());
+      if (targetComponent == nullptr) {
+        // Snapshots and spawns travel on different channels, so a record can
+        // arrive before the spawn of its entity. The tick is still acked, so
+        // the record is kept and applied once the spawn lands. Only a delta
+        // that can never be applied holds the ack back.
+        if (!m_owner.IsServer() &&
+            !BufferSnapshotRecord(networkID, packet.serverTick, baseTick,
+                                  componentView)) {
+          applied = false;
         }
+        continue;
       }
 
-      if (!m_receiveStream.SkipChecked(packetSize)) {
-        TK_LOG("Snapshot packet overflow while advancing component payload.");
-        break;
+      // Locally owned components reconcile their prediction against it.
+      if (!targetComponent->Deserialize(componentView, packet.serverTick,
+                                        baseTick)) {
+        TK_LOG(("Snapshot record for netID=" + std::to_string(networkID) +
+                " against tick " + std::to_string(baseTick) +
+                " was rejected; tick " + std::to_string(packet.serverTick) +
+                " is not acked.")
+                   .c_str());
+        applied = false;
       }
     }
 
-    if (m_owner.m_client) {
+    if (!applied) {
+      m_snapshotFragmentTracker.Reject(packet.serverTick, packet.fragmentCount);
+    }
+
+    // Only a tick whose fragments all arrived can serve as a delta baseline.
+    if (m_snapshotFragmentTracker.MarkReceived(packet.serverTick,
+                                               packet.fragmentIndex,
+                                               packet.fragmentCount) &&
+        m_owner.m_client) {
       SnapshotAckPacket ack;
-      ack.ackTick = packet->serverTick;
-      m_owner.m_client->SendPacket(ack);
+      ack.ackTick = packet.serverTick;
+      m_owner.m_client->SendPacket(ack, DeliveryChannel::Snapshot);
     }
   } else if (type == NetworkMessage::SnapshotAck) {
     SnapshotAckPacket *ack = (SnapshotAckPacket *)payload;
-    m_peerLastAckedTick[source] = ack->ackTick;
+    m_replicationScheduler.OnAck(source, ack->ackTick);
   } else if (type == NetworkMessage::ClientConnected) {
     if (m_owner.IsServer() && m_owner.m_server) {
       TK_LOG(("Replication server handling ClientConnected for peer=" +
               std::to_string(source) + " existingComponents=" +
-              std::to_string(m_networkComponents.size()))
+              std::to_string(m_networkComponents.Size()))
                  .c_str());
-      for (auto *nc : m_networkComponents) {
-        SpawnPacket msg;
-        msg.networkID = nc->GetNetworkID();
-        msg.ownerID = nc->GetOwnerID();
-
-        if (nc->GetSpawnClassName().empty()) {
-          TK_LOG("Warning: Replicating object with no SpanwClassName!");
-          continue;
-        }
-
-        strncpy(msg.className, nc->GetSpawnClassName().c_str(), 127);
+      // With interest management, spawns follow relevancy instead.
+      if (!m_interestManager.IsEnabled()) {
+        for (auto *nc : m_networkComponents.Items()) {
+          if (nc->GetSpawnClassName().empty()) {
+            TK_LOG("Warning: Replicating object with no SpanwClassName!");
+            continue;
+          }
 
-        if (auto ent = nc->GetEntity()) {
-          if (ent->m_scene.lock() == nullptr) {
+          SpawnPacket msg;
+          if (!BuildSpawnPacket(nc, msg)) {
             continue;
           }
 
-          Vec3 p = ent->m_node->GetTranslation();
-          Quaternion r = ent->m_node->GetOrientation();
-          msg.px = p.x;
-          msg.py = p.y;
-          msg.pz = p.z;
-          msg.rx = r.x;
-          msg.ry = r.y;
-          msg.rz = r.z;
-          msg.rw = r.w;
-        } else {
-          continue;
+          m_owner.m_server->SendPacketToPeer(source, msg,
+                                             DeliveryChannel::Lifecycle);
+          TK_LOG(("Replication server replayed spawn to peer=" +
+                  std::to_string(source) + " netID=" +
+                  std::to_string(msg.networkID) + " owner=" +
+                  std::to_string(msg.ownerID) + " class=" + msg.className)
+                     .c_str());
         }
-
-        m_owner.m_server->SendPacketToPeer(source, msg, true);
-        TK_LOG(("Replication server replayed spawn to peer=" +
-                std::to_string(source) + " netID=" +
-                std::to_string(msg.networkID) + " owner=" +
-                std::to_string(msg.ownerID) + " class=" + msg.className)
-                   .c_str());
       }
 
       if (m_owner.GetPlayerPrefabVal()) {
@@ -885,6 +984,8 @@ void ReplicationManager::ReceivePacket(int type, GamePacket *payload, int source
     HandleSpawnPacket(*static_cast<SpawnPacket *>(payload));
   } else if (type == NetworkMessage::Despawn) {
     DespawnPacket *p = (DespawnPacket *)payload;
+    // Snapshots sent before the despawn may still be in flight.
+    RetireSnapshotEntity(p->networkID, GetServerTick());
     if (NetworkComponent *target = FindComponentByNetworkID(p->networkID)) {
       if (auto ent = target->GetEntity()) {
         if (GetSceneManager()->GetCurrentScene()) {
@@ -893,37 +994,30 @@ void ReplicationManager::ReceivePacket(int type, GamePacket *payload, int source
         }
       }
     }
-  } else if (type == NetworkMessage::ClientUpdate) {
+  } else if (type == NetworkMessage::InputCommands) {
     if (m_owner.IsServer()) {
-      ClientUpdatePacket *p = (ClientUpdatePacket *)payload;
-      NetworkComponent *target = FindComponentByNetworkID(p->networkID);
+      InputCommandPacket *p = (InputCommandPacket *)payload;
+      if (!p->IsValid()) {
+        TK_LOG("Input packet has an invalid command count.");
+        return;
+      }
 
+      NetworkComponent *target = FindComponentByNetworkID(p->networkID);
       if (target && target->GetOwnerID() == source) {
-        if (auto ent = target->GetEntity()) {
-          ent->m_node->SetTranslation(Vec3(p->px, p->py, p->pz));
-          ent->m_node->SetOrientation(Quaternion(p->rw, p->rx, p->ry, p->rz));
-        }
+        target->QueueInputs(p->commands, static_cast<size_t>(p->commandCount));
       }
     }
   } else if (type == NetworkMessage::RPC) {
+    if (static_cast<size_t>(payload->GetTotalSize()) < sizeof(RPCPacket)) {
+      TK_LOG("RPC packet is shorter than its header.");
+      return;
+    }
     RPCPacket *packet = (RPCPacket *)payload;
 
     m_receiveStream.Clear();
     m_receiveStream.Write((void *)payload, payload->GetTotalSize());
     m_receiveStream.readOffset = sizeof(RPCPacket);
 
-    {
-      std::string log =
-          "RPC Recv: netID=" + std::to_string(packet->networkID) +
-          " hash=" + std::to_string(packet->functionHash) +
-          " numComponents=" + std::to_string(m_networkComponents.size());
-      TK_LOG(log.c_str());
-      for (auto *nc : m_networkComponents) {
-        TK_LOG(("  - Component ID: " + std::to_string(nc->GetNetworkID()))
-                   .c_str());
-      }
-    }
-
     NetworkComponent *targetComponent =
         FindComponentByNetworkID(packet->networkID);
     if (targetComponent) {
@@ -937,111 +1031,523 @@ void ReplicationManager::ReceivePacket(int type, GamePacket *payload, int source
         return;
       }
 
-      TK_LOG(("RPC Dispatch: found target, calling HandleRPC hash=" +
-              std::to_string(packet->functionHash))
-                 .c_str());
-      targetComponent->HandleRPC(packet->functionHash, m_receiveStream);
+      if (!targetComponent->HandleRPC(packet->functionHash, m_receiveStream)) {
+        TK_LOG(("RPC dropped: unknown hash or malformed arguments. hash=" +
+                std::to_string(packet->functionHash))
+                   .c_str());
+      }
+    } else if (!m_owner.IsServer() &&
+               m_pendingRpcs.size() < MaxPendingRpcs) {
+      // RPCs and spawns travel on different channels, so an RPC can arrive
+      // before the spawn of its target. Hold it until the spawn shows up.
+      const char *bytes = reinterpret_cast<const char *>(payload);
+      m_pendingRpcs.push_back(
+          {packet->networkID,
+           std::vector<char>(bytes, bytes + payload->GetTotalSize())});
     } else {
       TK_LOG("RPC Dispatch: no target component found!");
     }
   }
 }
 
-void ReplicationManager::BroadcastSnapshot() {
-  if (!m_owner.m_server) {
+void ReplicationManager::ReplayPendingRpcs(int networkID) {
+  if (m_pendingRpcs.empty()) {
     return;
   }
 
-  int currentTick = m_owner.m_server->GetServerTick();
+  std::vector<PendingRpc> pending = std::move(m_pendingRpcs);
+  m_pendingRpcs.clear();
+  for (PendingRpc &rpc : pending) {
+    if (rpc.networkID == networkID) {
+      GamePacket *packet = reinterpret_cast<GamePacket *>(rpc.bytes.data());
+      ReceivePacket(packet->type, packet, -1);
+    } else {
+      m_pendingRpcs.push_back(std::move(rpc));
+    }
+  }
+}
 
-  if (!m_owner.m_useDeltaCompression) {
-    m_sendStream.Clear();
+bool ReplicationManager::BufferSnapshotRecord(int networkID, int serverTick,
+                                              int baseTick,
+                                              const PacketReader &record) {
+  auto retired = std::find_if(
+      m_retiredSnapshotEntities.begin(), m_retiredSnapshotEntities.end(),
+      [networkID](const RetiredSnapshotEntity &entity) {
+        return entity.networkID == networkID;
+      });
+  if (retired != m_retiredSnapshotEntities.end()) {
+    retired->lastTick = std::max(retired->lastTick, serverTick);
+    return true;
+  }
+
+  size_t entityRecords = 0;
+  bool hasBaseline = baseTick == -1;
+  for (const PendingSnapshotRecord &pending : m_pendingSnapshotRecords) {
+    if (pending.networkID == networkID) {
+      ++entityRecords;
+      hasBaseline = hasBaseline || pending.serverTick == baseTick;
+    }
+  }
 
-    WorldSnapshotPacket header;
-    header.type = NetworkMessage::Snapshot;
-    header.size = 0;
-    header.serverTick = currentTick;
-    header.baseTick = -1;
-    header.entityCount = (int)m_networkComponents.size();
-    m_sendStream.Write(header);
+  if (!hasBaseline) {
+    TK_LOG(("Snapshot record for unknown netID=" + std::to_string(networkID) +
+            " against unbuffered tick " + std::to_string(baseTick) +
+            " dropped; tick " + std::to_string(serverTick) +
+            " is not acked.")
+               .c_str());
+    return false;
+  }
 
-    for (auto *networkComponent : m_networkComponents) {
-      networkComponent->Serialize(m_sendStream, -1);
+  if (baseTick == -1) {
+    // A full record makes everything buffered before it for the entity moot.
+    m_pendingSnapshotRecords.erase(
+        std::remove_if(m_pendingSnapshotRecords.begin(),
+                       m_pendingSnapshotRecords.end(),
+                       [networkID](const PendingSnapshotRecord &pending) {
+                         return pending.networkID == networkID;
+                       }),
+        m_pendingSnapshotRecords.end());
+    entityRecords = 0;
+  } else if (entityRecords >= MaxPendingSnapshotRecordsPerEntity) {
+    TK_LOG(("Too many snapshot records for unknown netID=" +
+            std::to_string(networkID) + "; its records are dropped.")
+               .c_str());
+    RetireSnapshotEntity(networkID, serverTick);
+    return true;
+  }
 
-      if (auto ent = networkComponent->GetEntity()) {
-        Vec3 pos = ent->m_node->GetTranslation();
-        String log = "Server Broadcast NetID: " +
-                     std::to_string(networkComponent->GetNetworkID()) +
-                     " Pos: " + std::to_string(pos.x) + ", " +
-                     std::to_string(pos.y) + ", " + std::to_string(pos.z);
-        TK_LOG(log.c_str());
+  if (entityRecords == 0) {
+    std::vector<int> pendingEntities;
+    for (const PendingSnapshotRecord &pending : m_pendingSnapshotRecords) {
+      if (std::find(pendingEntities.begin(), pendingEntities.end(),
+                    pending.networkID) == pendingEntities.end()) {
+        pendingEntities.push_back(pending.networkID);
       }
     }
 
-    size_t totalSize = m_sendStream.GetSize();
-    WorldSnapshotPacket *packetHeader =
-        (WorldSnapshotPacket *)m_sendStream.GetData();
-    packetHeader->size = (short)(totalSize - sizeof(GamePacket));
+    // The entity that has waited longest for its spawn makes room.
+    if (pendingEntities.size() >= MaxPendingSnapshotEntities) {
+      TK_LOG(("Too many unspawned entities in snapshots; records for netID=" +
+              std::to_string(pendingEntities.front()) + " are dropped.")
+                 .c_str());
+      RetireSnapshotEntity(pendingEntities.front(), serverTick);
+    }
+  }
+
+  m_pendingSnapshotRecords.push_back(
+      {networkID, serverTick, baseTick,
+       std::vector<char>(record.GetData(),
+                         record.GetData() + record.GetSize())});
+  return true;
+}
 
-    m_owner.m_server->SendGlobalPacket(
-        *reinterpret_cast<GamePacket *>(m_sendStream.GetData()), false);
+void ReplicationManager::RetireSnapshotEntity(int networkID, int tick) {
+  m_pendingSnapshotRecords.erase(
+      std::remove_if(m_pendingSnapshotRecords.begin(),
+                     m_pendingSnapshotRecords.end(),
+                     [networkID](const PendingSnapshotRecord &record) {
+                       return record.networkID == networkID;
+                     }),
+      m_pendingSnapshotRecords.end());
+
+  auto retired = std::find_if(
+      m_retiredSnapshotEntities.begin(), m_retiredSnapshotEntities.end(),
+      [networkID](const RetiredSnapshotEntity &entity) {
+        return entity.networkID == networkID;
+      });
+  if (retired != m_retiredSnapshotEntities.end()) {
+    retired->lastTick = std::max(retired->lastTick, tick);
   } else {
-    for (int peerID : m_owner.m_server->GetConnectedPeers()) {
-      int baseTick = -1;
-      if (m_peerLastAckedTick.count(peerID)) {
-        baseTick = m_peerLastAckedTick[peerID];
+    m_retiredSnapshotEntities.push_back({networkID, tick});
+  }
+}
+
+void ReplicationManager::ReplayPendingSnapshotRecords(
+    NetworkComponent *component) {
+  if (m_pendingSnapshotRecords.empty()) {
+    return;
+  }
+
+  // In arrival order, so each delta finds the baseline stored before it.
+  std::vector<PendingSnapshotRecord> pending =
+      std::move(m_pendingSnapshotRecords);
+  m_pendingSnapshotRecords.clear();
+  for (PendingSnapshotRecord &record : pending) {
+    if (record.networkID != component->GetNetworkID()) {
+      m_pendingSnapshotRecords.push_back(std::move(record));
+      continue;
+    }
+
+    PacketReader reader(record.bytes.data(), record.bytes.size());
+    if (!component->Deserialize(reader, record.serverTick, record.baseTick)) {
+      TK_LOG(("Buffered snapshot record for netID=" +
+              std::to_string(record.networkID) + " at tick " +
+              std::to_string(record.serverTick) + " could not be applied.")
+                 .c_str());
+    }
+  }
+}
+
+bool ReplicationManager::BuildSpawnPacket(NetworkComponent *component,
+                                          SpawnPacket &outPacket) const {
+  if (component->GetSpawnClassName().empty()) {
+    return false;
+  }
+
+  auto entity = component->GetEntity();
+  if (!entity || entity->m_scene.lock() == nullptr) {
+    return false;
+  }
+
+  outPacket.networkID = component->GetNetworkID();
+  outPacket.ownerID = component->GetOwnerID();
+  strncpy(outPacket.className, component->GetSpawnClassName().c_str(), 127);
+
+  Vec3 p = entity->m_node->GetTranslation();
+  Quaternion r = entity->m_node->GetOrientation();
+  outPacket.px = p.x;
+  outPacket.py = p.y;
+  outPacket.pz = p.z;
+  outPacket.rx = r.x;
+  outPacket.ry = r.y;
+  outPacket.rz = r.z;
+  outPacket.rw = r.w;
+  return true;
+}
+
+void ReplicationManager::CollectInterestedPeers(
+    int networkID, std::vector<TransportPeerId> &outPeers) const {
+  outPeers.clear();
+  for (TransportPeerId peerID : m_owner.m_server->GetConnectedPeers()) {
+    if (m_interestManager.IsRelevantByID(peerID, networkID)) {
+      outPeers.push_back(peerID);
+    }
+  }
+}
+
+void ReplicationManager::UpdateInterest() {
+  const ReplicationFrame &frame = m_replicationFrames[m_frontFrame];
+  const TransformFrame &transforms = m_transformCache.GetCurrent();
+  m_interestEntities.resize(frame.Size());
+  for (size_t i = 0; i < frame.Size(); ++i) {
+    InterestEntity &info = m_interestEntities[i];
+    info.networkID = frame.networkIDs[i];
+    info.ownerID = frame.ownerIDs[i];
+    info.hasPosition = transforms.present[i] != 0;
+    if (info.hasPosition) {
+      info.position = transforms.GetPosition(i);
+    }
+  }
+
+  // Only authenticated peers are told about the world.
+  m_interestPeers.clear();
+  for (TransportPeerId peerID : m_owner.m_server->GetConnectedPeers()) {
+    if (IsPeerAuthenticated(peerID)) {
+      m_interestPeers.push_back(peerID);
+    }
+  }
+  m_interestManager.Update(m_interestEntities, m_interestPeers);
+
+  for (TransportPeerId peerID : m_interestPeers) {
+    for (int networkID : m_interestManager.GetEntered(peerID)) {
+      SpawnPacket packet;
+      NetworkComponent *component = FindComponentByNetworkID(networkID);
+      if (component && BuildSpawnPacket(component, packet)) {
+        m_owner.m_server->SendPacketToPeer(peerID, packet,
+                                           DeliveryChannel::Lifecycle);
+      }
+    }
+
+    for (int networkID : m_interestManager.GetLeft(peerID)) {
+      // The peer's copy is destroyed; if it comes back it needs full state.
+      m_replicationScheduler.ForgetEntity(peerID, networkID);
+      NetworkComponent *component = FindComponentByNetworkID(networkID);
+      if (component && !component->GetSpawnClassName().empty()) {
+        DespawnPacket packet;
+        packet.networkID = networkID;
+        m_owner.m_server->SendPacketToPeer(peerID, packet,
+                                           DeliveryChannel::Lifecycle);
       }
-      SendSnapshotToPeer(peerID, baseTick);
     }
   }
 }
 
-void ReplicationManager::SendSnapshotToPeer(int peerID, int baseTick) {
+void ReplicationManager::BroadcastSnapshot() {
   if (!m_owner.m_server) {
     return;
   }
 
-  m_sendStream.Clear();
+  const ReplicationFrame &frame = m_replicationFrames[m_frontFrame];
+  m_snapshotEncoder.BeginTick(frame, m_transformCache);
+  if (m_interestManager.IsEnabled()) {
+    UpdateInterest();
+  }
+
+  m_scheduledEntities.resize(frame.Size());
+  for (size_t i = 0; i < frame.Size(); ++i) {
+    ReplicationEntityInfo &info = m_scheduledEntities[i];
+    info.networkID = frame.networkIDs[i];
+    info.basePriority = frame.priorities[i];
+    info.updateInterval = frame.updateIntervals[i];
+  }
+
+  ReplicationScheduler::ScheduleSettings settings;
+  settings.currentTick = frame.tick;
+  settings.historyDepth = static_cast<int>(m_owner.GetStateHistoryDepthVal());
+  settings.useDeltaBaselines = m_owner.m_useDeltaCompression;
+  settings.byteBudget = m_owner.GetSnapshotByteBudgetVal();
+
+  m_replicationScheduler.Schedule(
+      m_owner.m_server->GetConnectedPeers(), m_scheduledEntities, settings,
+      [this](int entityIndex, int baseTick) {
+        return m_snapshotEncoder.EncodeRecord(entityIndex, baseTick).size();
+      },
+      m_interestManager.IsEnabled() ? &m_interestManager : nullptr,
+      m_scheduledSnapshots);
 
-  WorldSnapshotPacket header;
-  header.type = NetworkMessage::Snapshot;
-  header.size = 0;
-  header.serverTick = m_owner.m_server->GetServerTick();
-  header.baseTick = baseTick;
-  header.entityCount = (int)m_networkComponents.size();
-  m_sendStream.Write(header);
+  m_encodePool.SetThreadCount(m_owner.GetSnapshotEncodeThreadsVal());
+  m_snapshotsPending = true;
+  if (m_owner.GetAsyncSnapshotEncodingVal()) {
+    // Sent by the next update, once this frame's job is done.
+    m_encodeThread.Start([this]() { EncodeScheduledSnapshots(); });
+  } else {
+    EncodeScheduledSnapshots();
+    FinishSnapshotEncode();
+  }
+}
 
-  for (auto *networkComponent : m_networkComponents) {
-    networkComponent->Serialize(m_sendStream, baseTick);
+void ReplicationManager::EncodeScheduledSnapshots() {
+  m_snapshotEncoder.EncodeSnapshots(
+      m_scheduledSnapshots, SnapshotFragmenter::DefaultMaxFragmentBytes,
+      m_encodePool, m_snapshotFragments);
+}
+
+void ReplicationManager::FinishSnapshotEncode() {
+  m_encodeThread.Wait();
+  if (!m_snapshotsPending) {
+    return;
+  }
+  m_snapshotsPending = false;
 
-    if (auto ent = networkComponent->GetEntity()) {
-      Vec3 pos = ent->m_node->GetTranslation();
-      String log =
-          "Server Send to Peer(" + std::to_string(peerID) +
-          ") NetID: " + std::to_string(networkComponent->GetNetworkID()) +
-          " Pos: " + std::to_string(pos.x) + ", " + std::to_string(pos.y) +
-          ", " + std::to_string(pos.z);
-      TK_LOG(log.c_str());
+  m_snapshotEncoder.TakeProblems(m_encodeProblems);
+  for (int networkID : m_encodeProblems.oversizedIDs) {
+    TK_LOG(("Snapshot record for netID=" + std::to_string(networkID) +
+            " exceeds the packet size limit and was dropped.")
+               .c_str());
+  }
+  if (m_encodeProblems.overFragmentLimit > 0) {
+    TK_LOG("Snapshot exceeds the fragment limit; trailing entities were not "
+           "sent this tick.");
+  }
+  for (const SnapshotEncoder::DroppedRecord &dropped :
+       m_encodeProblems.droppedRecords) {
+    m_replicationScheduler.ClearSent(
+        m_scheduledSnapshots[dropped.snapshotIndex].peers, dropped.networkID,
+        m_snapshotEncoder.GetCurrentTick());
+  }
+
+  if (!m_owner.m_server) {
+    return;
+  }
+  for (size_t i = 0; i < m_scheduledSnapshots.size(); ++i) {
+    const ScheduledSnapshot &snapshot = m_scheduledSnapshots[i];
+    for (PacketStream &fragment : m_snapshotFragments[i]) {
+      m_owner.m_server->SendPacketToPeers(
+          snapshot.peers, *reinterpret_cast<GamePacket *>(fragment.GetData()),
+          DeliveryChannel::Snapshot);
     }
   }
+}
+
+void ReplicationManager::CaptureReplicationFrame() {
+  const std::vector<NetworkComponent *> &components =
+      m_networkComponents.Items();
+  ReplicationFrame &frame = m_replicationFrames[m_frontFrame ^ 1];
+  frame.Begin(m_owner.m_server->GetServerTick(), components.size());
+  frame.spawned.swap(m_pendingSpawned);
+  frame.despawned.swap(m_pendingDespawned);
+
+  for (size_t i = 0; i < components.size(); ++i) {
+    NetworkComponent *nc = components[i];
+    EntityPtr entity = nc->GetEntity();
+    const bool hasTransform = entity && entity->m_node;
+    if (hasTransform) {
+      frame.transforms.Set(i, nc->GetNetworkID(),
+                           entity->m_node->GetTranslation(),
+                           entity->m_node->GetOrientation());
+    } else {
+      frame.transforms.SetMissing(i, nc->GetNetworkID());
+    }
+    nc->CaptureReplication(frame, hasTransform);
+  }
+}
+
+void ReplicationManager::PublishReplicationFrame() {
+  m_frontFrame ^= 1;
+  ReplicationFrame &frame = m_replicationFrames[m_frontFrame];
+
+  const size_t depth = (std::max)(1u, m_owner.GetStateHistoryDepthVal());
+  if (m_transformCache.GetCapacity() != depth) {
+    m_transformCache.SetCapacity(depth);
+  }
+  m_transformCache.CommitFrame(frame.transforms);
 
-  size_t totalSize = m_sendStream.GetSize();
-  WorldSnapshotPacket *packetHeader =
-      (WorldSnapshotPacket *)m_sendStream.GetData();
-  packetHeader->size = (short)(totalSize - sizeof(GamePacket));
+  for (int networkID : frame.despawned) {
+    m_replicationScheduler.RemoveEntity(networkID);
+    m_interestManager.RemoveEntity(networkID);
+  }
+}
+
+void ReplicationManager::RecordLagCompensation() {
+  const size_t depth = (std::max)(1u, m_owner.GetStateHistoryDepthVal());
+  if (m_lagCompensation.GetCapacity() != depth) {
+    m_lagCompensation.SetCapacity(depth);
+  }
+
+  LagCompensationFrame &frame = m_lagCompensation.BeginFrame(
+      m_owner.m_server->GetServerTick(), m_serverTime);
+  const TransformFrame &transforms = m_transformCache.GetCurrent();
+  const std::vector<NetworkComponent *> &components =
+      m_networkComponents.Items();
+  for (size_t i = 0; i < components.size(); ++i) {
+    NetworkComponent *nc = components[i];
+    if (!nc->HasHitBounds() || transforms.present[i] == 0) {
+      continue;
+    }
 
-  m_owner.m_server->SendPacketToPeer(
-      peerID, *reinterpret_cast<GamePacket *>(m_sendStream.GetData()), false);
+    frame.Add(nc->GetNetworkID(), transforms.GetPosition(i),
+              transforms.GetOrientation(i), nc->GetHitBoundsMin(),
+              nc->GetHitBoundsMax());
+  }
+  m_lagCompensation.EndFrame();
+}
+
+const LagCompensationFrame *
+ReplicationManager::RewindForPeer(TransportPeerId peerID) {
+  if (!m_owner.m_server || !m_owner.GetEnableLagCompensationVal() ||
+      m_lagCompensation.GetNewestTick() < 0) {
+    return nullptr;
+  }
+
+  const int serverTick = m_owner.m_server->GetServerTick();
+  if (peerID == m_rewoundPeer && serverTick == m_rewoundAtTick) {
+    return &m_rewoundFrame;
+  }
+
+  // Without a usable ack the newest tick is the best guess.
+  const int ackedTick = m_replicationScheduler.GetLastAckedTick(peerID);
+  double viewTick = m_lagCompensation.ResolveViewTick(
+      ackedTick, m_owner.GetNetworkSettings().bufferTime);
+  if (viewTick < 0.0) {
+    viewTick = ackedTick >= 0 && ackedTick < m_lagCompensation.GetOldestTick()
+                   ? m_lagCompensation.GetOldestTick()
+                   : m_lagCompensation.GetNewestTick();
+  }
+
+  const InterestManager *interest =
+      m_interestManager.IsEnabled() ? &m_interestManager : nullptr;
+  if (!m_lagCompensation.Rewind(viewTick, peerID, interest, m_rewoundFrame)) {
+    return nullptr;
+  }
+
+  m_rewoundPeer = peerID;
+  m_rewoundAtTick = serverTick;
+  return &m_rewoundFrame;
+}
+
+bool ReplicationManager::BeginLagCompensation(TransportPeerId peerID) {
+  EndLagCompensation();
+
+  const LagCompensationFrame *frame = RewindForPeer(peerID);
+  if (frame == nullptr) {
+    return false;
+  }
+
+  for (size_t i = 0; i < frame->Size(); ++i) {
+    NetworkComponent *nc = FindComponentByNetworkID(frame->networkIDs[i]);
+    EntityPtr entity = nc ? nc->GetEntity() : nullptr;
+    if (!entity || !entity->m_node) {
+      continue;
+    }
+
+    m_rewoundComponents.push_back(nc);
+    m_savedPositions.push_back(entity->m_node->GetTranslation());
+    m_savedOrientations.push_back(entity->m_node->GetOrientation());
+    entity->m_node->SetTranslation(frame->positions[i]);
+    entity->m_node->SetOrientation(frame->orientations[i]);
+  }
+  return true;
+}
+
+void ReplicationManager::EndLagCompensation() {
+  for (size_t i = 0; i < m_rewoundComponents.size(); ++i) {
+    EntityPtr entity = m_rewoundComponents[i]->GetEntity();
+    if (entity && entity->m_node) {
+      entity->m_node->SetTranslation(m_savedPositions[i]);
+      entity->m_node->SetOrientation(m_savedOrientations[i]);
+    }
+  }
+
+  m_rewoundComponents.clear();
+  m_savedPositions.clear();
+  m_savedOrientations.clear();
 }
 
 void ReplicationManager::UpdateAsServer(float deltaTime) {
-  (void)deltaTime;
+  m_interestManager.SetRadius(m_owner.GetRelevancyRadiusVal());
+
+  m_owner.m_server->UpdateServer();
+  // With async encoding the previous snapshot was encoded while the game
+  // ran; it goes out before a new tick replaces its frame.
+  FinishSnapshotEncode();
+
+  FixedTickScheduler::Settings tickSettings;
+  tickSettings.tickRate = m_owner.GetServerTickRateVal();
+  tickSettings.snapshotRate = m_owner.GetSnapshotSendRateVal();
+  tickSettings.maxCatchUpTicks = m_owner.GetMaxCatchUpTicksVal();
+  m_tickScheduler.Configure(tickSettings);
+
+  const uint64_t droppedBefore = m_tickScheduler.GetDroppedTicks();
+  const FixedTickScheduler::Steps steps = m_tickScheduler.Advance(deltaTime);
+  if (m_tickScheduler.GetDroppedTicks() != droppedBefore) {
+    TK_LOG(("Server fell behind; skipped " +
+            std::to_string(m_tickScheduler.GetDroppedTicks() - droppedBefore) +
+            " ticks.")
+               .c_str());
+  }
 
-  if (m_owner.m_server) {
-    m_owner.m_server->UpdateServer();
+  const double interval = m_tickScheduler.GetTickInterval();
+  const double tickSeconds = interval > 0.0 ? interval : deltaTime;
+  for (uint32_t tick = 0; tick < steps.ticks; ++tick) {
+    m_serverTime += tickSeconds;
+    m_owner.m_server->AdvanceServerTick();
+    // Catch-up ticks share one snapshot, sent after the last of them.
+    SimulateServerTick(static_cast<float>(tickSeconds),
+                       steps.sendSnapshot && tick + 1 == steps.ticks);
+  }
+
+  m_owner.m_server->FlushOutgoing();
+}
+
+void ReplicationManager::SimulateServerTick(float tickSeconds,
+                                            bool sendSnapshot) {
+  // Inputs received this update move their entities before the tick is
+  // recorded and sent, so the snapshot acks exactly what it shows. Owners
+  // get no more input time than the tick lasted.
+  for (auto *nc : m_networkComponents.Items()) {
+    nc->ProcessInputs(tickSeconds);
   }
+  CaptureReplicationFrame();
 
-  BroadcastSnapshot();
+  FinishSnapshotEncode();
+  PublishReplicationFrame();
+  if (m_owner.GetEnableLagCompensationVal()) {
+    RecordLagCompensation();
+  }
+
+  if (sendSnapshot) {
+    BroadcastSnapshot();
+  }
 }
 
 void ReplicationManager::UpdateAsClient(float deltaTime) {
@@ -1057,18 +1563,58 @@ void ReplicationManager::UpdateAsClient(float deltaTime) {
     return;
   }
 
-  m_clientUpdateTimer += deltaTime;
-  if (m_clientUpdateTimer >= 0.05f) {
-    m_clientUpdateTimer = 0.0f;
-    for (auto *nc : m_networkComponents) {
-      if (nc->IsLocalPlayer()) {
-        SendClientUpdate(nc);
+  if (!m_owner.IsServer()) {
+    UpdateInterpolation(deltaTime);
+  }
+
+  // Inputs go out as soon as there are new ones; every packet repeats the
+  // unacked ones, so loss only delays them.
+  if (!m_owner.IsServer()) {
+    for (auto *nc : m_networkComponents.Items()) {
+      if (nc->IsLocalPlayer() && nc->GetPredictionBuffer().HasUnsentInput()) {
+        SendInputCommands(nc);
       }
     }
   }
+
+  m_owner.m_client->FlushOutgoing();
+}
+
+void ReplicationManager::UpdateInterpolation(float deltaTime) {
+  const NetworkSettings settings = m_owner.GetNetworkSettings();
+  const double renderTick =
+      m_snapshotClock.Advance(deltaTime, settings.bufferTime);
+  if (!settings.enableInterpolation || renderTick < 0.0) {
+    return;
+  }
+
+  const double maxExtrapolationTicks =
+      settings.enableExtrapolation
+          ? settings.maxExtrapolationTime / m_snapshotClock.GetSecondsPerTick()
+          : 0.0;
+  for (auto *nc : m_networkComponents.Items()) {
+    nc->ApplyInterpolation(renderTick, maxExtrapolationTicks);
+  }
+}
+
+void ReplicationManager::FlushThrottledRpcs() {
+  if (!m_rpcThrottle.HasQueued()) {
+    return;
+  }
+
+  m_rpcThrottle.Flush(m_rpcClock, [this](const RPCThrottle::QueuedRpc &rpc) {
+    // The payload buffer is reused; routing only reads from it.
+    GamePacket *packet = reinterpret_cast<GamePacket *>(
+        const_cast<char *>(rpc.payload.data()));
+    DeliverRpc(packet, static_cast<RPCReceiver>(rpc.key.receiver),
+               rpc.ownerID, rpc.channel);
+  });
 }
 
 void ReplicationManager::Update(float deltaTime) {
+  m_rpcClock += deltaTime;
+  FlushThrottledRpcs();
+
   if (m_owner.m_server) {
     UpdateAsServer(deltaTime);
   }
@@ -1089,31 +1635,55 @@ int ReplicationManager::GetServerTick() const {
 void ReplicationManager::SetServerTick(int tick) { m_currentServerTick = tick; }
 
 void ReplicationManager::SendRPCPacket(PacketStream &rpcStream,
-                                       RPCReceiver target, int ownerID) {
+                                       RPCReceiver target, int ownerID,
+                                       const RPCSendPolicy &policy) {
   GamePacket *packet = reinterpret_cast<GamePacket *>(rpcStream.GetData());
 
-  TK_LOG(("SendRPCPacket: isServer=" + std::to_string(m_owner.IsServer()) +
-          " hasClient=" + std::to_string(m_owner.m_client != nullptr) +
-          " target=" + std::to_string((int)target))
-             .c_str());
+  if (policy.IsThrottled()) {
+    const RPCPacket *rpc = static_cast<RPCPacket *>(packet);
+    const RPCThrottleKey key{rpc->networkID, rpc->functionHash,
+                             static_cast<uint8_t>(target)};
+    if (m_rpcThrottle.Submit(key, policy, ownerID, rpcStream.GetData(),
+                             rpcStream.GetSize(),
+                             m_rpcClock) != RPCThrottleResult::Send) {
+      return;
+    }
+  }
+
+  DeliverRpc(packet, target, ownerID, policy.channel);
+}
 
+void ReplicationManager::DeliverRpc(GamePacket *packet, RPCReceiver target,
+                                    int ownerID, DeliveryChannel channel) {
   if (m_owner.IsServer() && m_owner.m_server) {
     if (target == RPCReceiver::Server) {
       ReceivePacket(packet->type, packet, -1);
     } else if (target == RPCReceiver::All) {
-      m_owner.m_server->SendGlobalPacket(*packet, true);
+      if (m_interestManager.IsEnabled()) {
+        CollectInterestedPeers(static_cast<RPCPacket *>(packet)->networkID,
+                               m_interestPeers);
+        m_owner.m_server->SendPacketToPeers(m_interestPeers, *packet, channel);
+      } else {
+        m_owner.m_server->SendGlobalPacket(*packet, channel);
+      }
       ReceivePacket(packet->type, packet, -1);
     } else if (target == RPCReceiver::Owner) {
       if (m_owner.GetLocalPeerID() == ownerID) {
         ReceivePacket(packet->type, packet, -1);
       } else if (ownerID != -1) {
-        m_owner.m_server->SendPacketToPeer(ownerID, *packet, true);
+        m_owner.m_server->SendPacketToPeer(ownerID, *packet, channel);
       }
     } else if (target == RPCReceiver::Others) {
-      m_owner.m_server->SendGlobalPacket(*packet, true);
+      if (m_interestManager.IsEnabled()) {
+        CollectInterestedPeers(static_cast<RPCPacket *>(packet)->networkID,
+                               m_interestPeers);
+        m_owner.m_server->SendPacketToPeers(m_interestPeers, *packet, channel);
+      } else {
+        m_owner.m_server->SendGlobalPacket(*packet, channel);
+      }
     }
   } else if (m_owner.m_client) {
-    m_owner.m_client->SendPacket(*packet, true);
+    m_owner.m_client->SendPacket(*packet, channel);
   }
 }
 } // namespace ToolKit::ToolKitNetworking
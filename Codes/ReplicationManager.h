@@ -1,9 +1,18 @@
 #pragma once
 
+#include "FixedTickScheduler.h"
 #include "HandshakeSecurity.h"
+#include "InterestManager.h"
+#include "LagCompensation.h"
 #include "NetworkComponent.h"
+#include "NetworkIdRegistry.h"
 #include "NetworkPackets.h"
 #include "NetworkSessionTypes.h"
+#include "RPCThrottle.h"
+#include "ReplicationScheduler.h"
+#include "SnapshotEncoder.h"
+#include "SnapshotInterpolation.h"
+#include "TransformCache.h"
 #include <functional>
 #include <map>
 #include <vector>
@@ -24,13 +33,16 @@ public:
                                        int ownerID, const Vec3 &pos,
                                        const Quaternion &rot);
   void DespawnNetworkObject(NetworkComponent *component);
-  void SendClientUpdate(NetworkComponent *component);
+  void SendInputCommands(NetworkComponent *component);
   void ReceivePacket(int type, GamePacket *payload, int source);
   void Update(float deltaTime);
 
   int GetServerTick() const;
   void SetServerTick(int tick);
-  void SendRPCPacket(PacketStream &rpcStream, RPCReceiver target, int ownerID);
+  // Rate limits and coalescing in `policy` apply before the transport;
+  // coalesced RPCs go out on the next Update().
+  void SendRPCPacket(PacketStream &rpcStream, RPCReceiver target, int ownerID,
+                     const RPCSendPolicy &policy = RPCSendPolicy());
   bool BeginSessionHandshake(const SessionJoinRequest &request);
   bool IsSessionAuthenticated() const;
   bool HasSessionAuthFailed() const;
@@ -38,11 +50,45 @@ public:
   const String &GetSessionAuthFailureDetail() const;
   void SetClockNowProvider(std::function<uint64_t()> clockNowProvider);
 
+  // Lag compensation (server). The hittable world as `peerID` saw it: its
+  // newest acked tick minus the interpolation delay. Rewinds at most once per
+  // peer and tick; returns nullptr when lag compensation is off or nothing is
+  // recorded yet.
+  const LagCompensationFrame *RewindForPeer(TransportPeerId peerID);
+  // Moves the live entities to RewindForPeer() transforms so engine queries
+  // see the past; EndLagCompensation() puts them back.
+  bool BeginLagCompensation(TransportPeerId peerID);
+  void EndLagCompensation();
+
 private:
   struct PeerHandshakeState {
     HandshakeSecurity::PeerHandshakeGateState gate;
   };
 
+  struct PendingRpc {
+    int networkID;
+    std::vector<char> bytes;
+  };
+  static constexpr size_t MaxPendingRpcs = 64;
+
+  struct PendingSnapshotRecord {
+    int networkID;
+    int serverTick;
+    int baseTick;
+    std::vector<char> bytes;
+  };
+  // Entities with buffered records, and records kept per entity. An entity
+  // past either limit is dropped like one whose spawn failed.
+  static constexpr size_t MaxPendingSnapshotEntities = 64;
+  static constexpr size_t MaxPendingSnapshotRecordsPerEntity = 64;
+
+  // An entity whose records are ignored: it was despawned or failed to
+  // spawn. Forgotten once no record for it arrived within the history depth.
+  struct RetiredSnapshotEntity {
+    int networkID;
+    int lastTick;
+  };
+
   NetworkComponent *InstantiateNetworkObject(const std::string &typeOrPath,
                                              EntityPtr &outEntity);
   NetworkComponent *FindComponentByNetworkID(int networkID) const;
@@ -61,30 +107,97 @@ private:
   void HandleHandshakeAccept(HandshakeAcceptPacket *packet);
   void HandleHandshakeReject(HandshakeRejectPacket *packet);
   void HandleSpawnPacket(const SpawnPacket &packet);
+  void ReplayPendingRpcs(int networkID);
+  // False when the record is a delta against a tick that was never buffered
+  // for its entity; the record's tick must not be acked then.
+  bool BufferSnapshotRecord(int networkID, int serverTick, int baseTick,
+                            const PacketReader &record);
+  void RetireSnapshotEntity(int networkID, int tick);
+  void ReplayPendingSnapshotRecords(NetworkComponent *component);
+  bool BuildSpawnPacket(NetworkComponent *component,
+                        SpawnPacket &outPacket) const;
+  void CollectInterestedPeers(int networkID,
+                              std::vector<TransportPeerId> &outPeers) const;
+  void UpdateInterest();
+  void CaptureReplicationFrame();
+  void PublishReplicationFrame();
+  void RecordLagCompensation();
   void BroadcastSnapshot();
-  void SendSnapshotToPeer(int peerID, int baseTick);
+  void EncodeScheduledSnapshots();
+  void FinishSnapshotEncode();
   void UpdateAsServer(float deltaTime);
+  // One server tick of `tickSeconds`: inputs, capture, lag compensation and,
+  // when due, the snapshot.
+  void SimulateServerTick(float tickSeconds, bool sendSnapshot);
   void UpdateAsClient(float deltaTime);
+  void UpdateInterpolation(float deltaTime);
+  void DeliverRpc(GamePacket *packet, RPCReceiver target, int ownerID,
+                  DeliveryChannel channel);
+  void FlushThrottledRpcs();
 
 private:
   NetworkManager &m_owner;
   int m_nextNetworkID = 1;
-  std::map<int, int> m_peerLastAckedTick;
   std::map<int, PeerHandshakeState> m_peerHandshakeStates;
-  std::vector<NetworkComponent *> m_networkComponents;
-  PacketStream m_sendStream;
+  NetworkIdRegistry<NetworkComponent> m_networkComponents;
   PacketStream m_receiveStream;
+  // Double buffered: the back frame is captured at the end of a tick while
+  // the front one may still be encoding. Slots follow m_networkComponents.
+  ReplicationFrame m_replicationFrames[2];
+  size_t m_frontFrame = 0;
+  // Network IDs registered and unregistered since the last capture.
+  std::vector<int> m_pendingSpawned;
+  std::vector<int> m_pendingDespawned;
+  // Transforms of the published frames, kept as delta baselines.
+  TransformCache m_transformCache;
+  SnapshotEncoder m_snapshotEncoder;
+  ReplicationScheduler m_replicationScheduler;
+  InterestManager m_interestManager;
+  std::vector<InterestEntity> m_interestEntities;
+  std::vector<TransportPeerId> m_interestPeers;
+  std::vector<ReplicationEntityInfo> m_scheduledEntities;
+  std::vector<ScheduledSnapshot> m_scheduledSnapshots;
+  // Fragments of each scheduled snapshot, sent in schedule order.
+  std::vector<std::vector<PacketStream>> m_snapshotFragments;
+  // m_snapshotFragments hold a tick that has not been sent yet.
+  bool m_snapshotsPending = false;
+  SnapshotEncoder::Problems m_encodeProblems;
+  SnapshotWorkerPool m_encodePool;
+  SnapshotFragmentTracker m_snapshotFragmentTracker;
+  SnapshotClock m_snapshotClock;
+  LagCompensationHistory m_lagCompensation;
+  LagCompensationFrame m_rewoundFrame;
+  TransportPeerId m_rewoundPeer = -1;
+  int m_rewoundAtTick = -1;
+  std::vector<NetworkComponent *> m_rewoundComponents;
+  std::vector<Vec3> m_savedPositions;
+  std::vector<Quaternion> m_savedOrientations;
+  // Spends Update() time in fixed ticks and paces snapshots
+  // (ServerTickRate, SnapshotSendRate, MaxCatchUpTicks).
+  FixedTickScheduler m_tickScheduler;
+  // Simulated seconds, advanced per tick.
+  double m_serverTime = 0.0;
+  // Seconds of Update() time; RPC rate limits are measured against it.
+  double m_rpcClock = 0.0;
+  RPCThrottle m_rpcThrottle;
   int m_currentServerTick = 0;
-  float m_clientUpdateTimer = 0.0f;
   bool m_handshakeStarted = false;
   bool m_localSessionAuthenticated = false;
   bool m_localAuthFailed = false;
   std::vector<SpawnPacket> m_pendingPreAuthSpawns;
+  // Client RPCs received before the spawn of their target.
+  std::vector<PendingRpc> m_pendingRpcs;
+  // Client snapshot records received before the spawn of their entity. Their
+  // ticks are acked, so they are applied once the entity registers.
+  std::vector<PendingSnapshotRecord> m_pendingSnapshotRecords;
+  std::vector<RetiredSnapshotEntity> m_retiredSnapshotEntities;
   uint64_t m_localClientNonce = 0;
   uint64_t m_localServerNonce = 0;
   std::function<uint64_t()> m_clockNowProvider;
   SessionJoinRequest m_pendingJoinRequest;
   DisconnectReason m_authFailureReason = DisconnectReason::None;
   String m_authFailureDetail;
+  // Last, so it is joined before the state its job reads is destroyed.
+  SnapshotJobThread m_encodeThread;
 };
 } // namespace ToolKit::ToolKitNetworking
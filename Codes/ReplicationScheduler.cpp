@@ -0,0 +1,261 @@
+#include "ReplicationScheduler.h"
+#include "SnapshotBaseline.h"
+#include <algorithm>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+// Slots wrap every bits.size() * 64 ticks; `tick` must be non-negative.
+size_t SentSlot(const std::vector<uint64_t> &bits, int tick) {
+  return static_cast<size_t>(tick) % (bits.size() * 64);
+}
+
+void SetSentBit(std::vector<uint64_t> &bits, int tick, bool sent) {
+  const size_t slot = SentSlot(bits, tick);
+  const uint64_t mask = uint64_t(1) << (slot % 64);
+  bits[slot / 64] = sent ? bits[slot / 64] | mask : bits[slot / 64] & ~mask;
+}
+} // namespace
+
+bool ReplicationScheduler::EntityState::WasSentAt(int tick) const {
+  const int age = lastSentTick - tick;
+  if (lastSentTick < 0 || tick < 0 || age < 0 ||
+      age >= static_cast<int>(sentBits.size() * 64)) {
+    return false;
+  }
+
+  const size_t slot = SentSlot(sentBits, tick);
+  return ((sentBits[slot / 64] >> (slot % 64)) & 1) != 0;
+}
+
+void ReplicationScheduler::EntityState::MarkSent(int tick, int historyDepth) {
+  const size_t words = static_cast<size_t>((std::max)(1, historyDepth) + 63) / 64;
+  if (sentBits.size() != words) {
+    sentBits.assign(words, 0);
+  } else if (lastSentTick >= 0 && tick > lastSentTick) {
+    // Ticks skipped since the last send reuse slots of older ones.
+    const int capacity = static_cast<int>(words * 64);
+    const int first = (std::max)(lastSentTick + 1, tick - capacity + 1);
+    for (int skipped = first; skipped < tick; ++skipped) {
+      SetSentBit(sentBits, skipped, false);
+    }
+  }
+
+  if (lastSentTick - tick < static_cast<int>(words * 64)) {
+    SetSentBit(sentBits, tick, true);
+  }
+  lastSentTick = (std::max)(lastSentTick, tick);
+  priority = 0.0f;
+}
+
+void ReplicationScheduler::EntityState::ClearSent(int tick) {
+  if (WasSentAt(tick)) {
+    SetSentBit(sentBits, tick, false);
+  }
+}
+
+void ReplicationScheduler::Schedule(
+    const std::vector<TransportPeerId> &peers,
+    const std::vector<ReplicationEntityInfo> &entities,
+    const ScheduleSettings &settings, const RecordSizeFunction &recordSize,
+    const InterestManager *interest,
+    std::vector<ScheduledSnapshot> &outSnapshots) {
+  size_t snapshotCount = 0;
+  for (TransportPeerId peerID : peers) {
+    PeerState &peer = m_peers[peerID];
+    SchedulePeer(peerID, peer, entities, settings, recordSize, interest,
+                 m_peerRecords);
+
+    const int baseTick =
+        settings.useDeltaBaselines &&
+                SnapshotBaseline::IsBaselineUsable(peer.lastAckedTick,
+                                                   settings.currentTick,
+                                                   settings.historyDepth)
+            ? peer.lastAckedTick
+            : -1;
+
+    auto match = std::find_if(
+        outSnapshots.begin(), outSnapshots.begin() + snapshotCount,
+        [&](const ScheduledSnapshot &snapshot) {
+          return snapshot.baseTick == baseTick &&
+                 snapshot.records == m_peerRecords;
+        });
+
+    if (match == outSnapshots.begin() + snapshotCount) {
+      if (snapshotCount == outSnapshots.size()) {
+        outSnapshots.emplace_back();
+      }
+      match = outSnapshots.begin() + snapshotCount++;
+      match->baseTick = baseTick;
+      match->records = m_peerRecords;
+      match->peers.clear();
+    }
+
+    match->peers.push_back(peerID);
+  }
+
+  outSnapshots.resize(snapshotCount);
+}
+
+void ReplicationScheduler::SchedulePeer(
+    TransportPeerId peerID, PeerState &peer,
+    const std::vector<ReplicationEntityInfo> &entities,
+    const ScheduleSettings &settings, const RecordSizeFunction &recordSize,
+    const InterestManager *interest, std::vector<ScheduledRecord> &outRecords) {
+  outRecords.clear();
+  m_candidates.clear();
+
+  for (size_t i = 0; i < entities.size(); ++i) {
+    if (interest != nullptr &&
+        !interest->IsRelevant(peerID, static_cast<int>(i))) {
+      continue;
+    }
+
+    const ReplicationEntityInfo &info = entities[i];
+    EntityState &state = peer.entities[info.networkID];
+    const int interval = (std::max)(1, info.updateInterval);
+    if (state.lastSentTick >= 0 &&
+        settings.currentTick - state.lastSentTick < interval) {
+      continue;
+    }
+
+    state.priority += (std::max)(0.0f, info.basePriority);
+
+    Candidate candidate;
+    candidate.priority = state.priority;
+    candidate.entityIndex = static_cast<int>(i);
+    candidate.state = &state;
+    m_candidates.push_back(candidate);
+  }
+
+  if (settings.byteBudget > 0) {
+    // Highest accumulated priority first; ties go to registration order so
+    // peers in the same situation pick the same entities.
+    std::sort(m_candidates.begin(), m_candidates.end(),
+              [](const Candidate &a, const Candidate &b) {
+                return a.priority != b.priority ? a.priority > b.priority
+                                                : a.entityIndex < b.entityIndex;
+              });
+  }
+
+  size_t usedBytes = 0;
+  for (const Candidate &candidate : m_candidates) {
+    const ReplicationEntityInfo &info = entities[candidate.entityIndex];
+    EntityState &state = *candidate.state;
+
+    ScheduledRecord record;
+    record.entityIndex = candidate.entityIndex;
+    record.networkID = info.networkID;
+    record.baseTick =
+        settings.useDeltaBaselines &&
+                SnapshotBaseline::IsBaselineUsable(state.ackedTick,
+                                                   settings.currentTick,
+                                                   settings.historyDepth)
+            ? state.ackedTick
+            : -1;
+
+    if (settings.byteBudget > 0) {
+      const size_t size = recordSize(record.entityIndex, record.baseTick);
+      // The first record always goes out so an oversized entity can't starve.
+      if (!outRecords.empty() && usedBytes + size > settings.byteBudget) {
+        continue;
+      }
+      usedBytes += size;
+    }
+
+    state.MarkSent(settings.currentTick, settings.historyDepth);
+    outRecords.push_back(record);
+  }
+
+  if (settings.byteBudget > 0) {
+    // Records go out in registration order, as without a budget.
+    std::sort(outRecords.begin(), outRecords.end(),
+              [](const ScheduledRecord &a, const ScheduledRecord &b) {
+                return a.entityIndex < b.entityIndex;
+              });
+  }
+}
+
+void ReplicationScheduler::OnAck(TransportPeerId peerID, int ackTick) {
+  auto it = m_peers.find(peerID);
+  if (it == m_peers.end() || ackTick < 0) {
+    return;
+  }
+
+  PeerState &peer = it->second;
+  peer.lastAckedTick = (std::max)(peer.lastAckedTick, ackTick);
+  for (auto &entry : peer.entities) {
+    EntityState &state = entry.second;
+    if (ackTick > state.ackedTick && state.WasSentAt(ackTick)) {
+      state.ackedTick = ackTick;
+    }
+  }
+}
+
+void ReplicationScheduler::ClearSent(const std::vector<TransportPeerId> &peers,
+                                     int networkID, int tick) {
+  for (TransportPeerId peerID : peers) {
+    auto peer = m_peers.find(peerID);
+    if (peer == m_peers.end()) {
+      continue;
+    }
+
+    auto entity = peer->second.entities.find(networkID);
+    if (entity != peer->second.entities.end()) {
+      entity->second.ClearSent(tick);
+    }
+  }
+}
+
+void ReplicationScheduler::ForgetEntity(TransportPeerId peerID,
+                                        int networkID) {
+  auto it = m_peers.find(peerID);
+  if (it != m_peers.end()) {
+    it->second.entities.erase(networkID);
+  }
+}
+
+void ReplicationScheduler::RemovePeer(TransportPeerId peerID) {
+  m_peers.erase(peerID);
+}
+
+void ReplicationScheduler::RemoveEntity(int networkID) {
+  for (auto &entry : m_peers) {
+    entry.second.entities.erase(networkID);
+  }
+}
+
+void ReplicationScheduler::Reset() {
+  m_peers.clear();
+  m_candidates.clear();
+  m_peerRecords.clear();
+}
+
+int ReplicationScheduler::GetLastAckedTick(TransportPeerId peerID) const {
+  auto peer = m_peers.find(peerID);
+  return peer != m_peers.end() ? peer->second.lastAckedTick : -1;
+}
+
+float ReplicationScheduler::GetPriority(TransportPeerId peerID,
+                                        int networkID) const {
+  auto peer = m_peers.find(peerID);
+  if (peer == m_peers.end()) {
+    return 0.0f;
+  }
+
+  auto entity = peer->second.entities.find(networkID);
+  return entity != peer->second.entities.end() ? entity->second.priority
+                                                : 0.0f;
+}
+
+int ReplicationScheduler::GetEntityBaseline(TransportPeerId peerID,
+                                            int networkID) const {
+  auto peer = m_peers.find(peerID);
+  if (peer == m_peers.end()) {
+    return -1;
+  }
+
+  auto entity = peer->second.entities.find(networkID);
+  return entity != peer->second.entities.end() ? entity->second.ackedTick
+                                                : -1;
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "InterestManager.h"
+#include "TransportTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Scheduling inputs for one replicated entity.
+struct ReplicationEntityInfo {
+  int networkID = -1;
+  // Priority added every tick the entity is due and not yet sent.
+  float basePriority = 1.0f;
+  // Minimum number of ticks between two sends to the same peer.
+  int updateInterval = 1;
+};
+
+// One entity record in a peer's snapshot, delta encoded against `baseTick`
+// (-1 for full state). `entityIndex` indexes the scheduled entity list.
+struct ScheduledRecord {
+  int entityIndex = -1;
+  int networkID = -1;
+  int baseTick = -1;
+
+  bool operator==(const ScheduledRecord &other) const {
+    return entityIndex == other.entityIndex && networkID == other.networkID &&
+           baseTick == other.baseTick;
+  }
+};
+
+// Peers that were scheduled the same records share one encoded snapshot.
+struct ScheduledSnapshot {
+  int baseTick = -1;
+  std::vector<ScheduledRecord> records;
+  std::vector<TransportPeerId> peers;
+};
+
+// Picks what each peer receives per snapshot. Every (peer, entity) pair keeps
+// an accumulated priority; each tick the highest priorities are written until
+// the peer's byte budget is spent and the rest carry over to the next tick.
+// The scheduler also remembers which ticks carried each entity to each peer,
+// so an ack only becomes an entity's delta baseline if the peer actually got
+// that entity in the acked tick.
+class ReplicationScheduler {
+public:
+  // Encoded size in bytes of an entity record against a base tick.
+  using RecordSizeFunction = std::function<size_t(int entityIndex, int baseTick)>;
+
+  struct ScheduleSettings {
+    int currentTick = 0;
+    // Ticks a baseline stays usable. Sends are remembered for as long, so an
+    // ack of any tick in the window can become an entity's baseline.
+    int historyDepth = 64;
+    bool useDeltaBaselines = true;
+    // Record bytes per peer per snapshot; 0 sends every due entity.
+    size_t byteBudget = 0;
+  };
+
+  // Entities `interest` marks irrelevant to a peer are skipped for it and
+  // keep their accumulated priority. Pass nullptr to consider everything.
+  void Schedule(const std::vector<TransportPeerId> &peers,
+                const std::vector<ReplicationEntityInfo> &entities,
+                const ScheduleSettings &settings,
+                const RecordSizeFunction &recordSize,
+                const InterestManager *interest,
+                std::vector<ScheduledSnapshot> &outSnapshots);
+
+  void OnAck(TransportPeerId peerID, int ackTick);
+  // Forgets that `tick` carried the entity to `peers`, for a scheduled record
+  // that was never sent. An ack of the tick then leaves its baseline alone.
+  void ClearSent(const std::vector<TransportPeerId> &peers, int networkID,
+                 int tick);
+  // Drops what the peer knows about the entity; its next record is a full
+  // state. Used when the peer's copy of the entity is destroyed.
+  void ForgetEntity(TransportPeerId peerID, int networkID);
+  void RemovePeer(TransportPeerId peerID);
+  void RemoveEntity(int networkID);
+  void Reset();
+
+  // Newest snapshot tick the peer acked, or -1.
+  int GetLastAckedTick(TransportPeerId peerID) const;
+  float GetPriority(TransportPeerId peerID, int networkID) const;
+  int GetEntityBaseline(TransportPeerId peerID, int networkID) const;
+
+private:
+  struct EntityState {
+    float priority = 0.0f;
+    int lastSentTick = -1;
+    int ackedTick = -1;
+    // Ring of sent flags indexed by tick, at least historyDepth bits long.
+    std::vector<uint64_t> sentBits;
+
+    bool WasSentAt(int tick) const;
+    void MarkSent(int tick, int historyDepth);
+    void ClearSent(int tick);
+  };
+
+  struct PeerState {
+    int lastAckedTick = -1;
+    std::unordered_map<int, EntityState> entities;
+  };
+
+  struct Candidate {
+    float priority = 0.0f;
+    int entityIndex = -1;
+    EntityState *state = nullptr;
+  };
+
+  void SchedulePeer(TransportPeerId peerID, PeerState &peer,
+                    const std::vector<ReplicationEntityInfo> &entities,
+                    const ScheduleSettings &settings,
+                    const RecordSizeFunction &recordSize,
+                    const InterestManager *interest,
+                    std::vector<ScheduledRecord> &outRecords);
+
+private:
+  std::map<TransportPeerId, PeerState> m_peers;
+  std::vector<Candidate> m_candidates;
+  std::vector<ScheduledRecord> m_peerRecords;
+};
+} // namespace ToolKit::ToolKitNetworking
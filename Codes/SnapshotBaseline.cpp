@@ -0,0 +1,73 @@
+#include "SnapshotBaseline.h"
+#include <algorithm>
+#include <functional>
+
+namespace ToolKit::ToolKitNetworking {
+size_t SnapshotDeltaKeyHash::operator()(const SnapshotDeltaKey &key) const {
+  size_t hash = std::hash<int>()(key.networkID);
+  hash ^= std::hash<int>()(key.baseTick) + 0x9e3779b9 + (hash << 6) +
+          (hash >> 2);
+  hash ^= std::hash<int>()(key.currentTick) + 0x9e3779b9 + (hash << 6) +
+          (hash >> 2);
+  return hash;
+}
+
+void SnapshotDeltaCache::Clear() {
+  if (m_count == 0) {
+    return;
+  }
+
+  std::fill(m_slots.begin(), m_slots.end(), -1);
+  m_count = 0;
+}
+
+std::vector<char> *SnapshotDeltaCache::Find(const SnapshotDeltaKey &key) {
+  if (m_count == 0) {
+    return nullptr;
+  }
+
+  const int index = m_slots[FindSlot(key)];
+  return index < 0 ? nullptr : &m_entries[index].bytes;
+}
+
+std::vector<char> &SnapshotDeltaCache::Insert(const SnapshotDeltaKey &key) {
+  // Keep the table at most half full so probe runs stay short.
+  if ((m_count + 1) * 2 > m_slots.size()) {
+    Rehash((std::max)(m_slots.size() * 2, static_cast<size_t>(64)));
+  }
+
+  if (m_count == m_entries.size()) {
+    m_entries.emplace_back();
+  }
+
+  Entry &entry = m_entries[m_count];
+  entry.key = key;
+  entry.bytes.clear();
+  m_slots[FindSlot(key)] = static_cast<int>(m_count);
+  m_count++;
+  return entry.bytes;
+}
+
+size_t SnapshotDeltaCache::FindSlot(const SnapshotDeltaKey &key) const {
+  const size_t mask = m_slots.size() - 1;
+  size_t slot = SnapshotDeltaKeyHash()(key) & mask;
+  while (m_slots[slot] >= 0 && !(m_entries[m_slots[slot]].key == key)) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void SnapshotDeltaCache::Rehash(size_t slotCount) {
+  m_slots.assign(slotCount, -1);
+  for (size_t i = 0; i < m_count; ++i) {
+    m_slots[FindSlot(m_entries[i].key)] = static_cast<int>(i);
+  }
+}
+
+namespace SnapshotBaseline {
+bool IsBaselineUsable(int baseTick, int currentTick, int historyDepth) {
+  return baseTick >= 0 && baseTick <= currentTick &&
+         currentTick - baseTick < historyDepth;
+}
+} // namespace SnapshotBaseline
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Identifies one encoded component delta: the same component encoded against
+// the same baseline on the same tick always produces the same bytes.
+struct SnapshotDeltaKey {
+  int networkID = -1;
+  int baseTick = -1;
+  int currentTick = -1;
+
+  bool operator==(const SnapshotDeltaKey &other) const {
+    return networkID == other.networkID && baseTick == other.baseTick &&
+           currentTick == other.currentTick;
+  }
+};
+
+struct SnapshotDeltaKeyHash {
+  size_t operator()(const SnapshotDeltaKey &key) const;
+};
+
+// Encoded deltas of the current tick keyed by SnapshotDeltaKey. Clear() keeps
+// every entry's byte buffer and the slot table, so a tick that encodes no more
+// deltas than an earlier one does not allocate. References returned by Find()
+// and Insert() stay valid until the next Clear().
+class SnapshotDeltaCache {
+public:
+  void Clear();
+
+  std::vector<char> *Find(const SnapshotDeltaKey &key);
+  // Empty buffer for `key`, which must not be cached yet.
+  std::vector<char> &Insert(const SnapshotDeltaKey &key);
+
+  size_t Size() const { return m_count; }
+
+private:
+  struct Entry {
+    SnapshotDeltaKey key;
+    std::vector<char> bytes;
+  };
+
+  size_t FindSlot(const SnapshotDeltaKey &key) const;
+  void Rehash(size_t slotCount);
+
+private:
+  // Open addressing over indices into m_entries; -1 marks an empty slot.
+  std::vector<int> m_slots;
+  std::deque<Entry> m_entries;
+  size_t m_count = 0;
+};
+
+namespace SnapshotBaseline {
+// A baseline is only usable while the server still holds it in its state
+// history: not from the future and fewer than `historyDepth` ticks old.
+bool IsBaselineUsable(int baseTick, int currentTick, int historyDepth);
+} // namespace SnapshotBaseline
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,233 @@
+#include "SnapshotEncoder.h"
+#include <algorithm>
+#include <climits>
+
+namespace ToolKit::ToolKitNetworking {
+void SnapshotEncoder::BeginTick(const ReplicationFrame &frame,
+                                TransformCache &transforms) {
+  m_frame = &frame;
+  m_transforms = &transforms;
+  if (m_workers.empty()) {
+    m_workers.resize(1);
+  }
+  if (frame.tick == m_currentTick) {
+    return;
+  }
+
+  m_currentTick = frame.tick;
+  m_deltaCache.Clear();
+}
+
+void SnapshotEncoder::Reset() {
+  m_currentTick = -1;
+  m_frame = nullptr;
+  m_transforms = nullptr;
+  m_deltaCache.Clear();
+  for (WorkerScratch &worker : m_workers) {
+    worker.stream.Clear();
+    worker.problems = Problems();
+  }
+  m_problems = Problems();
+}
+
+SnapshotDeltaKey SnapshotEncoder::MakeKey(size_t slot, int baseTick) const {
+  SnapshotDeltaKey key;
+  key.networkID = m_frame->networkIDs[slot];
+  key.baseTick = baseTick;
+  key.currentTick = m_currentTick;
+  return key;
+}
+
+const std::vector<char> &SnapshotEncoder::EncodeRecord(size_t slot,
+                                                       int baseTick) {
+  const SnapshotDeltaKey key = MakeKey(slot, baseTick);
+  if (std::vector<char> *cached = m_deltaCache.Find(key)) {
+    return *cached;
+  }
+
+  std::vector<char> &encoded = m_deltaCache.Insert(key);
+  EncodeInto(slot, baseTick, m_workers[0], encoded);
+  return encoded;
+}
+
+void SnapshotEncoder::EncodeInto(size_t slot, int baseTick,
+                                 WorkerScratch &scratch,
+                                 std::vector<char> &encoded) {
+  scratch.stream.Clear();
+  WriteEntityRecord(*m_frame, slot, baseTick,
+                    m_transforms->GetTransform(slot, baseTick),
+                    scratch.stream, scratch.variableMask);
+  encoded.assign(scratch.stream.buffer.begin(), scratch.stream.buffer.end());
+}
+
+void SnapshotEncoder::WriteSnapshotFragments(
+    const std::vector<ScheduledRecord> &records, int baseTick,
+    size_t maxFragmentBytes, std::vector<PacketStream> &outFragments) {
+  WorkerScratch &scratch = m_workers[0];
+  WriteFragments(scratch, 0, records, baseTick, maxFragmentBytes,
+                 outFragments);
+  CollectProblems(scratch);
+}
+
+void SnapshotEncoder::EncodeSnapshots(
+    const std::vector<ScheduledSnapshot> &snapshots, size_t maxFragmentBytes,
+    SnapshotWorkerPool &pool,
+    std::vector<std::vector<PacketStream>> &outFragments) {
+  const size_t workerCount = pool.GetWorkerCount();
+  if (m_workers.size() < workerCount) {
+    m_workers.resize(workerCount);
+  }
+
+  // Everything shared is prepared here, so the workers only read it: the
+  // transform changes of every baseline, and a cache entry per missing
+  // record. Cache entries keep their address while others are inserted.
+  m_jobs.clear();
+  for (const ScheduledSnapshot &snapshot : snapshots) {
+    for (const ScheduledRecord &record : snapshot.records) {
+      const size_t slot = static_cast<size_t>(record.entityIndex);
+      const SnapshotDeltaKey key = MakeKey(slot, record.baseTick);
+      if (m_deltaCache.Find(key) != nullptr) {
+        continue;
+      }
+
+      m_transforms->GetChanges(record.baseTick);
+      EncodeJob job;
+      job.slot = slot;
+      job.baseTick = record.baseTick;
+      job.encoded = &m_deltaCache.Insert(key);
+      m_jobs.push_back(job);
+    }
+  }
+
+  // Records of one entity share its variable bytes; keeping them on one
+  // worker keeps those bytes in one cache. Jobs are unique per slot and
+  // baseline, so the order is total; std::stable_sort would allocate.
+  std::sort(m_jobs.begin(), m_jobs.end(),
+            [](const EncodeJob &a, const EncodeJob &b) {
+              return a.slot != b.slot ? a.slot < b.slot
+                                      : a.baseTick < b.baseTick;
+            });
+  m_jobGroups.clear();
+  for (size_t i = 0; i < m_jobs.size(); ++i) {
+    if (i == 0 || m_jobs[i].slot != m_jobs[i - 1].slot) {
+      m_jobGroups.push_back(i);
+    }
+  }
+  m_jobGroups.push_back(m_jobs.size());
+
+  pool.Run(m_jobGroups.size() - 1, [&](size_t group, size_t worker) {
+    for (size_t i = m_jobGroups[group]; i < m_jobGroups[group + 1]; ++i) {
+      const EncodeJob &job = m_jobs[i];
+      EncodeInto(job.slot, job.baseTick, m_workers[worker], *job.encoded);
+    }
+  });
+
+  if (outFragments.size() < snapshots.size()) {
+    outFragments.resize(snapshots.size());
+  }
+  pool.Run(snapshots.size(), [&](size_t index, size_t worker) {
+    const ScheduledSnapshot &snapshot = snapshots[index];
+    WriteFragments(m_workers[worker], index, snapshot.records,
+                   snapshot.baseTick, maxFragmentBytes, outFragments[index]);
+  });
+
+  for (size_t worker = 0; worker < workerCount; ++worker) {
+    CollectProblems(m_workers[worker]);
+  }
+}
+
+void SnapshotEncoder::TakeProblems(Problems &out) {
+  out.oversizedIDs.clear();
+  out.oversizedIDs.swap(m_problems.oversizedIDs);
+  out.overFragmentLimit = m_problems.overFragmentLimit;
+  m_problems.overFragmentLimit = 0;
+  out.droppedRecords.clear();
+  out.droppedRecords.swap(m_problems.droppedRecords);
+}
+
+void SnapshotEncoder::WriteFragments(
+    WorkerScratch &scratch, size_t snapshotIndex,
+    const std::vector<ScheduledRecord> &records, int baseTick,
+    size_t maxFragmentBytes,
+    std::vector<PacketStream> &outFragments) {
+  const size_t headerPayloadBytes =
+      sizeof(WorldSnapshotPacket) - sizeof(GamePacket);
+  const size_t maxRecordBytes =
+      static_cast<size_t>(SHRT_MAX) - headerPayloadBytes;
+
+  scratch.records.clear();
+  scratch.recordIDs.clear();
+  scratch.recordSizes.clear();
+  for (const ScheduledRecord &record : records) {
+    const std::vector<char> &encoded =
+        EncodeRecord(static_cast<size_t>(record.entityIndex), record.baseTick);
+    const int networkID = m_frame->networkIDs[record.entityIndex];
+    if (encoded.size() > maxRecordBytes) {
+      scratch.problems.oversizedIDs.push_back(networkID);
+      scratch.problems.droppedRecords.push_back({snapshotIndex, networkID});
+      continue;
+    }
+
+    scratch.records.push_back(&encoded);
+    scratch.recordIDs.push_back(networkID);
+    scratch.recordSizes.push_back(encoded.size());
+  }
+
+  const size_t maxPayloadBytes =
+      maxFragmentBytes > sizeof(WorldSnapshotPacket)
+          ? maxFragmentBytes - sizeof(WorldSnapshotPacket)
+          : 0;
+  SnapshotFragmenter::PlanFragments(scratch.recordSizes, maxPayloadBytes,
+                                    scratch.ranges);
+
+  const size_t fragmentCount = (std::min)(
+      scratch.ranges.size(),
+      static_cast<size_t>(SnapshotFragmenter::MaxFragmentsPerTick));
+  if (fragmentCount < scratch.ranges.size()) {
+    scratch.problems.overFragmentLimit++;
+    const SnapshotFragmentRange &firstDropped = scratch.ranges[fragmentCount];
+    for (size_t i = static_cast<size_t>(firstDropped.firstEntity);
+         i < scratch.recordIDs.size(); ++i) {
+      scratch.problems.droppedRecords.push_back(
+          {snapshotIndex, scratch.recordIDs[i]});
+    }
+  }
+
+  outFragments.resize(fragmentCount);
+  for (size_t f = 0; f < fragmentCount; ++f) {
+    const SnapshotFragmentRange &range = scratch.ranges[f];
+    PacketStream &outStream = outFragments[f];
+    outStream.Clear();
+
+    WorldSnapshotPacket header;
+    header.serverTick = m_currentTick;
+    header.baseTick = baseTick;
+    header.entityCount = range.entityCount;
+    header.firstEntityIndex = range.firstEntity;
+    header.fragmentIndex = static_cast<short>(f);
+    header.fragmentCount = static_cast<short>(fragmentCount);
+    header.size =
+        static_cast<short>(headerPayloadBytes + range.payloadBytes);
+    outStream.Write(header);
+
+    for (int i = 0; i < range.entityCount; ++i) {
+      const std::vector<char> &encoded =
+          *scratch.records[range.firstEntity + i];
+      outStream.Write(encoded.data(), encoded.size());
+    }
+  }
+}
+
+void SnapshotEncoder::CollectProblems(WorkerScratch &scratch) {
+  m_problems.oversizedIDs.insert(m_problems.oversizedIDs.end(),
+                                 scratch.problems.oversizedIDs.begin(),
+                                 scratch.problems.oversizedIDs.end());
+  m_problems.overFragmentLimit += scratch.problems.overFragmentLimit;
+  m_problems.droppedRecords.insert(m_problems.droppedRecords.end(),
+                                   scratch.problems.droppedRecords.begin(),
+                                   scratch.problems.droppedRecords.end());
+  scratch.problems.oversizedIDs.clear();
+  scratch.problems.overFragmentLimit = 0;
+  scratch.problems.droppedRecords.clear();
+}
+} // namespace ToolKit::ToolKitNetworking
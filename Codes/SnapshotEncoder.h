@@ -0,0 +1,118 @@
+#pragma once
+
+#include "NetworkPackets.h"
+#include "ReplicationFrame.h"
+#include "ReplicationScheduler.h"
+#include "SnapshotBaseline.h"
+#include "SnapshotFragmenter.h"
+#include "SnapshotWorkerPool.h"
+#include "TransformCache.h"
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Encodes world snapshots with per-tick reuse of entity deltas. Each entity
+// is serialized at most once per (baseTick, currentTick) pair, so the cost of
+// a server tick scales with the number of distinct baselines instead of the
+// number of connected peers. EncodeSnapshots() spreads that work over a
+// SnapshotWorkerPool. Records are written from a ReplicationFrame, never from
+// the components, so encoding may run on another thread than the game.
+class SnapshotEncoder {
+public:
+  // A scheduled record that is missing from the written fragments.
+  // `snapshotIndex` indexes the snapshots passed to EncodeSnapshots().
+  struct DroppedRecord {
+    size_t snapshotIndex = 0;
+    int networkID = -1;
+  };
+
+  // Problems met while writing fragments, reported by the caller.
+  struct Problems {
+    // Records over the packet size limit, dropped.
+    std::vector<int> oversizedIDs;
+    // Snapshots that hit the fragment limit; their tail was not sent.
+    int overFragmentLimit = 0;
+    // Every record left out for either reason. Its peers never receive it
+    // in this tick, so the tick must not become its baseline.
+    std::vector<DroppedRecord> droppedRecords;
+
+    bool Empty() const {
+      return oversizedIDs.empty() && overFragmentLimit == 0 &&
+             droppedRecords.empty();
+    }
+  };
+
+  // Drops cached deltas from previous ticks. `frame` is the capture of the
+  // tick and `transforms` holds its committed transforms; both must stay
+  // unchanged until the tick is encoded.
+  void BeginTick(const ReplicationFrame &frame, TransformCache &transforms);
+  void Reset();
+
+  // Returns the entity record (networkID, payload size, payload) of
+  // replication slot `slot` against `baseTick`, serializing it only on a
+  // cache miss.
+  const std::vector<char> &EncodeRecord(size_t slot, int baseTick);
+
+  // Writes `records` as WorldSnapshotPackets of at most `maxFragmentBytes`
+  // each. Record entity indices are slots of the frame. `outFragments` is
+  // resized to the fragment count; its streams are reused between calls.
+  void WriteSnapshotFragments(const std::vector<ScheduledRecord> &records,
+                              int baseTick, size_t maxFragmentBytes,
+                              std::vector<PacketStream> &outFragments);
+
+  // Writes the fragments of `snapshots[i]` into `outFragments[i]`, like
+  // WriteSnapshotFragments() for each snapshot in turn and with the same
+  // bytes. Records missing from the cache are serialized on the pool first,
+  // then the fragments are assembled on the pool, one snapshot per task.
+  void EncodeSnapshots(const std::vector<ScheduledSnapshot> &snapshots,
+                       size_t maxFragmentBytes, SnapshotWorkerPool &pool,
+                       std::vector<std::vector<PacketStream>> &outFragments);
+
+  // Moves the problems met since the last call into `out`.
+  void TakeProblems(Problems &out);
+
+  int GetCurrentTick() const { return m_currentTick; }
+  size_t GetCachedDeltaCount() const { return m_deltaCache.Size(); }
+
+private:
+  // Per-worker state of record and fragment writing.
+  struct WorkerScratch {
+    PacketStream stream;
+    std::vector<uint8_t> variableMask;
+    std::vector<const std::vector<char> *> records;
+    std::vector<int> recordIDs;
+    std::vector<size_t> recordSizes;
+    std::vector<SnapshotFragmentRange> ranges;
+    Problems problems;
+  };
+
+  // One record to serialize into its pre-inserted cache entry.
+  struct EncodeJob {
+    size_t slot = 0;
+    int baseTick = -1;
+    std::vector<char> *encoded = nullptr;
+  };
+
+  SnapshotDeltaKey MakeKey(size_t slot, int baseTick) const;
+  void EncodeInto(size_t slot, int baseTick, WorkerScratch &scratch,
+                  std::vector<char> &encoded);
+  // Serializes missing records on the calling thread. EncodeSnapshots()
+  // caches all of them beforehand, so its workers only read the cache.
+  void WriteFragments(WorkerScratch &scratch, size_t snapshotIndex,
+                      const std::vector<ScheduledRecord> &records,
+                      int baseTick, size_t maxFragmentBytes,
+                      std::vector<PacketStream> &outFragments);
+  void CollectProblems(WorkerScratch &scratch);
+
+private:
+  int m_currentTick = -1;
+  const ReplicationFrame *m_frame = nullptr;
+  TransformCache *m_transforms = nullptr;
+  SnapshotDeltaCache m_deltaCache;
+  std::vector<EncodeJob> m_jobs;
+  // Offsets into m_jobs where the next slot's jobs start.
+  std::vector<size_t> m_jobGroups;
+  // Indexed by pool worker; worker 0 is the calling thread.
+  std::vector<WorkerScratch> m_workers;
+  Problems m_problems;
+};
+} // namespace ToolKit::ToolKitNetworking
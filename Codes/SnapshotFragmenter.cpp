@@ -0,0 +1,106 @@
+#include "SnapshotFragmenter.h"
+#include <algorithm>
+
+namespace ToolKit::ToolKitNetworking {
+namespace SnapshotFragmenter {
+void PlanFragments(const std::vector<size_t> &recordSizes,
+                   size_t maxPayloadBytes,
+                   std::vector<SnapshotFragmentRange> &outFragments) {
+  outFragments.clear();
+  outFragments.emplace_back();
+
+  for (size_t i = 0; i < recordSizes.size(); ++i) {
+    SnapshotFragmentRange *current = &outFragments.back();
+    if (current->entityCount > 0 &&
+        current->payloadBytes + recordSizes[i] > maxPayloadBytes) {
+      SnapshotFragmentRange next;
+      next.firstEntity = static_cast<int>(i);
+      outFragments.push_back(next);
+      current = &outFragments.back();
+    }
+
+    current->entityCount++;
+    current->payloadBytes += recordSizes[i];
+  }
+}
+} // namespace SnapshotFragmenter
+
+bool SnapshotFragmentTracker::MarkReceived(int serverTick, int fragmentIndex,
+                                           int fragmentCount) {
+  if (serverTick < 0 || fragmentCount <= 0 ||
+      fragmentCount > SnapshotFragmenter::MaxFragmentsPerTick ||
+      fragmentIndex < 0 || fragmentIndex >= fragmentCount) {
+    return false;
+  }
+
+  PendingTick *pending = FindOrCreate(serverTick, fragmentCount);
+  if (pending == nullptr) {
+    return false;
+  }
+
+  uint64_t &word = pending->received[static_cast<size_t>(fragmentIndex) / 64];
+  const uint64_t bit = uint64_t(1) << (fragmentIndex % 64);
+  if ((word & bit) != 0) {
+    return false;
+  }
+
+  word |= bit;
+  pending->receivedCount++;
+  return !pending->rejected &&
+         pending->receivedCount == pending->fragmentCount;
+}
+
+void SnapshotFragmentTracker::Reject(int serverTick, int fragmentCount) {
+  if (serverTick < 0 || fragmentCount <= 0 ||
+      fragmentCount > SnapshotFragmenter::MaxFragmentsPerTick) {
+    return;
+  }
+
+  if (PendingTick *pending = FindOrCreate(serverTick, fragmentCount)) {
+    pending->rejected = true;
+  }
+}
+
+bool SnapshotFragmentTracker::IsComplete(int serverTick) const {
+  for (const PendingTick &pending : m_pending) {
+    if (pending.serverTick == serverTick) {
+      return !pending.rejected &&
+             pending.receivedCount == pending.fragmentCount;
+    }
+  }
+  return false;
+}
+
+void SnapshotFragmentTracker::Reset() { m_pending.clear(); }
+
+SnapshotFragmentTracker::PendingTick *
+SnapshotFragmentTracker::FindOrCreate(int serverTick, int fragmentCount) {
+  for (PendingTick &pending : m_pending) {
+    if (pending.serverTick == serverTick) {
+      // Every fragment of a tick carries the same count; a mismatch means a
+      // corrupt or hostile fragment.
+      return pending.fragmentCount == fragmentCount ? &pending : nullptr;
+    }
+  }
+
+  if (m_pending.size() >= MaxPendingTicks) {
+    auto oldest = std::min_element(
+        m_pending.begin(), m_pending.end(),
+        [](const PendingTick &a, const PendingTick &b) {
+          return a.serverTick < b.serverTick;
+        });
+    if (oldest->serverTick > serverTick) {
+      // Older than everything still tracked; too late to matter.
+      return nullptr;
+    }
+    m_pending.erase(oldest);
+  }
+
+  PendingTick pending;
+  pending.serverTick = serverTick;
+  pending.fragmentCount = fragmentCount;
+  pending.received.assign((static_cast<size_t>(fragmentCount) + 63) / 64, 0);
+  m_pending.push_back(std::move(pending));
+  return &m_pending.back();
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Contiguous run of entity records that travels in one snapshot fragment.
+struct SnapshotFragmentRange {
+  int firstEntity = 0;
+  int entityCount = 0;
+  size_t payloadBytes = 0;
+};
+
+namespace SnapshotFragmenter {
+// Total bytes per snapshot datagram, header included. Stays below the common
+// 1280-1500 byte path MTU so ENet never has to fragment a snapshot itself.
+constexpr size_t DefaultMaxFragmentBytes = 1200;
+constexpr int MaxFragmentsPerTick = 4096;
+
+// Packs records in order into as few fragments as possible without exceeding
+// `maxPayloadBytes`. A record larger than the budget gets a fragment of its
+// own. An empty world still produces one empty fragment so the tick reaches
+// the client.
+void PlanFragments(const std::vector<size_t> &recordSizes,
+                   size_t maxPayloadBytes,
+                   std::vector<SnapshotFragmentRange> &outFragments);
+} // namespace SnapshotFragmenter
+
+// Tracks which fragments of recent ticks have arrived. Fragments are applied
+// as they come in; a tick is only complete, and safe to ack as a delta
+// baseline, once every fragment of it has been seen.
+class SnapshotFragmentTracker {
+public:
+  static constexpr size_t MaxPendingTicks = 8;
+
+  // Returns true exactly once per tick: when the last missing fragment
+  // arrives. Invalid indices or counts are ignored.
+  bool MarkReceived(int serverTick, int fragmentIndex, int fragmentCount);
+  // The tick never completes, e.g. because a record in it could not be
+  // applied; it must not become a delta baseline.
+  void Reject(int serverTick, int fragmentCount);
+  bool IsComplete(int serverTick) const;
+  void Reset();
+
+private:
+  struct PendingTick {
+    int serverTick = -1;
+    int fragmentCount = 0;
+    int receivedCount = 0;
+    bool rejected = false;
+    std::vector<uint64_t> received;
+  };
+
+  PendingTick *FindOrCreate(int serverTick, int fragmentCount);
+
+private:
+  std::vector<PendingTick> m_pending;
+};
+} // namespace ToolKit::ToolKitNetworking
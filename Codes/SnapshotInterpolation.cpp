@@ -0,0 +1,148 @@
+#include "SnapshotInterpolation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+Quaternion Blend(const Quaternion &from, const Quaternion &to, float t) {
+  // slerp keeps working for t > 1, which continues the last angular velocity.
+  return glm::normalize(glm::slerp(from, to, t));
+}
+} // namespace
+
+void InterpolationBuffer::Push(int tick, const Vec3 &position,
+                               const Quaternion &orientation) {
+  TransformSample sample;
+  sample.tick = tick;
+  sample.position = position;
+  sample.orientation = orientation;
+
+  // Snapshots almost always arrive in order, so scan from the newest end.
+  size_t insertAt = m_count;
+  while (insertAt > 0 && At(insertAt - 1).tick > tick) {
+    insertAt--;
+  }
+
+  if (insertAt > 0 && At(insertAt - 1).tick == tick) {
+    At(insertAt - 1) = sample;
+    return;
+  }
+
+  if (m_count == Capacity) {
+    if (insertAt == 0) {
+      return;
+    }
+
+    // Drop the oldest sample to make room.
+    m_head = (m_head + 1) % Capacity;
+    m_count--;
+    insertAt--;
+  }
+
+  for (size_t i = m_count; i > insertAt; --i) {
+    At(i) = At(i - 1);
+  }
+  At(insertAt) = sample;
+  m_count++;
+}
+
+InterpolationResult
+InterpolationBuffer::Sample(double renderTick, double maxExtrapolationTicks,
+                            Vec3 &outPosition,
+                            Quaternion &outOrientation) const {
+  if (m_count == 0) {
+    return InterpolationResult::Empty;
+  }
+
+  const TransformSample &oldest = At(0);
+  if (renderTick <= oldest.tick) {
+    outPosition = oldest.position;
+    outOrientation = oldest.orientation;
+    return InterpolationResult::Clamped;
+  }
+
+  const TransformSample &newest = At(m_count - 1);
+  if (renderTick >= newest.tick) {
+    const double ahead =
+        (std::min)(renderTick - newest.tick, maxExtrapolationTicks);
+    if (ahead <= 0.0 || m_count < 2) {
+      outPosition = newest.position;
+      outOrientation = newest.orientation;
+      return InterpolationResult::Clamped;
+    }
+
+    const TransformSample &previous = At(m_count - 2);
+    const float t = static_cast<float>(
+        1.0 + ahead / static_cast<double>(newest.tick - previous.tick));
+    outPosition = glm::mix(previous.position, newest.position, t);
+    outOrientation = Blend(previous.orientation, newest.orientation, t);
+    return InterpolationResult::Extrapolated;
+  }
+
+  // The render tick trails the newest sample by a few ticks, so the bracket
+  // is normally found within the last couple of samples.
+  size_t to = m_count - 1;
+  while (At(to - 1).tick > renderTick) {
+    to--;
+  }
+
+  const TransformSample &from = At(to - 1);
+  const TransformSample &next = At(to);
+  const float t = static_cast<float>((renderTick - from.tick) /
+                                     static_cast<double>(next.tick - from.tick));
+  outPosition = glm::mix(from.position, next.position, t);
+  outOrientation = Blend(from.orientation, next.orientation, t);
+  return InterpolationResult::Interpolated;
+}
+
+void InterpolationBuffer::Clear() {
+  m_head = 0;
+  m_count = 0;
+}
+
+void SnapshotClock::OnSnapshot(int serverTick) {
+  if (serverTick <= m_newestTick) {
+    return;
+  }
+
+  if (m_referenceTick >= 0 && m_localTime > m_referenceTime) {
+    const double observed = (m_localTime - m_referenceTime) /
+                            static_cast<double>(serverTick - m_referenceTick);
+    m_secondsPerTick += (observed - m_secondsPerTick) * TickLengthSmoothing;
+  }
+
+  if (m_referenceTick < 0 || m_localTime > m_referenceTime) {
+    m_referenceTick = serverTick;
+    m_referenceTime = m_localTime;
+  }
+
+  m_newestTick = serverTick;
+  m_newestArrival = m_localTime;
+}
+
+double SnapshotClock::Advance(double deltaTime, double bufferTime) {
+  m_localTime += deltaTime;
+  if (m_newestTick < 0) {
+    return -1.0;
+  }
+
+  const double bufferTicks = bufferTime / m_secondsPerTick;
+  const double target = m_newestTick +
+                        (m_localTime - m_newestArrival) / m_secondsPerTick -
+                        bufferTicks;
+
+  m_renderTick += deltaTime / m_secondsPerTick;
+  const double error = target - m_renderTick;
+  if (!m_running ||
+      std::abs(error) > (std::max)(bufferTicks, 1.0) * SnapThresholdBuffers) {
+    m_renderTick = target;
+    m_running = true;
+  } else {
+    m_renderTick += error * CorrectionRate;
+  }
+
+  return m_renderTick;
+}
+
+void SnapshotClock::Reset() { *this = SnapshotClock(); }
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Types.h>
+#include <array>
+#include <cstddef>
+
+namespace ToolKit::ToolKitNetworking {
+struct TransformSample {
+  int tick = -1;
+  Vec3 position;
+  Quaternion orientation;
+};
+
+enum class InterpolationResult {
+  Empty,
+  // Blended between the two samples around the render tick.
+  Interpolated,
+  // Ran past the newest sample and continued its last velocity.
+  Extrapolated,
+  // Held the oldest or newest sample.
+  Clamped
+};
+
+// Received transforms of one remote entity, ordered by server tick. Rendering
+// samples it a little in the past so there is usually a sample on both sides
+// of the render tick.
+class InterpolationBuffer {
+public:
+  static constexpr size_t Capacity = 32;
+
+  // Out-of-order samples are inserted in place; a sample older than a full
+  // buffer is dropped and a repeated tick replaces the stored sample.
+  void Push(int tick, const Vec3 &position, const Quaternion &orientation);
+
+  // `renderTick` may be fractional. Past the newest sample the last velocity
+  // is continued for at most `maxExtrapolationTicks`, then the transform holds.
+  InterpolationResult Sample(double renderTick, double maxExtrapolationTicks,
+                             Vec3 &outPosition,
+                             Quaternion &outOrientation) const;
+
+  void Clear();
+  size_t Size() const { return m_count; }
+  int GetNewestTick() const { return m_count > 0 ? At(m_count - 1).tick : -1; }
+
+private:
+  TransformSample &At(size_t index) {
+    return m_samples[(m_head + index) % Capacity];
+  }
+  const TransformSample &At(size_t index) const {
+    return m_samples[(m_head + index) % Capacity];
+  }
+
+private:
+  std::array<TransformSample, Capacity> m_samples;
+  size_t m_head = 0;
+  size_t m_count = 0;
+};
+
+// Client-side estimate of the server tick to render. The tick length is
+// learned from snapshot arrivals, so it follows whatever rate the server
+// actually sends at, and the render tick trails the newest received tick by
+// the buffer time.
+class SnapshotClock {
+public:
+  static constexpr double DefaultSecondsPerTick = 1.0 / 60.0;
+  // Fraction of each new tick-length observation blended into the estimate.
+  static constexpr double TickLengthSmoothing = 0.1;
+  // Fraction of the render tick's error corrected per frame.
+  static constexpr double CorrectionRate = 0.1;
+  // Errors larger than this many buffer lengths snap instead of drifting.
+  static constexpr double SnapThresholdBuffers = 2.0;
+
+  void OnSnapshot(int serverTick);
+
+  // Advances local time and returns the tick to render, or -1 before the
+  // first snapshot.
+  double Advance(double deltaTime, double bufferTime);
+
+  double GetRenderTick() const { return m_renderTick; }
+  double GetSecondsPerTick() const { return m_secondsPerTick; }
+  int GetNewestTick() const { return m_newestTick; }
+  void Reset();
+
+private:
+  double m_localTime = 0.0;
+  double m_secondsPerTick = DefaultSecondsPerTick;
+  int m_newestTick = -1;
+  double m_newestArrival = 0.0;
+  // Last arrival with a distinct local time; ticks that arrive in the same
+  // frame are folded into the next observation.
+  int m_referenceTick = -1;
+  double m_referenceTime = 0.0;
+  double m_renderTick = -1.0;
+  bool m_running = false;
+};
+} // namespace ToolKit::ToolKitNetworking
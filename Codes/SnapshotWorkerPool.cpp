@@ -0,0 +1,145 @@
+#include "SnapshotWorkerPool.h"
+
+namespace ToolKit::ToolKitNetworking {
+SnapshotWorkerPool::SnapshotWorkerPool(size_t threadCount) {
+  SetThreadCount(threadCount);
+}
+
+SnapshotWorkerPool::~SnapshotWorkerPool() { Stop(); }
+
+void SnapshotWorkerPool::SetThreadCount(size_t threadCount) {
+  if (threadCount == m_threads.size()) {
+    return;
+  }
+
+  Stop();
+  m_stopping = false;
+  m_threads.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_threads.emplace_back([this, i]() { WorkerLoop(i + 1); });
+  }
+}
+
+void SnapshotWorkerPool::Run(size_t count, const Task &task) {
+  if (count == 0) {
+    return;
+  }
+  if (m_threads.empty() || count == 1) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next.store(0, std::memory_order_relaxed);
+    m_active = m_threads.size();
+    m_generation++;
+  }
+  m_wake.notify_all();
+
+  Drain(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this]() { return m_active == 0; });
+  m_task = nullptr;
+}
+
+void SnapshotWorkerPool::WorkerLoop(size_t worker) {
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait(lock,
+                  [&]() { return m_stopping || m_generation != seen; });
+      if (m_stopping) {
+        return;
+      }
+      seen = m_generation;
+    }
+
+    Drain(worker);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_active == 0) {
+      m_done.notify_one();
+    }
+  }
+}
+
+void SnapshotWorkerPool::Drain(size_t worker) {
+  // m_task and m_count were published under the mutex before the wake-up.
+  for (size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+       index < m_count;
+       index = m_next.fetch_add(1, std::memory_order_relaxed)) {
+    (*m_task)(index, worker);
+  }
+}
+
+void SnapshotWorkerPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+  for (std::thread &thread : m_threads) {
+    thread.join();
+  }
+  m_threads.clear();
+}
+
+SnapshotJobThread::~SnapshotJobThread() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_wake.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void SnapshotJobThread::Start(std::function<void()> job) {
+  Wait();
+  if (!m_thread.joinable()) {
+    m_thread = std::thread([this]() { Loop(); });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_job = std::move(job);
+    m_busy = true;
+  }
+  m_wake.notify_one();
+}
+
+void SnapshotJobThread::Wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle.wait(lock, [this]() { return !m_busy; });
+}
+
+bool SnapshotJobThread::IsBusy() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_busy;
+}
+
+void SnapshotJobThread::Loop() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_wake.wait(lock, [this]() { return m_stopping || m_busy; });
+    if (m_busy) {
+      std::function<void()> job = std::move(m_job);
+      lock.unlock();
+      job();
+      lock.lock();
+      m_busy = false;
+      m_idle.notify_all();
+      continue;
+    }
+    return;
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Fixed set of threads that run the parallel loops of snapshot encoding. The
+// calling thread takes part as worker 0, so a pool without threads runs every
+// task inline and in order.
+class SnapshotWorkerPool {
+public:
+  // Non-owning view of a `void(size_t index, size_t worker)` callable. Run()
+  // returns before the callable goes away, so nothing is copied; a
+  // std::function would allocate for lambdas with a few captures.
+  class Task {
+  public:
+    template <typename Fn,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<Fn>, Task>>>
+    Task(Fn &&fn)
+        : m_callable(const_cast<void *>(
+              static_cast<const void *>(std::addressof(fn)))),
+          m_invoke([](void *callable, size_t index, size_t worker) {
+            (*static_cast<std::remove_reference_t<Fn> *>(callable))(index,
+                                                                   worker);
+          }) {}
+
+    void operator()(size_t index, size_t worker) const {
+      m_invoke(m_callable, index, worker);
+    }
+
+  private:
+    void *m_callable;
+    void (*m_invoke)(void *callable, size_t index, size_t worker);
+  };
+
+  explicit SnapshotWorkerPool(size_t threadCount = 0);
+  ~SnapshotWorkerPool();
+  SnapshotWorkerPool(const SnapshotWorkerPool &) = delete;
+  SnapshotWorkerPool &operator=(const SnapshotWorkerPool &) = delete;
+
+  // Joins the current threads and starts `threadCount` new ones. Must not be
+  // called while Run() is in progress.
+  void SetThreadCount(size_t threadCount);
+  size_t GetThreadCount() const { return m_threads.size(); }
+  // Threads plus the caller: the number of distinct `worker` values.
+  size_t GetWorkerCount() const { return m_threads.size() + 1; }
+
+  // Calls `task(index, worker)` once for every index in [0, count) and
+  // returns when all calls have finished. A worker runs one task at a time,
+  // so per-worker scratch needs no locking. Called from one thread only.
+  void Run(size_t count, const Task &task);
+
+private:
+  void WorkerLoop(size_t worker);
+  void Drain(size_t worker);
+  void Stop();
+
+private:
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  const Task *m_task = nullptr;
+  size_t m_count = 0;
+  std::atomic<size_t> m_next{0};
+  // Threads that have not finished the current generation yet.
+  size_t m_active = 0;
+  uint64_t m_generation = 0;
+  bool m_stopping = false;
+};
+
+// Runs one job at a time on a dedicated thread, so the snapshots of one tick
+// can be encoded while the game simulates the next.
+class SnapshotJobThread {
+public:
+  SnapshotJobThread() = default;
+  ~SnapshotJobThread();
+  SnapshotJobThread(const SnapshotJobThread &) = delete;
+  SnapshotJobThread &operator=(const SnapshotJobThread &) = delete;
+
+  // Waits for the running job, then hands `job` to the thread. The thread is
+  // started on first use.
+  void Start(std::function<void()> job);
+  // Returns once no job is running.
+  void Wait();
+  bool IsBusy();
+
+private:
+  void Loop();
+
+private:
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_idle;
+  std::function<void()> m_job;
+  bool m_busy = false;
+  bool m_stopping = false;
+};
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Lock-free queue between exactly one producer thread and one consumer
+// thread. Slots are written and read in place, so slot objects that own
+// memory (e.g. byte vectors) keep their capacity and the queue stops
+// allocating once every slot has grown to its working size.
+template <typename T> class SpscRing {
+public:
+  // `capacity` is rounded up to a power of two.
+  explicit SpscRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_slots.resize(size);
+    m_mask = size - 1;
+  }
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  size_t GetCapacity() const { return m_slots.size(); }
+
+  // Producer: the next free slot, or nullptr when the ring is full. The slot
+  // becomes visible to the consumer on CommitPush().
+  T *BeginPush() {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead == m_slots.size()) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      if (tail - m_cachedHead == m_slots.size()) {
+        return nullptr;
+      }
+    }
+    return &m_slots[tail & m_mask];
+  }
+
+  void CommitPush() {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  }
+
+  // Consumer: the oldest committed slot, or nullptr when the ring is empty.
+  // The slot stays valid until Pop().
+  T *Front() {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cachedTail) {
+        return nullptr;
+      }
+    }
+    return &m_slots[head & m_mask];
+  }
+
+  void Pop() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  }
+
+  // Approximate when called while the other side is running.
+  bool IsEmpty() const {
+    return m_head.load(std::memory_order_acquire) ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr size_t CacheLine = 64;
+
+  std::vector<T> m_slots;
+  size_t m_mask = 0;
+  // Each index is written by one side only; keeping them and the copies each
+  // side caches of the other's index on separate lines avoids false sharing.
+  alignas(CacheLine) std::atomic<size_t> m_head{0};
+  size_t m_cachedTail = 0;
+  alignas(CacheLine) std::atomic<size_t> m_tail{0};
+  size_t m_cachedHead = 0;
+};
+} // namespace ToolKit::ToolKitNetworking
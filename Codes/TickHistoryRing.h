@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+enum class TickHistoryLookup {
+  Found,
+  // The tick fell out of the history window. Callers must not use it as a
+  // baseline and should fall back to full state.
+  TooOld,
+  // The tick is inside the window but was never stored.
+  Missing
+};
+
+// Fixed-capacity history of per-tick values. Tick `t` lives in slot
+// `t % capacity`, so storing and looking up a tick is O(1) and memory stays
+// bounded for the whole session. Only the last `capacity` ticks, counted back
+// from the newest stored tick, are addressable.
+template <typename T> class TickHistoryRing {
+public:
+  static constexpr size_t DefaultCapacity = 64;
+
+  explicit TickHistoryRing(size_t capacity = DefaultCapacity) {
+    SetCapacity(capacity);
+  }
+
+  // Resizes the window. Existing history is dropped.
+  void SetCapacity(size_t capacity) {
+    m_slots.assign(capacity == 0 ? 1 : capacity, Slot());
+    m_newestTick = -1;
+  }
+
+  size_t GetCapacity() const { return m_slots.size(); }
+  int GetNewestTick() const { return m_newestTick; }
+
+  // Returns false if the tick is negative or already older than the window.
+  bool Store(int tick, const T &value) {
+    if (tick < 0 || IsTooOld(tick)) {
+      return false;
+    }
+
+    Slot &slot = m_slots[SlotIndex(tick)];
+    slot.tick = tick;
+    slot.value = value;
+    if (tick > m_newestTick) {
+      m_newestTick = tick;
+    }
+    return true;
+  }
+
+  TickHistoryLookup Lookup(int tick, T &outValue) const {
+    if (tick < 0) {
+      return TickHistoryLookup::Missing;
+    }
+
+    if (IsTooOld(tick)) {
+      return TickHistoryLookup::TooOld;
+    }
+
+    const Slot &slot = m_slots[SlotIndex(tick)];
+    if (slot.tick != tick) {
+      return TickHistoryLookup::Missing;
+    }
+
+    outValue = slot.value;
+    return TickHistoryLookup::Found;
+  }
+
+  bool IsTooOld(int tick) const {
+    return m_newestTick >= 0 &&
+           static_cast<long long>(m_newestTick) - tick >=
+               static_cast<long long>(m_slots.size());
+  }
+
+  // Forgets every tick below `minTick`.
+  void DiscardBefore(int minTick) {
+    for (Slot &slot : m_slots) {
+      if (slot.tick >= 0 && slot.tick < minTick) {
+        slot.tick = -1;
+      }
+    }
+  }
+
+  void Clear() {
+    for (Slot &slot : m_slots) {
+      slot.tick = -1;
+    }
+    m_newestTick = -1;
+  }
+
+private:
+  struct Slot {
+    int tick = -1;
+    T value{};
+  };
+
+  size_t SlotIndex(int tick) const {
+    return static_cast<size_t>(tick) % m_slots.size();
+  }
+
+private:
+  std::vector<Slot> m_slots;
+  int m_newestTick = -1;
+};
+} // namespace ToolKit::ToolKitNetworking
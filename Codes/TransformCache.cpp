@@ -0,0 +1,219 @@
+#include "TransformCache.h"
+#include <algorithm>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+TransformArrays ArraysOf(const TransformFrame &frame) {
+  TransformArrays arrays;
+  arrays.posX = frame.posX.data();
+  arrays.posY = frame.posY.data();
+  arrays.posZ = frame.posZ.data();
+  arrays.rotX = frame.rotX.data();
+  arrays.rotY = frame.rotY.data();
+  arrays.rotZ = frame.rotZ.data();
+  arrays.rotW = frame.rotW.data();
+  arrays.present = frame.present.data();
+  return arrays;
+}
+} // namespace
+
+uint8_t TransformChanges::Get(size_t slot) const {
+  if (TransformMaskTest(noBaseline.data(), slot)) {
+    return TransformNoBaseline;
+  }
+
+  uint8_t bits = 0;
+  if (TransformMaskTest(position.data(), slot)) {
+    bits |= TransformPositionChanged;
+  }
+  if (TransformMaskTest(orientation.data(), slot)) {
+    bits |= TransformOrientationChanged;
+  }
+  return bits;
+}
+
+void TransformFrame::Resize(size_t count) {
+  networkIDs.resize(count);
+  posX.resize(count);
+  posY.resize(count);
+  posZ.resize(count);
+  rotX.resize(count);
+  rotY.resize(count);
+  rotZ.resize(count);
+  rotW.resize(count);
+  present.resize(count);
+  m_sorted = false;
+}
+
+void TransformFrame::Set(size_t slot, int networkID, const Vec3 &position,
+                         const Quaternion &orientation) {
+  networkIDs[slot] = networkID;
+  posX[slot] = position.x;
+  posY[slot] = position.y;
+  posZ[slot] = position.z;
+  rotX[slot] = orientation.x;
+  rotY[slot] = orientation.y;
+  rotZ[slot] = orientation.z;
+  rotW[slot] = orientation.w;
+  present[slot] = 1;
+  m_sorted = false;
+}
+
+void TransformFrame::SetMissing(size_t slot, int networkID) {
+  Set(slot, networkID, Vec3(0.0f), Quaternion());
+  present[slot] = 0;
+}
+
+Vec3 TransformFrame::GetPosition(size_t slot) const {
+  return Vec3(posX[slot], posY[slot], posZ[slot]);
+}
+
+Quaternion TransformFrame::GetOrientation(size_t slot) const {
+  return Quaternion(rotW[slot], rotX[slot], rotY[slot], rotZ[slot]);
+}
+
+int TransformFrame::FindSlot(int networkID, size_t hint) const {
+  if (hint < networkIDs.size() && networkIDs[hint] == networkID) {
+    return static_cast<int>(hint);
+  }
+
+  if (!m_sorted) {
+    m_sortedSlots.resize(networkIDs.size());
+    for (size_t i = 0; i < networkIDs.size(); ++i) {
+      m_sortedSlots[i] = {networkIDs[i], static_cast<uint32_t>(i)};
+    }
+    std::sort(m_sortedSlots.begin(), m_sortedSlots.end());
+    m_sorted = true;
+  }
+
+  auto it = std::lower_bound(
+      m_sortedSlots.begin(), m_sortedSlots.end(), networkID,
+      [](const std::pair<int, uint32_t> &entry, int id) {
+        return entry.first < id;
+      });
+  if (it == m_sortedSlots.end() || it->first != networkID) {
+    return -1;
+  }
+  return static_cast<int>(it->second);
+}
+
+TransformCache::TransformCache(size_t capacity) { SetCapacity(capacity); }
+
+void TransformCache::SetCapacity(size_t capacity) {
+  m_frames.assign(capacity == 0 ? 1 : capacity, TransformFrame());
+  m_current = 0;
+  m_changeCount = 0;
+}
+
+TransformFrame &TransformCache::BeginFrame(int tick, size_t count) {
+  m_current = static_cast<size_t>(tick < 0 ? 0 : tick) % m_frames.size();
+  TransformFrame &frame = m_frames[m_current];
+  frame.tick = tick;
+  frame.Resize(count);
+  m_changeCount = 0;
+  return frame;
+}
+
+void TransformCache::CommitFrame(TransformFrame &frame) {
+  const int tick = frame.tick;
+  m_current = static_cast<size_t>(tick < 0 ? 0 : tick) % m_frames.size();
+  std::swap(m_frames[m_current], frame);
+  m_changeCount = 0;
+}
+
+const TransformFrame *TransformCache::FindFrame(int tick) const {
+  if (tick < 0) {
+    return nullptr;
+  }
+
+  const TransformFrame &frame =
+      m_frames[static_cast<size_t>(tick) % m_frames.size()];
+  return frame.tick == tick ? &frame : nullptr;
+}
+
+const TransformChanges &TransformCache::GetChanges(int baseTick) {
+  for (size_t i = 0; i < m_changeCount; ++i) {
+    if (m_changes[i].baseTick == baseTick) {
+      return m_changes[i];
+    }
+  }
+
+  if (m_changeCount == m_changes.size()) {
+    m_changes.emplace_back();
+  }
+  TransformChanges &changes = m_changes[m_changeCount++];
+  changes.baseTick = baseTick;
+
+  const TransformFrame &current = GetCurrent();
+  const size_t maskBytes = TransformMaskBytes(current.Size());
+  const TransformFrame *base = FindFrame(baseTick);
+  if (base == nullptr || baseTick == current.tick) {
+    changes.position.assign(maskBytes, 0xff);
+    changes.orientation.assign(maskBytes, 0xff);
+    changes.noBaseline.assign(maskBytes, 0xff);
+    return changes;
+  }
+
+  changes.position.resize(maskBytes);
+  changes.orientation.resize(maskBytes);
+  changes.noBaseline.resize(maskBytes);
+  GatherBaseline(*base);
+
+  TransformChangeMasks masks;
+  masks.position = changes.position.data();
+  masks.orientation = changes.orientation.data();
+  masks.noBaseline = changes.noBaseline.data();
+  DetectTransformChanges(ArraysOf(current), ArraysOf(m_baseline),
+                         current.Size(), TransformPositionThreshold,
+                         TransformOrientationThreshold, masks, m_kernel);
+  return changes;
+}
+
+SnapshotTransform TransformCache::GetTransform(size_t slot, int baseTick) {
+  const TransformFrame &current = GetCurrent();
+  SnapshotTransform transform;
+  transform.present = current.present[slot] != 0;
+  if (!transform.present) {
+    return transform;
+  }
+
+  transform.position = current.GetPosition(slot);
+  transform.orientation = current.GetOrientation(slot);
+  const uint8_t bits = GetChanges(baseTick).Get(slot);
+  transform.positionChanged = (bits & TransformPositionChanged) != 0;
+  transform.orientationChanged = (bits & TransformOrientationChanged) != 0;
+  transform.hasBaseline = (bits & TransformNoBaseline) != TransformNoBaseline;
+  return transform;
+}
+
+void TransformCache::Reset() {
+  for (TransformFrame &frame : m_frames) {
+    frame.tick = -1;
+    frame.Resize(0);
+  }
+  m_current = 0;
+  m_changeCount = 0;
+}
+
+void TransformCache::GatherBaseline(const TransformFrame &base) {
+  const TransformFrame &current = GetCurrent();
+  const size_t count = current.Size();
+  m_baseline.Resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const int slot = base.FindSlot(current.networkIDs[i], i);
+    if (slot < 0 || base.present[slot] == 0) {
+      m_baseline.present[i] = 0;
+      continue;
+    }
+
+    m_baseline.posX[i] = base.posX[slot];
+    m_baseline.posY[i] = base.posY[slot];
+    m_baseline.posZ[i] = base.posZ[slot];
+    m_baseline.rotX[i] = base.rotX[slot];
+    m_baseline.rotY[i] = base.rotY[slot];
+    m_baseline.rotZ[i] = base.rotZ[slot];
+    m_baseline.rotW[i] = base.rotW[slot];
+    m_baseline.present[i] = 1;
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
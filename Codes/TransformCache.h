@@ -0,0 +1,129 @@
+#pragma once
+
+#include "TransformChangeKernel.h"
+#include <Types.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+// Smallest transform moves sent in a delta: world units for the position,
+// 1 - |dot| for the orientation.
+constexpr float TransformPositionThreshold = 0.001f;
+constexpr float TransformOrientationThreshold = 0.001f;
+
+// Change bits of one entity against a baseline.
+enum TransformChange : uint8_t {
+  TransformPositionChanged = 1 << 0,
+  TransformOrientationChanged = 1 << 1,
+  TransformFullyChanged = TransformPositionChanged | TransformOrientationChanged,
+  // The baseline does not hold the entity; everything is sent in full.
+  TransformNoBaseline = TransformFullyChanged | 1 << 2
+};
+
+// Replicated transforms of one server tick, one array per component, indexed
+// by replication slot: the entity's dense index on that tick.
+struct TransformFrame {
+  int tick = -1;
+  std::vector<int> networkIDs;
+  std::vector<float> posX, posY, posZ;
+  std::vector<float> rotX, rotY, rotZ, rotW;
+  // 0 for entities without a node; their records carry no transform.
+  std::vector<uint8_t> present;
+
+  size_t Size() const { return networkIDs.size(); }
+  void Resize(size_t count);
+  void Set(size_t slot, int networkID, const Vec3 &position,
+           const Quaternion &orientation);
+  void SetMissing(size_t slot, int networkID);
+  Vec3 GetPosition(size_t slot) const;
+  Quaternion GetOrientation(size_t slot) const;
+
+  // Slot of `networkID`, or -1. `hint` is tried first; entities usually keep
+  // their slot from one tick to the next.
+  int FindSlot(int networkID, size_t hint) const;
+
+private:
+  // (networkID, slot) sorted by network ID, built on the first lookup that
+  // misses the hint.
+  mutable std::vector<std::pair<int, uint32_t>> m_sortedSlots;
+  mutable bool m_sorted = false;
+};
+
+// Change masks of the current frame against one baseline, one bit per slot
+// (see TransformMaskTest()).
+struct TransformChanges {
+  int baseTick = -1;
+  std::vector<uint8_t> position;
+  std::vector<uint8_t> orientation;
+  std::vector<uint8_t> noBaseline;
+
+  // TransformChange bits of `slot`.
+  uint8_t Get(size_t slot) const;
+};
+
+// The transform part of one entity record against one baseline.
+struct SnapshotTransform {
+  Vec3 position = Vec3(0.0f);
+  Quaternion orientation;
+  bool present = false;
+  // The entity was in the baseline, so network variables are delta encoded
+  // against it too.
+  bool hasBaseline = false;
+  bool positionChanged = true;
+  bool orientationChanged = true;
+};
+
+// Server-side history of TransformFrames. ReplicationManager reads each
+// node's world transform once per tick into the current frame; change
+// detection then runs over contiguous arrays with DetectTransformChanges(),
+// once per distinct baseline instead of once per entity record, and earlier
+// frames serve as the baselines. Does not allocate once the arrays have grown
+// to the world size.
+class TransformCache {
+public:
+  static constexpr size_t DefaultCapacity = 64;
+
+  explicit TransformCache(size_t capacity = DefaultCapacity);
+
+  // Defaults to GetBestTransformKernel().
+  void SetKernel(TransformKernel kernel) { m_kernel = kernel; }
+  TransformKernel GetKernel() const { return m_kernel; }
+
+  // Resizes the history window. Existing frames are dropped.
+  void SetCapacity(size_t capacity);
+  size_t GetCapacity() const { return m_frames.size(); }
+
+  // Frame of `tick` with `count` slots, reusing the arrays of the frame it
+  // replaces. Every slot must be set before changes are read.
+  TransformFrame &BeginFrame(int tick, size_t count);
+  // Makes `frame`, filled elsewhere, the current frame of `frame.tick`. The
+  // frame it replaces is handed back in `frame` so its arrays get reused.
+  void CommitFrame(TransformFrame &frame);
+  const TransformFrame &GetCurrent() const { return m_frames[m_current]; }
+  // Stored frame of `tick`, or nullptr once it left the window.
+  const TransformFrame *FindFrame(int tick) const;
+
+  // Changes of every current slot against the frame of `baseTick`. Slots
+  // without a baseline, because the frame is gone or the entity was not in
+  // it, are TransformNoBaseline. Computed once per baseline per tick; the
+  // reference is valid until the next GetChanges() or BeginFrame().
+  const TransformChanges &GetChanges(int baseTick);
+  SnapshotTransform GetTransform(size_t slot, int baseTick);
+
+  void Reset();
+
+private:
+  void GatherBaseline(const TransformFrame &base);
+
+private:
+  std::vector<TransformFrame> m_frames;
+  size_t m_current = 0;
+  // Baseline transforms reordered into the current frame's slots.
+  TransformFrame m_baseline;
+  std::vector<TransformChanges> m_changes;
+  size_t m_changeCount = 0;
+  TransformKernel m_kernel = GetBestTransformKernel();
+};
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,250 @@
+#include "TransformChangeKernel.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define TK_NET_TRANSFORM_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC accepts AVX2 intrinsics in any function.
+#define TK_NET_TARGET_AVX2
+#else
+#define TK_NET_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+struct KernelArgs {
+  const TransformArrays &current;
+  const TransformArrays &baseline;
+  size_t count;
+  float positionThreshold2;
+  float orientationThreshold;
+  const TransformChangeMasks &out;
+};
+
+// Bytes [firstByte, TransformMaskBytes(count)). The sums are spelled out in
+// the order the SIMD kernels add them, so every kernel rounds the same way.
+void DetectScalar(const KernelArgs &args, size_t firstByte) {
+  const TransformArrays &c = args.current;
+  const TransformArrays &b = args.baseline;
+  const size_t byteCount = TransformMaskBytes(args.count);
+  for (size_t byte = firstByte; byte < byteCount; ++byte) {
+    uint8_t moved = 0;
+    uint8_t turned = 0;
+    uint8_t missing = 0;
+    const size_t first = byte * 8;
+    const size_t last = first + 8 < args.count ? first + 8 : args.count;
+    for (size_t i = first; i < last; ++i) {
+      const float dx = c.posX[i] - b.posX[i];
+      const float dy = c.posY[i] - b.posY[i];
+      const float dz = c.posZ[i] - b.posZ[i];
+      const float distance2 = (dx * dx + dy * dy) + dz * dz;
+      const float dot = ((c.rotX[i] * b.rotX[i] + c.rotY[i] * b.rotY[i]) +
+                         c.rotZ[i] * b.rotZ[i]) +
+                        c.rotW[i] * b.rotW[i];
+      const uint8_t bit = static_cast<uint8_t>(1u << (i - first));
+      if (distance2 > args.positionThreshold2) {
+        moved |= bit;
+      }
+      if (1.0f - std::fabs(dot) > args.orientationThreshold) {
+        turned |= bit;
+      }
+      if (b.present[i] == 0) {
+        missing |= bit;
+      }
+    }
+
+    args.out.position[byte] = moved | missing;
+    args.out.orientation[byte] = turned | missing;
+    if (args.out.noBaseline != nullptr) {
+      args.out.noBaseline[byte] = missing;
+    }
+  }
+}
+
+#ifdef TK_NET_TRANSFORM_SIMD
+// Bit per zero byte among the eight at `present`.
+inline uint8_t MissingBits(const uint8_t *present) {
+  const __m128i bytes =
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(present));
+  const __m128i zero = _mm_cmpeq_epi8(bytes, _mm_setzero_si128());
+  return static_cast<uint8_t>(_mm_movemask_epi8(zero) & 0xff);
+}
+
+inline void StoreMasks(const KernelArgs &args, size_t byte, uint8_t moved,
+                       uint8_t turned, uint8_t missing) {
+  args.out.position[byte] = moved | missing;
+  args.out.orientation[byte] = turned | missing;
+  if (args.out.noBaseline != nullptr) {
+    args.out.noBaseline[byte] = missing;
+  }
+}
+
+// Four entities: position bits in the low nibble, orientation bits in the
+// high one.
+inline uint8_t DetectSse4(const KernelArgs &args, size_t i) {
+  const TransformArrays &c = args.current;
+  const TransformArrays &b = args.baseline;
+  const __m128 dx =
+      _mm_sub_ps(_mm_loadu_ps(c.posX + i), _mm_loadu_ps(b.posX + i));
+  const __m128 dy =
+      _mm_sub_ps(_mm_loadu_ps(c.posY + i), _mm_loadu_ps(b.posY + i));
+  const __m128 dz =
+      _mm_sub_ps(_mm_loadu_ps(c.posZ + i), _mm_loadu_ps(b.posZ + i));
+  const __m128 distance2 = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+  __m128 dot = _mm_mul_ps(_mm_loadu_ps(c.rotX + i), _mm_loadu_ps(b.rotX + i));
+  dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(c.rotY + i),
+                                   _mm_loadu_ps(b.rotY + i)));
+  dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(c.rotZ + i),
+                                   _mm_loadu_ps(b.rotZ + i)));
+  dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(c.rotW + i),
+                                   _mm_loadu_ps(b.rotW + i)));
+  const __m128 turn = _mm_sub_ps(_mm_set1_ps(1.0f),
+                                 _mm_andnot_ps(_mm_set1_ps(-0.0f), dot));
+
+  const int moved = _mm_movemask_ps(
+      _mm_cmpgt_ps(distance2, _mm_set1_ps(args.positionThreshold2)));
+  const int turned = _mm_movemask_ps(
+      _mm_cmpgt_ps(turn, _mm_set1_ps(args.orientationThreshold)));
+  return static_cast<uint8_t>(moved | turned << 4);
+}
+
+void DetectSse(const KernelArgs &args) {
+  const size_t fullBytes = args.count / 8;
+  for (size_t byte = 0; byte < fullBytes; ++byte) {
+    const size_t i = byte * 8;
+    const uint8_t low = DetectSse4(args, i);
+    const uint8_t high = DetectSse4(args, i + 4);
+    StoreMasks(args, byte,
+               static_cast<uint8_t>((low & 0x0f) | (high & 0x0f) << 4),
+               static_cast<uint8_t>(low >> 4 | (high & 0xf0)),
+               MissingBits(args.baseline.present + i));
+  }
+  DetectScalar(args, fullBytes);
+}
+
+TK_NET_TARGET_AVX2 void DetectAvx2(const KernelArgs &args) {
+  const TransformArrays &c = args.current;
+  const TransformArrays &b = args.baseline;
+  const __m256 positionThreshold2 = _mm256_set1_ps(args.positionThreshold2);
+  const __m256 orientationThreshold =
+      _mm256_set1_ps(args.orientationThreshold);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+
+  const size_t fullBytes = args.count / 8;
+  for (size_t byte = 0; byte < fullBytes; ++byte) {
+    const size_t i = byte * 8;
+    const __m256 dx =
+        _mm256_sub_ps(_mm256_loadu_ps(c.posX + i), _mm256_loadu_ps(b.posX + i));
+    const __m256 dy =
+        _mm256_sub_ps(_mm256_loadu_ps(c.posY + i), _mm256_loadu_ps(b.posY + i));
+    const __m256 dz =
+        _mm256_sub_ps(_mm256_loadu_ps(c.posZ + i), _mm256_loadu_ps(b.posZ + i));
+    const __m256 distance2 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+        _mm256_mul_ps(dz, dz));
+
+    __m256 dot =
+        _mm256_mul_ps(_mm256_loadu_ps(c.rotX + i), _mm256_loadu_ps(b.rotX + i));
+    dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_loadu_ps(c.rotY + i),
+                                           _mm256_loadu_ps(b.rotY + i)));
+    dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_loadu_ps(c.rotZ + i),
+                                           _mm256_loadu_ps(b.rotZ + i)));
+    dot = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_loadu_ps(c.rotW + i),
+                                           _mm256_loadu_ps(b.rotW + i)));
+    const __m256 turn = _mm256_sub_ps(one, _mm256_andnot_ps(sign, dot));
+
+    const int moved = _mm256_movemask_ps(
+        _mm256_cmp_ps(distance2, positionThreshold2, _CMP_GT_OQ));
+    const int turned = _mm256_movemask_ps(
+        _mm256_cmp_ps(turn, orientationThreshold, _CMP_GT_OQ));
+    StoreMasks(args, byte, static_cast<uint8_t>(moved),
+               static_cast<uint8_t>(turned), MissingBits(b.present + i));
+  }
+  DetectScalar(args, fullBytes);
+}
+
+bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4] = {};
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+
+  __cpuid(info, 1);
+  const bool osSavesYmm = (info[2] & (1 << 27)) != 0 &&
+                          (info[2] & (1 << 28)) != 0 &&
+                          (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+} // namespace
+
+void DetectTransformChanges(const TransformArrays &current,
+                            const TransformArrays &baseline, size_t count,
+                            float positionThreshold,
+                            float orientationThreshold,
+                            const TransformChangeMasks &out,
+                            TransformKernel kernel) {
+  const KernelArgs args{current,
+                        baseline,
+                        count,
+                        positionThreshold * positionThreshold,
+                        orientationThreshold,
+                        out};
+  if (!IsTransformKernelSupported(kernel)) {
+    kernel = TransformKernel::Scalar;
+  }
+
+  switch (kernel) {
+#ifdef TK_NET_TRANSFORM_SIMD
+  case TransformKernel::Avx2:
+    DetectAvx2(args);
+    return;
+  case TransformKernel::Sse:
+    DetectSse(args);
+    return;
+#endif
+  default:
+    DetectScalar(args, 0);
+    return;
+  }
+}
+
+bool IsTransformKernelSupported(TransformKernel kernel) {
+  switch (kernel) {
+  case TransformKernel::Scalar:
+    return true;
+#ifdef TK_NET_TRANSFORM_SIMD
+  case TransformKernel::Sse:
+    return true;
+  case TransformKernel::Avx2: {
+    static const bool hasAvx2 = CpuHasAvx2();
+    return hasAvx2;
+  }
+#endif
+  default:
+    return false;
+  }
+}
+
+TransformKernel GetBestTransformKernel() {
+  if (IsTransformKernelSupported(TransformKernel::Avx2)) {
+    return TransformKernel::Avx2;
+  }
+  if (IsTransformKernelSupported(TransformKernel::Sse)) {
+    return TransformKernel::Sse;
+  }
+  return TransformKernel::Scalar;
+}
+} // namespace ToolKit::ToolKitNetworking
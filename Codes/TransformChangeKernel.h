@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ToolKit::ToolKitNetworking {
+enum class TransformKernel {
+  Scalar,
+  // Four entities per step; always available on x86-64.
+  Sse,
+  // Eight entities per step, chosen at runtime when the CPU has AVX2.
+  Avx2
+};
+
+// One TransformFrame's arrays, or a baseline gathered into the same slots.
+struct TransformArrays {
+  const float *posX = nullptr;
+  const float *posY = nullptr;
+  const float *posZ = nullptr;
+  const float *rotX = nullptr;
+  const float *rotY = nullptr;
+  const float *rotZ = nullptr;
+  const float *rotW = nullptr;
+  // Non-zero where the entity has a transform.
+  const uint8_t *present = nullptr;
+};
+
+struct TransformChangeMasks {
+  // One bit per entity, entity `i` in bit `i % 8` of byte `i / 8`. Each mask
+  // holds TransformMaskBytes(count) bytes.
+  uint8_t *position = nullptr;
+  uint8_t *orientation = nullptr;
+  // Optional: entities without a baseline.
+  uint8_t *noBaseline = nullptr;
+};
+
+constexpr size_t TransformMaskBytes(size_t count) { return (count + 7) / 8; }
+
+inline bool TransformMaskTest(const uint8_t *mask, size_t index) {
+  return (mask[index / 8] >> (index % 8) & 1) != 0;
+}
+
+// Sets an entity's position bit where the squared distance to the baseline
+// exceeds `positionThreshold` squared, and its orientation bit where
+// 1 - |dot| exceeds `orientationThreshold`. Entities without a baseline get
+// both. Every kernel produces the same masks.
+void DetectTransformChanges(const TransformArrays &current,
+                            const TransformArrays &baseline, size_t count,
+                            float positionThreshold,
+                            float orientationThreshold,
+                            const TransformChangeMasks &out,
+                            TransformKernel kernel);
+
+bool IsTransformKernelSupported(TransformKernel kernel);
+// The widest kernel this CPU runs, detected once.
+TransformKernel GetBestTransformKernel();
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,212 @@
+#include "TransportIoThread.h"
+#include "NetworkBase.h"
+#include <algorithm>
+
+namespace ToolKit::ToolKitNetworking {
+TransportIoThread::TransportIoThread(size_t queueCapacity)
+    : m_outbound(queueCapacity), m_inbound(queueCapacity) {}
+
+TransportIoThread::~TransportIoThread() { Stop(); }
+
+void TransportIoThread::Start(ENetHost *host) {
+  Stop();
+  m_host = host;
+  // Without a wake socket the thread still runs, waiting on the host alone.
+  OpenWakeSocket();
+  m_running.store(true, std::memory_order_release);
+  m_thread = std::thread([this]() { Run(); });
+}
+
+void TransportIoThread::Stop() {
+  m_running.store(false, std::memory_order_release);
+  Wake();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  CloseWakeSocket();
+  m_host = nullptr;
+}
+
+void TransportIoThread::Send(int peerSlot, const void *data, size_t size,
+                             DeliveryChannel channel) {
+  TransportDatagram *slot = m_outbound.BeginPush();
+  while (slot == nullptr) {
+    if (!IsRunning()) {
+      return;
+    }
+    std::this_thread::yield();
+    slot = m_outbound.BeginPush();
+  }
+
+  slot->kind = TransportEventKind::Receive;
+  slot->peerSlot = peerSlot;
+  slot->channel = channel;
+  const char *bytes = static_cast<const char *>(data);
+  slot->bytes.assign(bytes, bytes + size);
+  m_outbound.CommitPush();
+
+  if (!m_wakePending.exchange(true)) {
+    Wake();
+  }
+}
+
+void TransportIoThread::Run() {
+  while (IsRunning()) {
+    // Cleared before the queue is read, so a Send() that the read misses
+    // wakes the next wait.
+    m_wakePending.store(false);
+    // enet_host_service() returns before sending when it has an event to
+    // hand out, so new datagrams are flushed right away.
+    if (SendQueued()) {
+      enet_host_flush(m_host);
+    }
+
+    // With the inbound queue full, leave packets inside ENet until the game
+    // thread catches up, but keep sending.
+    ENetEvent event;
+    if (m_inbound.BeginPush() == nullptr) {
+      enet_host_flush(m_host);
+      std::this_thread::yield();
+      continue;
+    }
+
+    int result = enet_host_service(m_host, &event, 0);
+    if (result <= 0) {
+      WaitForWork();
+      continue;
+    }
+
+    while (result > 0) {
+      const int peerSlot = static_cast<int>(event.peer->incomingPeerID);
+      if (event.type == ENET_EVENT_TYPE_CONNECT) {
+        PushEvent(TransportEventKind::Connect, peerSlot, nullptr, 0);
+      } else if (event.type == ENET_EVENT_TYPE_DISCONNECT) {
+        PushEvent(TransportEventKind::Disconnect, peerSlot, nullptr, 0);
+      } else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+        PushEvent(TransportEventKind::Receive, peerSlot, event.packet->data,
+                  event.packet->dataLength);
+        enet_packet_destroy(event.packet);
+      }
+
+      if (m_inbound.BeginPush() == nullptr) {
+        break;
+      }
+      result = enet_host_check_events(m_host, &event);
+    }
+  }
+
+  SendQueued();
+  enet_host_flush(m_host);
+}
+
+bool TransportIoThread::SendQueued() {
+  bool sent = false;
+  while (TransportDatagram *datagram = m_outbound.Front()) {
+    sent = true;
+    ENetPacket *packet = NetworkBase::CreatePooledPacket(
+        datagram->bytes.data(), datagram->bytes.size(), datagram->channel);
+    if (packet == nullptr) {
+      m_outbound.Pop();
+      continue;
+    }
+    const enet_uint8 channelID =
+        NetworkBase::GetENetChannel(datagram->channel);
+
+    bool queued = false;
+    if (datagram->peerSlot < 0) {
+      enet_host_broadcast(m_host, channelID, packet);
+      queued = true;
+    } else if (static_cast<size_t>(datagram->peerSlot) < m_host->peerCount) {
+      queued = enet_peer_send(&m_host->peers[datagram->peerSlot], channelID,
+                              packet) == 0;
+    }
+
+    // Peers that are not connected refuse the packet.
+    if (!queued) {
+      enet_packet_destroy(packet);
+    }
+    m_outbound.Pop();
+  }
+  return sent;
+}
+
+void TransportIoThread::WaitForWork() {
+  if (m_wakeSocket == ENET_SOCKET_NULL) {
+    enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+    enet_socket_wait(m_host->socket, &condition, ServiceTimeoutMs);
+    return;
+  }
+
+  ENetSocketSet readSet;
+  ENET_SOCKETSET_EMPTY(readSet);
+  ENET_SOCKETSET_ADD(readSet, m_host->socket);
+  ENET_SOCKETSET_ADD(readSet, m_wakeSocket);
+  const ENetSocket maxSocket = (std::max)(m_host->socket, m_wakeSocket);
+  if (enet_socketset_select(maxSocket, &readSet, nullptr, ServiceTimeoutMs) <=
+          0 ||
+      !ENET_SOCKETSET_CHECK(readSet, m_wakeSocket)) {
+    return;
+  }
+
+  char byte = 0;
+  ENetBuffer buffer;
+  buffer.data = &byte;
+  buffer.dataLength = sizeof(byte);
+  ENetAddress sender;
+  while (enet_socket_receive(m_wakeSocket, &sender, &buffer, 1) > 0) {
+  }
+}
+
+bool TransportIoThread::OpenWakeSocket() {
+  m_wakeSocket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+  if (m_wakeSocket == ENET_SOCKET_NULL) {
+    return false;
+  }
+
+  ENetAddress address = {};
+  address.port = 0;
+  if (enet_address_set_host_ip(&address, "127.0.0.1") != 0 ||
+      enet_socket_bind(m_wakeSocket, &address) != 0 ||
+      enet_socket_get_address(m_wakeSocket, &m_wakeAddress) != 0 ||
+      enet_socket_set_option(m_wakeSocket, ENET_SOCKOPT_NONBLOCK, 1) != 0) {
+    CloseWakeSocket();
+    return false;
+  }
+  return true;
+}
+
+void TransportIoThread::CloseWakeSocket() {
+  if (m_wakeSocket != ENET_SOCKET_NULL) {
+    enet_socket_destroy(m_wakeSocket);
+    m_wakeSocket = ENET_SOCKET_NULL;
+  }
+}
+
+void TransportIoThread::Wake() {
+  if (m_wakeSocket == ENET_SOCKET_NULL) {
+    return;
+  }
+
+  char byte = 0;
+  ENetBuffer buffer;
+  buffer.data = &byte;
+  buffer.dataLength = sizeof(byte);
+  enet_socket_send(m_wakeSocket, &m_wakeAddress, &buffer, 1);
+}
+
+bool TransportIoThread::PushEvent(TransportEventKind kind, int peerSlot,
+                                  const void *data, size_t size) {
+  TransportDatagram *slot = m_inbound.BeginPush();
+  if (slot == nullptr) {
+    return false;
+  }
+
+  slot->kind = kind;
+  slot->peerSlot = peerSlot;
+  slot->channel = DeliveryChannel::Snapshot;
+  const char *bytes = static_cast<const char *>(data);
+  slot->bytes.assign(bytes, bytes + size);
+  m_inbound.CommitPush();
+  return true;
+}
+} // namespace ToolKit::ToolKitNetworking
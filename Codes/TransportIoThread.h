@@ -0,0 +1,87 @@
+#pragma once
+
+#include "SpscRing.h"
+#include "TransportTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <enet/enet.h>
+#include <thread>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+enum class TransportEventKind : uint8_t { Connect, Disconnect, Receive };
+
+// One entry of the queues between the game thread and the I/O thread. On the
+// way in it is an ENet event; on the way out a datagram to send.
+struct TransportDatagram {
+  TransportEventKind kind = TransportEventKind::Receive;
+  // ENet peer slot. Outgoing datagrams with -1 are broadcast.
+  int peerSlot = -1;
+  DeliveryChannel channel = DeliveryChannel::Snapshot;
+  std::vector<char> bytes;
+};
+
+// Services an ENet host on its own thread, so receiving, acking and resending
+// do not wait for the next game frame. While running, the thread owns the
+// host: the game thread only talks to it through Send() and Drain(). When
+// idle the thread waits on the host's socket and on a loopback wake socket
+// that Send() pokes, so queued datagrams go out at once.
+class TransportIoThread {
+public:
+  static constexpr size_t DefaultQueueCapacity = 4096;
+  // Longest the thread waits without traffic before servicing ENet's
+  // resend and timeout timers.
+  static constexpr uint32_t ServiceTimeoutMs = 1;
+
+  explicit TransportIoThread(size_t queueCapacity = DefaultQueueCapacity);
+  ~TransportIoThread();
+
+  void Start(_ENetHost *host);
+  // Sends everything still queued and joins the thread. The host belongs to
+  // the caller again afterwards.
+  void Stop();
+  bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+  // Game thread. Copies the datagram into a queue slot; waits for room if
+  // the I/O thread has fallen a full queue behind.
+  void Send(int peerSlot, const void *data, size_t size,
+            DeliveryChannel channel);
+
+  // Game thread. Hands every event received since the last call to
+  // `handler(TransportDatagram &)` in arrival order. Returns the count.
+  template <typename Fn> size_t Drain(Fn &&handler);
+
+private:
+  void Run();
+  // True when anything was handed to ENet.
+  bool SendQueued();
+  void WaitForWork();
+  bool OpenWakeSocket();
+  void CloseWakeSocket();
+  void Wake();
+  bool PushEvent(TransportEventKind kind, int peerSlot, const void *data,
+                 size_t size);
+
+private:
+  _ENetHost *m_host = nullptr;
+  std::thread m_thread;
+  std::atomic<bool> m_running{false};
+  ENetSocket m_wakeSocket = ENET_SOCKET_NULL;
+  ENetAddress m_wakeAddress = {};
+  // Set by the first Send() after the thread last looked at the queue.
+  std::atomic<bool> m_wakePending{false};
+  SpscRing<TransportDatagram> m_outbound;
+  SpscRing<TransportDatagram> m_inbound;
+};
+
+template <typename Fn> size_t TransportIoThread::Drain(Fn &&handler) {
+  size_t count = 0;
+  while (TransportDatagram *event = m_inbound.Front()) {
+    handler(*event);
+    m_inbound.Pop();
+    count++;
+  }
+  return count;
+}
+} // namespace ToolKit::ToolKitNetworking
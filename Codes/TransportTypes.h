@@ -1,14 +1,40 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace ToolKit::ToolKitNetworking {
 struct GamePacket;
 
 using TransportPeerId = int;
 
+// Named delivery channels. Each maps onto its own ENet channel, so a lost
+// packet only stalls later packets of the same channel.
+enum class DeliveryChannel : uint8_t {
+  // Unreliable, sequenced: snapshots, and snapshot acks and input commands
+  // from clients.
+  Snapshot,
+  // Reliable, ordered: handshake, spawn and despawn.
+  Lifecycle,
+  // Reliable, ordered: RPCs.
+  ReliableRpc,
+  // Unreliable, unsequenced: RPCs that may be dropped.
+  UnreliableRpc,
+  Count
+};
+
+constexpr size_t DeliveryChannelCount =
+    static_cast<size_t>(DeliveryChannel::Count);
+
+inline bool IsReliableChannel(DeliveryChannel channel) {
+  return channel == DeliveryChannel::Lifecycle ||
+         channel == DeliveryChannel::ReliableRpc;
+}
+
 struct TransportPacketEnvelope {
   int messageType = 0;
   GamePacket *packet = nullptr;
   TransportPeerId peerId = -1;
-  bool reliable = false;
+  DeliveryChannel channel = DeliveryChannel::Snapshot;
 };
 } // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,245 @@
+// Replaces the global operator new/delete to count heap allocations, so it
+// is built as its own executable instead of joining the other tests.
+#include "NetworkBase.h"
+#include "NetworkComponent.h"
+#include "PacketBufferPool.h"
+#include "RPCDispatchTable.h"
+#include "Support/TestNetworkManager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <enet/enet.h>
+#include <gtest/gtest.h>
+#include <new>
+#include <vector>
+
+namespace {
+// Heap allocations made by any thread while counting is on, so work the
+// encoder hands to its worker threads is counted too.
+std::atomic<bool> g_countAllocations{false};
+std::atomic<size_t> g_allocationCount{0};
+
+void *CountedAllocate(size_t size) {
+  if (g_countAllocations.load(std::memory_order_relaxed)) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+// Counts the heap allocations made while `fn` runs.
+template <typename Fn> size_t CountAllocations(Fn &&fn) {
+  g_allocationCount = 0;
+  g_countAllocations = true;
+  fn();
+  g_countAllocations = false;
+  return g_allocationCount;
+}
+} // namespace
+
+void *operator new(size_t size) { return CountedAllocate(size); }
+void *operator new[](size_t size) { return CountedAllocate(size); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t) noexcept { std::free(memory); }
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+constexpr uint32_t HealthRpc = RPCNameHash("SetHealth");
+constexpr uint32_t AimRpc = RPCNameHash("SetAim");
+
+class TickedComponent : public NetworkComponent {
+public:
+  TickedComponent() {
+    RegisterNetworkVariable(&score);
+    RegisterRPC("SetHealth", [this](PacketStream &) { ++rpcCalls; });
+    RegisterRPC("SetAim", [this](PacketStream &) { ++rpcCalls; });
+  }
+
+  NetworkVariable<int> score{"score", 0};
+  int rpcCalls = 0;
+};
+
+// A server-configured ReplicationManager with three authenticated peers and
+// a world of replicated components, run one Update() per tick over a
+// FakeTransportHost that only counts what it is handed.
+class ServerFixture {
+public:
+  static constexpr int EntityCount = 64;
+  static constexpr int PeerCount = 3;
+
+  ServerFixture() : m_components(EntityCount) {
+    m_manager.ConfigureAsDedicatedServer(7777, PeerCount);
+    m_ready = m_manager.StartConfiguredSession();
+    for (int peer = 1; m_ready && peer <= PeerCount; ++peer) {
+      m_ready = AuthenticateFakePeer(m_manager, peer, 100 + peer);
+    }
+    if (!m_ready) {
+      return;
+    }
+
+    m_manager.GetFakeServer()->recordPackets = false;
+    m_manager.GetFakeServer()->sentPackets.clear();
+    for (int i = 0; i < EntityCount; ++i) {
+      m_components[i].SetNetworkID(i + 1);
+      m_manager.RegisterComponent(&m_components[i]);
+    }
+  }
+
+  ~ServerFixture() {
+    for (TickedComponent &component : m_components) {
+      m_manager.UnregisterComponent(&component);
+    }
+  }
+
+  bool IsReady() const { return m_ready; }
+
+  // Every entity changes a third of the time; each peer acks the previous
+  // tick and raises a reliable RPC plus a burst of coalesced ones.
+  void Run(int tick) {
+    for (int i = 0; i < EntityCount; ++i) {
+      if (i % 3 == tick % 3) {
+        m_components[i].score.Set(i + tick);
+      }
+    }
+
+    for (int peer = 1; peer <= PeerCount; ++peer) {
+      SnapshotAckPacket ack;
+      ack.ackTick = tick - 1;
+      m_manager.ReceivePacket(NetworkMessage::SnapshotAck, &ack, peer);
+
+      TickedComponent &component = m_components[peer - 1];
+      component.SendRPC(HealthRpc, RPCReceiver::All,
+                        100.0f - static_cast<float>(tick % 50), tick);
+      const Vec3 aim(static_cast<float>(peer), 0.0f, 1.0f);
+      for (int call = 0; call < 3; ++call) {
+        component.SendRPCWithPolicy(
+            AimRpc, RPCReceiver::Others,
+            RPCSendPolicy::Unreliable(0.0f, true), aim);
+      }
+    }
+
+    m_manager.GetFakeServer()->serverTick = tick;
+    m_manager.Update(1.0f / 60.0f);
+  }
+
+  size_t GetSentBytes() const { return m_manager.GetFakeServer()->sentBytes; }
+
+  int GetRpcCalls() const {
+    int calls = 0;
+    for (const TickedComponent &component : m_components) {
+      calls += component.rpcCalls;
+    }
+    return calls;
+  }
+
+private:
+  TestNetworkManager m_manager;
+  std::vector<TickedComponent> m_components;
+  bool m_ready = false;
+};
+
+// Waits up to a second for the next event on `host`.
+bool ServiceUntilEvent(ENetHost *host, ENetHost *other, ENetEvent &event) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (std::chrono::steady_clock::now() < deadline) {
+    enet_host_service(other, nullptr, 0);
+    if (enet_host_service(host, &event, 1) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+// Once the transform history has wrapped, every container has reached its
+// working size and a server tick allocates nothing above the transport.
+TEST(ReplicationTickAllocationTest, SteadyStateServerTickDoesNotAllocate) {
+  ServerFixture server;
+  ASSERT_TRUE(server.IsReady());
+
+  int tick = 1;
+  for (; tick <= 96; ++tick) {
+    server.Run(tick);
+  }
+
+  for (int i = 0; i < 32; ++i, ++tick) {
+    EXPECT_EQ(CountAllocations([&]() { server.Run(tick); }), 0u)
+        << "tick " << tick;
+  }
+  EXPECT_GT(server.GetSentBytes(), 0u);
+  EXPECT_GT(server.GetRpcCalls(), 0);
+}
+
+// ENet allocates through enet_malloc, which the operator new hook cannot
+// see by itself. NetworkBase::Initialise() hands those allocations to the
+// PacketBufferPool, whose buffers come from operator new, so once traffic
+// has warmed the pool, sending and receiving datagrams stays off the heap.
+TEST(ReplicationTickAllocationTest, SteadyStateENetTrafficDoesNotAllocate) {
+  NetworkBase::Initialise();
+
+  ENetAddress address;
+  enet_address_set_host(&address, "127.0.0.1");
+  address.port = 0;
+  ENetHost *server =
+      enet_host_create(&address, 1, DeliveryChannelCount, 0, 0);
+  ASSERT_NE(server, nullptr);
+  address.port = server->address.port;
+  ENetHost *client = enet_host_create(nullptr, 1, DeliveryChannelCount, 0, 0);
+  ASSERT_NE(client, nullptr);
+  enet_host_connect(client, &address, DeliveryChannelCount, 0);
+
+  ENetEvent event;
+  ASSERT_TRUE(ServiceUntilEvent(server, client, event));
+  ASSERT_EQ(event.type, ENET_EVENT_TYPE_CONNECT);
+  ENetPeer *peer = event.peer;
+  ASSERT_TRUE(ServiceUntilEvent(client, server, event));
+  ASSERT_EQ(event.type, ENET_EVENT_TYPE_CONNECT);
+
+  // A snapshot and a reliable RPC, delivered and acked.
+  std::vector<char> snapshot(1000, 's');
+  std::vector<char> rpc(64, 'r');
+  const auto exchange = [&]() {
+    for (const std::vector<char> *payload : {&snapshot, &rpc}) {
+      const DeliveryChannel channel = payload == &rpc
+                                          ? DeliveryChannel::ReliableRpc
+                                          : DeliveryChannel::Snapshot;
+      ENetPacket *packet = NetworkBase::CreatePooledPacket(
+          payload->data(), payload->size(), channel);
+      ASSERT_EQ(enet_peer_send(peer, NetworkBase::GetENetChannel(channel),
+                               packet),
+                0);
+    }
+    enet_host_flush(server);
+
+    for (int received = 0; received < 2;) {
+      ENetEvent incoming;
+      ASSERT_TRUE(ServiceUntilEvent(client, server, incoming));
+      if (incoming.type == ENET_EVENT_TYPE_RECEIVE) {
+        enet_packet_destroy(incoming.packet);
+        ++received;
+      }
+    }
+    enet_host_flush(client);
+    enet_host_service(server, &event, 1);
+  };
+
+  for (int i = 0; i < 200; ++i) {
+    exchange();
+  }
+
+  const uint64_t pooledBefore = PacketBufferPool::Get().GetCreatedCount();
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(CountAllocations(exchange), 0u) << "exchange " << i;
+  }
+  EXPECT_EQ(PacketBufferPool::Get().GetCreatedCount(), pooledBefore);
+
+  enet_host_destroy(client);
+  enet_host_destroy(server);
+  NetworkBase::Destroy();
+}
+} // namespace ToolKit::ToolKitNetworking
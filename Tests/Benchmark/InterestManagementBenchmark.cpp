@@ -0,0 +1,126 @@
+// Runs interest management over 5k moving entities for 64 peers and compares
+// the per-tick cost with a brute-force distance check of every entity against
+// every peer, along with how many snapshot records relevancy saves.
+
+#include "InterestManager.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ToolKit;
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr int EntityCount = 5000;
+constexpr int PeerCount = 64;
+constexpr int Ticks = 60;
+constexpr float WorldSize = 2000.0f;
+constexpr float Radius = 150.0f;
+constexpr float MaxStep = 2.0f;
+
+template <typename Fn> double MeasureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+size_t BruteForceRelevantCount(const std::vector<InterestEntity> &entities,
+                               const std::vector<TransportPeerId> &peers,
+                               std::vector<uint8_t> &outRelevant) {
+  outRelevant.assign(entities.size() * peers.size(), 0);
+  size_t count = 0;
+  for (size_t p = 0; p < peers.size(); ++p) {
+    const Vec3 viewer = entities[p].position;
+    for (size_t i = 0; i < entities.size(); ++i) {
+      const Vec3 offset = entities[i].position - viewer;
+      const float distanceSquared =
+          offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+      if (entities[i].ownerID == peers[p] ||
+          distanceSquared <= Radius * Radius) {
+        outRelevant[p * entities.size() + i] = 1;
+        count++;
+      }
+    }
+  }
+  return count;
+}
+} // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> coordinate(0.0f, WorldSize);
+  std::uniform_real_distribution<float> step(-MaxStep, MaxStep);
+
+  std::vector<TransportPeerId> peers(PeerCount);
+  std::vector<InterestEntity> entities(EntityCount);
+  for (int i = 0; i < EntityCount; ++i) {
+    entities[i].networkID = i + 1;
+    entities[i].hasPosition = true;
+    entities[i].position =
+        Vec3(coordinate(random), 0.0f, coordinate(random));
+  }
+
+  // The first PeerCount entities are the peers' players.
+  for (int p = 0; p < PeerCount; ++p) {
+    peers[p] = p + 1;
+    entities[p].ownerID = peers[p];
+  }
+
+  InterestManager interest;
+  interest.SetRadius(Radius);
+
+  // The first tick has no hysteresis, so it must match the brute force.
+  interest.Update(entities, peers);
+  std::vector<uint8_t> expected;
+  BruteForceRelevantCount(entities, peers, expected);
+  for (size_t p = 0; p < peers.size(); ++p) {
+    for (size_t i = 0; i < entities.size(); ++i) {
+      const bool relevant = interest.IsRelevant(peers[p], static_cast<int>(i));
+      if (relevant != (expected[p * entities.size() + i] != 0)) {
+        std::printf("relevancy mismatch: peer %d entity %d\n", peers[p],
+                    entities[i].networkID);
+        return 1;
+      }
+    }
+  }
+
+  double gridMs = 0.0;
+  double bruteForceMs = 0.0;
+  size_t relevantRecords = 0;
+  size_t enterLeaveEvents = 0;
+  for (int tick = 0; tick < Ticks; ++tick) {
+    for (InterestEntity &entity : entities) {
+      entity.position.x += step(random);
+      entity.position.z += step(random);
+    }
+
+    gridMs += MeasureMs([&]() { interest.Update(entities, peers); });
+    bruteForceMs += MeasureMs(
+        [&]() { BruteForceRelevantCount(entities, peers, expected); });
+
+    for (TransportPeerId peerID : peers) {
+      enterLeaveEvents += interest.GetEntered(peerID).size() +
+                          interest.GetLeft(peerID).size();
+      for (int i = 0; i < EntityCount; ++i) {
+        relevantRecords += interest.IsRelevant(peerID, i) ? 1 : 0;
+      }
+    }
+  }
+
+  const double recordsPerTick = static_cast<double>(relevantRecords) / Ticks;
+  std::printf("interest management, %d entities, %d peers, radius %.0f\n",
+              EntityCount, PeerCount, Radius);
+  std::printf("  grid update:        %.3f ms/tick\n", gridMs / Ticks);
+  std::printf("  brute force:        %.3f ms/tick\n", bruteForceMs / Ticks);
+  std::printf("  relevant per peer:  %.1f of %d entities\n",
+              recordsPerTick / PeerCount, EntityCount);
+  std::printf("  snapshot records:   %.0f/tick vs %d without interest\n",
+              recordsPerTick, EntityCount * PeerCount);
+  std::printf("  spawn/despawn:      %.1f/tick\n",
+              static_cast<double>(enterLeaveEvents) / Ticks);
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Records 1k hittable entities per tick into the lag-compensation history and
+// validates 512 hitscans per tick from 64 peers, each rewound to its own view
+// tick.
+
+#include "LagCompensation.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ToolKit;
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr int EntityCount = 1000;
+constexpr int PeerCount = 64;
+constexpr int ShotsPerPeer = 8;
+constexpr int Ticks = 300;
+constexpr double TickTime = 1.0 / 60.0;
+constexpr float WorldSize = 500.0f;
+
+template <typename Fn> double MeasureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+} // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> coordinate(0.0f, WorldSize);
+  std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  std::uniform_int_distribution<int> latency(2, 20);
+
+  std::vector<Vec3> positions(EntityCount);
+  for (Vec3 &position : positions) {
+    position = Vec3(coordinate(random), 0.0f, coordinate(random));
+  }
+
+  LagCompensationHistory history;
+  LagCompensationFrame rewound;
+  const Vec3 boundsMin(-0.5f, 0.0f, -0.5f);
+  const Vec3 boundsMax(0.5f, 2.0f, 0.5f);
+
+  double recordMs = 0.0;
+  double rewindMs = 0.0;
+  double raycastMs = 0.0;
+  size_t hits = 0;
+  size_t shots = 0;
+  for (int tick = 0; tick < Ticks; ++tick) {
+    for (Vec3 &position : positions) {
+      position.x += step(random);
+      position.z += step(random);
+    }
+
+    recordMs += MeasureMs([&]() {
+      LagCompensationFrame &frame = history.BeginFrame(tick, tick * TickTime);
+      // Registry order is not ID order; record back to front.
+      for (int i = EntityCount - 1; i >= 0; --i) {
+        frame.Add(i + 1, positions[i], Quaternion(), boundsMin, boundsMax);
+      }
+      history.EndFrame();
+    });
+
+    for (int peer = 0; peer < PeerCount; ++peer) {
+      const int ackedTick = (std::max)(0, tick - latency(random));
+      rewindMs += MeasureMs([&]() {
+        const double viewTick = history.ResolveViewTick(ackedTick, 0.1);
+        history.Rewind(viewTick, peer + 1, nullptr, rewound);
+      });
+
+      // Shots from the peer's player towards random directions.
+      const Vec3 origin = rewound.positions[peer] + Vec3(0.0f, 1.0f, 0.0f);
+      for (int shot = 0; shot < ShotsPerPeer; ++shot) {
+        const float a = angle(random);
+        const Vec3 direction(std::cos(a), 0.0f, std::sin(a));
+        LagCompensationHit hit;
+        raycastMs += MeasureMs([&]() {
+          hits += LagCompensation::Raycast(rewound, origin, direction, 200.0f,
+                                           peer + 1, hit)
+                      ? 1
+                      : 0;
+        });
+        shots++;
+      }
+    }
+  }
+
+  std::printf("lag compensation, %d entities, %d peers, %d shots/tick\n",
+              EntityCount, PeerCount, PeerCount * ShotsPerPeer);
+  std::printf("  record:   %.3f ms/tick\n", recordMs / Ticks);
+  std::printf("  rewind:   %.3f ms/tick (%.1f us/peer)\n", rewindMs / Ticks,
+              rewindMs * 1000.0 / (Ticks * PeerCount));
+  std::printf("  raycast:  %.3f ms/tick (%.1f us/shot)\n", raycastMs / Ticks,
+              raycastMs * 1000.0 / static_cast<double>(shots));
+  std::printf("  hit rate: %.1f%%\n",
+              100.0 * static_cast<double>(hits) / static_cast<double>(shots));
+  return 0;
+}
@@ -0,0 +1,74 @@
+// Queues an RPC-heavy tick for 64 peers (small reliable RPCs and spawns plus
+// an unreliable snapshot fragment each) and compares the number of datagrams
+// with and without per-peer bundling.
+
+#include "PacketBatcher.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ToolKit;
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr int PeerCount = 64;
+constexpr int Ticks = 600;
+constexpr int RpcsPerPeer = 24;
+constexpr int SpawnsPerPeer = 2;
+constexpr int SnapshotBytes = 480;
+constexpr int MaxRpcBytes = 48;
+} // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<int> rpcSize(8, MaxRpcBytes);
+
+  std::vector<char> rpcBuffer(sizeof(GamePacket) + MaxRpcBytes, 0);
+  std::vector<char> snapshotBuffer(sizeof(GamePacket) + SnapshotBytes, 0);
+  GamePacket *rpc = reinterpret_cast<GamePacket *>(rpcBuffer.data());
+  *rpc = GamePacket(NetworkMessage::RPC);
+  GamePacket *snapshot = reinterpret_cast<GamePacket *>(snapshotBuffer.data());
+  *snapshot = GamePacket(NetworkMessage::Snapshot);
+  snapshot->size = SnapshotBytes;
+  SpawnPacket spawn;
+
+  std::vector<PacketBatcher> peers(PeerCount);
+  size_t messages = 0;
+  size_t datagrams = 0;
+  size_t bytes = 0;
+  double elapsedMs = 0.0;
+  for (int tick = 0; tick < Ticks; ++tick) {
+    auto start = std::chrono::steady_clock::now();
+    for (PacketBatcher &peer : peers) {
+      for (int i = 0; i < RpcsPerPeer; ++i) {
+        rpc->size = static_cast<short>(rpcSize(random));
+        peer.Queue(*rpc, DeliveryChannel::ReliableRpc);
+      }
+      for (int i = 0; i < SpawnsPerPeer; ++i) {
+        peer.Queue(spawn, DeliveryChannel::Lifecycle);
+      }
+      peer.Queue(*snapshot, DeliveryChannel::Snapshot);
+      messages += RpcsPerPeer + SpawnsPerPeer + 1;
+
+      peer.Flush([&](const void *, size_t size, DeliveryChannel) {
+        datagrams++;
+        bytes += size;
+      });
+    }
+    elapsedMs += std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  }
+
+  std::printf("packet batching, %d peers, %d messages/peer/tick\n", PeerCount,
+              RpcsPerPeer + SpawnsPerPeer + 1);
+  std::printf("  datagrams:  %.1f/tick unbundled, %.1f/tick bundled (%.1fx)\n",
+              static_cast<double>(messages) / Ticks,
+              static_cast<double>(datagrams) / Ticks,
+              static_cast<double>(messages) / static_cast<double>(datagrams));
+  std::printf("  avg size:   %.0f bytes/datagram\n",
+              static_cast<double>(bytes) / static_cast<double>(datagrams));
+  std::printf("  queue+flush: %.3f ms/tick\n", elapsedMs / Ticks);
+  return 0;
+}
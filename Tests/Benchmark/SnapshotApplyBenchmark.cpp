@@ -0,0 +1,121 @@
+// Applies a 10k-entity snapshot payload on the receive side, resolving every
+// entity record through NetworkIdRegistry, and compares it with the linear
+// network ID scan the replication manager used before the registry existed.
+
+#include "NetworkIdRegistry.h"
+#include "NetworkPackets.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr int EntityCount = 10000;
+constexpr int Iterations = 20;
+
+struct ReplicatedEntity {
+  int networkID = -1;
+  float position[3] = {};
+  float rotation[4] = {};
+};
+
+// Mirrors the snapshot entity record: networkID, payload size, payload.
+PacketStream BuildSnapshotPayload(const std::vector<ReplicatedEntity> &source) {
+  PacketStream stream;
+  for (const ReplicatedEntity &entity : source) {
+    stream.Write(entity.networkID);
+    stream.Write(static_cast<int>(sizeof(entity.position) +
+                                  sizeof(entity.rotation)));
+    stream.Write(entity.position);
+    stream.Write(entity.rotation);
+  }
+  return stream;
+}
+
+template <typename FindFn>
+int ApplySnapshot(PacketStream &stream, FindFn &&find) {
+  stream.readOffset = 0;
+  int applied = 0;
+  for (int i = 0; i < EntityCount; ++i) {
+    int networkID = -1;
+    int payloadSize = 0;
+    if (!stream.Read(networkID) || !stream.Read(payloadSize)) {
+      break;
+    }
+
+    if (ReplicatedEntity *target = find(networkID)) {
+      stream.Read(target->position);
+      stream.Read(target->rotation);
+      applied++;
+    } else if (!stream.SkipChecked(payloadSize)) {
+      break;
+    }
+  }
+  return applied;
+}
+
+template <typename Fn> double MeasureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < Iterations; ++i) {
+    fn();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / Iterations;
+}
+} // namespace
+
+int main() {
+  std::vector<ReplicatedEntity> serverEntities(EntityCount);
+  std::vector<ReplicatedEntity> clientEntities(EntityCount);
+  for (int i = 0; i < EntityCount; ++i) {
+    serverEntities[i].networkID = i + 1;
+    serverEntities[i].position[0] = static_cast<float>(i);
+    serverEntities[i].rotation[3] = 1.0f;
+    clientEntities[i].networkID = i + 1;
+  }
+
+  NetworkIdRegistry<ReplicatedEntity> registry;
+  registry.Reserve(EntityCount);
+  for (ReplicatedEntity &entity : clientEntities) {
+    registry.Insert(entity.networkID, &entity);
+  }
+
+  // Snapshot order differs from registration order on a real client.
+  std::vector<ReplicatedEntity> sendOrder(serverEntities.rbegin(),
+                                          serverEntities.rend());
+  PacketStream snapshot = BuildSnapshotPayload(sendOrder);
+
+  int registryApplied = 0;
+  const double registryMs = MeasureMs([&]() {
+    registryApplied = ApplySnapshot(
+        snapshot, [&](int networkID) { return registry.Find(networkID); });
+  });
+
+  int linearApplied = 0;
+  const double linearMs = MeasureMs([&]() {
+    linearApplied = ApplySnapshot(snapshot, [&](int networkID) {
+      for (ReplicatedEntity &entity : clientEntities) {
+        if (entity.networkID == networkID) {
+          return &entity;
+        }
+      }
+      return static_cast<ReplicatedEntity *>(nullptr);
+    });
+  });
+
+  std::printf("snapshot apply, %d entities\n", EntityCount);
+  std::printf("  registry lookup: %.3f ms\n", registryMs);
+  std::printf("  linear scan:     %.3f ms\n", linearMs);
+
+  if (registryApplied != EntityCount || linearApplied != EntityCount ||
+      clientEntities[0].position[0] != 0.0f ||
+      clientEntities[EntityCount - 1].position[0] !=
+          static_cast<float>(EntityCount - 1)) {
+    std::printf("snapshot apply produced unexpected state\n");
+    return 1;
+  }
+
+  return 0;
+}
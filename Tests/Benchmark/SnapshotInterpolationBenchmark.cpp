@@ -0,0 +1,75 @@
+// Measures the per-frame cost of sampling interpolation buffers for 1k remote
+// entities, including the buffer pushes of a 20 Hz snapshot stream rendered
+// at 60 Hz.
+
+#include "SnapshotInterpolation.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ToolKit;
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr int EntityCount = 1000;
+constexpr int Frames = 6000;
+constexpr int FramesPerSnapshot = 3;
+constexpr double FrameTime = 1.0 / 60.0;
+constexpr double BufferTime = 0.1;
+} // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+
+  std::vector<InterpolationBuffer> buffers(EntityCount);
+  std::vector<Vec3> positions(EntityCount, Vec3(0.0f));
+  std::vector<Vec3> rendered(EntityCount);
+  std::vector<Quaternion> orientations(EntityCount);
+  SnapshotClock clock;
+
+  int tick = 0;
+  size_t interpolated = 0;
+  double pushMs = 0.0;
+  double sampleMs = 0.0;
+  for (int frame = 0; frame < Frames; ++frame) {
+    if (frame % FramesPerSnapshot == 0) {
+      for (Vec3 &position : positions) {
+        position.x += step(random);
+        position.z += step(random);
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < EntityCount; ++i) {
+        buffers[i].Push(tick, positions[i], Quaternion());
+      }
+      clock.OnSnapshot(tick++);
+      pushMs += std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const double renderTick = clock.Advance(FrameTime, BufferTime);
+    for (int i = 0; i < EntityCount; ++i) {
+      interpolated += buffers[i].Sample(renderTick, 0.0, rendered[i],
+                                        orientations[i]) ==
+                      InterpolationResult::Interpolated;
+    }
+    sampleMs += std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+  }
+
+  const double samples = static_cast<double>(EntityCount) * Frames;
+  std::printf("snapshot interpolation, %d entities, %d frames\n", EntityCount,
+              Frames);
+  std::printf("  sample:        %.3f ms/frame (%.1f ns/entity)\n",
+              sampleMs / Frames, sampleMs * 1e6 / samples);
+  std::printf("  push:          %.3f ms/snapshot\n",
+              pushMs / (Frames / FramesPerSnapshot));
+  std::printf("  interpolated:  %.1f%% of samples\n",
+              100.0 * static_cast<double>(interpolated) / samples);
+  return 0;
+}
@@ -0,0 +1,174 @@
+// Encodes the transforms of 10k entities against four baselines per tick, as
+// a server with peers on different acks does. Compares per-entity reads and
+// baseline lookups, as NetworkComponent::Serialize did, with one
+// TransformCache capture per tick and change detection over its arrays.
+
+#include "NetworkPackets.h"
+#include "TickHistoryRing.h"
+#include "TransformCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ToolKit;
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr int EntityCount = 10000;
+constexpr int Ticks = 200;
+constexpr int BaselineLags[] = {1, 2, 4, 8};
+constexpr float MovingShare = 0.25f;
+
+// Stands in for the engine node: a heap object behind a virtual call.
+class TransformSource {
+public:
+  virtual ~TransformSource() = default;
+  virtual Vec3 GetTranslation() const { return m_position; }
+  virtual Quaternion GetOrientation() const { return m_orientation; }
+
+  Vec3 m_position = Vec3(0.0f);
+  Quaternion m_orientation;
+};
+
+struct BaselineState {
+  Vec3 position = Vec3(0.0f);
+  Quaternion orientation;
+};
+
+struct PerEntityState {
+  TransformSource *source = nullptr;
+  TickHistoryRing<BaselineState> history;
+};
+
+void WriteRecord(PacketStream &stream, int networkID, int baseTick,
+                 const Vec3 &position, const Quaternion &orientation,
+                 bool positionChanged, bool orientationChanged) {
+  stream.WriteInt(networkID);
+  stream.WriteInt(baseTick);
+  stream.WriteInt(0);
+  PropertySerializer serializer(stream);
+  serializer.Write(NetworkProperty::Position, position, positionChanged);
+  serializer.Write(NetworkProperty::Orientation, orientation,
+                   orientationChanged);
+}
+
+template <typename Fn> double MeasureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+} // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> coordinate(0.0f, 500.0f);
+  std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+  std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+
+  // Allocated in a shuffled order so neighbouring entities are not
+  // neighbours in memory, as with scene nodes.
+  std::vector<std::unique_ptr<TransformSource>> storage(EntityCount);
+  std::vector<int> order(EntityCount);
+  for (int i = 0; i < EntityCount; ++i) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), random);
+  for (int index : order) {
+    storage[index] = std::make_unique<TransformSource>();
+    storage[index]->m_position =
+        Vec3(coordinate(random), 0.0f, coordinate(random));
+  }
+
+  std::vector<PerEntityState> entities(EntityCount);
+  for (int i = 0; i < EntityCount; ++i) {
+    entities[i].source = storage[i].get();
+  }
+
+  TransformCache cache;
+  PacketStream perEntityStream(EntityCount * 48);
+  PacketStream cachedStream(EntityCount * 48);
+  double perEntityMs = 0.0;
+  double captureMs = 0.0;
+  double cachedMs = 0.0;
+  size_t perEntityBytes = 0;
+  size_t cachedBytes = 0;
+
+  for (int tick = 0; tick < Ticks; ++tick) {
+    for (auto &source : storage) {
+      if (chance(random) < MovingShare) {
+        source->m_position.x += step(random);
+        source->m_position.z += step(random);
+      }
+    }
+
+    perEntityMs += MeasureMs([&]() {
+      perEntityStream.Clear();
+      for (int lag : BaselineLags) {
+        const int baseTick = tick - lag;
+        for (int i = 0; i < EntityCount; ++i) {
+          PerEntityState &entity = entities[i];
+          const Vec3 position = entity.source->GetTranslation();
+          const Quaternion orientation = entity.source->GetOrientation();
+          BaselineState base;
+          const bool hasBase = entity.history.Lookup(baseTick, base) ==
+                               TickHistoryLookup::Found;
+          const bool moved =
+              !hasBase || glm::distance(position, base.position) >
+                              TransformPositionThreshold;
+          const bool turned =
+              !hasBase ||
+              1.0f - std::abs(glm::dot(orientation, base.orientation)) >
+                  TransformOrientationThreshold;
+          WriteRecord(perEntityStream, i + 1, baseTick, position, orientation,
+                      moved, turned);
+          entity.history.Store(tick, BaselineState{position, orientation});
+        }
+      }
+    });
+    perEntityBytes += perEntityStream.GetSize();
+
+    captureMs += MeasureMs([&]() {
+      TransformFrame &frame = cache.BeginFrame(tick, EntityCount);
+      for (int i = 0; i < EntityCount; ++i) {
+        frame.Set(i, i + 1, entities[i].source->GetTranslation(),
+                  entities[i].source->GetOrientation());
+      }
+    });
+
+    cachedMs += MeasureMs([&]() {
+      cachedStream.Clear();
+      const TransformFrame &frame = cache.GetCurrent();
+      for (int lag : BaselineLags) {
+        const int baseTick = tick - lag;
+        const TransformChanges &changes = cache.GetChanges(baseTick);
+        for (int i = 0; i < EntityCount; ++i) {
+          WriteRecord(cachedStream, i + 1, baseTick, frame.GetPosition(i),
+                      frame.GetOrientation(i),
+                      TransformMaskTest(changes.position.data(), i),
+                      TransformMaskTest(changes.orientation.data(), i));
+        }
+      }
+    });
+    cachedBytes += cachedStream.GetSize();
+  }
+
+  const size_t baselines = sizeof(BaselineLags) / sizeof(BaselineLags[0]);
+  std::printf("transform encoding, %d entities, %zu baselines/tick\n",
+              EntityCount, baselines);
+  std::printf("  per entity:    %.3f ms/tick (%.3f ms/baseline)\n",
+              perEntityMs / Ticks, perEntityMs / (Ticks * baselines));
+  std::printf("  cache capture: %.3f ms/tick\n", captureMs / Ticks);
+  std::printf("  cache encode:  %.3f ms/tick (%.3f ms/baseline)\n",
+              cachedMs / Ticks, cachedMs / (Ticks * baselines));
+
+  if (perEntityBytes != cachedBytes) {
+    std::printf("cached encoding produced different records\n");
+    return 1;
+  }
+  return 0;
+}
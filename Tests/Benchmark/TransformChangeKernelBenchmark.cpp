@@ -0,0 +1,120 @@
+// Runs transform change detection over 100k entities with each kernel the CPU
+// supports and checks that they agree with the scalar one.
+
+#include "TransformChangeKernel.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace ToolKit::ToolKitNetworking;
+
+namespace {
+constexpr size_t EntityCount = 100000;
+constexpr int Iterations = 200;
+constexpr float PositionThreshold = 0.001f;
+constexpr float OrientationThreshold = 0.001f;
+
+struct Columns {
+  std::vector<float> posX, posY, posZ, rotX, rotY, rotZ, rotW;
+  std::vector<uint8_t> present;
+
+  Columns()
+      : posX(EntityCount), posY(EntityCount), posZ(EntityCount),
+        rotX(EntityCount), rotY(EntityCount), rotZ(EntityCount),
+        rotW(EntityCount, 1.0f), present(EntityCount, 1) {}
+
+  TransformArrays Arrays() const {
+    return TransformArrays{posX.data(), posY.data(), posZ.data(), rotX.data(),
+                           rotY.data(), rotZ.data(), rotW.data(),
+                           present.data()};
+  }
+};
+
+struct Masks {
+  std::vector<uint8_t> position = std::vector<uint8_t>(
+      TransformMaskBytes(EntityCount));
+  std::vector<uint8_t> orientation = std::vector<uint8_t>(
+      TransformMaskBytes(EntityCount));
+
+  TransformChangeMasks Out() {
+    return TransformChangeMasks{position.data(), orientation.data(), nullptr};
+  }
+};
+
+const char *KernelName(TransformKernel kernel) {
+  switch (kernel) {
+  case TransformKernel::Sse:
+    return "sse";
+  case TransformKernel::Avx2:
+    return "avx2";
+  default:
+    return "scalar";
+  }
+}
+
+double MeasureMs(const Columns &current, const Columns &baseline,
+                 TransformKernel kernel, Masks &masks) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < Iterations; ++i) {
+    DetectTransformChanges(current.Arrays(), baseline.Arrays(), EntityCount,
+                           PositionThreshold, OrientationThreshold,
+                           masks.Out(), kernel);
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / Iterations;
+}
+} // namespace
+
+int main() {
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> coordinate(0.0f, 500.0f);
+  std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+  // A quarter of the world moves and a tenth turns between the two ticks.
+  Columns baseline;
+  Columns current;
+  for (size_t i = 0; i < EntityCount; ++i) {
+    baseline.posX[i] = current.posX[i] = coordinate(random);
+    baseline.posZ[i] = current.posZ[i] = coordinate(random);
+    const float yaw = angle(random);
+    baseline.rotY[i] = current.rotY[i] = std::sin(yaw * 0.5f);
+    baseline.rotW[i] = current.rotW[i] = std::cos(yaw * 0.5f);
+    if (chance(random) < 0.25f) {
+      current.posX[i] += 0.1f;
+    }
+    if (chance(random) < 0.1f) {
+      current.rotY[i] = std::sin(yaw * 0.5f + 0.05f);
+      current.rotW[i] = std::cos(yaw * 0.5f + 0.05f);
+    }
+  }
+
+  Masks expected;
+  const double scalarMs =
+      MeasureMs(current, baseline, TransformKernel::Scalar, expected);
+  std::printf("transform change detection, %zu entities\n", EntityCount);
+  std::printf("  %-6s %.3f ms\n", KernelName(TransformKernel::Scalar),
+              scalarMs);
+
+  int result = 0;
+  for (TransformKernel kernel : {TransformKernel::Sse, TransformKernel::Avx2}) {
+    if (!IsTransformKernelSupported(kernel)) {
+      std::printf("  %-6s not supported\n", KernelName(kernel));
+      continue;
+    }
+
+    Masks masks;
+    const double ms = MeasureMs(current, baseline, kernel, masks);
+    std::printf("  %-6s %.3f ms (%.1fx)\n", KernelName(kernel), ms,
+                scalarMs / ms);
+    if (masks.position != expected.position ||
+        masks.orientation != expected.orientation) {
+      std::printf("  %s masks differ from scalar\n", KernelName(kernel));
+      result = 1;
+    }
+  }
+  return result;
+}
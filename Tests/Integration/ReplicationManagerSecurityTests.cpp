@@ -1,5 +1,5 @@
 #include "NetworkManager.h"
-#include "Support/FakeTransport.h"
+#include "Support/TestNetworkManager.h"
 #include <ToolKit.h>
 #include <gtest/gtest.h>
 #include <algorithm>
@@ -7,14 +7,6 @@
 
 namespace ToolKit::ToolKitNetworking {
 namespace {
-template <size_t N>
-void CopyPacketText(char (&target)[N], const char *value) {
-  std::memset(target, 0, N);
-  if (value != nullptr) {
-    std::memcpy(target, value, (std::min)(N - 1, std::strlen(value)));
-  }
-}
-
 class ToolKitTestEnvironment : public ::testing::Environment {
 public:
   void SetUp() override {
@@ -30,77 +22,6 @@ private:
 
 const auto g_toolkitEnvironment =
     ::testing::AddGlobalTestEnvironment(new ToolKitTestEnvironment());
-
-class TestNetworkManager : public NetworkManager {
-public:
-  TestNetworkManager() { NativeConstruct(true); }
-
-  void ConfigureAsDedicatedServer(uint16_t listenPort = 7777,
-                                  uint maxClients = 2,
-                                  const String &sessionId = {},
-                                  const String &joinCredential = {},
-                                  bool requireJoinCredential = false,
-                                  const String &buildCompatibilityId = {}) {
-    m_role.SetEnum(NetworkRole::DedicatedServer);
-    m_listenPort = listenPort;
-    m_maxClients = maxClients;
-    m_sessionId = sessionId;
-    m_joinCredential = joinCredential;
-    m_requireJoinCredential = requireJoinCredential;
-    m_buildCompatibilityId = buildCompatibilityId;
-  }
-
-  void ConfigureAsClient(const String &host = "127.0.0.1", uint port = 7777,
-                         const String &sessionId = {},
-                         const String &joinCredential = {},
-                         const String &buildCompatibilityId = {}) {
-    m_role.SetEnum(NetworkRole::Client);
-    m_connectHost = host;
-    m_connectPort = port;
-    m_sessionId = sessionId;
-    m_joinCredential = joinCredential;
-    m_buildCompatibilityId = buildCompatibilityId;
-  }
-
-  void SetClockNow(uint64_t *nowMs) {
-    SetReplicationClockNowProviderForTests([nowMs]() { return *nowMs; });
-  }
-
-  std::shared_ptr<FakeTransportHost> GetFakeServer() const { return m_fakeServer; }
-  std::shared_ptr<FakeTransportPeer> GetFakeClient() const { return m_fakeClient; }
-
-  bool StartServerTransport(uint16_t port) override {
-    lastStartedServerPort = port;
-    m_fakeServer = std::make_shared<FakeTransportHost>();
-    m_server = m_fakeServer;
-    return true;
-  }
-
-  bool StartClientTransport(const String &host, uint16_t port) override {
-    m_fakeClient = std::make_shared<FakeTransportPeer>();
-    m_fakeClient->connectedHost = host.c_str();
-    m_fakeClient->connectedPort = static_cast<int>(port);
-    m_fakeClient->connectResult = true;
-    m_fakeClient->connected = true;
-    m_client = m_fakeClient;
-    return true;
-  }
-
-public:
-  uint16_t lastStartedServerPort = 0;
-
-private:
-  std::shared_ptr<FakeTransportHost> m_fakeServer;
-  std::shared_ptr<FakeTransportPeer> m_fakeClient;
-};
-
-HandshakeHelloPacket MakeValidHello(uint64_t clientNonce = 1001) {
-  HandshakeHelloPacket hello;
-  hello.protocolVersion = SessionProtocol::Version;
-  hello.requestedHostingMode = static_cast<uint>(HostingMode::Client);
-  hello.clientNonce = clientNonce;
-  return hello;
-}
 } // namespace
 
 TEST(ReplicationManagerSecurityTest, MalformedHandshakeHelloIsRejectedWithProtocolError) {
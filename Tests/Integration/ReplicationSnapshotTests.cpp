@@ -0,0 +1,418 @@
+#include "NetworkComponent.h"
+#include "Support/TestNetworkManager.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+size_t CountPacketsOfType(const FakeTransportHost &host, int type) {
+  return static_cast<size_t>(
+      std::count_if(host.sentPackets.begin(), host.sentPackets.end(),
+                    [type](const SentPacketRecord &record) {
+                      return record.type == type;
+                    }));
+}
+
+class ScoreComponent : public NetworkComponent {
+public:
+  ScoreComponent() { RegisterNetworkVariable(&score); }
+
+  NetworkVariable<int> score{"score", 0};
+};
+
+// A one-record, full-state snapshot carrying `score` for `networkID`,
+// encoded the way the server encodes it.
+std::vector<char> MakeScoreSnapshot(int serverTick, int networkID,
+                                    int score) {
+  ReplicationFrame frame;
+  frame.Begin(serverTick, 1);
+  frame.AddEntity(networkID, 0, 1.0f, 1, 0, QuantizationRange(), 0);
+  PacketStream value;
+  NetSerializer<int>::Write(value, score);
+  const uint32_t offset = 0;
+  frame.SetVariables(&serverTick, &offset, 1, value.buffer.data(),
+                     value.GetSize());
+
+  SnapshotTransform transform;
+  transform.present = true;
+  PacketStream record;
+  std::vector<uint8_t> maskScratch;
+  WriteEntityRecord(frame, 0, -1, transform, record, maskScratch);
+
+  WorldSnapshotPacket header;
+  header.serverTick = serverTick;
+  header.entityCount = 1;
+  header.size = static_cast<short>(sizeof(WorldSnapshotPacket) -
+                                   sizeof(GamePacket) + record.GetSize());
+  std::vector<char> bytes(sizeof(WorldSnapshotPacket));
+  std::memcpy(bytes.data(), &header, sizeof(WorldSnapshotPacket));
+  bytes.insert(bytes.end(), record.buffer.begin(), record.buffer.end());
+  return bytes;
+}
+
+const SnapshotAckPacket *FindLastAck(const FakeTransportPeer &client) {
+  for (auto it = client.sentPackets.rbegin(); it != client.sentPackets.rend();
+       ++it) {
+    if (it->type == NetworkMessage::SnapshotAck) {
+      return it->As<SnapshotAckPacket>();
+    }
+  }
+
+  return nullptr;
+}
+} // namespace
+
+TEST(ReplicationSnapshotTest, PeersSharingABaselineReceiveOneSharedSnapshot) {
+  TestNetworkManager manager;
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 2, 202));
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.sentPackets.clear();
+  host.sharedSendCalls = 0;
+
+  manager.Update(0.0f);
+
+  EXPECT_EQ(host.sharedSendCalls, 1);
+  ASSERT_EQ(CountPacketsOfType(host, NetworkMessage::Snapshot), 2u);
+
+  const SentPacketRecord *first =
+      host.FindLastPacketForPeer(NetworkMessage::Snapshot, 1);
+  const SentPacketRecord *second =
+      host.FindLastPacketForPeer(NetworkMessage::Snapshot, 2);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(first->bytes, second->bytes);
+}
+
+TEST(ReplicationSnapshotTest, SnapshotRecordsArrivingBeforeTheSpawnAreApplied) {
+  TestNetworkManager manager;
+  manager.ConfigureAsClient();
+  ASSERT_TRUE(AuthenticateFakeClient(manager));
+
+  // The snapshot overtakes the spawn of entity 7 on the unreliable channel.
+  std::vector<char> snapshot = MakeScoreSnapshot(10, 7, 42);
+  manager.ReceivePacket(NetworkMessage::Snapshot,
+                        reinterpret_cast<GamePacket *>(snapshot.data()), -1);
+
+  // The tick is acked, so the server will encode deltas against it.
+  const SnapshotAckPacket *ack = FindLastAck(*manager.GetFakeClient());
+  ASSERT_NE(ack, nullptr);
+  EXPECT_EQ(ack->ackTick, 10);
+
+  ScoreComponent component;
+  component.SetNetworkID(7);
+  manager.RegisterComponent(&component);
+
+  EXPECT_EQ(component.score.Get(), 42);
+}
+
+TEST(ReplicationSnapshotTest, UnspawnedEntitiesNeverHoldBackTheAck) {
+  TestNetworkManager manager;
+  manager.ConfigureAsClient();
+  ASSERT_TRUE(AuthenticateFakeClient(manager));
+
+  // Far more entities than the buffer keeps, none of which ever spawns.
+  for (int tick = 10; tick < 210; ++tick) {
+    std::vector<char> snapshot = MakeScoreSnapshot(tick, 1000 + tick, tick);
+    manager.ReceivePacket(NetworkMessage::Snapshot,
+                          reinterpret_cast<GamePacket *>(snapshot.data()), -1);
+
+    const SnapshotAckPacket *ack = FindLastAck(*manager.GetFakeClient());
+    ASSERT_NE(ack, nullptr);
+    ASSERT_EQ(ack->ackTick, tick);
+  }
+}
+
+TEST(ReplicationSnapshotTest, RecordsForDespawnedEntitiesAreDropped) {
+  TestNetworkManager manager;
+  manager.ConfigureAsClient();
+  ASSERT_TRUE(AuthenticateFakeClient(manager));
+
+  std::vector<char> before = MakeScoreSnapshot(10, 7, 42);
+  manager.ReceivePacket(NetworkMessage::Snapshot,
+                        reinterpret_cast<GamePacket *>(before.data()), -1);
+
+  DespawnPacket despawn;
+  despawn.networkID = 7;
+  manager.ReceivePacket(NetworkMessage::Despawn, &despawn, -1);
+
+  // Sent before the despawn, arriving after it.
+  std::vector<char> late = MakeScoreSnapshot(11, 7, 43);
+  manager.ReceivePacket(NetworkMessage::Snapshot,
+                        reinterpret_cast<GamePacket *>(late.data()), -1);
+  const SnapshotAckPacket *ack = FindLastAck(*manager.GetFakeClient());
+  ASSERT_NE(ack, nullptr);
+  EXPECT_EQ(ack->ackTick, 11);
+
+  ScoreComponent component;
+  component.SetNetworkID(7);
+  manager.RegisterComponent(&component);
+
+  EXPECT_EQ(component.score.Get(), 0);
+}
+
+TEST(ReplicationSnapshotTest, TransportIsFlushedOncePerTickAfterSending) {
+  TestNetworkManager manager;
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.sentPackets.clear();
+  host.flushCalls = 0;
+
+  manager.Update(0.0f);
+
+  EXPECT_EQ(host.flushCalls, 1);
+  EXPECT_EQ(CountPacketsOfType(host, NetworkMessage::Snapshot), 1u);
+}
+
+TEST(ReplicationSnapshotTest, SnapshotsAndSessionTrafficUseSeparateChannels) {
+  TestNetworkManager manager;
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  const SentPacketRecord *accept =
+      host.FindLastPacketForPeer(NetworkMessage::HandshakeAccept, 1);
+  ASSERT_NE(accept, nullptr);
+  EXPECT_EQ(accept->channel, DeliveryChannel::Lifecycle);
+  EXPECT_TRUE(accept->reliable);
+
+  manager.Update(0.0f);
+
+  const SentPacketRecord *snapshot =
+      host.FindLastPacketForPeer(NetworkMessage::Snapshot, 1);
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->channel, DeliveryChannel::Snapshot);
+  EXPECT_FALSE(snapshot->reliable);
+}
+
+TEST(ReplicationSnapshotTest, PeersWithDifferentBaselinesAreEncodedSeparately) {
+  TestNetworkManager manager;
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 2, 202));
+
+  SnapshotAckPacket ack;
+  ack.ackTick = 5;
+  manager.ReceivePacket(NetworkMessage::SnapshotAck, &ack, 1);
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.serverTick = 6;
+  host.sentPackets.clear();
+  host.sharedSendCalls = 0;
+
+  manager.Update(0.0f);
+
+  EXPECT_EQ(host.sharedSendCalls, 2);
+  const SentPacketRecord *acked =
+      host.FindLastPacketForPeer(NetworkMessage::Snapshot, 1);
+  const SentPacketRecord *unacked =
+      host.FindLastPacketForPeer(NetworkMessage::Snapshot, 2);
+  ASSERT_NE(acked, nullptr);
+  ASSERT_NE(unacked, nullptr);
+
+  WorldSnapshotPacket ackedHeader;
+  WorldSnapshotPacket unackedHeader;
+  std::memcpy(&ackedHeader, acked->bytes.data(), sizeof(WorldSnapshotPacket));
+  std::memcpy(&unackedHeader, unacked->bytes.data(), sizeof(WorldSnapshotPacket));
+  EXPECT_EQ(ackedHeader.baseTick, 5);
+  EXPECT_EQ(unackedHeader.baseTick, -1);
+}
+
+TEST(ReplicationSnapshotTest, BaselinesOlderThanTheHistoryWindowGetFullState) {
+  TestNetworkManager manager;
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+
+  SnapshotAckPacket ack;
+  ack.ackTick = 5;
+  manager.ReceivePacket(NetworkMessage::SnapshotAck, &ack, 1);
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.serverTick = 5 + static_cast<int>(manager.GetStateHistoryDepthVal());
+  host.sentPackets.clear();
+
+  manager.Update(0.0f);
+
+  const SentPacketRecord *snapshot =
+      host.FindLastPacketForPeer(NetworkMessage::Snapshot, 1);
+  ASSERT_NE(snapshot, nullptr);
+  WorldSnapshotPacket header;
+  std::memcpy(&header, snapshot->bytes.data(), sizeof(WorldSnapshotPacket));
+  EXPECT_EQ(header.baseTick, -1);
+}
+
+TEST(ReplicationSnapshotTest, LargeWorldsAreSplitIntoMtuSizedFragments) {
+  TestNetworkManager manager;
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+
+  // Declared after the manager so they unregister before it goes away.
+  std::vector<std::unique_ptr<NetworkComponent>> components;
+  for (int i = 0; i < 400; ++i) {
+    components.push_back(std::make_unique<NetworkComponent>());
+    manager.RegisterComponent(components.back().get());
+  }
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.sentPackets.clear();
+
+  manager.Update(0.0f);
+
+  std::vector<WorldSnapshotPacket> headers;
+  for (const SentPacketRecord &record : host.sentPackets) {
+    if (record.type != NetworkMessage::Snapshot || record.peerId != 1) {
+      continue;
+    }
+
+    EXPECT_LE(record.bytes.size(), SnapshotFragmenter::DefaultMaxFragmentBytes);
+    WorldSnapshotPacket header;
+    std::memcpy(&header, record.bytes.data(), sizeof(WorldSnapshotPacket));
+    EXPECT_EQ(static_cast<size_t>(header.GetTotalSize()), record.bytes.size());
+    headers.push_back(header);
+  }
+
+  ASSERT_GT(headers.size(), 1u);
+  int nextEntity = 0;
+  for (size_t i = 0; i < headers.size(); ++i) {
+    EXPECT_EQ(headers[i].fragmentIndex, static_cast<short>(i));
+    EXPECT_EQ(headers[i].fragmentCount, static_cast<short>(headers.size()));
+    EXPECT_EQ(headers[i].firstEntityIndex, nextEntity);
+    nextEntity += headers[i].entityCount;
+  }
+  EXPECT_EQ(nextEntity, static_cast<int>(components.size()));
+}
+
+TEST(ReplicationSnapshotTest, EncodeThreadsProduceTheSameBytesAsTheGameThread) {
+  const auto encodeWorld = [](uint encodeThreads) {
+    TestNetworkManager manager;
+    manager.SetSnapshotEncodeThreadsVal(encodeThreads);
+    manager.ConfigureAsDedicatedServer(7777, 4);
+    EXPECT_TRUE(manager.StartConfiguredSession());
+    for (int peer = 1; peer <= 3; ++peer) {
+      EXPECT_TRUE(AuthenticateFakePeer(manager, peer, 100 + peer));
+    }
+
+    SnapshotAckPacket ack;
+    ack.ackTick = 5;
+    manager.ReceivePacket(NetworkMessage::SnapshotAck, &ack, 1);
+
+    std::vector<std::unique_ptr<NetworkComponent>> components;
+    for (int i = 0; i < 400; ++i) {
+      components.push_back(std::make_unique<NetworkComponent>());
+      manager.RegisterComponent(components.back().get());
+    }
+
+    FakeTransportHost &host = *manager.GetFakeServer();
+    host.serverTick = 6;
+    host.sentPackets.clear();
+    manager.Update(0.0f);
+
+    std::vector<SentPacketRecord> snapshots;
+    for (const SentPacketRecord &record : host.sentPackets) {
+      if (record.type == NetworkMessage::Snapshot) {
+        snapshots.push_back(record);
+      }
+    }
+    return snapshots;
+  };
+
+  const std::vector<SentPacketRecord> serial = encodeWorld(0);
+  const std::vector<SentPacketRecord> parallel = encodeWorld(3);
+
+  ASSERT_GT(serial.size(), 3u);
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (size_t i = 0; i < serial.size(); ++i) {
+    EXPECT_EQ(serial[i].peerId, parallel[i].peerId);
+    EXPECT_EQ(serial[i].bytes, parallel[i].bytes);
+  }
+}
+
+TEST(ReplicationSnapshotTest, AsyncEncodingSendsTheCapturedFrameAfterTheWorldMoved) {
+  TestNetworkManager manager;
+  manager.SetAsyncSnapshotEncodingVal(true);
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+
+  std::vector<std::unique_ptr<NetworkComponent>> components;
+  for (int i = 0; i < 400; ++i) {
+    components.push_back(std::make_unique<NetworkComponent>());
+    manager.RegisterComponent(components.back().get());
+  }
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.serverTick = 6;
+  host.sentPackets.clear();
+  manager.Update(0.0f);
+  EXPECT_EQ(CountPacketsOfType(host, NetworkMessage::Snapshot), 0u);
+
+  // Tick 6 is being encoded from its frame; destroying every entity while
+  // the next tick simulates must not change what goes out.
+  components.clear();
+  host.serverTick = 7;
+  manager.Update(0.0f);
+
+  int entities = 0;
+  for (const SentPacketRecord &record : host.sentPackets) {
+    if (record.type != NetworkMessage::Snapshot) {
+      continue;
+    }
+
+    WorldSnapshotPacket header;
+    std::memcpy(&header, record.bytes.data(), sizeof(WorldSnapshotPacket));
+    if (header.serverTick == 6) {
+      entities += header.entityCount;
+    }
+  }
+  EXPECT_EQ(entities, 400);
+}
+
+TEST(ReplicationSnapshotTest, FixedTickRateDecouplesTicksAndSnapshotsFromUpdates) {
+  TestNetworkManager manager;
+  manager.SetServerTickRateVal(60.0f);
+  manager.SetSnapshotSendRateVal(20.0f);
+  manager.SetMaxCatchUpTicksVal(5);
+  manager.ConfigureAsDedicatedServer(7777, 4);
+  ASSERT_TRUE(manager.StartConfiguredSession());
+  ASSERT_TRUE(AuthenticateFakePeer(manager, 1, 101));
+
+  FakeTransportHost &host = *manager.GetFakeServer();
+  host.sentPackets.clear();
+  host.tickAdvances = 0;
+  host.updateCalls = 0;
+  host.flushCalls = 0;
+
+  // Shorter than a tick: the transport is serviced but nothing simulates.
+  manager.Update(0.004f);
+  EXPECT_EQ(host.updateCalls, 1);
+  EXPECT_EQ(host.flushCalls, 1);
+  EXPECT_EQ(host.tickAdvances, 0);
+  EXPECT_EQ(CountPacketsOfType(host, NetworkMessage::Snapshot), 0u);
+
+  // 60 Hz ticks send a 20 Hz snapshot on every third one.
+  for (int i = 0; i < 12; ++i) {
+    manager.Update(1.0f / 60.0f);
+  }
+  EXPECT_EQ(host.tickAdvances, 12);
+  EXPECT_EQ(CountPacketsOfType(host, NetworkMessage::Snapshot), 4u);
+
+  // A one-second hitch runs MaxCatchUpTicks ticks and sends one snapshot.
+  host.sentPackets.clear();
+  host.tickAdvances = 0;
+  manager.Update(1.0f);
+  EXPECT_EQ(host.tickAdvances, 5);
+  EXPECT_EQ(CountPacketsOfType(host, NetworkMessage::Snapshot), 1u);
+}
+} // namespace ToolKit::ToolKitNetworking
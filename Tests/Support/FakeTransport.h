@@ -11,6 +11,7 @@ namespace ToolKit::ToolKitNetworking {
 struct SentPacketRecord {
   TransportPeerId peerId = -1;
   int type = None;
+  DeliveryChannel channel = DeliveryChannel::Snapshot;
   bool reliable = false;
   std::vector<char> bytes;
 
@@ -29,30 +30,53 @@ public:
   void Shutdown() override { shutdownCalls++; }
 
   bool SendGlobalReliablePacket(GamePacket &packet) const override {
-    return SendGlobalPacket(packet, true);
+    return SendGlobalPacket(packet, DeliveryChannel::Lifecycle);
   }
 
-  bool SendGlobalPacket(GamePacket &packet, bool reliable = false) const override {
-    return SendPacketToPeer(-1, packet, reliable);
+  bool SendGlobalPacket(
+      GamePacket &packet,
+      DeliveryChannel channel = DeliveryChannel::Snapshot) const override {
+    return SendPacketToPeer(-1, packet, channel);
   }
 
   bool SendGlobalPacket(int messageID) const override {
     GamePacket packet(static_cast<short>(messageID));
-    return SendPacketToPeer(-1, packet, false);
+    return SendPacketToPeer(-1, packet, DeliveryChannel::Snapshot);
   }
 
-  bool SendPacketToPeer(TransportPeerId peerID, GamePacket &packet,
-                        bool reliable = false) const override {
+  bool SendPacketToPeer(
+      TransportPeerId peerID, GamePacket &packet,
+      DeliveryChannel channel = DeliveryChannel::Snapshot) const override {
+    sentPacketCount++;
+    sentBytes += static_cast<size_t>(packet.GetTotalSize());
+    if (!recordPackets) {
+      return true;
+    }
+
     SentPacketRecord record;
     record.peerId = peerID;
     record.type = packet.type;
-    record.reliable = reliable;
+    record.channel = channel;
+    record.reliable = IsReliableChannel(channel);
     record.bytes.resize(static_cast<size_t>(packet.GetTotalSize()));
     std::memcpy(record.bytes.data(), &packet, record.bytes.size());
     sentPackets.push_back(record);
     return true;
   }
 
+  bool SendPacketToPeers(const std::vector<TransportPeerId> &peerIDs,
+                         GamePacket &packet,
+                         DeliveryChannel channel =
+                             DeliveryChannel::Snapshot) const override {
+    sharedSendCalls++;
+    for (TransportPeerId peerID : peerIDs) {
+      SendPacketToPeer(peerID, packet, channel);
+    }
+    return !peerIDs.empty();
+  }
+
+  void FlushOutgoing() override { flushCalls++; }
+
   void AddPeer(TransportPeerId peerID) override {
     if (std::find(connectedPeers.begin(), connectedPeers.end(), peerID) ==
         connectedPeers.end()) {
@@ -75,8 +99,9 @@ public:
   }
 
   std::string GetIpAddress() const override { return "127.0.0.1"; }
-  void UpdateServer() override {}
-  int GetServerTick() const override { return 0; }
+  void UpdateServer() override { ++updateCalls; }
+  void AdvanceServerTick() override { ++tickAdvances; }
+  int GetServerTick() const override { return serverTick; }
   void RegisterPacketHandler(int, PacketReceiver *) override {}
   void ClearPacketHandlers() override {}
 
@@ -93,9 +118,18 @@ public:
 
 public:
   mutable std::vector<SentPacketRecord> sentPackets;
+  // Off, sends are only counted, so the host itself never allocates.
+  bool recordPackets = true;
+  mutable size_t sentPacketCount = 0;
+  mutable size_t sentBytes = 0;
+  mutable int sharedSendCalls = 0;
+  int flushCalls = 0;
   std::vector<TransportPeerId> connectedPeers;
   bool initialised = true;
   int shutdownCalls = 0;
+  int serverTick = 0;
+  int updateCalls = 0;
+  int tickAdvances = 0;
 };
 
 class FakeTransportPeer : public ITransportPeer {
@@ -112,15 +146,19 @@ public:
   TransportPeerId GetPeerID() const override { return peerID; }
   void SetPeerID(TransportPeerId peerId) override { peerID = peerId; }
 
-  void SendPacket(GamePacket &payload, bool reliable = false) override {
+  void SendPacket(GamePacket &payload,
+                  DeliveryChannel channel = DeliveryChannel::Snapshot) override {
     SentPacketRecord record;
     record.type = payload.type;
-    record.reliable = reliable;
+    record.channel = channel;
+    record.reliable = IsReliableChannel(channel);
     record.bytes.resize(static_cast<size_t>(payload.GetTotalSize()));
     std::memcpy(record.bytes.data(), &payload, record.bytes.size());
     sentPackets.push_back(record);
   }
 
+  void FlushOutgoing() override { flushCalls++; }
+
   void Disconnect() override {
     connected = false;
     disconnectCalls++;
@@ -137,6 +175,7 @@ public:
   bool connectResult = true;
   bool connected = false;
   int disconnectCalls = 0;
+  int flushCalls = 0;
   TransportPeerId peerID = -1;
 };
 } // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "NetworkManager.h"
+#include "Support/FakeTransport.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ToolKit::ToolKitNetworking {
+template <size_t N>
+void CopyPacketText(char (&target)[N], const char *value) {
+  std::memset(target, 0, N);
+  if (value != nullptr) {
+    std::memcpy(target, value, (std::min)(N - 1, std::strlen(value)));
+  }
+}
+
+class TestNetworkManager : public NetworkManager {
+public:
+  TestNetworkManager() {
+    NativeConstruct(true);
+    // One tick and one snapshot per Update(), whatever its delta time.
+    m_serverTickRate = 0.0f;
+    m_snapshotSendRate = 0.0f;
+  }
+
+  void ConfigureAsDedicatedServer(uint16_t listenPort = 7777,
+                                  uint maxClients = 2,
+                                  const String &sessionId = {},
+                                  const String &joinCredential = {},
+                                  bool requireJoinCredential = false,
+                                  const String &buildCompatibilityId = {}) {
+    m_role.SetEnum(NetworkRole::DedicatedServer);
+    m_listenPort = listenPort;
+    m_maxClients = maxClients;
+    m_sessionId = sessionId;
+    m_joinCredential = joinCredential;
+    m_requireJoinCredential = requireJoinCredential;
+    m_buildCompatibilityId = buildCompatibilityId;
+  }
+
+  void ConfigureAsClient(const String &host = "127.0.0.1", uint port = 7777,
+                         const String &sessionId = {},
+                         const String &joinCredential = {},
+                         const String &buildCompatibilityId = {}) {
+    m_role.SetEnum(NetworkRole::Client);
+    m_connectHost = host;
+    m_connectPort = port;
+    m_sessionId = sessionId;
+    m_joinCredential = joinCredential;
+    m_buildCompatibilityId = buildCompatibilityId;
+  }
+
+  void SetClockNow(uint64_t *nowMs) {
+    SetReplicationClockNowProviderForTests([nowMs]() { return *nowMs; });
+  }
+
+  std::shared_ptr<FakeTransportHost> GetFakeServer() const { return m_fakeServer; }
+  std::shared_ptr<FakeTransportPeer> GetFakeClient() const { return m_fakeClient; }
+
+  bool StartServerTransport(uint16_t port) override {
+    lastStartedServerPort = port;
+    m_fakeServer = std::make_shared<FakeTransportHost>();
+    m_server = m_fakeServer;
+    return true;
+  }
+
+  bool StartClientTransport(const String &host, uint16_t port) override {
+    m_fakeClient = std::make_shared<FakeTransportPeer>();
+    m_fakeClient->connectedHost = host.c_str();
+    m_fakeClient->connectedPort = static_cast<int>(port);
+    m_fakeClient->connectResult = true;
+    m_fakeClient->connected = true;
+    m_client = m_fakeClient;
+    return true;
+  }
+
+public:
+  uint16_t lastStartedServerPort = 0;
+
+private:
+  std::shared_ptr<FakeTransportHost> m_fakeServer;
+  std::shared_ptr<FakeTransportPeer> m_fakeClient;
+};
+
+inline HandshakeHelloPacket MakeValidHello(uint64_t clientNonce = 1001) {
+  HandshakeHelloPacket hello;
+  hello.protocolVersion = SessionProtocol::Version;
+  hello.requestedHostingMode = static_cast<uint>(HostingMode::Client);
+  hello.clientNonce = clientNonce;
+  return hello;
+}
+
+// Drives the hello/challenge/response exchange so `peerId` is accepted as an
+// authenticated replication peer on a server-configured manager.
+inline bool AuthenticateFakePeer(TestNetworkManager &manager, int peerId,
+                                 uint64_t clientNonce) {
+  HandshakeHelloPacket hello = MakeValidHello(clientNonce);
+  manager.ReceivePacket(NetworkMessage::HandshakeHello, &hello, peerId);
+
+  const SentPacketRecord *challenge =
+      manager.GetFakeServer()->FindLastPacketForPeer(
+          NetworkMessage::HandshakeChallenge, peerId);
+  if (challenge == nullptr || challenge->As<HandshakeChallengePacket>() == nullptr) {
+    return false;
+  }
+
+  HandshakeResponsePacket response;
+  response.clientNonce = challenge->As<HandshakeChallengePacket>()->clientNonce;
+  response.serverNonce = challenge->As<HandshakeChallengePacket>()->serverNonce;
+  manager.ReceivePacket(NetworkMessage::HandshakeResponse, &response, peerId);
+  return manager.GetFakeServer()->FindLastPacketForPeer(
+             NetworkMessage::HandshakeAccept, peerId) != nullptr;
+}
+
+// Starts a client-configured manager and answers its hello with a challenge
+// and an accept, as a server would, so replication traffic is let through.
+inline bool AuthenticateFakeClient(TestNetworkManager &manager,
+                                   int assignedPeerId = 1,
+                                   uint64_t serverNonce = 2002) {
+  if (!manager.StartConfiguredSession()) {
+    return false;
+  }
+  manager.Update(0.0f);
+
+  const HandshakeHelloPacket *hello = nullptr;
+  for (const SentPacketRecord &record : manager.GetFakeClient()->sentPackets) {
+    if (record.type == NetworkMessage::HandshakeHello) {
+      hello = record.As<HandshakeHelloPacket>();
+    }
+  }
+  if (hello == nullptr) {
+    return false;
+  }
+
+  HandshakeChallengePacket challenge;
+  challenge.clientNonce = hello->clientNonce;
+  challenge.serverNonce = serverNonce;
+  manager.ReceivePacket(NetworkMessage::HandshakeChallenge, &challenge, -1);
+
+  HandshakeAcceptPacket accept;
+  accept.assignedPeerID = assignedPeerId;
+  manager.ReceivePacket(NetworkMessage::HandshakeAccept, &accept, -1);
+  return manager.IsSessionAuthenticated();
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,236 @@
+#include "NetworkPackets.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+QuantizationRange WorldRange() {
+  QuantizationRange range;
+  range.min = -512.0f;
+  range.max = 512.0f;
+  range.bits = 18;
+  return range;
+}
+
+float QuaternionAngleError(const Quaternion &a, const Quaternion &b) {
+  const float d = std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+  return 2.0f * std::acos((std::min)(1.0f, d));
+}
+} // namespace
+
+TEST(BitPackerTest, RoundTripsBitsAndBooleansAcrossByteBoundaries) {
+  std::vector<char> buffer;
+  {
+    BitPacker packer(buffer);
+    packer.WriteBool(true);
+    packer.WriteBits(0x5, 3);
+    packer.WriteBool(false);
+    packer.WriteBits(0x1ABCD, 17);
+    packer.WriteBits(0xFFFFFFFFu, 32);
+    EXPECT_EQ(packer.GetBitsWritten(), 54u);
+  }
+  EXPECT_EQ(buffer.size(), 7u);
+
+  BitReader reader(buffer.data(), buffer.size());
+  bool flag = false;
+  uint32_t value = 0;
+  ASSERT_TRUE(reader.ReadBool(flag));
+  EXPECT_TRUE(flag);
+  ASSERT_TRUE(reader.ReadBits(value, 3));
+  EXPECT_EQ(value, 0x5u);
+  ASSERT_TRUE(reader.ReadBool(flag));
+  EXPECT_FALSE(flag);
+  ASSERT_TRUE(reader.ReadBits(value, 17));
+  EXPECT_EQ(value, 0x1ABCDu);
+  ASSERT_TRUE(reader.ReadBits(value, 32));
+  EXPECT_EQ(value, 0xFFFFFFFFu);
+}
+
+TEST(BitPackerTest, VarIntsUseZigZagAndStaySmallForSmallMagnitudes) {
+  EXPECT_EQ(BitPacking::ZigZagEncode(0), 0u);
+  EXPECT_EQ(BitPacking::ZigZagEncode(-1), 1u);
+  EXPECT_EQ(BitPacking::ZigZagEncode(1), 2u);
+  EXPECT_EQ(BitPacking::ZigZagDecode(BitPacking::ZigZagEncode(INT32_MIN)),
+            INT32_MIN);
+
+  const int32_t values[] = {0, -1, 63, -64, 64, 100000, INT32_MAX, INT32_MIN};
+  std::vector<char> buffer;
+  {
+    BitPacker packer(buffer);
+    for (int32_t v : values) {
+      packer.WriteVarInt(v);
+    }
+  }
+
+  BitReader reader(buffer.data(), buffer.size());
+  for (int32_t expected : values) {
+    int32_t value = 0;
+    ASSERT_TRUE(reader.ReadVarInt(value));
+    EXPECT_EQ(value, expected);
+  }
+
+  std::vector<char> small;
+  {
+    BitPacker packer(small);
+    packer.WriteVarUInt(127);
+  }
+  EXPECT_EQ(small.size(), 1u);
+}
+
+TEST(BitPackerTest, QuantizedFloatsStayWithinOneStep) {
+  const QuantizationRange range = WorldRange();
+  const float step = (range.max - range.min) / ((1 << range.bits) - 1);
+  const Vec3 position(12.345f, -300.5f, 511.9f);
+
+  std::vector<char> buffer;
+  {
+    BitPacker packer(buffer);
+    packer.WriteQuantizedVec3(position, range);
+  }
+  EXPECT_EQ(buffer.size(), 7u);
+
+  BitReader reader(buffer.data(), buffer.size());
+  Vec3 decoded;
+  ASSERT_TRUE(reader.ReadQuantizedVec3(decoded, range));
+  EXPECT_NEAR(decoded.x, position.x, step);
+  EXPECT_NEAR(decoded.y, position.y, step);
+  EXPECT_NEAR(decoded.z, position.z, step);
+}
+
+TEST(BitPackerTest, QuantizationClampsOutOfRangeAndNanValues) {
+  const QuantizationRange range = WorldRange();
+  EXPECT_EQ(BitPacking::QuantizeFloat(10000.0f, range),
+            (1u << range.bits) - 1);
+  EXPECT_EQ(BitPacking::QuantizeFloat(-10000.0f, range), 0u);
+  EXPECT_EQ(BitPacking::QuantizeFloat(std::nanf(""), range), 0u);
+}
+
+TEST(BitPackerTest, SmallestThreeQuaternionsRoundTripInFourBytes) {
+  const Quaternion rotations[] = {
+      Quaternion(1.0f, 0.0f, 0.0f, 0.0f),
+      Quaternion(0.0f, 0.0f, 0.0f, 1.0f),
+      Quaternion(0.5f, -0.5f, 0.5f, -0.5f),
+      Quaternion(-0.9238795f, 0.0f, 0.3826834f, 0.0f),
+      Quaternion(0.1825742f, 0.3651484f, 0.5477226f, 0.7302967f)};
+
+  for (const Quaternion &rotation : rotations) {
+    std::vector<char> buffer;
+    {
+      BitPacker packer(buffer);
+      packer.WriteQuaternion(rotation);
+      EXPECT_EQ(packer.GetBitsWritten(), 32u);
+    }
+    ASSERT_EQ(buffer.size(), 4u);
+
+    BitReader reader(buffer.data(), buffer.size());
+    Quaternion decoded;
+    ASSERT_TRUE(reader.ReadQuaternion(decoded));
+    EXPECT_LT(QuaternionAngleError(rotation, decoded), 0.005f);
+  }
+}
+
+TEST(BitPackerTest, ReaderRejectsTruncatedAndOverlongInput) {
+  const char one = 0x7F;
+  BitReader reader(&one, 1);
+  uint32_t value = 0;
+  EXPECT_FALSE(reader.ReadBits(value, 9));
+  EXPECT_TRUE(reader.HasOverflowed());
+  EXPECT_FALSE(reader.ReadBits(value, 1));
+
+  const char overlong[6] = {'\xFF', '\xFF', '\xFF', '\xFF', '\xFF', 0x01};
+  BitReader varReader(overlong, sizeof(overlong));
+  EXPECT_FALSE(varReader.ReadVarUInt(value));
+  EXPECT_TRUE(varReader.HasOverflowed());
+}
+
+TEST(BitPackerTest, PropertySerializerPacksOnlyOptedInProperties) {
+  const QuantizationRange range = WorldRange();
+  const Vec3 position(1.0f, 2.0f, 3.0f);
+  const Quaternion rotation(0.5f, -0.5f, 0.5f, -0.5f);
+
+  PacketStream raw;
+  {
+    PropertySerializer serializer(raw);
+    serializer.WriteQuantized(NetworkProperty::Position, position,
+                              QuantizationRange(), true);
+    serializer.WriteCompressed(NetworkProperty::Orientation, rotation, 0, true);
+  }
+
+  PacketStream packed;
+  {
+    PropertySerializer serializer(packed);
+    serializer.WriteQuantized(NetworkProperty::Position, position, range, true);
+    serializer.WriteCompressed(NetworkProperty::Orientation, rotation,
+                               BitPacking::DefaultQuaternionBits, true);
+    serializer.Write(NetworkProperty::Scale, 7, true);
+  }
+
+  EXPECT_EQ(raw.GetSize(), 1u + sizeof(Vec3) + sizeof(Quaternion));
+  EXPECT_EQ(packed.GetSize(), 1u + 7u + 4u + sizeof(int));
+
+  PacketReader reader = packed.GetReader();
+  PropertyDeserializer deserializer(reader);
+  Vec3 decodedPosition;
+  Quaternion decodedRotation;
+  int trailing = 0;
+  deserializer.ReadQuantized(NetworkProperty::Position, decodedPosition, Vec3(),
+                             range);
+  deserializer.ReadCompressed(NetworkProperty::Orientation, decodedRotation,
+                              Quaternion(), BitPacking::DefaultQuaternionBits);
+  deserializer.Read(NetworkProperty::Scale, trailing, 0);
+
+  EXPECT_NEAR(decodedPosition.y, 2.0f, 0.01f);
+  EXPECT_LT(QuaternionAngleError(rotation, decodedRotation), 0.005f);
+  EXPECT_EQ(trailing, 7);
+}
+
+TEST(BitPackerTest, PropertyDeserializerKeepsDefaultsForUnchangedProperties) {
+  PacketStream stream;
+  {
+    PropertySerializer serializer(stream);
+    serializer.WriteQuantized(NetworkProperty::Position, Vec3(1, 1, 1),
+                              WorldRange(), false);
+  }
+
+  PacketReader reader = stream.GetReader();
+  PropertyDeserializer deserializer(reader);
+  Vec3 value;
+  deserializer.ReadQuantized(NetworkProperty::Position, value, Vec3(4, 5, 6),
+                             WorldRange());
+  EXPECT_EQ(value, Vec3(4, 5, 6));
+}
+
+TEST(BitPackerTest, PropertyDeserializerFailsOnTruncatedProperties) {
+  const QuantizationRange range = WorldRange();
+  PacketStream stream;
+  {
+    PropertySerializer serializer(stream);
+    serializer.WriteQuantized(NetworkProperty::Position, Vec3(1, 2, 3), range,
+                              true);
+    serializer.WriteCompressed(NetworkProperty::Orientation, Quaternion(),
+                               BitPacking::DefaultQuaternionBits, true);
+    serializer.Write(NetworkProperty::Scale, 7, true);
+  }
+
+  // Mask and position survive, the orientation is cut short.
+  PacketReader reader(stream.buffer.data(), stream.GetSize() - sizeof(int) - 2);
+  PropertyDeserializer deserializer(reader);
+  Vec3 position;
+  EXPECT_TRUE(deserializer.ReadQuantized(NetworkProperty::Position, position,
+                                         Vec3(), range));
+  EXPECT_NEAR(position.z, 3.0f, 0.01f);
+
+  const size_t remaining = reader.GetRemaining();
+  const Quaternion fallback(0.0f, 1.0f, 0.0f, 0.0f);
+  Quaternion orientation;
+  EXPECT_FALSE(deserializer.ReadCompressed(NetworkProperty::Orientation,
+                                           orientation, fallback,
+                                           BitPacking::DefaultQuaternionBits));
+  EXPECT_EQ(orientation, fallback);
+  EXPECT_EQ(reader.GetRemaining(), remaining);
+
+  int scale = 0;
+  EXPECT_FALSE(deserializer.Read(NetworkProperty::Scale, scale, -1));
+  EXPECT_EQ(scale, -1);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,294 @@
+#include "ClientPrediction.h"
+#include "NetworkPackets.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+void Move(const InputCommand &input, Vec3 &position, Quaternion &) {
+  position += input.move * input.deltaTime;
+}
+
+InputCommand MoveX(float velocity) {
+  InputCommand input;
+  input.deltaTime = 0.1f;
+  input.move = Vec3(velocity, 0.0f, 0.0f);
+  return input;
+}
+
+// Predicts `inputs` from `position` the way NetworkComponent does.
+void Predict(PredictionBuffer &buffer, std::vector<InputCommand> inputs,
+             Vec3 &position) {
+  Quaternion orientation;
+  for (InputCommand &input : inputs) {
+    Move(input, position, orientation);
+    buffer.Record(input, position, orientation);
+  }
+}
+} // namespace
+
+TEST(PredictionBufferTest, AssignsSequencesAndTracksSends) {
+  PredictionBuffer buffer;
+  Vec3 position(0.0f);
+  EXPECT_FALSE(buffer.HasUnsentInput());
+
+  Predict(buffer, {MoveX(1.0f), MoveX(1.0f)}, position);
+  EXPECT_EQ(buffer.GetPendingCount(), 2u);
+  EXPECT_EQ(buffer.GetPendingInput(0).sequence, 1u);
+  EXPECT_EQ(buffer.GetNewestSequence(), 2u);
+  EXPECT_TRUE(buffer.HasUnsentInput());
+
+  buffer.MarkSent();
+  EXPECT_FALSE(buffer.HasUnsentInput());
+}
+
+TEST(PredictionBufferTest, MatchingAckOnlyDropsAckedInputs) {
+  PredictionBuffer buffer;
+  Vec3 position(0.0f);
+  Predict(buffer, {MoveX(1.0f), MoveX(1.0f), MoveX(1.0f)}, position);
+
+  Vec3 out(-1.0f);
+  Quaternion orientation;
+  EXPECT_EQ(buffer.Reconcile(2, Vec3(0.2f, 0.0f, 0.0f), Quaternion(), Move,
+                             out, orientation),
+            ReconcileResult::Confirmed);
+  EXPECT_EQ(buffer.GetPendingCount(), 1u);
+  EXPECT_EQ(buffer.GetPendingInput(0).sequence, 3u);
+  EXPECT_FLOAT_EQ(out.x, -1.0f);
+}
+
+TEST(PredictionBufferTest, CorrectionReplaysUnackedInputs) {
+  PredictionBuffer buffer;
+  Vec3 position(0.0f);
+  Predict(buffer, {MoveX(1.0f), MoveX(2.0f), MoveX(3.0f)}, position);
+  EXPECT_FLOAT_EQ(position.x, 0.6f);
+
+  // The server was pushed back by 1 unit before input 1.
+  Vec3 out;
+  Quaternion orientation;
+  ASSERT_EQ(buffer.Reconcile(1, Vec3(-0.9f, 0.0f, 0.0f), Quaternion(), Move,
+                             out, orientation),
+            ReconcileResult::Corrected);
+  EXPECT_NEAR(out.x, -0.4f, 1e-5f);
+
+  // The replayed predictions are what later acks are checked against.
+  EXPECT_EQ(buffer.Reconcile(2, Vec3(-0.7f, 0.0f, 0.0f), Quaternion(), Move,
+                             out, orientation),
+            ReconcileResult::Confirmed);
+}
+
+TEST(PredictionBufferTest, RepeatedAndStaleAcks) {
+  PredictionBuffer buffer;
+  Vec3 position(0.0f);
+  Predict(buffer, {MoveX(1.0f), MoveX(1.0f)}, position);
+
+  Vec3 out;
+  Quaternion orientation;
+  EXPECT_EQ(buffer.Reconcile(2, Vec3(0.2f, 0.0f, 0.0f), Quaternion(), Move,
+                             out, orientation),
+            ReconcileResult::Confirmed);
+  EXPECT_EQ(buffer.Reconcile(1, Vec3(5.0f), Quaternion(), Move, out,
+                             orientation),
+            ReconcileResult::Stale);
+
+  // Same ack, but the server moved the entity on its own.
+  EXPECT_EQ(buffer.Reconcile(2, Vec3(0.2f, 1.0f, 0.0f), Quaternion(), Move,
+                             out, orientation),
+            ReconcileResult::Corrected);
+  EXPECT_FLOAT_EQ(out.y, 1.0f);
+  EXPECT_EQ(buffer.Reconcile(2, Vec3(0.2f, 1.0f, 0.0f), Quaternion(), Move,
+                             out, orientation),
+            ReconcileResult::Confirmed);
+}
+
+TEST(PredictionBufferTest, NoAckYetReplaysEverythingFromTheServerState) {
+  PredictionBuffer buffer;
+  Vec3 position(10.0f, 0.0f, 0.0f);
+  Predict(buffer, {MoveX(1.0f), MoveX(1.0f)}, position);
+
+  Vec3 out;
+  Quaternion orientation;
+  ASSERT_EQ(buffer.Reconcile(0, Vec3(0.0f), Quaternion(), Move, out,
+                             orientation),
+            ReconcileResult::Corrected);
+  EXPECT_NEAR(out.x, 0.2f, 1e-5f);
+  EXPECT_EQ(buffer.GetPendingCount(), 2u);
+}
+
+TEST(PredictionBufferTest, DropsTheOldestInputWhenFull) {
+  PredictionBuffer buffer;
+  Vec3 position(0.0f);
+  std::vector<InputCommand> inputs(PredictionBuffer::Capacity + 2,
+                                   MoveX(1.0f));
+  Predict(buffer, inputs, position);
+
+  EXPECT_EQ(buffer.GetPendingCount(), PredictionBuffer::Capacity);
+  EXPECT_EQ(buffer.GetPendingInput(0).sequence, 3u);
+}
+
+TEST(InputCommandQueueTest, AcceptsEachSequenceOnceAndInOrder) {
+  InputCommandQueue queue;
+  InputCommand commands[3];
+  for (uint32_t i = 0; i < 3; ++i) {
+    commands[i] = MoveX(1.0f);
+    commands[i].sequence = i + 1;
+  }
+
+  EXPECT_EQ(queue.Accept(commands, 2), 2u);
+  // Resent with one new input; reordered older packets are ignored.
+  EXPECT_EQ(queue.Accept(commands, 3), 1u);
+  EXPECT_EQ(queue.Accept(commands, 1), 0u);
+
+  queue.SetMaxTimeCredit(1.0f);
+  queue.AddElapsedTime(1.0f);
+  InputCommand input;
+  for (uint32_t expected = 1; expected <= 3; ++expected) {
+    ASSERT_TRUE(queue.Pop(input));
+    EXPECT_EQ(input.sequence, expected);
+  }
+  EXPECT_FALSE(queue.Pop(input));
+  EXPECT_EQ(queue.GetLastProcessedSequence(), 3u);
+}
+
+TEST(InputCommandQueueTest, ClampsDeltaTime) {
+  InputCommandQueue queue;
+  queue.SetMaxDeltaTime(0.05f);
+  InputCommand commands[3];
+  commands[0].sequence = 1;
+  commands[0].deltaTime = 10.0f;
+  commands[1].sequence = 2;
+  commands[1].deltaTime = -1.0f;
+  commands[2].sequence = 3;
+  commands[2].deltaTime = std::nanf("");
+  ASSERT_EQ(queue.Accept(commands, 3), 3u);
+
+  queue.AddElapsedTime(0.05f);
+  InputCommand input;
+  ASSERT_TRUE(queue.Pop(input));
+  EXPECT_FLOAT_EQ(input.deltaTime, 0.05f);
+  ASSERT_TRUE(queue.Pop(input));
+  EXPECT_FLOAT_EQ(input.deltaTime, 0.0f);
+  ASSERT_TRUE(queue.Pop(input));
+  EXPECT_FLOAT_EQ(input.deltaTime, 0.0f);
+}
+
+TEST(InputCommandQueueTest, DropsNonFiniteAndDegenerateCommands) {
+  InputCommandQueue queue;
+  InputCommand commands[4];
+  for (uint32_t i = 0; i < 4; ++i) {
+    commands[i] = MoveX(1.0f);
+    commands[i].sequence = i + 1;
+  }
+  commands[0].move.y = std::nanf("");
+  commands[1].move.z = std::numeric_limits<float>::infinity();
+  commands[2].orientation = Quaternion(0.0f, 0.0f, 0.0f, 0.0f);
+  commands[3].orientation = Quaternion(2.0f, 0.0f, 0.0f, 0.0f);
+
+  EXPECT_EQ(queue.Accept(commands, 4), 1u);
+  // Dropped sequences are consumed; resending them changes nothing.
+  EXPECT_EQ(queue.Accept(commands, 3), 0u);
+
+  queue.AddElapsedTime(1.0f);
+  InputCommand input;
+  ASSERT_TRUE(queue.Pop(input));
+  EXPECT_EQ(input.sequence, 4u);
+  EXPECT_NEAR(glm::dot(input.orientation, input.orientation), 1.0f, 1e-5f);
+  EXPECT_FALSE(queue.Pop(input));
+}
+
+TEST(InputCommandQueueTest, ClampsMoveLength) {
+  InputCommandQueue queue;
+  queue.SetMaxMoveLength(5.0f);
+  InputCommand commands[2] = {MoveX(1000.0f), MoveX(3.0f)};
+  commands[0].sequence = 1;
+  commands[1].sequence = 2;
+  ASSERT_EQ(queue.Accept(commands, 2), 2u);
+
+  queue.AddElapsedTime(1.0f);
+  InputCommand input;
+  ASSERT_TRUE(queue.Pop(input));
+  EXPECT_NEAR(input.move.x, 5.0f, 1e-4f);
+  ASSERT_TRUE(queue.Pop(input));
+  EXPECT_FLOAT_EQ(input.move.x, 3.0f);
+}
+
+TEST(InputCommandQueueTest, SimulatedTimeIsBoundedByElapsedTime) {
+  InputCommandQueue queue;
+  queue.SetMaxDeltaTime(0.1f);
+  queue.SetMaxTimeCredit(0.1f);
+  std::vector<InputCommand> commands(20, MoveX(1.0f));
+  for (size_t i = 0; i < commands.size(); ++i) {
+    commands[i].sequence = static_cast<uint32_t>(i + 1);
+    commands[i].deltaTime = 0.05f;
+  }
+  ASSERT_EQ(queue.Accept(commands.data(), commands.size()), 20u);
+
+  // A tick of 1/20 s runs one 0.05 s input, however many are queued.
+  InputCommand input;
+  int popped = 0;
+  for (int tick = 0; tick < 4; ++tick) {
+    queue.AddElapsedTime(0.05f);
+    while (queue.Pop(input)) {
+      popped++;
+    }
+    EXPECT_EQ(popped, tick + 1);
+  }
+
+  // Idle time is banked only up to the credit cap.
+  queue.AddElapsedTime(10.0f);
+  EXPECT_FLOAT_EQ(queue.GetTimeCredit(), 0.1f);
+  while (queue.Pop(input)) {
+    popped++;
+  }
+  EXPECT_EQ(popped, 6);
+}
+
+TEST(InputCommandQueueTest, StorageStaysBoundedWhileInputsKeepWaiting) {
+  InputCommandQueue queue;
+  const float tickSeconds = 1.0f / 60.0f;
+  uint32_t sequence = 0;
+  InputCommand input;
+
+  // The owner's clock runs 1% fast: one extra input every 100 ticks, so the
+  // queue is never drained.
+  for (int tick = 1; tick <= 20000; ++tick) {
+    const int sent = tick % 100 == 0 ? 2 : 1;
+    for (int i = 0; i < sent; ++i) {
+      InputCommand command = MoveX(1.0f);
+      command.deltaTime = tickSeconds;
+      command.sequence = ++sequence;
+      queue.Accept(&command, 1);
+    }
+
+    queue.AddElapsedTime(tickSeconds);
+    while (queue.Pop(input)) {
+    }
+    if (tick >= 100) {
+      ASSERT_FALSE(queue.IsEmpty()) << "tick " << tick;
+    }
+    ASSERT_LE(queue.GetSize(), InputCommandQueue::Capacity) << "tick " << tick;
+  }
+
+  // Inputs are still simulated at the rate time is credited; the excess
+  // was dropped once the queue was full.
+  EXPECT_GE(queue.GetSize(), InputCommandQueue::Capacity - 1);
+  EXPECT_GE(queue.GetLastProcessedSequence(), 19990u);
+}
+
+TEST(InputCommandPacketTest, SizeCoversOnlyTheSentCommands) {
+  InputCommandPacket packet;
+  packet.SetCommandCount(2);
+  EXPECT_TRUE(packet.IsValid());
+  EXPECT_EQ(packet.GetTotalSize(),
+            static_cast<int>(sizeof(InputCommandPacket) -
+                             (InputCommandPacket::MaxCommands - 2) *
+                                 sizeof(InputCommand)));
+
+  packet.commandCount = 3;
+  EXPECT_FALSE(packet.IsValid());
+  packet.commandCount = InputCommandPacket::MaxCommands + 1;
+  EXPECT_FALSE(packet.IsValid());
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,112 @@
+#include "FixedTickScheduler.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+FixedTickScheduler MakeScheduler(float tickRate, float snapshotRate,
+                                 uint32_t maxCatchUpTicks = 5) {
+  FixedTickScheduler scheduler;
+  FixedTickScheduler::Settings settings;
+  settings.tickRate = tickRate;
+  settings.snapshotRate = snapshotRate;
+  settings.maxCatchUpTicks = maxCatchUpTicks;
+  scheduler.Configure(settings);
+  return scheduler;
+}
+} // namespace
+
+TEST(FixedTickSchedulerTest, TickCountFollowsTimeNotUpdates) {
+  FixedTickScheduler scheduler = MakeScheduler(60.0f, 0.0f);
+
+  // 144 Hz frames: a tick roughly every 2.4 updates.
+  uint32_t ticks = 0;
+  for (int i = 0; i < 144; ++i) {
+    ticks += scheduler.Advance(1.0 / 144.0).ticks;
+  }
+  EXPECT_EQ(ticks, 60u);
+
+  // 30 Hz frames: two ticks per update.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(scheduler.Advance(1.0 / 30.0).ticks, 2u);
+  }
+  EXPECT_EQ(scheduler.GetDroppedTicks(), 0u);
+}
+
+TEST(FixedTickSchedulerTest, RemainderCarriesOverToTheNextUpdate) {
+  FixedTickScheduler scheduler = MakeScheduler(10.0f, 0.0f);
+
+  EXPECT_EQ(scheduler.Advance(0.06).ticks, 0u);
+  EXPECT_NEAR(scheduler.GetAlpha(), 0.6, 1e-9);
+  EXPECT_EQ(scheduler.Advance(0.06).ticks, 1u);
+  EXPECT_NEAR(scheduler.GetAlpha(), 0.2, 1e-9);
+}
+
+TEST(FixedTickSchedulerTest, LongFramesAreCappedAndTheRestIsDropped) {
+  FixedTickScheduler scheduler = MakeScheduler(60.0f, 0.0f, 4);
+
+  const FixedTickScheduler::Steps steps = scheduler.Advance(0.5);
+  EXPECT_EQ(steps.ticks, 4u);
+  EXPECT_EQ(scheduler.GetDroppedTicks(), 26u);
+  EXPECT_LT(scheduler.GetAlpha(), 1.0);
+
+  // No debt is left behind: the next frame runs at the normal pace.
+  EXPECT_EQ(scheduler.Advance(1.0 / 60.0).ticks, 1u);
+}
+
+TEST(FixedTickSchedulerTest, SnapshotsGoOutAtTheirOwnRate) {
+  FixedTickScheduler scheduler = MakeScheduler(60.0f, 20.0f);
+
+  std::vector<int> sentOnTick;
+  for (int tick = 0; tick < 12; ++tick) {
+    const FixedTickScheduler::Steps steps = scheduler.Advance(1.0 / 60.0);
+    ASSERT_EQ(steps.ticks, 1u);
+    if (steps.sendSnapshot) {
+      sentOnTick.push_back(tick);
+    }
+  }
+  EXPECT_EQ(sentOnTick, (std::vector<int>{0, 3, 6, 9}));
+}
+
+TEST(FixedTickSchedulerTest, CatchUpTicksShareOneSnapshot) {
+  FixedTickScheduler scheduler = MakeScheduler(60.0f, 20.0f, 10);
+  ASSERT_TRUE(scheduler.Advance(1.0 / 60.0).sendSnapshot);
+
+  // Nine ticks in one update cover three snapshot periods but send once,
+  // and the missed periods do not burst out afterwards.
+  const FixedTickScheduler::Steps steps = scheduler.Advance(9.0 / 60.0);
+  EXPECT_EQ(steps.ticks, 9u);
+  EXPECT_TRUE(steps.sendSnapshot);
+  EXPECT_FALSE(scheduler.Advance(1.0 / 60.0).sendSnapshot);
+}
+
+TEST(FixedTickSchedulerTest, ZeroRatesFollowUpdates) {
+  FixedTickScheduler scheduler = MakeScheduler(0.0f, 0.0f);
+  for (double deltaTime : {0.0, 0.001, 0.25}) {
+    const FixedTickScheduler::Steps steps = scheduler.Advance(deltaTime);
+    EXPECT_EQ(steps.ticks, 1u);
+    EXPECT_TRUE(steps.sendSnapshot);
+  }
+  EXPECT_EQ(scheduler.GetTickInterval(), 0.0);
+
+  // A snapshot rate at or above the tick rate sends after every tick.
+  FixedTickScheduler matched = MakeScheduler(30.0f, 60.0f);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(matched.Advance(1.0 / 30.0).sendSnapshot);
+  }
+}
+
+TEST(FixedTickSchedulerTest, ResetDropsAccumulatedTime) {
+  FixedTickScheduler scheduler = MakeScheduler(60.0f, 20.0f, 2);
+  scheduler.Advance(0.5);
+  scheduler.Advance(0.01);
+  ASSERT_GT(scheduler.GetDroppedTicks(), 0u);
+
+  scheduler.Reset();
+  EXPECT_EQ(scheduler.GetDroppedTicks(), 0u);
+  EXPECT_EQ(scheduler.GetAlpha(), 0.0);
+  const FixedTickScheduler::Steps steps = scheduler.Advance(1.0 / 60.0);
+  EXPECT_EQ(steps.ticks, 1u);
+  EXPECT_TRUE(steps.sendSnapshot);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,144 @@
+#include "InterestManager.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+std::vector<int> QueryIDs(const InterestGrid &grid, const Vec3 &center,
+                          float radius) {
+  std::vector<int> ids;
+  grid.ForEachInRadius(center, radius, [&](int networkID, int, float) {
+    ids.push_back(networkID);
+  });
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+InterestEntity MakeEntity(int networkID, TransportPeerId ownerID, float x) {
+  InterestEntity entity;
+  entity.networkID = networkID;
+  entity.ownerID = ownerID;
+  entity.hasPosition = true;
+  entity.position = Vec3(x, 0.0f, 0.0f);
+  return entity;
+}
+
+std::vector<int> Sorted(std::vector<int> ids) {
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+} // namespace
+
+TEST(InterestGridTest, FindsEntitiesWithinRadiusAcrossCells) {
+  InterestGrid grid(10.0f);
+  grid.Update(1, Vec3(0.0f, 0.0f, 0.0f), 0);
+  grid.Update(2, Vec3(9.0f, 0.0f, 0.0f), 1);
+  grid.Update(3, Vec3(11.0f, 0.0f, 0.0f), 2);
+  grid.Update(4, Vec3(-25.0f, 0.0f, 3.0f), 3);
+
+  EXPECT_EQ(QueryIDs(grid, Vec3(0.0f), 12.0f), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(QueryIDs(grid, Vec3(0.0f), 5.0f), (std::vector<int>{1}));
+  EXPECT_EQ(QueryIDs(grid, Vec3(-20.0f, 0.0f, 0.0f), 6.0f),
+            (std::vector<int>{4}));
+}
+
+TEST(InterestGridTest, MovesAndRemovesEntities) {
+  InterestGrid grid(10.0f);
+  for (int id = 1; id <= 5; ++id) {
+    grid.Update(id, Vec3(static_cast<float>(id), 0.0f, 0.0f), id);
+  }
+
+  grid.Update(2, Vec3(100.0f, 0.0f, 0.0f), 2);
+  grid.Remove(3);
+  grid.Remove(42);
+
+  EXPECT_EQ(grid.Size(), 4u);
+  EXPECT_EQ(QueryIDs(grid, Vec3(0.0f), 10.0f), (std::vector<int>{1, 4, 5}));
+  EXPECT_EQ(QueryIDs(grid, Vec3(100.0f, 0.0f, 0.0f), 1.0f),
+            (std::vector<int>{2}));
+
+  grid.SetCellSize(3.0f);
+  EXPECT_EQ(QueryIDs(grid, Vec3(0.0f), 10.0f), (std::vector<int>{1, 4, 5}));
+}
+
+TEST(InterestManagerTest, DisabledManagerMakesEverythingRelevant) {
+  InterestManager interest;
+  interest.Update({MakeEntity(1, 0, 1000.0f)}, {7});
+
+  EXPECT_FALSE(interest.IsEnabled());
+  EXPECT_TRUE(interest.IsRelevant(7, 0));
+  EXPECT_TRUE(interest.IsRelevantByID(7, 1));
+  EXPECT_TRUE(interest.GetEntered(7).empty());
+}
+
+TEST(InterestManagerTest, PeersSeeEntitiesAroundTheirPlayer) {
+  InterestManager interest;
+  interest.SetRadius(10.0f);
+
+  std::vector<InterestEntity> entities = {
+      MakeEntity(1, 1, 0.0f), MakeEntity(2, 2, 100.0f), MakeEntity(3, 0, 5.0f),
+      MakeEntity(4, 0, 95.0f), MakeEntity(5, 0, 50.0f)};
+  InterestEntity global;
+  global.networkID = 6;
+  entities.push_back(global);
+
+  interest.Update(entities, {1, 2, 3});
+
+  EXPECT_EQ(Sorted(interest.GetEntered(1)), (std::vector<int>{1, 3, 6}));
+  EXPECT_EQ(Sorted(interest.GetEntered(2)), (std::vector<int>{2, 4, 6}));
+  EXPECT_TRUE(interest.IsRelevant(1, 0));
+  EXPECT_FALSE(interest.IsRelevant(1, 1));
+  EXPECT_FALSE(interest.IsRelevantByID(2, 5));
+
+  // Peer 3 has no player yet and sees everything.
+  EXPECT_EQ(interest.GetEntered(3).size(), entities.size());
+}
+
+TEST(InterestManagerTest, ReportsEnterAndLeaveWithHysteresis) {
+  InterestManager interest;
+  interest.SetRadius(10.0f);
+
+  std::vector<InterestEntity> entities = {MakeEntity(1, 1, 0.0f),
+                                          MakeEntity(2, 0, 9.0f)};
+  interest.Update(entities, {1});
+  EXPECT_EQ(Sorted(interest.GetEntered(1)), (std::vector<int>{1, 2}));
+
+  // Still inside the exit radius: stays relevant, nothing reported.
+  entities[1].position.x = 12.0f;
+  interest.Update(entities, {1});
+  EXPECT_TRUE(interest.GetEntered(1).empty());
+  EXPECT_TRUE(interest.GetLeft(1).empty());
+  EXPECT_TRUE(interest.IsRelevantByID(1, 2));
+
+  entities[1].position.x = 13.0f;
+  interest.Update(entities, {1});
+  EXPECT_EQ(interest.GetLeft(1), (std::vector<int>{2}));
+  EXPECT_FALSE(interest.IsRelevant(1, 1));
+
+  // Re-entering needs the plain radius again.
+  entities[1].position.x = 11.0f;
+  interest.Update(entities, {1});
+  EXPECT_TRUE(interest.GetEntered(1).empty());
+
+  entities[1].position.x = 10.0f;
+  interest.Update(entities, {1});
+  EXPECT_EQ(interest.GetEntered(1), (std::vector<int>{2}));
+}
+
+TEST(InterestManagerTest, RemovedEntitiesAndPeersAreForgotten) {
+  InterestManager interest;
+  interest.SetRadius(10.0f);
+  interest.Update({MakeEntity(1, 1, 0.0f), MakeEntity(2, 0, 1.0f)}, {1});
+
+  interest.RemoveEntity(2);
+  EXPECT_FALSE(interest.IsRelevantByID(1, 2));
+  interest.Update({MakeEntity(1, 1, 0.0f)}, {1});
+  EXPECT_TRUE(interest.GetLeft(1).empty());
+
+  interest.RemovePeer(1);
+  EXPECT_FALSE(interest.IsRelevantByID(1, 1));
+
+  interest.SetRadius(0.0f);
+  EXPECT_TRUE(interest.IsRelevantByID(1, 1));
+}
+} // namespace ToolKit::ToolKitNetworking
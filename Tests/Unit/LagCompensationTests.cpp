@@ -0,0 +1,164 @@
+#include "InterestManager.h"
+#include "LagCompensation.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+const Vec3 UnitMin(-0.5f, -0.5f, -0.5f);
+const Vec3 UnitMax(0.5f, 0.5f, 0.5f);
+
+void RecordAtX(LagCompensationHistory &history, int tick, double time,
+               const std::vector<std::pair<int, float>> &entities) {
+  LagCompensationFrame &frame = history.BeginFrame(tick, time);
+  for (const auto &entity : entities) {
+    frame.Add(entity.first, Vec3(entity.second, 0.0f, 0.0f), Quaternion(),
+              UnitMin, UnitMax);
+  }
+  history.EndFrame();
+}
+
+float XOf(const LagCompensationFrame &frame, int networkID) {
+  for (size_t i = 0; i < frame.Size(); ++i) {
+    if (frame.networkIDs[i] == networkID) {
+      return frame.positions[i].x;
+    }
+  }
+  return -1000.0f;
+}
+} // namespace
+
+TEST(LagCompensationHistoryTest, RewindsToRecordedAndFractionalTicks) {
+  LagCompensationHistory history;
+  LagCompensationFrame frame;
+  EXPECT_FALSE(history.Rewind(0.0, 1, nullptr, frame));
+
+  // Recorded out of ID order on purpose.
+  RecordAtX(history, 10, 1.0, {{2, 100.0f}, {1, 0.0f}});
+  RecordAtX(history, 11, 1.1, {{1, 10.0f}, {2, 90.0f}});
+
+  ASSERT_TRUE(history.Rewind(10.0, 1, nullptr, frame));
+  EXPECT_EQ(frame.networkIDs, (std::vector<int>{1, 2}));
+  EXPECT_FLOAT_EQ(XOf(frame, 1), 0.0f);
+
+  ASSERT_TRUE(history.Rewind(10.25, 1, nullptr, frame));
+  EXPECT_FLOAT_EQ(XOf(frame, 1), 2.5f);
+  EXPECT_FLOAT_EQ(XOf(frame, 2), 97.5f);
+
+  // Clamped to the window.
+  ASSERT_TRUE(history.Rewind(50.0, 1, nullptr, frame));
+  EXPECT_FLOAT_EQ(XOf(frame, 1), 10.0f);
+  ASSERT_TRUE(history.Rewind(2.0, 1, nullptr, frame));
+  EXPECT_FLOAT_EQ(XOf(frame, 1), 0.0f);
+}
+
+TEST(LagCompensationHistoryTest, OnlyEntitiesThatExistedAreRewound) {
+  LagCompensationHistory history;
+  RecordAtX(history, 1, 0.0, {{1, 0.0f}, {2, 5.0f}});
+  RecordAtX(history, 2, 0.1, {{1, 1.0f}, {3, 7.0f}});
+
+  LagCompensationFrame frame;
+  ASSERT_TRUE(history.Rewind(1.5, 1, nullptr, frame));
+  // 2 was despawned afterwards but was there; 3 did not exist yet.
+  EXPECT_EQ(frame.networkIDs, (std::vector<int>{1, 2}));
+  EXPECT_FLOAT_EQ(XOf(frame, 1), 0.5f);
+  EXPECT_FLOAT_EQ(XOf(frame, 2), 5.0f);
+}
+
+TEST(LagCompensationHistoryTest, ResolvesViewTickFromRecordedTimes) {
+  LagCompensationHistory history(8);
+  // Uneven tick lengths: the delay is measured in server time, not ticks.
+  RecordAtX(history, 5, 1.00, {{1, 0.0f}});
+  RecordAtX(history, 6, 1.10, {{1, 0.0f}});
+  RecordAtX(history, 7, 1.15, {{1, 0.0f}});
+  RecordAtX(history, 8, 1.20, {{1, 0.0f}});
+
+  EXPECT_DOUBLE_EQ(history.ResolveViewTick(8, 0.0), 8.0);
+  EXPECT_NEAR(history.ResolveViewTick(8, 0.1), 6.0, 1e-9);
+  EXPECT_NEAR(history.ResolveViewTick(8, 0.15), 5.5, 1e-9);
+  EXPECT_DOUBLE_EQ(history.ResolveViewTick(8, 5.0), 5.0);
+  EXPECT_LT(history.ResolveViewTick(42, 0.1), 0.0);
+
+  for (int tick = 9; tick < 20; ++tick) {
+    RecordAtX(history, tick, tick * 0.1, {{1, 0.0f}});
+  }
+  EXPECT_FALSE(history.HasTick(8));
+  EXPECT_EQ(history.GetOldestTick(), 12);
+}
+
+TEST(LagCompensationHistoryTest, KeepsOnlyEntitiesRelevantToTheViewer) {
+  InterestManager interest;
+  interest.SetRadius(10.0f);
+  std::vector<InterestEntity> entities(3);
+  for (int i = 0; i < 3; ++i) {
+    entities[i].networkID = i + 1;
+    entities[i].hasPosition = true;
+    entities[i].position = Vec3(i * 50.0f, 0.0f, 0.0f);
+  }
+  entities[0].ownerID = 7;
+  interest.Update(entities, {7});
+
+  LagCompensationHistory history;
+  RecordAtX(history, 1, 0.0, {{1, 0.0f}, {2, 50.0f}, {3, 100.0f}});
+
+  LagCompensationFrame frame;
+  ASSERT_TRUE(history.Rewind(1.0, 7, &interest, frame));
+  EXPECT_EQ(frame.networkIDs, (std::vector<int>{1}));
+}
+
+TEST(LagCompensationHistoryTest, RewindReusesItsBuffers) {
+  LagCompensationHistory history;
+  std::vector<std::pair<int, float>> entities;
+  for (int id = 1; id <= 100; ++id) {
+    entities.push_back({id, static_cast<float>(id)});
+  }
+  RecordAtX(history, 1, 0.0, entities);
+  RecordAtX(history, 2, 0.1, entities);
+
+  LagCompensationFrame frame;
+  ASSERT_TRUE(history.Rewind(1.5, 1, nullptr, frame));
+  const int *ids = frame.networkIDs.data();
+  const Vec3 *positions = frame.positions.data();
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(history.Rewind(1.0 + i * 0.1, 1, nullptr, frame));
+  }
+  EXPECT_EQ(frame.networkIDs.data(), ids);
+  EXPECT_EQ(frame.positions.data(), positions);
+}
+
+TEST(LagCompensationRaycastTest, HitsNearestBoxAndSkipsTheShooter) {
+  LagCompensationFrame frame;
+  frame.Add(1, Vec3(0.0f), Quaternion(), UnitMin, UnitMax);
+  frame.Add(2, Vec3(5.0f, 0.0f, 0.0f), Quaternion(), UnitMin, UnitMax);
+  frame.Add(3, Vec3(10.0f, 0.0f, 0.0f), Quaternion(), UnitMin, UnitMax);
+
+  LagCompensationHit hit;
+  ASSERT_TRUE(LagCompensation::Raycast(frame, Vec3(0.0f),
+                                       Vec3(1.0f, 0.0f, 0.0f), 100.0f, 1, hit));
+  EXPECT_EQ(hit.networkID, 2);
+  EXPECT_FLOAT_EQ(hit.distance, 4.5f);
+
+  EXPECT_FALSE(LagCompensation::Raycast(frame, Vec3(0.0f),
+                                        Vec3(1.0f, 0.0f, 0.0f), 4.0f, 1, hit));
+  EXPECT_FALSE(LagCompensation::Raycast(frame, Vec3(0.0f, 2.0f, 0.0f),
+                                        Vec3(1.0f, 0.0f, 0.0f), 100.0f, 1,
+                                        hit));
+}
+
+TEST(LagCompensationRaycastTest, UsesTheEntityOrientation) {
+  // A long thin box along X, turned 90 degrees about Y so it lies along Z.
+  const float halfAngle = 0.5f * 1.5707963f;
+  LagCompensationFrame frame;
+  frame.Add(1, Vec3(0.0f, 0.0f, 0.0f),
+            Quaternion(std::cos(halfAngle), 0.0f, std::sin(halfAngle), 0.0f),
+            Vec3(-3.0f, -0.5f, -0.5f), Vec3(3.0f, 0.5f, 0.5f));
+
+  LagCompensationHit hit;
+  EXPECT_TRUE(LagCompensation::Raycast(frame, Vec3(-5.0f, 0.0f, 2.5f),
+                                       Vec3(1.0f, 0.0f, 0.0f), 100.0f, -1,
+                                       hit));
+  EXPECT_NEAR(hit.distance, 4.5f, 1e-4f);
+  EXPECT_FALSE(LagCompensation::Raycast(frame, Vec3(2.5f, 0.0f, -5.0f),
+                                        Vec3(0.0f, 0.0f, 1.0f), 100.0f, -1,
+                                        hit));
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,184 @@
+#include "NetSerializer.h"
+#include "NetworkPackets.h"
+#include "NetworkVariable.h"
+#include "RPCPacket.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+struct PlainPoint {
+  int x = 0;
+  int y = 0;
+};
+
+enum class Team : uint8_t { Red, Blue };
+
+PacketReader ReaderOver(const PacketStream &stream) {
+  return PacketReader(stream.buffer.data(), stream.buffer.size());
+}
+} // namespace
+} // namespace ToolKit::ToolKitNetworking
+
+TK_NET_SERIALIZE_AS_BYTES(ToolKit::ToolKitNetworking::PlainPoint)
+
+namespace ToolKit::ToolKitNetworking {
+static_assert(NetSerializer<int>::FixedSize == sizeof(int));
+static_assert(NetSerializer<bool>::FixedSize == 1);
+static_assert(NetSerializer<std::string>::FixedSize == 0);
+static_assert(NetIsFixedSize<int, float, Team, PlainPoint>);
+static_assert(NetFixedSizeOf<int, float, Team, PlainPoint> ==
+              sizeof(int) + sizeof(float) + 1 + sizeof(PlainPoint));
+static_assert(!NetIsFixedSize<int, std::string>);
+static_assert(NetSerializer<std::array<short, 4>>::FixedSize == 8);
+
+TEST(NetSerializerTest, RoundTripsScalarsStringsAndContainers) {
+  const std::string text = "hello, world";
+  const std::vector<int> ids = {1, -2, 300000};
+  const std::vector<std::string> names = {"a", "", "long name"};
+  const std::array<float, 3> weights = {0.5f, 1.0f, -2.0f};
+  const PlainPoint point{3, -4};
+
+  PacketStream stream;
+  NetWriteAll(stream, 7, true, Team::Blue, text, ids, names, weights, point);
+  EXPECT_EQ(stream.GetSize(), NetEncodedSize(7, true, Team::Blue, text, ids,
+                                             names, weights, point));
+
+  int number = 0;
+  bool flag = false;
+  Team team = Team::Red;
+  std::string outText;
+  std::vector<int> outIds;
+  std::vector<std::string> outNames;
+  std::array<float, 3> outWeights{};
+  PlainPoint outPoint;
+
+  PacketReader reader = ReaderOver(stream);
+  ASSERT_TRUE(NetReadAll(reader, number, flag, team, outText, outIds,
+                         outNames, outWeights, outPoint));
+  EXPECT_EQ(reader.GetRemaining(), 0u);
+  EXPECT_EQ(number, 7);
+  EXPECT_TRUE(flag);
+  EXPECT_EQ(team, Team::Blue);
+  EXPECT_EQ(outText, text);
+  EXPECT_EQ(outIds, ids);
+  EXPECT_EQ(outNames, names);
+  EXPECT_EQ(outWeights, weights);
+  EXPECT_EQ(outPoint.x, 3);
+  EXPECT_EQ(outPoint.y, -4);
+}
+
+TEST(NetSerializerTest, VarIntsShrinkSmallValuesAndKeepTheRange) {
+  PacketStream stream;
+  NetWriteAll(stream, NetVarInt<int>(-1), NetVarInt<int>(63),
+              NetVarInt<int>(INT32_MIN), NetVarInt<uint64_t>(UINT64_MAX));
+  EXPECT_EQ(stream.GetSize(), 1u + 1u + 5u + 10u);
+
+  NetVarInt<int> a, b, c;
+  NetVarInt<uint64_t> d;
+  PacketReader reader = ReaderOver(stream);
+  ASSERT_TRUE(NetReadAll(reader, a, b, c, d));
+  EXPECT_EQ(a, -1);
+  EXPECT_EQ(b, 63);
+  EXPECT_EQ(c, INT32_MIN);
+  EXPECT_EQ(d, UINT64_MAX);
+}
+
+TEST(NetSerializerTest, RejectsVarIntsOutsideTheTargetType) {
+  PacketStream stream;
+  NetWriteAll(stream, NetVarInt<int>(300));
+
+  NetVarInt<int8_t> small;
+  PacketReader reader = ReaderOver(stream);
+  EXPECT_FALSE(NetReadAll(reader, small));
+
+  // Eleven continuation bytes never terminate a 64-bit varint.
+  PacketStream endless;
+  for (int i = 0; i < 11; ++i) {
+    endless.Write(static_cast<uint8_t>(0xff));
+  }
+  NetVarInt<uint64_t> wide;
+  PacketReader endlessReader = ReaderOver(endless);
+  EXPECT_FALSE(NetReadAll(endlessReader, wide));
+}
+
+TEST(NetSerializerTest, RejectsTruncatedPayloads) {
+  PacketStream stream;
+  NetWriteAll(stream, std::string("truncated"), 5);
+
+  for (size_t cut = 0; cut < stream.GetSize(); ++cut) {
+    PacketReader reader(stream.buffer.data(), cut);
+    std::string text;
+    int number = 0;
+    EXPECT_FALSE(NetReadAll(reader, text, number)) << "cut at " << cut;
+  }
+}
+
+TEST(NetSerializerTest, RejectsLengthsThePayloadCannotHold) {
+  // Announces 1000 ints but carries none; nothing may be allocated for them.
+  PacketStream stream;
+  NetVarIntCodec::Write(stream, 1000);
+  std::vector<int> ids;
+  PacketReader reader = ReaderOver(stream);
+  EXPECT_FALSE(NetReadAll(reader, ids));
+  EXPECT_LT(ids.capacity(), 1000u);
+
+  PacketStream huge;
+  NetVarIntCodec::Write(huge, uint64_t(NetMaxContainerLength) + 1);
+  huge.buffer.resize(huge.buffer.size() + NetMaxContainerLength + 1);
+  std::string text;
+  PacketReader hugeReader = ReaderOver(huge);
+  EXPECT_FALSE(NetReadAll(hugeReader, text));
+}
+
+TEST(NetSerializerTest, RejectsBoolsOtherThanZeroOrOne) {
+  PacketStream stream;
+  stream.Write(static_cast<uint8_t>(2));
+  bool flag = false;
+  PacketReader reader = ReaderOver(stream);
+  EXPECT_FALSE(NetReadAll(reader, flag));
+}
+
+TEST(NetSerializerTest, PresizedStreamsDoNotReallocate) {
+  const std::string text(500, 'x');
+  const std::vector<int> ids(100, 9);
+  const size_t size = NetEncodedSize(text, ids);
+
+  PacketStream stream(size);
+  const char *memory = stream.buffer.data();
+  NetWriteAll(stream, text, ids);
+  EXPECT_EQ(stream.GetSize(), size);
+  EXPECT_EQ(stream.buffer.data(), memory);
+}
+
+TEST(NetSerializerTest, NetworkVariableKeepsItsValueOnMalformedInput) {
+  NetworkVariable<std::string> sent("name", "server value");
+  PacketStream stream;
+  sent.Serialize(stream);
+
+  NetworkVariable<std::string> received("name", "old");
+  PacketReader reader = ReaderOver(stream);
+  ASSERT_TRUE(received.Deserialize(reader));
+  EXPECT_EQ(received.Get(), "server value");
+
+  PacketReader truncated(stream.buffer.data(), stream.GetSize() - 1);
+  NetworkVariable<std::string> untouched("name", "old");
+  EXPECT_FALSE(untouched.Deserialize(truncated));
+  EXPECT_EQ(untouched.Get(), "old");
+}
+
+TEST(NetSerializerTest, PackRPCRefusesCallsOverThePacketSizeLimit) {
+  const std::string small = "hello";
+  PacketStream stream(RPCPacketSize(small));
+  ASSERT_TRUE(PackRPC(stream, 3, 77u, small));
+  const RPCPacket *packed = static_cast<const RPCPacket *>(stream.GetData());
+  EXPECT_EQ(static_cast<size_t>(packed->GetTotalSize()), stream.GetSize());
+
+  // A valid string whose packet would not fit GamePacket::size.
+  const std::string oversized(40000, 'x');
+  EXPECT_GT(RPCPacketSize(oversized), MaxRPCPacketBytes);
+  EXPECT_FALSE(PackRPC(stream, 3, 77u, oversized));
+  EXPECT_EQ(stream.GetSize(), 0u);
+}
+} // namespace ToolKit::ToolKitNetworking
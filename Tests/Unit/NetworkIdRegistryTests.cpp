@@ -0,0 +1,122 @@
+#include "NetworkIdRegistry.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+struct TrackedObject {
+  int id = 0;
+};
+} // namespace
+
+TEST(NetworkIdRegistryTest, FindsRegisteredObjectsById) {
+  NetworkIdRegistry<TrackedObject> registry;
+  TrackedObject a{1};
+  TrackedObject b{2};
+
+  ASSERT_TRUE(registry.Insert(1, &a));
+  ASSERT_TRUE(registry.Insert(2, &b));
+
+  EXPECT_EQ(registry.Find(1), &a);
+  EXPECT_EQ(registry.Find(2), &b);
+  EXPECT_EQ(registry.Find(3), nullptr);
+  EXPECT_EQ(registry.Find(-1), nullptr);
+  EXPECT_EQ(registry.Size(), 2u);
+}
+
+TEST(NetworkIdRegistryTest, RejectsDuplicateAndInvalidIds) {
+  NetworkIdRegistry<TrackedObject> registry;
+  TrackedObject a{1};
+  TrackedObject b{1};
+
+  EXPECT_TRUE(registry.Insert(1, &a));
+  EXPECT_FALSE(registry.Insert(1, &b));
+  EXPECT_FALSE(registry.Insert(-1, &b));
+  EXPECT_FALSE(registry.Insert(4, nullptr));
+  EXPECT_EQ(registry.Find(1), &a);
+  EXPECT_EQ(registry.Size(), 1u);
+}
+
+TEST(NetworkIdRegistryTest, RemoveOnlyDropsTheRegisteredOwnerOfAnId) {
+  NetworkIdRegistry<TrackedObject> registry;
+  TrackedObject a{1};
+  TrackedObject impostor{1};
+  ASSERT_TRUE(registry.Insert(1, &a));
+
+  EXPECT_FALSE(registry.Remove(1, &impostor));
+  EXPECT_EQ(registry.Find(1), &a);
+
+  EXPECT_TRUE(registry.Remove(1, &a));
+  EXPECT_EQ(registry.Find(1), nullptr);
+  EXPECT_FALSE(registry.Remove(1, &a));
+  EXPECT_TRUE(registry.Empty());
+}
+
+TEST(NetworkIdRegistryTest, StaleHandlesDoNotResolveAfterIdReuse) {
+  NetworkIdRegistry<TrackedObject> registry;
+  TrackedObject first{7};
+  TrackedObject second{7};
+
+  ASSERT_TRUE(registry.Insert(7, &first));
+  NetworkIdHandle handle = registry.GetHandle(7);
+  ASSERT_TRUE(handle.IsValid());
+  EXPECT_EQ(registry.Resolve(handle), &first);
+
+  ASSERT_TRUE(registry.Remove(7, &first));
+  EXPECT_EQ(registry.Resolve(handle), nullptr);
+
+  ASSERT_TRUE(registry.Insert(7, &second));
+  EXPECT_EQ(registry.Resolve(handle), nullptr);
+  EXPECT_EQ(registry.Resolve(registry.GetHandle(7)), &second);
+  EXPECT_FALSE(registry.GetHandle(8).IsValid());
+}
+
+TEST(NetworkIdRegistryTest, StaysConsistentThroughGrowthAndRemoval) {
+  constexpr int Count = 4096;
+  std::vector<TrackedObject> objects(Count);
+  NetworkIdRegistry<TrackedObject> registry;
+
+  for (int i = 0; i < Count; ++i) {
+    objects[i].id = i * 3 + 1;
+    ASSERT_TRUE(registry.Insert(objects[i].id, &objects[i]));
+  }
+
+  for (int i = 0; i < Count; i += 2) {
+    ASSERT_TRUE(registry.Remove(objects[i].id, &objects[i]));
+  }
+
+  EXPECT_EQ(registry.Size(), static_cast<size_t>(Count / 2));
+  for (int i = 0; i < Count; ++i) {
+    TrackedObject *expected = (i % 2 == 0) ? nullptr : &objects[i];
+    ASSERT_EQ(registry.Find(objects[i].id), expected) << "id " << objects[i].id;
+  }
+
+  for (TrackedObject *item : registry.Items()) {
+    EXPECT_EQ(registry.Find(item->id), item);
+  }
+}
+
+TEST(NetworkIdRegistryTest, HostileIdsDoNotDegradeLookup) {
+  NetworkIdRegistry<TrackedObject> registry;
+  TrackedObject high{0x7FFFFFFF};
+  TrackedObject low{1};
+
+  ASSERT_TRUE(registry.Insert(high.id, &high));
+  ASSERT_TRUE(registry.Insert(low.id, &low));
+
+  EXPECT_EQ(registry.Find(high.id), &high);
+  EXPECT_EQ(registry.Find(low.id), &low);
+  EXPECT_EQ(registry.Find(0x7FFFFFFE), nullptr);
+}
+
+TEST(NetworkIdRegistryTest, ClearDropsEverything) {
+  NetworkIdRegistry<TrackedObject> registry;
+  TrackedObject a{1};
+  ASSERT_TRUE(registry.Insert(1, &a));
+
+  registry.Clear();
+  EXPECT_TRUE(registry.Empty());
+  EXPECT_EQ(registry.Find(1), nullptr);
+  EXPECT_TRUE(registry.Insert(1, &a));
+  EXPECT_EQ(registry.Find(1), &a);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,104 @@
+#include "NetworkVariableDelta.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+std::vector<size_t> SetBits(const std::vector<uint8_t> &mask, size_t count) {
+  std::vector<size_t> bits;
+  for (size_t i = 0; i < count; ++i) {
+    if (VariableMask::IsSet(mask, i)) {
+      bits.push_back(i);
+    }
+  }
+  return bits;
+}
+} // namespace
+
+TEST(VariableChangeTrackerTest, FullStateSelectsEveryVariable) {
+  VariableChangeTracker tracker;
+  tracker.Resize(3);
+
+  std::vector<uint8_t> mask;
+  EXPECT_EQ(tracker.BuildMask(-1, mask), 3u);
+  EXPECT_EQ(SetBits(mask, 3), (std::vector<size_t>{0, 1, 2}));
+
+  // Never changed variables are not part of any delta.
+  EXPECT_EQ(tracker.BuildMask(0, mask), 0u);
+}
+
+TEST(VariableChangeTrackerTest, DeltaCarriesChangesSinceEachBaseline) {
+  VariableChangeTracker tracker;
+  tracker.Resize(4);
+  tracker.MarkChanged(0, 5);
+  tracker.MarkChanged(2, 8);
+  tracker.MarkChanged(3, 10);
+
+  std::vector<uint8_t> mask;
+  EXPECT_EQ(tracker.BuildMask(4, mask), 3u);
+  EXPECT_EQ(SetBits(mask, 4), (std::vector<size_t>{0, 2, 3}));
+  EXPECT_EQ(tracker.BuildMask(8, mask), 1u);
+  EXPECT_EQ(SetBits(mask, 4), (std::vector<size_t>{3}));
+  EXPECT_EQ(tracker.BuildMask(10, mask), 0u);
+}
+
+TEST(VariableChangeTrackerTest, QueriesDoNotConsumeChanges) {
+  VariableChangeTracker tracker;
+  tracker.Resize(2);
+  tracker.MarkChanged(1, 7);
+
+  // Peers encoded in any order on the same tick get the same answer.
+  std::vector<uint8_t> first;
+  std::vector<uint8_t> second;
+  tracker.BuildMask(6, first);
+  tracker.BuildMask(3, second);
+  tracker.BuildMask(6, second);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(SetBits(first, 2), (std::vector<size_t>{1}));
+
+  tracker.Reset();
+  EXPECT_EQ(tracker.GetChangedTick(1), -1);
+}
+
+TEST(VariableMaskTest, RoundTripsManyVariables) {
+  VariableChangeTracker tracker;
+  tracker.Resize(70);
+  tracker.MarkChanged(0, 2);
+  tracker.MarkChanged(33, 2);
+  tracker.MarkChanged(69, 2);
+
+  std::vector<uint8_t> mask;
+  tracker.BuildMask(1, mask);
+
+  PacketStream stream;
+  VariableMask::Write(stream, tracker.GetVariableCount(), mask);
+  stream.WriteInt(1234);
+  // One varint byte plus 70 bits.
+  EXPECT_EQ(stream.GetSize(), 1u + 9u + sizeof(int));
+
+  PacketReader reader = stream.GetReader();
+  size_t count = 0;
+  std::vector<uint8_t> readMask;
+  ASSERT_TRUE(VariableMask::Read(reader, 70, count, readMask));
+  EXPECT_EQ(count, 70u);
+  EXPECT_EQ(SetBits(readMask, count), (std::vector<size_t>{0, 33, 69}));
+
+  int trailer = 0;
+  ASSERT_TRUE(reader.ReadInt(trailer));
+  EXPECT_EQ(trailer, 1234);
+}
+
+TEST(VariableMaskTest, RejectsTruncatedOrOversizedMasks) {
+  std::vector<uint8_t> mask(2, 0xFF);
+  PacketStream stream;
+  VariableMask::Write(stream, 16, mask);
+
+  size_t count = 0;
+  std::vector<uint8_t> readMask;
+  PacketReader tooMany = stream.GetReader();
+  EXPECT_FALSE(VariableMask::Read(tooMany, 8, count, readMask));
+
+  PacketReader truncated(stream.buffer.data(), stream.GetSize() - 1);
+  EXPECT_FALSE(VariableMask::Read(truncated, 16, count, readMask));
+  EXPECT_EQ(count, 0u);
+}
+} // namespace ToolKit::ToolKitNetworking
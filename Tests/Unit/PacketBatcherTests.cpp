@@ -0,0 +1,159 @@
+#include "PacketBatcher.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+struct SentDatagram {
+  std::vector<char> bytes;
+  DeliveryChannel channel = DeliveryChannel::Snapshot;
+};
+
+std::vector<SentDatagram> FlushAll(PacketBatcher &batcher) {
+  std::vector<SentDatagram> sent;
+  batcher.Flush([&](const void *data, size_t size, DeliveryChannel channel) {
+    const char *bytes = static_cast<const char *>(data);
+    sent.push_back({std::vector<char>(bytes, bytes + size), channel});
+  });
+  return sent;
+}
+
+std::vector<int> ReceivedAckTicks(SentDatagram &datagram) {
+  std::vector<int> ticks;
+  GamePacket *packet = reinterpret_cast<GamePacket *>(datagram.bytes.data());
+  auto collect = [&](GamePacket *message) {
+    EXPECT_EQ(message->type, NetworkMessage::SnapshotAck);
+    ticks.push_back(static_cast<SnapshotAckPacket *>(message)->ackTick);
+  };
+  if (packet->type == NetworkMessage::Bundle) {
+    EXPECT_TRUE(PacketBundle::ForEach(datagram.bytes.data(),
+                                      datagram.bytes.size(), collect));
+  } else {
+    collect(packet);
+  }
+  return ticks;
+}
+
+SnapshotAckPacket Ack(int tick) {
+  SnapshotAckPacket packet;
+  packet.ackTick = tick;
+  return packet;
+}
+} // namespace
+
+TEST(PacketBatcherTest, CoalescesEachChannelInOrder) {
+  PacketBatcher batcher;
+  for (int tick = 0; tick < 5; ++tick) {
+    ASSERT_TRUE(batcher.Queue(Ack(tick), tick % 2 == 0
+                                             ? DeliveryChannel::ReliableRpc
+                                             : DeliveryChannel::Snapshot));
+  }
+  ASSERT_TRUE(batcher.HasPending());
+
+  // Channels are flushed in enum order.
+  std::vector<SentDatagram> sent = FlushAll(batcher);
+  ASSERT_EQ(sent.size(), 2u);
+  EXPECT_EQ(sent[0].channel, DeliveryChannel::Snapshot);
+  EXPECT_EQ(ReceivedAckTicks(sent[0]), (std::vector<int>{1, 3}));
+  EXPECT_EQ(sent[1].channel, DeliveryChannel::ReliableRpc);
+  EXPECT_EQ(ReceivedAckTicks(sent[1]), (std::vector<int>{0, 2, 4}));
+
+  EXPECT_FALSE(batcher.HasPending());
+  EXPECT_EQ(batcher.GetQueuedMessageCount(), 5u);
+  EXPECT_EQ(batcher.GetSentDatagramCount(), 2u);
+}
+
+TEST(PacketBatcherTest, SingleMessageIsSentBare) {
+  PacketBatcher batcher;
+  SnapshotAckPacket ack = Ack(7);
+  ASSERT_TRUE(batcher.Queue(ack, DeliveryChannel::Snapshot));
+
+  std::vector<SentDatagram> sent = FlushAll(batcher);
+  ASSERT_EQ(sent.size(), 1u);
+  ASSERT_EQ(sent[0].bytes.size(), static_cast<size_t>(ack.GetTotalSize()));
+  EXPECT_EQ(reinterpret_cast<GamePacket *>(sent[0].bytes.data())->type,
+            NetworkMessage::SnapshotAck);
+}
+
+TEST(PacketBatcherTest, BundlesStayWithinTheSizeLimit) {
+  const size_t limit = 64;
+  PacketBatcher batcher(limit);
+  for (int tick = 0; tick < 20; ++tick) {
+    ASSERT_TRUE(batcher.Queue(Ack(tick), DeliveryChannel::Lifecycle));
+  }
+
+  std::vector<int> received;
+  for (SentDatagram &datagram : FlushAll(batcher)) {
+    EXPECT_LE(datagram.bytes.size(), limit);
+    for (int tick : ReceivedAckTicks(datagram)) {
+      received.push_back(tick);
+    }
+  }
+  ASSERT_EQ(received.size(), 20u);
+  for (int tick = 0; tick < 20; ++tick) {
+    EXPECT_EQ(received[tick], tick);
+  }
+}
+
+TEST(PacketBatcherTest, RejectsPacketsLargerThanABundle) {
+  PacketBatcher batcher(32);
+  HandshakeRejectPacket reject;
+  EXPECT_FALSE(batcher.CanBundle(reject));
+  EXPECT_FALSE(batcher.Queue(reject, DeliveryChannel::Lifecycle));
+  EXPECT_FALSE(batcher.HasPending());
+}
+
+TEST(PacketBatcherTest, MessagesStartAligned) {
+  PacketBatcher batcher;
+  GamePacket odd(NetworkMessage::SnapshotAck);
+  odd.size = 3;
+  std::vector<char> padded(sizeof(GamePacket) + 3, 0);
+  std::memcpy(padded.data(), &odd, sizeof(odd));
+  ASSERT_TRUE(batcher.Queue(*reinterpret_cast<GamePacket *>(padded.data()),
+                            DeliveryChannel::Snapshot));
+  ASSERT_TRUE(batcher.Queue(Ack(1), DeliveryChannel::Snapshot));
+
+  std::vector<SentDatagram> sent = FlushAll(batcher);
+  ASSERT_EQ(sent.size(), 1u);
+  std::vector<size_t> offsets;
+  const char *base = sent[0].bytes.data();
+  EXPECT_TRUE(PacketBundle::ForEach(
+      sent[0].bytes.data(), sent[0].bytes.size(), [&](GamePacket *message) {
+        offsets.push_back(static_cast<size_t>(
+            reinterpret_cast<const char *>(message) - base));
+      }));
+  ASSERT_EQ(offsets.size(), 2u);
+  for (size_t offset : offsets) {
+    EXPECT_EQ(offset % PacketBatcher::MessageAlignment, 0u);
+  }
+}
+
+TEST(PacketBundleTest, RejectsTruncatedAndNestedBundles) {
+  PacketBatcher batcher;
+  batcher.Queue(Ack(1), DeliveryChannel::Snapshot);
+  batcher.Queue(Ack(2), DeliveryChannel::Snapshot);
+  std::vector<SentDatagram> sent = FlushAll(batcher);
+  ASSERT_EQ(sent.size(), 1u);
+  std::vector<char> bytes = sent[0].bytes;
+
+  int handled = 0;
+  auto count = [&](GamePacket *) { handled++; };
+  EXPECT_FALSE(PacketBundle::ForEach(bytes.data(), bytes.size() - 4, count));
+  EXPECT_EQ(handled, 1);
+
+  // A message claiming to be a bundle itself.
+  handled = 0;
+  reinterpret_cast<GamePacket *>(bytes.data() + sizeof(PacketBundleHeader))
+      ->type = NetworkMessage::Bundle;
+  EXPECT_FALSE(PacketBundle::ForEach(bytes.data(), bytes.size(), count));
+  EXPECT_EQ(handled, 0);
+
+  // More messages announced than present.
+  bytes = sent[0].bytes;
+  reinterpret_cast<PacketBundleHeader *>(bytes.data())->messageCount = 3;
+  handled = 0;
+  EXPECT_FALSE(PacketBundle::ForEach(bytes.data(), bytes.size(), count));
+  EXPECT_EQ(handled, 2);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,127 @@
+#include "NetworkPackets.h"
+#include "PacketBufferPool.h"
+#include <atomic>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(PacketBufferPoolTest, ReleasedBuffersAreReused) {
+  PacketBufferPool pool;
+  std::vector<char> buffer = pool.Acquire(300);
+  EXPECT_GE(buffer.capacity(), 512u);
+  const char *memory = buffer.data();
+  pool.Release(std::move(buffer));
+
+  std::vector<char> again = pool.Acquire(400);
+  EXPECT_EQ(again.data(), memory);
+  EXPECT_TRUE(again.empty());
+  EXPECT_EQ(pool.GetCreatedCount(), 1u);
+}
+
+TEST(PacketBufferPoolTest, BuffersAreFiledByTheClassTheirCapacityCovers) {
+  PacketBufferPool pool;
+  std::vector<char> grown = pool.Acquire(256);
+  grown.resize(3000);
+  pool.Release(std::move(grown));
+
+  // 3000 bytes of capacity serves 2 KiB requests but not 4 KiB ones.
+  EXPECT_GE(pool.Acquire(2048).capacity(), 3000u);
+  EXPECT_EQ(pool.Acquire(4096).capacity(), 4096u);
+}
+
+TEST(PacketBufferPoolTest, OversizedAndTinyBuffersAreNotPooled) {
+  PacketBufferPool pool;
+  std::vector<char> large = pool.Acquire(PacketBufferPool::MaxClassBytes + 1);
+  EXPECT_GE(large.capacity(), PacketBufferPool::MaxClassBytes + 1);
+  pool.Release(std::vector<char>(16));
+  EXPECT_EQ(pool.GetCreatedCount(), 0u);
+  EXPECT_EQ(pool.GetFreeCount(), 0u);
+
+  pool.Release(std::move(large));
+  EXPECT_EQ(pool.GetFreeCount(), 1u);
+}
+
+TEST(PacketBufferPoolTest, DetachedBuffersRecycleTheirShells) {
+  PacketBufferPool pool;
+  std::vector<char> *first = pool.AcquireDetached(100);
+  first->resize(100);
+  pool.ReleaseDetached(first);
+
+  std::vector<char> *second = pool.AcquireDetached(100);
+  EXPECT_EQ(second, first);
+  EXPECT_TRUE(second->empty());
+  EXPECT_EQ(pool.GetCreatedCount(), 1u);
+  pool.ReleaseDetached(second);
+}
+
+TEST(PacketBufferPoolTest, FreedBlocksAreReused) {
+  PacketBufferPool pool;
+  void *first = pool.AllocateBlock(48);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % alignof(std::max_align_t),
+            0u);
+  std::memset(first, 0xAB, 48);
+  pool.FreeBlock(first);
+
+  void *second = pool.AllocateBlock(120);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(pool.GetCreatedCount(), 1u);
+  pool.FreeBlock(second);
+  pool.FreeBlock(nullptr);
+}
+
+TEST(PacketBufferPoolTest, BuffersCanBeReleasedOnAnotherThread) {
+  PacketBufferPool pool;
+  constexpr int Count = 10000;
+  std::atomic<int> released{0};
+
+  std::thread releaser([&]() {
+    for (int i = 0; i < Count; ++i) {
+      std::vector<char> *buffer = pool.AcquireDetached(512);
+      buffer->resize(512);
+      pool.ReleaseDetached(buffer);
+      released++;
+    }
+  });
+
+  for (int i = 0; i < Count; ++i) {
+    pool.Release(pool.Acquire(1024));
+  }
+  releaser.join();
+
+  EXPECT_EQ(released.load(), Count);
+  EXPECT_LE(pool.GetCreatedCount(), 4u);
+}
+
+TEST(PacketBufferPoolTest, PacketStreamReturnsItsBufferToThePool) {
+  const char *memory = nullptr;
+  {
+    PacketStream stream;
+    stream.WriteInt(7);
+    memory = stream.buffer.data();
+  }
+
+  PacketStream reused;
+  EXPECT_EQ(reused.buffer.data(), memory);
+  EXPECT_EQ(reused.GetSize(), 0u);
+}
+
+TEST(PacketBufferPoolTest, PacketStreamCopiesAndMovesKeepTheirContents) {
+  PacketStream source;
+  source.WriteInt(42);
+  source.readOffset = 2;
+
+  PacketStream copy(source);
+  EXPECT_EQ(copy.buffer, source.buffer);
+  EXPECT_EQ(copy.readOffset, 2);
+  EXPECT_NE(copy.buffer.data(), source.buffer.data());
+
+  PacketStream moved(std::move(copy));
+  int value = 0;
+  moved.readOffset = 0;
+  ASSERT_TRUE(moved.ReadInt(value));
+  EXPECT_EQ(value, 42);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,76 @@
+#include "NetworkPackets.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(PacketReaderTest, ReadsValuesInOrderWithoutCopyingTheBuffer) {
+  PacketStream stream;
+  stream.WriteInt(42);
+  stream.WriteFloat(1.5f);
+
+  PacketReader reader = stream.GetReader();
+  EXPECT_EQ(reader.GetData(), stream.buffer.data());
+
+  int intValue = 0;
+  float floatValue = 0.0f;
+  ASSERT_TRUE(reader.ReadInt(intValue));
+  ASSERT_TRUE(reader.ReadFloat(floatValue));
+  EXPECT_EQ(intValue, 42);
+  EXPECT_EQ(floatValue, 1.5f);
+  EXPECT_EQ(reader.GetRemaining(), 0u);
+  EXPECT_FALSE(reader.ReadInt(intValue));
+}
+
+TEST(PacketReaderTest, SubViewsAreBoundedToTheirSlice) {
+  PacketStream stream;
+  stream.WriteInt(1);
+  stream.WriteInt(2);
+  stream.WriteInt(3);
+
+  PacketReader reader = stream.GetReader();
+  PacketReader view;
+  ASSERT_TRUE(reader.ReadView(sizeof(int), view));
+  EXPECT_EQ(view.GetData(), stream.buffer.data());
+  EXPECT_EQ(view.GetSize(), sizeof(int));
+
+  int value = 0;
+  ASSERT_TRUE(view.ReadInt(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_FALSE(view.ReadInt(value));
+
+  ASSERT_TRUE(reader.ReadInt(value));
+  EXPECT_EQ(value, 2);
+}
+
+TEST(PacketReaderTest, RejectsViewsAndSkipsPastTheEnd) {
+  PacketStream stream;
+  stream.WriteInt(1);
+
+  PacketReader reader = stream.GetReader();
+  PacketReader view;
+  EXPECT_FALSE(reader.ReadView(sizeof(int) + 1, view));
+  EXPECT_FALSE(reader.SkipChecked(-1));
+  EXPECT_FALSE(reader.SkipChecked(5));
+  EXPECT_EQ(reader.GetReadOffset(), 0u);
+  EXPECT_TRUE(reader.SkipChecked(4));
+  EXPECT_FALSE(reader.CanReadSize(1));
+}
+
+TEST(PacketReaderTest, EmptyReaderRejectsEveryRead) {
+  PacketReader reader;
+  int value = 0;
+  EXPECT_FALSE(reader.ReadInt(value));
+  EXPECT_TRUE(reader.CanReadSize(0));
+  EXPECT_EQ(reader.GetRemaining(), 0u);
+}
+
+TEST(PacketReaderTest, WellFormedPacketsFitInsideTheReceivedBuffer) {
+  SnapshotAckPacket ack;
+  EXPECT_TRUE(IsWellFormedPacket(&ack, sizeof(ack)));
+  EXPECT_FALSE(IsWellFormedPacket(&ack, sizeof(ack) - 1));
+  EXPECT_FALSE(IsWellFormedPacket(&ack, sizeof(GamePacket) - 1));
+  EXPECT_FALSE(IsWellFormedPacket(nullptr, sizeof(ack)));
+
+  ack.size = -4;
+  EXPECT_FALSE(IsWellFormedPacket(&ack, sizeof(ack)));
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,78 @@
+#include "RPCDispatchTable.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+bool DispatchA(NetworkComponent *, PacketStream &) { return true; }
+bool DispatchB(NetworkComponent *, PacketStream &) { return true; }
+bool DispatchC(NetworkComponent *, PacketStream &) { return true; }
+
+// The runtime hash RPCs used before names were hashed at compile time.
+uint32_t RuntimeDjb2(const std::string &name) {
+  uint32_t hash = 5381;
+  for (char c : name)
+    hash = ((hash << 5) + hash) + c;
+  return hash;
+}
+} // namespace
+
+TEST(RPCDispatchTableTest, NameHashIsAConstantMatchingTheWireHash) {
+  constexpr uint32_t hash = RPCNameHash("RequestJump");
+  static_assert(hash == RPCNameHash("RequestJump"), "constexpr");
+  EXPECT_EQ(hash, RuntimeDjb2("RequestJump"));
+  EXPECT_EQ(RPCNameHash(""), 5381u);
+  EXPECT_EQ(RPCNameHash("\xe9t\xe9"), RuntimeDjb2("\xe9t\xe9"));
+}
+
+TEST(RPCDispatchTableTest, EntriesStaySortedAndAreFoundByHash) {
+  RPCDispatchTable table;
+  EXPECT_EQ(table.Add(30, "C", DispatchC), RPCRegisterResult::Added);
+  EXPECT_EQ(table.Add(10, "A", DispatchA), RPCRegisterResult::Added);
+  EXPECT_EQ(table.Add(20, "B", DispatchB), RPCRegisterResult::Added);
+
+  ASSERT_EQ(table.Size(), 3u);
+  EXPECT_EQ(table.GetEntries()[0].hash, 10u);
+  EXPECT_EQ(table.GetEntries()[1].hash, 20u);
+  EXPECT_EQ(table.GetEntries()[2].hash, 30u);
+
+  const RPCDispatchTable::Entry *entry = table.Find(20);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->name, "B");
+  EXPECT_EQ(entry->dispatch, &DispatchB);
+  EXPECT_EQ(table.Find(25), nullptr);
+}
+
+TEST(RPCDispatchTableTest, CollidingNamesAreRejected) {
+  RPCDispatchTable table;
+  table.Add(7, "Fire", DispatchA);
+
+  EXPECT_EQ(table.Add(7, "Reload", DispatchB), RPCRegisterResult::Collision);
+  EXPECT_EQ(table.Find(7)->dispatch, &DispatchA);
+
+  EXPECT_EQ(table.Add(7, "Fire", DispatchC), RPCRegisterResult::Replaced);
+  EXPECT_EQ(table.Find(7)->dispatch, &DispatchC);
+  EXPECT_EQ(table.Size(), 1u);
+}
+
+TEST(RPCDispatchTableTest, InheritKeepsOverridesAndReportsCollisions) {
+  RPCDispatchTable base;
+  base.Add(RPCNameHash("Fire"), "Fire", DispatchA);
+  base.Add(RPCNameHash("Jump"), "Jump", DispatchA);
+  base.Add(99, "BaseOnly", DispatchA);
+
+  RPCDispatchTable derived;
+  derived.Add(RPCNameHash("Jump"), "Jump", DispatchB);
+  derived.Add(99, "DerivedOnly", DispatchC);
+
+  std::vector<RPCDispatchTable::Entry> collisions;
+  EXPECT_EQ(derived.Inherit(base, &collisions), 1u);
+  ASSERT_EQ(collisions.size(), 1u);
+  EXPECT_EQ(collisions[0].name, "BaseOnly");
+
+  EXPECT_EQ(derived.Size(), 3u);
+  EXPECT_EQ(derived.Find(RPCNameHash("Fire"))->dispatch, &DispatchA);
+  EXPECT_EQ(derived.Find(RPCNameHash("Jump"))->dispatch, &DispatchB);
+  EXPECT_EQ(derived.Find(99)->name, "DerivedOnly");
+}
+} // namespace ToolKit::ToolKitNetworking
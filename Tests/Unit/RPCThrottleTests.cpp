@@ -0,0 +1,125 @@
+#include "RPCThrottle.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+RPCThrottleKey Key(int networkID, uint32_t hash = 1) {
+  return RPCThrottleKey{networkID, hash, 0};
+}
+
+RPCThrottleResult Submit(RPCThrottle &throttle, const RPCThrottleKey &key,
+                         const RPCSendPolicy &policy,
+                         const std::string &payload, double now) {
+  return throttle.Submit(key, policy, 7, payload.data(), payload.size(), now);
+}
+
+std::vector<std::string> Flush(RPCThrottle &throttle, double now) {
+  std::vector<std::string> sent;
+  throttle.Flush(now, [&sent](const RPCThrottle::QueuedRpc &rpc) {
+    sent.emplace_back(rpc.payload.begin(), rpc.payload.end());
+  });
+  return sent;
+}
+} // namespace
+
+TEST(RPCThrottleTest, UnthrottledPoliciesAlwaysSend) {
+  RPCThrottle throttle;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(Submit(throttle, Key(1), RPCSendPolicy::Reliable(), "a", 0.0),
+              RPCThrottleResult::Send);
+    EXPECT_EQ(Submit(throttle, Key(1), RPCSendPolicy::Unreliable(), "a", 0.0),
+              RPCThrottleResult::Send);
+  }
+  EXPECT_FALSE(throttle.HasQueued());
+  EXPECT_EQ(throttle.GetDroppedCount(), 0u);
+}
+
+TEST(RPCThrottleTest, RateLimitDropsCallsInsideTheInterval) {
+  RPCThrottle throttle;
+  const RPCSendPolicy policy = RPCSendPolicy::Unreliable(10.0f);
+
+  EXPECT_EQ(Submit(throttle, Key(1), policy, "a", 0.0),
+            RPCThrottleResult::Send);
+  EXPECT_EQ(Submit(throttle, Key(1), policy, "b", 0.05),
+            RPCThrottleResult::Dropped);
+  // Other components and RPCs have their own limit.
+  EXPECT_EQ(Submit(throttle, Key(2), policy, "c", 0.05),
+            RPCThrottleResult::Send);
+  EXPECT_EQ(Submit(throttle, Key(1, 2), policy, "d", 0.05),
+            RPCThrottleResult::Send);
+  EXPECT_EQ(Submit(throttle, Key(1), policy, "e", 0.1),
+            RPCThrottleResult::Send);
+  EXPECT_EQ(throttle.GetDroppedCount(), 1u);
+}
+
+TEST(RPCThrottleTest, CoalescingSendsOnlyTheLatestCallPerFlush) {
+  RPCThrottle throttle;
+  const RPCSendPolicy policy = RPCSendPolicy::Unreliable(0.0f, true);
+
+  EXPECT_EQ(Submit(throttle, Key(1), policy, "first", 0.0),
+            RPCThrottleResult::Queued);
+  EXPECT_EQ(Submit(throttle, Key(1), policy, "second", 0.0),
+            RPCThrottleResult::Queued);
+  EXPECT_EQ(Submit(throttle, Key(2), policy, "other", 0.0),
+            RPCThrottleResult::Queued);
+  EXPECT_EQ(Submit(throttle, Key(1), policy, "latest", 0.0),
+            RPCThrottleResult::Queued);
+
+  EXPECT_EQ(Flush(throttle, 0.0),
+            (std::vector<std::string>{"latest", "other"}));
+  EXPECT_EQ(throttle.GetCoalescedCount(), 2u);
+  EXPECT_FALSE(throttle.HasQueued());
+  EXPECT_TRUE(Flush(throttle, 0.1).empty());
+}
+
+TEST(RPCThrottleTest, CoalescedStreamsOverTheLimitWaitForTheInterval) {
+  RPCThrottle throttle;
+  const RPCSendPolicy policy = RPCSendPolicy::Reliable(10.0f, true);
+
+  Submit(throttle, Key(1), policy, "a", 0.0);
+  EXPECT_EQ(Flush(throttle, 0.0), std::vector<std::string>{"a"});
+
+  Submit(throttle, Key(1), policy, "b", 0.02);
+  EXPECT_TRUE(Flush(throttle, 0.02).empty());
+  Submit(throttle, Key(1), policy, "c", 0.05);
+  EXPECT_TRUE(Flush(throttle, 0.05).empty());
+  EXPECT_TRUE(throttle.HasQueued());
+
+  EXPECT_EQ(Flush(throttle, 0.1), std::vector<std::string>{"c"});
+  EXPECT_FALSE(throttle.HasQueued());
+}
+
+TEST(RPCThrottleTest, CallsMadeDuringAFlushWaitForTheNextOne) {
+  RPCThrottle throttle;
+  const RPCSendPolicy policy = RPCSendPolicy::Unreliable(0.0f, true);
+  Submit(throttle, Key(1), policy, "a", 0.0);
+
+  std::vector<std::string> sent;
+  throttle.Flush(0.0, [&](const RPCThrottle::QueuedRpc &rpc) {
+    sent.emplace_back(rpc.payload.begin(), rpc.payload.end());
+    Submit(throttle, Key(1), policy, "again", 0.0);
+    Submit(throttle, Key(3), policy, "new", 0.0);
+  });
+  EXPECT_EQ(sent, std::vector<std::string>{"a"});
+  EXPECT_EQ(Flush(throttle, 0.1),
+            (std::vector<std::string>{"again", "new"}));
+}
+
+TEST(RPCThrottleTest, ForgottenComponentsLoseQueuedCallsAndLimits) {
+  RPCThrottle throttle;
+  const RPCSendPolicy limited = RPCSendPolicy::Unreliable(1.0f);
+  const RPCSendPolicy coalesced = RPCSendPolicy::Unreliable(0.0f, true);
+
+  Submit(throttle, Key(1), limited, "a", 0.0);
+  Submit(throttle, Key(1, 2), coalesced, "queued", 0.0);
+  Submit(throttle, Key(2, 2), coalesced, "kept", 0.0);
+  throttle.ForgetComponent(1);
+
+  EXPECT_EQ(Flush(throttle, 0.0), std::vector<std::string>{"kept"});
+  // A network ID reused by a new component starts without a limit.
+  EXPECT_EQ(Submit(throttle, Key(1), limited, "b", 0.1),
+            RPCThrottleResult::Send);
+}
+} // namespace ToolKit::ToolKitNetworking
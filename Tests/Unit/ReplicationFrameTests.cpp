@@ -0,0 +1,157 @@
+#include "NetworkVariableDelta.h"
+#include "ReplicationFrame.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+// Adds an entity whose variables are ints changed on `changedTicks`.
+void AddEntityWithInts(ReplicationFrame &frame, int networkID,
+                       const std::vector<int> &values,
+                       const std::vector<int> &changedTicks) {
+  frame.AddEntity(networkID, 0, 1.0f, 1, 0, QuantizationRange(), 0);
+
+  std::vector<uint32_t> offsets;
+  std::vector<char> bytes;
+  for (int value : values) {
+    offsets.push_back(static_cast<uint32_t>(bytes.size()));
+    const char *raw = reinterpret_cast<const char *>(&value);
+    bytes.insert(bytes.end(), raw, raw + sizeof(int));
+  }
+  frame.SetVariables(changedTicks.data(), offsets.data(), values.size(),
+                     bytes.data(), bytes.size());
+}
+
+SnapshotTransform PresentTransform(bool hasBaseline) {
+  SnapshotTransform transform;
+  transform.present = true;
+  transform.hasBaseline = hasBaseline;
+  transform.position = Vec3(1.0f, 2.0f, 3.0f);
+  transform.positionChanged = !hasBaseline;
+  transform.orientationChanged = !hasBaseline;
+  return transform;
+}
+
+// Reads a record up to its variables; returns the property mask.
+unsigned char ReadRecordHeader(PacketReader &reader, int &networkID,
+                               int &baseTick, int &payloadSize) {
+  EXPECT_TRUE(reader.ReadInt(networkID));
+  EXPECT_TRUE(reader.ReadInt(baseTick));
+  EXPECT_TRUE(reader.ReadInt(payloadSize));
+  unsigned char mask = 0;
+  EXPECT_TRUE(reader.Read(mask));
+  return mask;
+}
+} // namespace
+
+TEST(ReplicationFrameTest, VariableBytesOfEverySlotAreAppendedInOrder) {
+  ReplicationFrame frame;
+  frame.Begin(7, 3);
+  AddEntityWithInts(frame, 1, {10, 11}, {3, 5});
+  frame.AddEntity(2, 0, 1.0f, 1, 0, QuantizationRange(), 0);
+  AddEntityWithInts(frame, 3, {30}, {6});
+
+  ASSERT_EQ(frame.Size(), 3u);
+  EXPECT_EQ(frame.GetVariableCount(0), 2u);
+  EXPECT_EQ(frame.GetVariableCount(1), 0u);
+  EXPECT_EQ(frame.GetVariableCount(2), 1u);
+  EXPECT_EQ(frame.variableChangedTicks, (std::vector<int>{3, 5, 6}));
+  EXPECT_EQ(frame.variableOffsets, (std::vector<uint32_t>{0, 4, 8, 12}));
+
+  int third = 0;
+  std::memcpy(&third, frame.variableBytes.data() + frame.variableOffsets[2],
+              sizeof(int));
+  EXPECT_EQ(third, 30);
+
+  // A new tick reuses the frame from scratch.
+  frame.Begin(8, 0);
+  EXPECT_EQ(frame.tick, 8);
+  EXPECT_EQ(frame.Size(), 0u);
+  EXPECT_TRUE(frame.variableBytes.empty());
+  EXPECT_EQ(frame.variableOffsets.size(), 1u);
+}
+
+TEST(ReplicationFrameTest, FullRecordCarriesTransformAndEveryVariable) {
+  ReplicationFrame frame;
+  frame.Begin(7, 1);
+  AddEntityWithInts(frame, 42, {5, 6}, {-1, 3});
+
+  PacketStream stream;
+  std::vector<uint8_t> mask;
+  WriteEntityRecord(frame, 0, -1, PresentTransform(false), stream, mask);
+
+  PacketReader reader = stream.GetReader();
+  int networkID = 0;
+  int baseTick = 0;
+  int payloadSize = 0;
+  const unsigned char properties =
+      ReadRecordHeader(reader, networkID, baseTick, payloadSize);
+  EXPECT_EQ(networkID, 42);
+  EXPECT_EQ(baseTick, -1);
+  EXPECT_EQ(static_cast<size_t>(payloadSize), reader.GetRemaining() + 1);
+  EXPECT_EQ(properties, static_cast<unsigned char>(
+                            NetworkProperty::Position |
+                            NetworkProperty::Orientation |
+                            NetworkProperty::NetworkVariables));
+
+  Vec3 position;
+  Quaternion orientation;
+  ASSERT_TRUE(reader.Read(position));
+  ASSERT_TRUE(reader.Read(orientation));
+  EXPECT_EQ(position, Vec3(1.0f, 2.0f, 3.0f));
+
+  size_t variableCount = 0;
+  ASSERT_TRUE(VariableMask::Read(reader, 8, variableCount, mask));
+  EXPECT_EQ(variableCount, 2u);
+  EXPECT_TRUE(VariableMask::IsSet(mask, 0));
+  EXPECT_TRUE(VariableMask::IsSet(mask, 1));
+  int first = 0;
+  int second = 0;
+  ASSERT_TRUE(reader.ReadInt(first));
+  ASSERT_TRUE(reader.ReadInt(second));
+  EXPECT_EQ(first, 5);
+  EXPECT_EQ(second, 6);
+  EXPECT_EQ(reader.GetRemaining(), 0u);
+}
+
+TEST(ReplicationFrameTest, DeltaRecordCarriesVariablesChangedAfterTheBase) {
+  ReplicationFrame frame;
+  frame.Begin(9, 1);
+  AddEntityWithInts(frame, 42, {5, 6, 7}, {2, 8, 4});
+
+  PacketStream stream;
+  std::vector<uint8_t> mask;
+  WriteEntityRecord(frame, 0, 5, PresentTransform(true), stream, mask);
+
+  PacketReader reader = stream.GetReader();
+  int networkID = 0;
+  int baseTick = 0;
+  int payloadSize = 0;
+  const unsigned char properties =
+      ReadRecordHeader(reader, networkID, baseTick, payloadSize);
+  EXPECT_EQ(baseTick, 5);
+  EXPECT_EQ(properties,
+            static_cast<unsigned char>(NetworkProperty::NetworkVariables));
+
+  size_t variableCount = 0;
+  ASSERT_TRUE(VariableMask::Read(reader, 8, variableCount, mask));
+  EXPECT_EQ(variableCount, 3u);
+  EXPECT_FALSE(VariableMask::IsSet(mask, 0));
+  EXPECT_TRUE(VariableMask::IsSet(mask, 1));
+  EXPECT_FALSE(VariableMask::IsSet(mask, 2));
+  int value = 0;
+  ASSERT_TRUE(reader.ReadInt(value));
+  EXPECT_EQ(value, 6);
+  EXPECT_EQ(reader.GetRemaining(), 0u);
+}
+
+TEST(ReplicationFrameTest, EntitiesWithoutATransformWriteAnEmptyRecord) {
+  ReplicationFrame frame;
+  frame.Begin(1, 1);
+  AddEntityWithInts(frame, 42, {5}, {1});
+
+  PacketStream stream;
+  std::vector<uint8_t> mask;
+  WriteEntityRecord(frame, 0, -1, SnapshotTransform(), stream, mask);
+  EXPECT_EQ(stream.GetSize(), 3 * sizeof(int));
+}
+} // namespace ToolKit::ToolKitNetworking
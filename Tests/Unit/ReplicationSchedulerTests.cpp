@@ -0,0 +1,255 @@
+#include "ReplicationScheduler.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+std::vector<ReplicationEntityInfo> MakeEntities(int count) {
+  std::vector<ReplicationEntityInfo> entities(static_cast<size_t>(count));
+  for (int i = 0; i < count; ++i) {
+    entities[i].networkID = i + 1;
+  }
+  return entities;
+}
+
+size_t FixedRecordSize(int, int) { return 100; }
+
+ReplicationScheduler::ScheduleSettings MakeSettings(int tick,
+                                                    size_t byteBudget = 0) {
+  ReplicationScheduler::ScheduleSettings settings;
+  settings.currentTick = tick;
+  settings.byteBudget = byteBudget;
+  return settings;
+}
+
+std::vector<int> ScheduledIDs(const ScheduledSnapshot &snapshot) {
+  std::vector<int> ids;
+  for (const ScheduledRecord &record : snapshot.records) {
+    ids.push_back(record.networkID);
+  }
+  return ids;
+}
+} // namespace
+
+TEST(ReplicationSchedulerTest, WithoutBudgetEveryPeerSharesTheFullSnapshot) {
+  ReplicationScheduler scheduler;
+  std::vector<ScheduledSnapshot> snapshots;
+  scheduler.Schedule({1, 2}, MakeEntities(3), MakeSettings(0), FixedRecordSize,
+                     nullptr, snapshots);
+
+  ASSERT_EQ(snapshots.size(), 1u);
+  EXPECT_EQ(snapshots[0].peers, (std::vector<TransportPeerId>{1, 2}));
+  EXPECT_EQ(ScheduledIDs(snapshots[0]), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(snapshots[0].baseTick, -1);
+}
+
+TEST(ReplicationSchedulerTest, BudgetCapsBytesAndCarriesTheRestOver) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(10);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  std::vector<int> sendCounts(entities.size(), 0);
+  for (int tick = 0; tick < 10; ++tick) {
+    scheduler.Schedule({1}, entities, MakeSettings(tick, 300),
+                       FixedRecordSize, nullptr, snapshots);
+    ASSERT_EQ(snapshots.size(), 1u);
+    ASSERT_EQ(snapshots[0].records.size(), 3u);
+    for (const ScheduledRecord &record : snapshots[0].records) {
+      sendCounts[record.entityIndex]++;
+    }
+  }
+
+  // Equal priorities rotate through the whole world; nobody starves.
+  for (int count : sendCounts) {
+    EXPECT_GE(count, 2);
+    EXPECT_LE(count, 4);
+  }
+}
+
+TEST(ReplicationSchedulerTest, HigherPriorityEntitiesAreSentMoreOften) {
+  ReplicationScheduler scheduler;
+  std::vector<ReplicationEntityInfo> entities = MakeEntities(4);
+  entities[0].basePriority = 4.0f;
+  std::vector<ScheduledSnapshot> snapshots;
+
+  int importantSends = 0;
+  int otherSends = 0;
+  for (int tick = 0; tick < 20; ++tick) {
+    scheduler.Schedule({1}, entities, MakeSettings(tick, 100),
+                       FixedRecordSize, nullptr, snapshots);
+    ASSERT_EQ(snapshots[0].records.size(), 1u);
+    if (snapshots[0].records[0].networkID == entities[0].networkID) {
+      importantSends++;
+    } else {
+      otherSends++;
+    }
+  }
+
+  EXPECT_GT(importantSends, otherSends / 3);
+  EXPECT_GT(otherSends, 0);
+}
+
+TEST(ReplicationSchedulerTest, UpdateIntervalSkipsTicks) {
+  ReplicationScheduler scheduler;
+  std::vector<ReplicationEntityInfo> entities = MakeEntities(2);
+  entities[1].updateInterval = 3;
+  std::vector<ScheduledSnapshot> snapshots;
+
+  std::vector<size_t> recordCounts;
+  for (int tick = 0; tick < 6; ++tick) {
+    scheduler.Schedule({1}, entities, MakeSettings(tick), FixedRecordSize,
+                       nullptr, snapshots);
+    recordCounts.push_back(snapshots[0].records.size());
+  }
+
+  EXPECT_EQ(recordCounts, (std::vector<size_t>{2, 1, 1, 2, 1, 1}));
+}
+
+TEST(ReplicationSchedulerTest, AcksOnlyBaselineEntitiesSentInThatTick) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(2);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  scheduler.Schedule({1}, entities, MakeSettings(0, 100), FixedRecordSize,
+                     nullptr, snapshots);
+  ASSERT_EQ(ScheduledIDs(snapshots[0]), (std::vector<int>{1}));
+
+  scheduler.OnAck(1, 0);
+  EXPECT_EQ(scheduler.GetEntityBaseline(1, 1), 0);
+  EXPECT_EQ(scheduler.GetEntityBaseline(1, 2), -1);
+
+  scheduler.Schedule({1}, entities, MakeSettings(1, 100), FixedRecordSize,
+                     nullptr, snapshots);
+  ASSERT_EQ(snapshots[0].records.size(), 1u);
+  EXPECT_EQ(snapshots[0].records[0].networkID, 2);
+  EXPECT_EQ(snapshots[0].records[0].baseTick, -1);
+  EXPECT_EQ(snapshots[0].baseTick, 0);
+
+  scheduler.Schedule({1}, entities, MakeSettings(2, 100), FixedRecordSize,
+                     nullptr, snapshots);
+  ASSERT_EQ(snapshots[0].records.size(), 1u);
+  EXPECT_EQ(snapshots[0].records[0].networkID, 1);
+  EXPECT_EQ(snapshots[0].records[0].baseTick, 0);
+}
+
+TEST(ReplicationSchedulerTest, RecordsThatWereNeverSentAreNotBaselines) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(2);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  scheduler.Schedule({1, 2}, entities, MakeSettings(0), FixedRecordSize,
+                     nullptr, snapshots);
+  scheduler.ClearSent({1}, 2, 0);
+  scheduler.OnAck(1, 0);
+  scheduler.OnAck(2, 0);
+
+  EXPECT_EQ(scheduler.GetEntityBaseline(1, 1), 0);
+  EXPECT_EQ(scheduler.GetEntityBaseline(1, 2), -1);
+  EXPECT_EQ(scheduler.GetEntityBaseline(2, 2), 0);
+}
+
+TEST(ReplicationSchedulerTest, UnusableBaselinesFallBackToFullState) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(1);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  scheduler.Schedule({1}, entities, MakeSettings(0), FixedRecordSize,
+                     nullptr, snapshots);
+  scheduler.OnAck(1, 0);
+
+  ReplicationScheduler::ScheduleSettings settings = MakeSettings(1);
+  settings.useDeltaBaselines = false;
+  scheduler.Schedule({1}, entities, settings, FixedRecordSize, nullptr,
+                     snapshots);
+  EXPECT_EQ(snapshots[0].baseTick, -1);
+  EXPECT_EQ(snapshots[0].records[0].baseTick, -1);
+
+  settings = MakeSettings(64);
+  settings.historyDepth = 64;
+  scheduler.Schedule({1}, entities, settings, FixedRecordSize, nullptr,
+                     snapshots);
+  EXPECT_EQ(snapshots[0].records[0].baseTick, -1);
+}
+
+TEST(ReplicationSchedulerTest, SentHistoryFollowsTheHistoryDepth) {
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(1);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  for (int depth : {64, 256}) {
+    ReplicationScheduler scheduler;
+    for (int tick = 0; tick < 200; ++tick) {
+      ReplicationScheduler::ScheduleSettings settings = MakeSettings(tick);
+      settings.historyDepth = depth;
+      scheduler.Schedule({1}, entities, settings, FixedRecordSize, nullptr,
+                         snapshots);
+    }
+
+    // A late ack for a tick 150 ticks back.
+    scheduler.OnAck(1, 49);
+    ReplicationScheduler::ScheduleSettings settings = MakeSettings(200);
+    settings.historyDepth = depth;
+    scheduler.Schedule({1}, entities, settings, FixedRecordSize, nullptr,
+                       snapshots);
+    EXPECT_EQ(snapshots[0].records[0].baseTick, depth > 151 ? 49 : -1)
+        << "depth " << depth;
+  }
+}
+
+TEST(ReplicationSchedulerTest, PeersWithDifferentAcksGetSeparateSnapshots) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(2);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  scheduler.Schedule({1, 2}, entities, MakeSettings(0), FixedRecordSize,
+                     nullptr, snapshots);
+  scheduler.OnAck(1, 0);
+  scheduler.Schedule({1, 2}, entities, MakeSettings(1), FixedRecordSize,
+                     nullptr, snapshots);
+
+  ASSERT_EQ(snapshots.size(), 2u);
+  EXPECT_EQ(snapshots[0].peers, (std::vector<TransportPeerId>{1}));
+  EXPECT_EQ(snapshots[0].records[0].baseTick, 0);
+  EXPECT_EQ(snapshots[1].peers, (std::vector<TransportPeerId>{2}));
+  EXPECT_EQ(snapshots[1].records[0].baseTick, -1);
+}
+
+TEST(ReplicationSchedulerTest, RemovingPeersAndEntitiesDropsTheirState) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(2);
+  std::vector<ScheduledSnapshot> snapshots;
+
+  scheduler.Schedule({1}, entities, MakeSettings(0, 100), FixedRecordSize,
+                     nullptr, snapshots);
+  EXPECT_GT(scheduler.GetPriority(1, 2), 0.0f);
+
+  scheduler.RemoveEntity(2);
+  EXPECT_EQ(scheduler.GetPriority(1, 2), 0.0f);
+
+  scheduler.OnAck(1, 0);
+  scheduler.RemovePeer(1);
+  EXPECT_EQ(scheduler.GetEntityBaseline(1, 1), -1);
+}
+
+TEST(ReplicationSchedulerTest, IrrelevantEntitiesAreSkippedPerPeer) {
+  ReplicationScheduler scheduler;
+  const std::vector<ReplicationEntityInfo> entities = MakeEntities(2);
+
+  std::vector<InterestEntity> positions(2);
+  for (size_t i = 0; i < positions.size(); ++i) {
+    positions[i].networkID = entities[i].networkID;
+    positions[i].hasPosition = true;
+    positions[i].position = Vec3(100.0f * static_cast<float>(i), 0.0f, 0.0f);
+  }
+  positions[0].ownerID = 1;
+
+  InterestManager interest;
+  interest.SetRadius(10.0f);
+  interest.Update(positions, {1});
+
+  std::vector<ScheduledSnapshot> snapshots;
+  scheduler.Schedule({1}, entities, MakeSettings(0), FixedRecordSize,
+                     &interest, snapshots);
+  ASSERT_EQ(snapshots.size(), 1u);
+  EXPECT_EQ(ScheduledIDs(snapshots[0]), (std::vector<int>{1}));
+  EXPECT_EQ(scheduler.GetPriority(1, 2), 0.0f);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,59 @@
+#include "SnapshotBaseline.h"
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(SnapshotBaselineTest, BaselineUsabilityIsBoundedByHistoryDepth) {
+  EXPECT_TRUE(SnapshotBaseline::IsBaselineUsable(10, 10, 64));
+  EXPECT_TRUE(SnapshotBaseline::IsBaselineUsable(10, 73, 64));
+  EXPECT_FALSE(SnapshotBaseline::IsBaselineUsable(10, 74, 64));
+  EXPECT_FALSE(SnapshotBaseline::IsBaselineUsable(11, 10, 64));
+  EXPECT_FALSE(SnapshotBaseline::IsBaselineUsable(-1, 10, 64));
+}
+
+TEST(SnapshotBaselineTest, DeltaKeysDistinguishEveryField) {
+  std::unordered_set<SnapshotDeltaKey, SnapshotDeltaKeyHash> keys;
+  keys.insert({7, 10, 12});
+  keys.insert({7, 11, 12});
+  keys.insert({7, 10, 13});
+  keys.insert({8, 10, 12});
+  keys.insert({7, 10, 12});
+
+  EXPECT_EQ(keys.size(), 4u);
+  EXPECT_EQ(keys.count({7, -1, 12}), 0u);
+}
+
+TEST(SnapshotBaselineTest, DeltaCacheFindsInsertedEntriesAcrossRehashes) {
+  SnapshotDeltaCache cache;
+  std::vector<std::vector<char> *> inserted;
+  for (int id = 0; id < 200; ++id) {
+    std::vector<char> &bytes = cache.Insert({id, id % 3 - 1, 50});
+    bytes.assign(4, static_cast<char>(id));
+    inserted.push_back(&bytes);
+  }
+
+  EXPECT_EQ(cache.Size(), 200u);
+  for (int id = 0; id < 200; ++id) {
+    std::vector<char> *bytes = cache.Find({id, id % 3 - 1, 50});
+    ASSERT_EQ(bytes, inserted[id]);
+    EXPECT_EQ((*bytes)[0], static_cast<char>(id));
+  }
+  EXPECT_EQ(cache.Find({0, 5, 50}), nullptr);
+}
+
+TEST(SnapshotBaselineTest, DeltaCacheClearKeepsEntryBuffers) {
+  SnapshotDeltaCache cache;
+  std::vector<char> &first = cache.Insert({1, -1, 10});
+  first.assign(300, 'a');
+  const char *memory = first.data();
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0u);
+  EXPECT_EQ(cache.Find({1, -1, 10}), nullptr);
+
+  std::vector<char> &reused = cache.Insert({2, -1, 11});
+  EXPECT_TRUE(reused.empty());
+  EXPECT_GE(reused.capacity(), 300u);
+  EXPECT_EQ(reused.data(), memory);
+}
+} // namespace ToolKit::ToolKitNetworking
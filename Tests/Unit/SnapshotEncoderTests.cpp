@@ -0,0 +1,147 @@
+#include "SnapshotEncoder.h"
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+// A captured tick with one int variable per entity. No component exists in
+// these tests: the encoder only has the frame and the transform history.
+void CaptureWorld(ReplicationFrame &frame, TransformCache &transforms,
+                  int tick, int entityCount) {
+  frame.Begin(tick, static_cast<size_t>(entityCount));
+  for (int i = 0; i < entityCount; ++i) {
+    frame.AddEntity(i + 1, 0, 1.0f, 1, 0, QuantizationRange(), 0);
+    const int changedTick = i % 3 == 0 ? tick : 1;
+    const uint32_t offset = 0;
+    const int value = i * 10 + tick;
+    frame.SetVariables(&changedTick, &offset, 1,
+                       reinterpret_cast<const char *>(&value), sizeof(int));
+    frame.transforms.Set(static_cast<size_t>(i), i + 1,
+                         Vec3(static_cast<float>(i), 0.0f,
+                              static_cast<float>(tick)),
+                         Quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+  }
+  transforms.CommitFrame(frame.transforms);
+}
+
+ScheduledSnapshot ScheduleAll(int entityCount, int baseTick) {
+  ScheduledSnapshot snapshot;
+  snapshot.baseTick = baseTick;
+  for (int i = 0; i < entityCount; ++i) {
+    ScheduledRecord record;
+    record.entityIndex = i;
+    record.networkID = i + 1;
+    record.baseTick = baseTick;
+    snapshot.records.push_back(record);
+  }
+  return snapshot;
+}
+
+std::vector<std::vector<PacketStream>>
+EncodeTick(int tick, size_t threadCount,
+           const std::vector<ScheduledSnapshot> &snapshots) {
+  ReplicationFrame frames[2];
+  TransformCache transforms(8);
+  CaptureWorld(frames[0], transforms, tick - 1, 600);
+  CaptureWorld(frames[1], transforms, tick, 600);
+
+  SnapshotEncoder encoder;
+  SnapshotWorkerPool pool(threadCount);
+  std::vector<std::vector<PacketStream>> fragments;
+  encoder.BeginTick(frames[1], transforms);
+  encoder.EncodeSnapshots(snapshots,
+                          SnapshotFragmenter::DefaultMaxFragmentBytes, pool,
+                          fragments);
+  return fragments;
+}
+} // namespace
+
+TEST(SnapshotEncoderTest, EncodesEveryBaselineGroupFromTheFrame) {
+  const std::vector<ScheduledSnapshot> snapshots = {ScheduleAll(600, -1),
+                                                    ScheduleAll(600, 4)};
+  const std::vector<std::vector<PacketStream>> fragments =
+      EncodeTick(5, 0, snapshots);
+
+  ASSERT_EQ(fragments.size(), 2u);
+  for (size_t s = 0; s < fragments.size(); ++s) {
+    ASSERT_GT(fragments[s].size(), 1u);
+    int entities = 0;
+    for (const PacketStream &fragment : fragments[s]) {
+      WorldSnapshotPacket header;
+      std::memcpy(&header, fragment.buffer.data(), sizeof(header));
+      EXPECT_EQ(header.serverTick, 5);
+      EXPECT_EQ(header.baseTick, snapshots[s].baseTick);
+      EXPECT_EQ(static_cast<size_t>(header.GetTotalSize()),
+                fragment.GetSize());
+      entities += header.entityCount;
+    }
+    EXPECT_EQ(entities, 600);
+  }
+}
+
+TEST(SnapshotEncoderTest, WorkerThreadsWriteTheSameBytes) {
+  std::vector<ScheduledSnapshot> snapshots = {ScheduleAll(600, -1),
+                                              ScheduleAll(600, 4),
+                                              ScheduleAll(300, 4)};
+  const std::vector<std::vector<PacketStream>> serial =
+      EncodeTick(5, 0, snapshots);
+  const std::vector<std::vector<PacketStream>> parallel =
+      EncodeTick(5, 3, snapshots);
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (size_t s = 0; s < serial.size(); ++s) {
+    ASSERT_EQ(serial[s].size(), parallel[s].size());
+    for (size_t f = 0; f < serial[s].size(); ++f) {
+      EXPECT_EQ(serial[s][f].buffer, parallel[s][f].buffer);
+    }
+  }
+}
+
+TEST(SnapshotEncoderTest, GroupsSharingABaselineReuseRecords) {
+  ReplicationFrame frame;
+  TransformCache transforms(8);
+  CaptureWorld(frame, transforms, 3, 20);
+
+  SnapshotEncoder encoder;
+  encoder.BeginTick(frame, transforms);
+  SnapshotWorkerPool pool;
+  std::vector<std::vector<PacketStream>> fragments;
+  encoder.EncodeSnapshots({ScheduleAll(20, -1), ScheduleAll(10, -1)},
+                          SnapshotFragmenter::DefaultMaxFragmentBytes, pool,
+                          fragments);
+  EXPECT_EQ(encoder.GetCachedDeltaCount(), 20u);
+  EXPECT_EQ(&encoder.EncodeRecord(3, -1), &encoder.EncodeRecord(3, -1));
+
+  SnapshotEncoder::Problems problems;
+  encoder.TakeProblems(problems);
+  EXPECT_TRUE(problems.Empty());
+}
+
+TEST(SnapshotEncoderTest, RecordsPastTheFragmentLimitAreReported) {
+  const int entityCount = SnapshotFragmenter::MaxFragmentsPerTick + 10;
+  ReplicationFrame frame;
+  TransformCache transforms(8);
+  CaptureWorld(frame, transforms, 3, entityCount);
+
+  // Room for one record per fragment.
+  SnapshotEncoder encoder;
+  encoder.BeginTick(frame, transforms);
+  SnapshotWorkerPool pool;
+  std::vector<std::vector<PacketStream>> fragments;
+  encoder.EncodeSnapshots({ScheduleAll(10, -1), ScheduleAll(entityCount, -1)},
+                          sizeof(WorldSnapshotPacket) + 1, pool, fragments);
+  ASSERT_EQ(fragments[1].size(),
+            static_cast<size_t>(SnapshotFragmenter::MaxFragmentsPerTick));
+
+  SnapshotEncoder::Problems problems;
+  encoder.TakeProblems(problems);
+  EXPECT_EQ(problems.overFragmentLimit, 1);
+  ASSERT_EQ(problems.droppedRecords.size(), 10u);
+  for (size_t i = 0; i < problems.droppedRecords.size(); ++i) {
+    EXPECT_EQ(problems.droppedRecords[i].snapshotIndex, 1u);
+    EXPECT_EQ(problems.droppedRecords[i].networkID,
+              SnapshotFragmenter::MaxFragmentsPerTick + 1 +
+                  static_cast<int>(i));
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
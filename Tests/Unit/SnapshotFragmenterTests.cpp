@@ -0,0 +1,99 @@
+#include "SnapshotFragmenter.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(SnapshotFragmenterTest, PacksRecordsWithinTheBudget) {
+  const std::vector<size_t> recordSizes = {400, 400, 400, 300, 100, 500};
+  std::vector<SnapshotFragmentRange> fragments;
+  SnapshotFragmenter::PlanFragments(recordSizes, 1000, fragments);
+
+  ASSERT_EQ(fragments.size(), 3u);
+  EXPECT_EQ(fragments[0].firstEntity, 0);
+  EXPECT_EQ(fragments[0].entityCount, 2);
+  EXPECT_EQ(fragments[0].payloadBytes, 800u);
+  EXPECT_EQ(fragments[1].firstEntity, 2);
+  EXPECT_EQ(fragments[1].entityCount, 3);
+  EXPECT_EQ(fragments[1].payloadBytes, 800u);
+  EXPECT_EQ(fragments[2].firstEntity, 5);
+  EXPECT_EQ(fragments[2].entityCount, 1);
+  EXPECT_EQ(fragments[2].payloadBytes, 500u);
+}
+
+TEST(SnapshotFragmenterTest, OversizedRecordsGetTheirOwnFragment) {
+  const std::vector<size_t> recordSizes = {100, 5000, 100};
+  std::vector<SnapshotFragmentRange> fragments;
+  SnapshotFragmenter::PlanFragments(recordSizes, 1000, fragments);
+
+  ASSERT_EQ(fragments.size(), 3u);
+  EXPECT_EQ(fragments[1].firstEntity, 1);
+  EXPECT_EQ(fragments[1].entityCount, 1);
+  EXPECT_EQ(fragments[1].payloadBytes, 5000u);
+  EXPECT_EQ(fragments[2].firstEntity, 2);
+}
+
+TEST(SnapshotFragmenterTest, EmptyWorldProducesOneEmptyFragment) {
+  std::vector<SnapshotFragmentRange> fragments;
+  SnapshotFragmenter::PlanFragments({}, 1000, fragments);
+
+  ASSERT_EQ(fragments.size(), 1u);
+  EXPECT_EQ(fragments[0].entityCount, 0);
+  EXPECT_EQ(fragments[0].payloadBytes, 0u);
+}
+
+TEST(SnapshotFragmentTrackerTest, CompletesOnceWhenEveryFragmentArrives) {
+  SnapshotFragmentTracker tracker;
+  EXPECT_FALSE(tracker.MarkReceived(10, 2, 3));
+  EXPECT_FALSE(tracker.MarkReceived(10, 0, 3));
+  EXPECT_FALSE(tracker.IsComplete(10));
+  EXPECT_FALSE(tracker.MarkReceived(10, 0, 3));
+  EXPECT_TRUE(tracker.MarkReceived(10, 1, 3));
+  EXPECT_TRUE(tracker.IsComplete(10));
+  EXPECT_FALSE(tracker.MarkReceived(10, 1, 3));
+
+  EXPECT_TRUE(tracker.MarkReceived(11, 0, 1));
+}
+
+TEST(SnapshotFragmentTrackerTest, IgnoresInvalidFragments) {
+  SnapshotFragmentTracker tracker;
+  EXPECT_FALSE(tracker.MarkReceived(-1, 0, 1));
+  EXPECT_FALSE(tracker.MarkReceived(1, 1, 1));
+  EXPECT_FALSE(tracker.MarkReceived(1, -1, 1));
+  EXPECT_FALSE(tracker.MarkReceived(1, 0, 0));
+  EXPECT_FALSE(
+      tracker.MarkReceived(1, 0, SnapshotFragmenter::MaxFragmentsPerTick + 1));
+
+  EXPECT_FALSE(tracker.MarkReceived(2, 0, 2));
+  EXPECT_FALSE(tracker.MarkReceived(2, 1, 3));
+  EXPECT_TRUE(tracker.MarkReceived(2, 1, 2));
+}
+
+TEST(SnapshotFragmentTrackerTest, RejectedTicksNeverComplete) {
+  SnapshotFragmentTracker tracker;
+  EXPECT_FALSE(tracker.MarkReceived(10, 0, 2));
+  tracker.Reject(10, 2);
+  EXPECT_FALSE(tracker.MarkReceived(10, 1, 2));
+  EXPECT_FALSE(tracker.IsComplete(10));
+
+  // Rejected before any fragment was counted.
+  tracker.Reject(11, 1);
+  EXPECT_FALSE(tracker.MarkReceived(11, 0, 1));
+  EXPECT_FALSE(tracker.IsComplete(11));
+
+  EXPECT_TRUE(tracker.MarkReceived(12, 0, 1));
+}
+
+TEST(SnapshotFragmentTrackerTest, EvictsTheOldestIncompleteTick) {
+  SnapshotFragmentTracker tracker;
+  for (int tick = 0; tick < static_cast<int>(
+                              SnapshotFragmentTracker::MaxPendingTicks);
+       ++tick) {
+    EXPECT_FALSE(tracker.MarkReceived(tick, 0, 2));
+  }
+
+  EXPECT_FALSE(tracker.MarkReceived(100, 0, 2));
+  EXPECT_FALSE(tracker.MarkReceived(0, 1, 2));
+  EXPECT_FALSE(tracker.IsComplete(0));
+  EXPECT_TRUE(tracker.MarkReceived(1, 1, 2));
+  EXPECT_TRUE(tracker.MarkReceived(100, 1, 2));
+}
+} // namespace ToolKit::ToolKitNetworking
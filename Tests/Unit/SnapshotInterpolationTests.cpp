@@ -0,0 +1,127 @@
+#include "SnapshotInterpolation.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+void PushAtX(InterpolationBuffer &buffer, int tick, float x) {
+  buffer.Push(tick, Vec3(x, 0.0f, 0.0f), Quaternion());
+}
+
+float SampleX(const InterpolationBuffer &buffer, double renderTick,
+              double maxExtrapolationTicks, InterpolationResult *result) {
+  Vec3 position;
+  Quaternion orientation;
+  *result = buffer.Sample(renderTick, maxExtrapolationTicks, position,
+                          orientation);
+  return position.x;
+}
+} // namespace
+
+TEST(InterpolationBufferTest, BlendsBetweenSurroundingTicks) {
+  InterpolationBuffer buffer;
+  InterpolationResult result;
+  Vec3 position;
+  Quaternion orientation;
+  EXPECT_EQ(buffer.Sample(1.0, 0.0, position, orientation),
+            InterpolationResult::Empty);
+
+  PushAtX(buffer, 10, 0.0f);
+  PushAtX(buffer, 12, 4.0f);
+  PushAtX(buffer, 13, 10.0f);
+
+  EXPECT_FLOAT_EQ(SampleX(buffer, 11.0, 0.0, &result), 2.0f);
+  EXPECT_EQ(result, InterpolationResult::Interpolated);
+  EXPECT_FLOAT_EQ(SampleX(buffer, 12.5, 0.0, &result), 7.0f);
+
+  EXPECT_FLOAT_EQ(SampleX(buffer, 5.0, 0.0, &result), 0.0f);
+  EXPECT_EQ(result, InterpolationResult::Clamped);
+}
+
+TEST(InterpolationBufferTest, ExtrapolationIsBounded) {
+  InterpolationBuffer buffer;
+  PushAtX(buffer, 10, 0.0f);
+  PushAtX(buffer, 11, 1.0f);
+
+  InterpolationResult result;
+  EXPECT_FLOAT_EQ(SampleX(buffer, 12.0, 0.0, &result), 1.0f);
+  EXPECT_EQ(result, InterpolationResult::Clamped);
+
+  EXPECT_FLOAT_EQ(SampleX(buffer, 12.5, 3.0, &result), 2.5f);
+  EXPECT_EQ(result, InterpolationResult::Extrapolated);
+  EXPECT_FLOAT_EQ(SampleX(buffer, 20.0, 3.0, &result), 4.0f);
+}
+
+TEST(InterpolationBufferTest, SlerpsOrientation) {
+  InterpolationBuffer buffer;
+  const float halfAngle = 0.5f * 1.5707963f;
+  buffer.Push(0, Vec3(0.0f), Quaternion());
+  buffer.Push(2, Vec3(0.0f),
+              Quaternion(std::cos(halfAngle), 0.0f, std::sin(halfAngle), 0.0f));
+
+  Vec3 position;
+  Quaternion orientation;
+  buffer.Sample(1.0, 0.0, position, orientation);
+  // Halfway through a 90 degree turn about Y.
+  EXPECT_NEAR(orientation.w, std::cos(0.5f * halfAngle), 1e-4f);
+  EXPECT_NEAR(orientation.y, std::sin(0.5f * halfAngle), 1e-4f);
+}
+
+TEST(InterpolationBufferTest, KeepsTickOrderAndDropsOldestWhenFull) {
+  InterpolationBuffer buffer;
+  PushAtX(buffer, 10, 10.0f);
+  PushAtX(buffer, 12, 12.0f);
+  PushAtX(buffer, 11, 11.0f);
+  PushAtX(buffer, 12, 20.0f);
+
+  InterpolationResult result;
+  EXPECT_EQ(buffer.Size(), 3u);
+  EXPECT_FLOAT_EQ(SampleX(buffer, 10.5, 0.0, &result), 10.5f);
+  EXPECT_FLOAT_EQ(SampleX(buffer, 12.0, 0.0, &result), 20.0f);
+
+  const int capacity = static_cast<int>(InterpolationBuffer::Capacity);
+  for (int tick = 13; tick < 13 + capacity; ++tick) {
+    PushAtX(buffer, tick, static_cast<float>(tick));
+  }
+  EXPECT_EQ(buffer.Size(), InterpolationBuffer::Capacity);
+  EXPECT_EQ(buffer.GetNewestTick(), 12 + capacity);
+
+  // Older than everything in a full buffer.
+  PushAtX(buffer, 1, 1.0f);
+  EXPECT_EQ(buffer.Size(), InterpolationBuffer::Capacity);
+  EXPECT_FLOAT_EQ(SampleX(buffer, 0.0, 0.0, &result), 13.0f);
+}
+
+TEST(SnapshotClockTest, LearnsTickLengthAndTrailsByTheBufferTime) {
+  SnapshotClock clock;
+  EXPECT_LT(clock.Advance(0.01, 0.1), 0.0);
+
+  // Server sends a tick every 50 ms; the client renders at 100 Hz.
+  int tick = 100;
+  double renderTick = 0.0;
+  for (int frame = 0; frame < 400; ++frame) {
+    if (frame % 5 == 0) {
+      clock.OnSnapshot(tick++);
+    }
+    renderTick = clock.Advance(0.01, 0.1);
+  }
+
+  EXPECT_NEAR(clock.GetSecondsPerTick(), 0.05, 0.002);
+  // Two ticks of buffer behind the newest tick, plus up to a tick of age.
+  EXPECT_GT(renderTick, clock.GetNewestTick() - 2.5);
+  EXPECT_LT(renderTick, clock.GetNewestTick() - 0.5);
+}
+
+TEST(SnapshotClockTest, SnapsAfterALargeJump) {
+  SnapshotClock clock;
+  clock.OnSnapshot(10);
+  clock.Advance(0.016, 0.1);
+
+  clock.OnSnapshot(1000);
+  const double renderTick = clock.Advance(0.016, 0.1);
+  EXPECT_GT(renderTick, 990.0);
+
+  clock.Reset();
+  EXPECT_EQ(clock.GetNewestTick(), -1);
+  EXPECT_LT(clock.Advance(0.016, 0.1), 0.0);
+}
+} // namespace ToolKit::ToolKitNetworking
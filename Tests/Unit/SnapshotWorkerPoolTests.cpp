@@ -0,0 +1,79 @@
+#include "SnapshotWorkerPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(SnapshotWorkerPoolTest, PoolWithoutThreadsRunsInlineInOrder) {
+  SnapshotWorkerPool pool;
+  EXPECT_EQ(pool.GetWorkerCount(), 1u);
+
+  std::vector<size_t> order;
+  pool.Run(5, [&](size_t index, size_t worker) {
+    EXPECT_EQ(worker, 0u);
+    order.push_back(index);
+  });
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(SnapshotWorkerPoolTest, RunsEveryIndexOnceAcrossWorkers) {
+  SnapshotWorkerPool pool(3);
+  ASSERT_EQ(pool.GetWorkerCount(), 4u);
+
+  for (int round = 0; round < 50; ++round) {
+    std::vector<std::atomic<int>> hits(1000);
+    std::vector<int> perWorker(pool.GetWorkerCount(), 0);
+    pool.Run(hits.size(), [&](size_t index, size_t worker) {
+      ASSERT_LT(worker, perWorker.size());
+      hits[index].fetch_add(1);
+      // One task at a time per worker, so this needs no lock.
+      perWorker[worker]++;
+    });
+
+    int total = 0;
+    for (int count : perWorker) {
+      total += count;
+    }
+    EXPECT_EQ(total, 1000);
+    for (const std::atomic<int> &count : hits) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+}
+
+TEST(SnapshotWorkerPoolTest, ResizingKeepsTheLoopWorking) {
+  SnapshotWorkerPool pool(2);
+  pool.SetThreadCount(0);
+  EXPECT_EQ(pool.GetThreadCount(), 0u);
+  pool.SetThreadCount(4);
+  EXPECT_EQ(pool.GetWorkerCount(), 5u);
+
+  std::atomic<size_t> sum{0};
+  pool.Run(100, [&](size_t index, size_t) { sum.fetch_add(index); });
+  EXPECT_EQ(sum.load(), 4950u);
+
+  pool.Run(0, [&](size_t, size_t) { FAIL(); });
+}
+
+TEST(SnapshotJobThreadTest, RunsJobsOneAfterAnotherOffTheCallingThread) {
+  SnapshotJobThread thread;
+  const std::thread::id caller = std::this_thread::get_id();
+  std::vector<int> order;
+  std::atomic<bool> offThread{true};
+
+  for (int i = 0; i < 20; ++i) {
+    thread.Start([&, i]() {
+      offThread = offThread && std::this_thread::get_id() != caller;
+      order.push_back(i);
+    });
+  }
+  thread.Wait();
+
+  EXPECT_FALSE(thread.IsBusy());
+  EXPECT_TRUE(offThread.load());
+  ASSERT_EQ(order.size(), 20u);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+} // namespace ToolKit::ToolKitNetworking
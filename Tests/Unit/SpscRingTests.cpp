@@ -0,0 +1,81 @@
+#include "SpscRing.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(SpscRingTest, RoundsCapacityUpToAPowerOfTwo) {
+  SpscRing<int> ring(5);
+  EXPECT_EQ(ring.GetCapacity(), 8u);
+}
+
+TEST(SpscRingTest, PopsInPushOrderAndReportsFull) {
+  SpscRing<int> ring(4);
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_EQ(ring.Front(), nullptr);
+
+  for (int i = 0; i < 4; ++i) {
+    int *slot = ring.BeginPush();
+    ASSERT_NE(slot, nullptr);
+    *slot = i;
+    ring.CommitPush();
+  }
+  EXPECT_EQ(ring.BeginPush(), nullptr);
+
+  for (int i = 0; i < 4; ++i) {
+    int *front = ring.Front();
+    ASSERT_NE(front, nullptr);
+    EXPECT_EQ(*front, i);
+    ring.Pop();
+  }
+  EXPECT_TRUE(ring.IsEmpty());
+  EXPECT_NE(ring.BeginPush(), nullptr);
+}
+
+TEST(SpscRingTest, SlotsKeepTheirBuffersAcrossWraps) {
+  SpscRing<std::vector<char>> ring(2);
+  for (int round = 0; round < 2; ++round) {
+    std::vector<char> *slot = ring.BeginPush();
+    slot->assign(256, 'x');
+    ring.CommitPush();
+    ring.Pop();
+  }
+
+  // Back at the first slot: its buffer is reused instead of reallocated.
+  for (int i = 0; i < 2; ++i) {
+    std::vector<char> *slot = ring.BeginPush();
+    EXPECT_GE(slot->capacity(), 256u);
+    ring.CommitPush();
+    ring.Pop();
+  }
+}
+
+TEST(SpscRingTest, TransfersEveryItemBetweenThreads) {
+  constexpr int Count = 200000;
+  SpscRing<int> ring(64);
+
+  std::thread producer([&]() {
+    for (int i = 0; i < Count; ++i) {
+      int *slot = nullptr;
+      while ((slot = ring.BeginPush()) == nullptr) {
+        std::this_thread::yield();
+      }
+      *slot = i;
+      ring.CommitPush();
+    }
+  });
+
+  int expected = 0;
+  while (expected < Count) {
+    if (int *front = ring.Front()) {
+      ASSERT_EQ(*front, expected);
+      ring.Pop();
+      expected++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(ring.IsEmpty());
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,93 @@
+#include "TickHistoryRing.h"
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+TEST(TickHistoryRingTest, LooksUpStoredTicks) {
+  TickHistoryRing<int> history(8);
+  ASSERT_TRUE(history.Store(3, 30));
+  ASSERT_TRUE(history.Store(4, 40));
+
+  int value = 0;
+  EXPECT_EQ(history.Lookup(3, value), TickHistoryLookup::Found);
+  EXPECT_EQ(value, 30);
+  EXPECT_EQ(history.Lookup(4, value), TickHistoryLookup::Found);
+  EXPECT_EQ(value, 40);
+  EXPECT_EQ(history.Lookup(5, value), TickHistoryLookup::Missing);
+  EXPECT_EQ(history.Lookup(-1, value), TickHistoryLookup::Missing);
+}
+
+TEST(TickHistoryRingTest, RejectsTicksOlderThanTheWindow) {
+  TickHistoryRing<int> history(8);
+  for (int tick = 0; tick < 20; ++tick) {
+    ASSERT_TRUE(history.Store(tick, tick * 10));
+  }
+
+  int value = 0;
+  EXPECT_EQ(history.Lookup(12, value), TickHistoryLookup::Found);
+  EXPECT_EQ(value, 120);
+  EXPECT_EQ(history.Lookup(11, value), TickHistoryLookup::TooOld);
+  EXPECT_TRUE(history.IsTooOld(11));
+  EXPECT_FALSE(history.Store(11, 0));
+  EXPECT_EQ(history.GetNewestTick(), 19);
+}
+
+TEST(TickHistoryRingTest, SlotReuseDoesNotAliasOlderTicks) {
+  TickHistoryRing<int> history(4);
+  ASSERT_TRUE(history.Store(1, 10));
+  ASSERT_TRUE(history.Store(5, 50));
+
+  int value = 0;
+  EXPECT_EQ(history.Lookup(1, value), TickHistoryLookup::TooOld);
+  EXPECT_EQ(history.Lookup(5, value), TickHistoryLookup::Found);
+  EXPECT_EQ(value, 50);
+  EXPECT_EQ(history.Lookup(3, value), TickHistoryLookup::Missing);
+}
+
+TEST(TickHistoryRingTest, AcceptsOutOfOrderTicksInsideTheWindow) {
+  TickHistoryRing<int> history(8);
+  ASSERT_TRUE(history.Store(10, 100));
+  ASSERT_TRUE(history.Store(7, 70));
+
+  int value = 0;
+  EXPECT_EQ(history.Lookup(7, value), TickHistoryLookup::Found);
+  EXPECT_EQ(value, 70);
+  EXPECT_EQ(history.GetNewestTick(), 10);
+}
+
+TEST(TickHistoryRingTest, RestoringTheSameTickOverwritesIt) {
+  TickHistoryRing<int> history(8);
+  ASSERT_TRUE(history.Store(2, 1));
+  ASSERT_TRUE(history.Store(2, 2));
+
+  int value = 0;
+  EXPECT_EQ(history.Lookup(2, value), TickHistoryLookup::Found);
+  EXPECT_EQ(value, 2);
+}
+
+TEST(TickHistoryRingTest, DiscardAndClearForgetTicks) {
+  TickHistoryRing<int> history(8);
+  for (int tick = 0; tick < 6; ++tick) {
+    history.Store(tick, tick);
+  }
+
+  history.DiscardBefore(4);
+  int value = 0;
+  EXPECT_EQ(history.Lookup(3, value), TickHistoryLookup::Missing);
+  EXPECT_EQ(history.Lookup(4, value), TickHistoryLookup::Found);
+
+  history.Clear();
+  EXPECT_EQ(history.Lookup(4, value), TickHistoryLookup::Missing);
+  EXPECT_EQ(history.GetNewestTick(), -1);
+}
+
+TEST(TickHistoryRingTest, CapacityChangeResetsHistory) {
+  TickHistoryRing<int> history;
+  EXPECT_EQ(history.GetCapacity(), TickHistoryRing<int>::DefaultCapacity);
+  history.Store(1, 1);
+
+  history.SetCapacity(16);
+  int value = 0;
+  EXPECT_EQ(history.GetCapacity(), 16u);
+  EXPECT_EQ(history.Lookup(1, value), TickHistoryLookup::Missing);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,127 @@
+#include "TransformCache.h"
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+const Quaternion Identity(1.0f, 0.0f, 0.0f, 0.0f);
+
+// Yaw of `radians` around Y.
+Quaternion Yaw(float radians) {
+  return Quaternion(std::cos(radians * 0.5f), 0.0f, std::sin(radians * 0.5f),
+                    0.0f);
+}
+} // namespace
+
+TEST(TransformCacheTest, FrameStoresTransformsPerSlot) {
+  TransformFrame frame;
+  frame.Resize(2);
+  frame.Set(0, 10, Vec3(1.0f, 2.0f, 3.0f), Yaw(0.5f));
+  frame.SetMissing(1, 11);
+
+  EXPECT_EQ(frame.Size(), 2u);
+  EXPECT_EQ(frame.GetPosition(0), Vec3(1.0f, 2.0f, 3.0f));
+  EXPECT_EQ(frame.GetOrientation(0), Yaw(0.5f));
+  EXPECT_EQ(frame.present[0], 1);
+  EXPECT_EQ(frame.present[1], 0);
+
+  EXPECT_EQ(frame.FindSlot(10, 0), 0);
+  EXPECT_EQ(frame.FindSlot(11, 0), 1);
+  EXPECT_EQ(frame.FindSlot(12, 1), -1);
+}
+
+TEST(TransformCacheTest, DetectsMovesAndTurnsAboveTheThresholds) {
+  TransformCache cache(8);
+  TransformFrame &base = cache.BeginFrame(1, 4);
+  for (int i = 0; i < 4; ++i) {
+    base.Set(i, i + 1, Vec3(0.0f), Identity);
+  }
+
+  TransformFrame &current = cache.BeginFrame(2, 4);
+  current.Set(0, 1, Vec3(0.0f), Identity);
+  current.Set(1, 2, Vec3(1.0f, 0.0f, 0.0f), Identity);
+  current.Set(2, 3, Vec3(0.0f), Yaw(0.5f));
+  current.Set(3, 4, Vec3(TransformPositionThreshold * 0.5f, 0.0f, 0.0f),
+              Identity);
+
+  const TransformChanges &changes = cache.GetChanges(1);
+  ASSERT_EQ(changes.position.size(), 1u);
+  EXPECT_EQ(changes.Get(0), 0);
+  EXPECT_EQ(changes.Get(1), TransformPositionChanged);
+  EXPECT_EQ(changes.Get(2), TransformOrientationChanged);
+  EXPECT_EQ(changes.Get(3), 0);
+
+  const SnapshotTransform moved = cache.GetTransform(1, 1);
+  EXPECT_TRUE(moved.present);
+  EXPECT_TRUE(moved.hasBaseline);
+  EXPECT_TRUE(moved.positionChanged);
+  EXPECT_FALSE(moved.orientationChanged);
+  EXPECT_EQ(moved.position, Vec3(1.0f, 0.0f, 0.0f));
+}
+
+TEST(TransformCacheTest, OppositeQuaternionsAreTheSameOrientation) {
+  TransformCache cache(8);
+  cache.BeginFrame(1, 1).Set(0, 1, Vec3(0.0f), Yaw(0.3f));
+  cache.BeginFrame(2, 1).Set(0, 1, Vec3(0.0f), -Yaw(0.3f));
+  EXPECT_EQ(cache.GetChanges(1).Get(0), 0);
+}
+
+TEST(TransformCacheTest, EntitiesWithoutABaselineAreSentInFull) {
+  TransformCache cache(4);
+  TransformFrame &base = cache.BeginFrame(1, 2);
+  base.Set(0, 1, Vec3(0.0f), Identity);
+  base.SetMissing(1, 2);
+
+  TransformFrame &current = cache.BeginFrame(2, 3);
+  current.Set(0, 1, Vec3(0.0f), Identity);
+  current.Set(1, 2, Vec3(0.0f), Identity);
+  current.Set(2, 3, Vec3(0.0f), Identity);
+
+  const TransformChanges &changes = cache.GetChanges(1);
+  EXPECT_EQ(changes.Get(0), 0);
+  // No node on the baseline tick, and spawned after it.
+  EXPECT_EQ(changes.Get(1), TransformNoBaseline);
+  EXPECT_EQ(changes.Get(2), TransformNoBaseline);
+  EXPECT_FALSE(cache.GetTransform(2, 1).hasBaseline);
+
+  // Never recorded, or no baseline at all.
+  EXPECT_EQ(cache.GetChanges(0).Get(0), TransformNoBaseline);
+  EXPECT_EQ(cache.GetChanges(-1).Get(0), TransformNoBaseline);
+}
+
+TEST(TransformCacheTest, BaselinesAreMatchedByNetworkIDWhenSlotsMove) {
+  TransformCache cache(4);
+  TransformFrame &base = cache.BeginFrame(1, 3);
+  base.Set(0, 1, Vec3(1.0f), Identity);
+  base.Set(1, 2, Vec3(2.0f), Identity);
+  base.Set(2, 3, Vec3(3.0f), Identity);
+
+  // Entity 2 was removed and entity 3 took its slot.
+  TransformFrame &current = cache.BeginFrame(2, 2);
+  current.Set(0, 1, Vec3(1.0f), Identity);
+  current.Set(1, 3, Vec3(3.0f), Identity);
+
+  const TransformChanges &changes = cache.GetChanges(1);
+  EXPECT_EQ(changes.Get(0), 0);
+  EXPECT_EQ(changes.Get(1), 0);
+}
+
+TEST(TransformCacheTest, FramesOlderThanTheWindowAreGone) {
+  TransformCache cache(4);
+  for (int tick = 1; tick <= 5; ++tick) {
+    cache.BeginFrame(tick, 1).Set(0, 1, Vec3(0.0f), Identity);
+  }
+
+  EXPECT_EQ(cache.FindFrame(1), nullptr);
+  ASSERT_NE(cache.FindFrame(2), nullptr);
+  EXPECT_EQ(cache.FindFrame(2)->tick, 2);
+  EXPECT_EQ(cache.GetChanges(1).Get(0), TransformNoBaseline);
+  EXPECT_EQ(cache.GetChanges(2).Get(0), 0);
+}
+
+TEST(TransformCacheTest, MissingNodesCarryNoTransform) {
+  TransformCache cache(4);
+  cache.BeginFrame(1, 1).SetMissing(0, 1);
+  EXPECT_FALSE(cache.GetTransform(0, -1).present);
+}
+} // namespace ToolKit::ToolKitNetworking
@@ -0,0 +1,147 @@
+#include "TransformChangeKernel.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace ToolKit::ToolKitNetworking {
+namespace {
+constexpr float PositionThreshold = 0.001f;
+constexpr float OrientationThreshold = 0.001f;
+
+struct Columns {
+  std::vector<float> posX, posY, posZ, rotX, rotY, rotZ, rotW;
+  std::vector<uint8_t> present;
+
+  explicit Columns(size_t count)
+      : posX(count), posY(count), posZ(count), rotX(count), rotY(count),
+        rotZ(count), rotW(count, 1.0f), present(count, 1) {}
+
+  TransformArrays Arrays() const {
+    return TransformArrays{posX.data(), posY.data(), posZ.data(), rotX.data(),
+                           rotY.data(), rotZ.data(), rotW.data(),
+                           present.data()};
+  }
+};
+
+struct Masks {
+  std::vector<uint8_t> position, orientation, noBaseline;
+
+  explicit Masks(size_t count)
+      : position(TransformMaskBytes(count)),
+        orientation(TransformMaskBytes(count)),
+        noBaseline(TransformMaskBytes(count)) {}
+
+  TransformChangeMasks Out() {
+    return TransformChangeMasks{position.data(), orientation.data(),
+                                noBaseline.data()};
+  }
+};
+
+// A baseline and a current frame where some entities moved or turned by a
+// little more or a little less than the thresholds.
+void FillRandom(size_t count, Columns &current, Columns &baseline) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> kind(0, 5);
+  for (size_t i = 0; i < count; ++i) {
+    baseline.posX[i] = coordinate(random);
+    baseline.posY[i] = coordinate(random);
+    baseline.posZ[i] = coordinate(random);
+    const float angle = unit(random);
+    baseline.rotY[i] = std::sin(angle);
+    baseline.rotW[i] = std::cos(angle);
+
+    current.posX[i] = baseline.posX[i];
+    current.posY[i] = baseline.posY[i];
+    current.posZ[i] = baseline.posZ[i];
+    current.rotY[i] = baseline.rotY[i];
+    current.rotW[i] = baseline.rotW[i];
+    switch (kind(random)) {
+    case 0:
+      current.posX[i] += 0.01f * unit(random);
+      break;
+    case 1:
+      current.posZ[i] += PositionThreshold * 0.5f;
+      break;
+    case 2:
+      current.rotY[i] = std::sin(angle + 0.1f * unit(random));
+      current.rotW[i] = std::cos(angle + 0.1f * unit(random));
+      break;
+    case 3:
+      // The same orientation, negated.
+      current.rotY[i] = -baseline.rotY[i];
+      current.rotW[i] = -baseline.rotW[i];
+      break;
+    case 4:
+      baseline.present[i] = 0;
+      break;
+    default:
+      break;
+    }
+  }
+}
+} // namespace
+
+TEST(TransformChangeKernelTest, ScalarKernelAppliesBothThresholds) {
+  Columns current(4);
+  Columns baseline(4);
+  current.posX[1] = 1.0f;
+  current.posX[2] = PositionThreshold * 0.5f;
+  current.rotY[3] = 0.2f;
+  current.rotW[3] = 0.98f;
+  baseline.present[0] = 0;
+
+  Masks masks(4);
+  DetectTransformChanges(current.Arrays(), baseline.Arrays(), 4,
+                         PositionThreshold, OrientationThreshold, masks.Out(),
+                         TransformKernel::Scalar);
+  EXPECT_EQ(masks.position[0], 0b0011);
+  EXPECT_EQ(masks.orientation[0], 0b1001);
+  EXPECT_EQ(masks.noBaseline[0], 0b0001);
+}
+
+TEST(TransformChangeKernelTest, SimdKernelsMatchTheScalarKernel) {
+  for (size_t count : {0u, 1u, 7u, 8u, 9u, 31u, 1000u, 1003u}) {
+    Columns current(count);
+    Columns baseline(count);
+    FillRandom(count, current, baseline);
+
+    Masks expected(count);
+    DetectTransformChanges(current.Arrays(), baseline.Arrays(), count,
+                           PositionThreshold, OrientationThreshold,
+                           expected.Out(), TransformKernel::Scalar);
+
+    for (TransformKernel kernel :
+         {TransformKernel::Sse, TransformKernel::Avx2}) {
+      if (!IsTransformKernelSupported(kernel)) {
+        continue;
+      }
+
+      Masks actual(count);
+      DetectTransformChanges(current.Arrays(), baseline.Arrays(), count,
+                             PositionThreshold, OrientationThreshold,
+                             actual.Out(), kernel);
+      EXPECT_EQ(actual.position, expected.position) << count;
+      EXPECT_EQ(actual.orientation, expected.orientation) << count;
+      EXPECT_EQ(actual.noBaseline, expected.noBaseline) << count;
+    }
+  }
+}
+
+TEST(TransformChangeKernelTest, UnsupportedKernelsFallBackToScalar) {
+  EXPECT_TRUE(IsTransformKernelSupported(TransformKernel::Scalar));
+  EXPECT_TRUE(IsTransformKernelSupported(GetBestTransformKernel()));
+
+  Columns current(3);
+  Columns baseline(3);
+  current.posY[2] = 5.0f;
+  Masks masks(3);
+  DetectTransformChanges(current.Arrays(), baseline.Arrays(), 3,
+                         PositionThreshold, OrientationThreshold, masks.Out(),
+                         TransformKernel::Avx2);
+  EXPECT_EQ(masks.position[0], 0b100);
+  EXPECT_EQ(masks.orientation[0], 0);
+}
+} // namespace ToolKit::ToolKitNetworking